@@ -0,0 +1,112 @@
+/**
+ * @file   icaruscode/Analysis/Algorithms/BranchCreator.h
+ * @brief  Helper to create or reconnect the branches of a ROOT tree.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Analysis/AnalysisTree_module.cc`
+ *
+ * This is a header-only library.
+ */
+
+#ifndef ICARUSCODE_ANALYSIS_ALGORITHMS_BRANCHCREATOR_H
+#define ICARUSCODE_ANALYSIS_ALGORITHMS_BRANCHCREATOR_H
+
+// framework libraries
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// ROOT libraries
+#include "TTree.h"
+#include "TBranch.h"
+
+// C/C++ standard libraries
+#include <string>
+#include <sstream>
+#include <vector>
+
+
+namespace icarus {
+
+  /**
+   * @brief Little helper functor class to create or reset branches in a tree.
+   *
+   * Each call creates the named branch if the tree does not have it yet, and
+   * otherwise points the existing branch to the specified data, if it is not
+   * already pointing there. Calls on a null tree have no effect.
+   */
+  class BranchCreator {
+      public:
+    TTree* pTree; ///< the tree to be worked on
+    BranchCreator(TTree* tree): pTree(tree) {}
+
+    //@{
+    /// Create a branch if it does not exist, and set its address
+    void operator()
+      (std::string name, void* address, std::string leaflist /*, int bufsize = 32000 */)
+      {
+        if (!pTree) return;
+        TBranch* pBranch = pTree->GetBranch(name.c_str());
+        if (!pBranch) {
+          pTree->Branch(name.c_str(), address, leaflist.c_str() /*, bufsize */);
+          MF_LOG_DEBUG("AnalysisTreeStructure")
+            << "Creating branch '" << name << " with leaf '" << leaflist << "'";
+        }
+        else if (pBranch->GetAddress() != address) {
+          pBranch->SetAddress(address);
+          MF_LOG_DEBUG("AnalysisTreeStructure")
+            << "Reassigning address to branch '" << name << "'";
+        }
+        else {
+          MF_LOG_DEBUG("AnalysisTreeStructure")
+            << "Branch '" << name << "' is fine";
+        }
+      } // operator()
+    void operator()
+      (std::string name, void* address, const std::stringstream& leaflist /*, int bufsize = 32000 */)
+      { return this->operator() (name, address, leaflist.str() /*, int bufsize = 32000 */); }
+    template <typename T>
+    void operator()
+      (std::string name, std::vector<T>& data, std::string leaflist /*, int bufsize = 32000 */)
+      { return this->operator() (name, (void*) data.data(), leaflist /*, int bufsize = 32000 */); }
+
+    template <typename T>
+    void operator() (std::string name, std::vector<T>& data)
+      {
+        // overload for a generic object expressed directly by reference
+        // (as opposed to a generic object expressed by a pointer or
+        // to a simple leaf sequence specification);
+        // TTree::Branch(name, T* obj, Int_t bufsize, splitlevel) and
+        // TTree::SetObject() are used.
+        if (!pTree) return;
+        TBranch* pBranch = pTree->GetBranch(name.c_str());
+        if (!pBranch) {
+          pBranch = pTree->Branch(name.c_str(), &data);
+          // ROOT needs a dictionary for std::vector<T> (not for T, which may
+          // well be a fundamental type) to create the branch; if it had none,
+          // the branch was not created
+          MF_LOG_DEBUG("AnalysisTreeStructure")
+            << "Creating object branch '" << name << " with "
+            << (pBranch? pBranch->GetClassName(): "no class (creation failed)");
+        }
+        else if
+          (*(reinterpret_cast<std::vector<T>**>(pBranch->GetAddress())) != &data)
+        {
+          // when an object is provided directly, the address of the object
+          // is assigned in TBranchElement::fObject (via TObject::SetObject())
+          // and the address itself is set to the address of the fObject
+          // member. Here we check that the address of the object in fObject
+          // is the same as the address of our current data type
+          pBranch->SetObject(&data);
+          MF_LOG_DEBUG("AnalysisTreeStructure")
+            << "Reassigning object to branch '" << name << "'";
+        }
+        else {
+          MF_LOG_DEBUG("AnalysisTreeStructure")
+            << "Branch '" << name << "' is fine";
+        }
+      } // operator()
+    //@}
+  }; // class BranchCreator
+
+} // namespace icarus
+
+
+#endif // ICARUSCODE_ANALYSIS_ALGORITHMS_BRANCHCREATOR_H
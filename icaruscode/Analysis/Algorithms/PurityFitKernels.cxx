@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////
+// \file PurityFitKernels.cxx
+//
+// \brief Closed-form fits used by the electron lifetime (purity) monitor
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "icaruscode/Analysis/Algorithms/PurityFitKernels.h"
+
+#include <cmath>
+
+namespace {
+
+    // sums of (x - <x>) products, which keep their precision when x is far from 0
+    struct CentredSums
+    {
+        double S   = 0.;
+        double mx  = 0.;
+        double my  = 0.;
+        double Sxx = 0.;
+        double Sxy = 0.;
+    };
+
+    icarus::purity::LinearFitResult lineFromSums(const CentredSums& sums, std::size_t n)
+    {
+        icarus::purity::LinearFitResult result;
+
+        result.nPoints = n;
+
+        if (n < 2 || !(sums.S > 0.) || !(sums.Sxx > 0.)) return result;
+
+        result.slope          = sums.Sxy / sums.Sxx;
+        result.intercept      = sums.my - result.slope * sums.mx;
+        result.slopeError     = std::sqrt(1. / sums.Sxx);
+        result.interceptError = std::sqrt(1. / sums.S + sums.mx * sums.mx / sums.Sxx);
+        result.valid          = true;
+
+        return result;
+    }
+
+    // weight of the point i: function of the index
+    template <typename Weight>
+    CentredSums centredSums(const double* x, const double* y, std::size_t n, Weight weight)
+    {
+        CentredSums sums;
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            sums.S  += weight(i);
+            sums.mx += weight(i) * x[i];
+            sums.my += weight(i) * y[i];
+        }
+
+        if (!(sums.S > 0.)) return sums;
+
+        sums.mx /= sums.S;
+        sums.my /= sums.S;
+
+        for(std::size_t i = 0; i < n; i++)
+        {
+            double dx = x[i] - sums.mx;
+
+            sums.Sxx += weight(i) * dx * dx;
+            sums.Sxy += weight(i) * dx * (y[i] - sums.my);
+        }
+
+        return sums;
+    }
+
+} // local namespace
+
+void icarus::purity::LinearRegression::accumulate(double x, double y, double w)
+{
+    fS   += w;
+    fSx  += w * x;
+    fSy  += w * y;
+    fSxx += w * x * x;
+    fSxy += w * x * y;
+}
+
+icarus::purity::LinearFitResult icarus::purity::LinearRegression::fit() const
+{
+    CentredSums sums;
+
+    if (fS > 0.)
+    {
+        sums.S   = fS;
+        sums.mx  = fSx / fS;
+        sums.my  = fSy / fS;
+        sums.Sxx = fSxx - fS * sums.mx * sums.mx;
+        sums.Sxy = fSxy - fS * sums.mx * sums.my;
+    }
+
+    return lineFromSums(sums, fN);
+}
+
+icarus::purity::LinearFitResult icarus::purity::linearFit(const double* x, const double* y, std::size_t n, double sigmaY)
+{
+    double w = sigmaY > 0. ? 1. / (sigmaY * sigmaY) : 1.;
+
+    LinearFitResult result = lineFromSums(centredSums(x, y, n, [w](std::size_t){return w;}), n);
+
+    if (result.valid) result.chi2 = linearFitChi2(result, x, y, n, sigmaY);
+
+    return result;
+}
+
+double icarus::purity::linearFitChi2(const LinearFitResult& line, const double* x, const double* y, std::size_t n, double sigmaY)
+{
+    double chi2 = 0.;
+
+    for(std::size_t i = 0; i < n; i++)
+    {
+        double residual = y[i] - line(x[i]);
+
+        chi2 += residual * residual;
+    }
+
+    return sigmaY > 0. ? chi2 / (sigmaY * sigmaY) : chi2;
+}
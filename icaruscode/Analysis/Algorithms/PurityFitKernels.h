@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////
+// \file PurityFitKernels.h
+//
+// \brief Closed-form fits used by the electron lifetime (purity) monitor
+//
+// These replace ROOT graph fits on small per-cluster samples:
+// all the estimators are computed in one or two passes over plain arrays,
+// with no object allocation.
+//
+//  * linear fits (ROOT "pol1");
+//    a running sum interface supports removing points one at a time,
+//    as needed by outlier rejection
+//
+////////////////////////////////////////////////////////////////////////
+#ifndef ICARUSCODE_ANALYSIS_ALGORITHMS_PURITYFITKERNELS_H
+#define ICARUSCODE_ANALYSIS_ALGORITHMS_PURITYFITKERNELS_H
+
+#include <cstddef>
+
+namespace icarus {
+namespace purity {
+
+    /// Result of a fit of `y = intercept + slope * x`
+    struct LinearFitResult
+    {
+        double      intercept      = 0.;
+        double      slope          = 0.;
+        double      interceptError = 0.;
+        double      slopeError     = 0.;
+        double      chi2           = 0.;
+        std::size_t nPoints        = 0;
+        bool        valid          = false;  ///< false if fewer than two distinct x
+
+        /// Returns the fitted value at `x`
+        double operator()(double x) const { return intercept + slope * x; }
+    };
+
+    /**
+     * @brief Weighted sums for a straight line fit, with points added or removed
+     *
+     * The fit is in closed form from the sums; parameter errors assume that the
+     * weights are the inverse variances of the points. The chi square is not
+     * available from the sums, see `linearFitChi2()`.
+     */
+    class LinearRegression
+    {
+    public:
+        void add(double x, double y, double w = 1.)    { fN++; accumulate(x, y, w); }
+        void remove(double x, double y, double w = 1.) { fN--; accumulate(x, y, -w); }
+
+        std::size_t nPoints() const { return fN; }
+
+        /// Returns the best fit line (chi2 is left 0)
+        LinearFitResult fit() const;
+
+    private:
+        void accumulate(double x, double y, double w);
+
+        std::size_t fN   = 0;
+        double      fS   = 0.;
+        double      fSx  = 0.;
+        double      fSy  = 0.;
+        double      fSxx = 0.;
+        double      fSxy = 0.;
+    };
+
+    /**
+     * @brief Fits a straight line to `n` points with a common uncertainty
+     * @param sigmaY uncertainty of all the `y`; non-positive means unit weights
+     *
+     * This is equivalent to a ROOT "pol1" fit of a `TGraphErrors` with no `x`
+     * errors and all `y` errors equal to `sigmaY`: the parameters do not depend
+     * on `sigmaY`, while their errors and the chi square scale with it.
+     */
+    LinearFitResult linearFit(const double* x, const double* y, std::size_t n, double sigmaY = 0.);
+
+    /// Returns the chi square of `line` on `n` points with a common uncertainty
+    double linearFitChi2(const LinearFitResult& line, const double* x, const double* y, std::size_t n, double sigmaY);
+
+} // namespace purity
+} // namespace icarus
+
+#endif // ICARUSCODE_ANALYSIS_ALGORITHMS_PURITYFITKERNELS_H
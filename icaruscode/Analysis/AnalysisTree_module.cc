@@ -13,7 +13,8 @@
 // [x] use variable size array buffers for each tracker datum instead of [kMaxTrack]
 // [x] turn the truth/GEANT information into vectors
 // [ ] move hit_trkid into the track information, remove kMaxTrackers
-// [ ] turn the hit information into vectors (~1 MB worth), remove kMaxHits
+// [~] turn the hit information into vectors (~1 MB worth), remove kMaxHits
+//     (done in "VariableLengthHits: true" mode only)
 // [ ] fill the tree branch by branch
 // 
 // Current implementation:
@@ -66,6 +67,16 @@
 // necessarily make memory available, because of how std::vector::resize()
 // works; that feature can be implemented, but it currently has not been.
 // 
+// The "VariableLengthHits: true" mode replaces the fixed size hit pools with
+// variable length branches, sized to the content of each event:
+// the event hits (hit_*) are stored as std::vector branches with no_hits
+// entries, and the calorimetry hits of each tracker (trkdedx_*, trkdqdx_*,
+// trkresrg_*, trkxp_*, trkyp_*, trkzp_*, trkxyz_*) as one flat std::vector
+// per branch, with the hits of all tracks and planes in sequence: track 0
+// plane 0, track 0 plane 1, ... The number of hits of each track on each plane
+// is in ntrkhits_* (negative values mean no hits). These vectors are cleared,
+// not reset, on each event, and no hit limit applies.
+// 
 // The BoxedArray<> class is a wrapper around a normal C array; it is needed
 // to be able to include such structure in a std::vector. This container
 // requires its objects to be default-constructable and copy-constructable,
@@ -121,8 +132,10 @@
 #include "lardataobj/AnalysisBase/FlashMatch.h"
 
 #include "icaruscode/RecoUtils/RecoUtils.h"
+#include "icaruscode/Analysis/Algorithms/BranchCreator.h"
 
 #include <cstring> // std::memcpy()
+#include <limits> // std::numeric_limits<>
 #include <vector>
 #include <map>
 #include <iterator> // std::begin(), std::end()
@@ -131,7 +144,6 @@
 #include <fstream>
 #include <algorithm>
 #include <functional> // std::mem_fun_ref
-#include <typeinfo>
 
 #include "TTree.h"
 #include "TTimeStamp.h"
@@ -215,6 +227,9 @@ namespace icarus {
        * PlaneData_t<Float_t>, PlaneData_t<Int_t>: 12  bytes/track
        * HitData_t<Float_t>                      : 24k bytes/track
        * HitCoordData_t<Float_t>                 : 72k bytes/track
+       *
+       * In variable length mode, the hit data is not allocated and
+       * FlatHitData_t<Float_t> takes 4 bytes per stored hit instead.
        */
       template <typename T>
       using TrackData_t = std::vector<T>;
@@ -224,8 +239,11 @@ namespace icarus {
       using HitData_t = std::vector<BoxedArray<T[kNplanes][kMaxTrackHits]>>;
       template <typename T>
       using HitCoordData_t = std::vector<BoxedArray<T[kNplanes][kMaxTrackHits][3]>>;
+      template <typename T>
+      using FlatHitData_t = std::vector<T>;
       
       size_t MaxTracks; ///< maximum number of storable tracks
+      bool VariableLengthHits = false; ///< use FlatHitData_t instead of HitData_t
       
       Short_t  ntracks;             //number of reconstructed tracks
       PlaneData_t<Float_t>    trkke;
@@ -251,6 +269,15 @@ namespace icarus {
       HitData_t<Float_t>      trkdqdx;
       HitData_t<Float_t>      trkresrg;
       HitCoordData_t<Float_t> trkxyz;
+      
+      // variable length mode: hits of all tracks and planes in sequence
+      FlatHitData_t<Float_t>  flatdedx;
+      FlatHitData_t<Float_t>  flatxp;
+      FlatHitData_t<Float_t>  flatyp;
+      FlatHitData_t<Float_t>  flatzp;
+      FlatHitData_t<Float_t>  flatdqdx;
+      FlatHitData_t<Float_t>  flatresrg;
+      FlatHitData_t<Float_t>  flatxyz; // 3 entries per hit
 
       // more track info
       TrackData_t<Short_t> trkId;
@@ -304,11 +331,17 @@ namespace icarus {
       void Resize(size_t nTracks);
       void SetAddresses(TTree* pTree, std::string tracker, bool isCosmics);
       
+      /// Appends the hits of one calorimetry plane (variable length mode)
+      void AppendHits(const anab::Calorimetry& calo);
+      
       size_t GetMaxTracks() const { return MaxTracks; }
       size_t GetMaxPlanesPerTrack(int /* iTrack */ = 0) const
         { return (size_t) kNplanes; }
       size_t GetMaxHitsPerTrack(int /* iTrack */ = 0, int /* ipl */ = 0) const
-        { return (size_t) kMaxTrackHits; }
+        {
+          return VariableLengthHits
+            ? std::numeric_limits<size_t>::max(): (size_t) kMaxTrackHits;
+        }
       
     }; // class TrackDataStruct
     
@@ -351,20 +384,23 @@ namespace icarus {
     // Double_t   taulife;              //electron lifetime
     Char_t     isdata;               //flag, 0=MC 1=data
 
-    // hit information (non-resizeable, 45x kMaxHits = 900k bytes worth)
+    // hit information (kMaxHits entries, 45x kMaxHits = 900k bytes worth,
+    // unless in variable length mode, where they are sized to no_hits)
+    bool     VariableLengthHits;       ///! whether hit data is sized to the event
+    size_t   MaxHits;                  ///! the number of hits there is currently room for
     Int_t    no_hits;                  //number of hits
-    Short_t  hit_tpc[kMaxHits];        //tpc number
-    Short_t  hit_plane[kMaxHits];      //plane number
-    Short_t  hit_wire[kMaxHits];       //wire number
-    Short_t  hit_channel[kMaxHits];    //channel ID
-    Float_t  hit_peakT[kMaxHits];      //peak time
-    Float_t  hit_charge[kMaxHits];     //charge (area)
-    Float_t  hit_ph[kMaxHits];         //amplitude
-    Float_t  hit_startT[kMaxHits];     //hit start time
-    Float_t  hit_endT[kMaxHits];       //hit end time
-    Float_t  hit_nelec[kMaxHits];     //hit number of electrons
-    Float_t  hit_energy[kMaxHits];       //hit energy
-    Short_t  hit_trkid[kMaxHits];      //is this hit associated with a reco track?
+    std::vector<Short_t>  hit_tpc;     //tpc number
+    std::vector<Short_t>  hit_plane;   //plane number
+    std::vector<Short_t>  hit_wire;    //wire number
+    std::vector<Short_t>  hit_channel; //channel ID
+    std::vector<Float_t>  hit_peakT;   //peak time
+    std::vector<Float_t>  hit_charge;  //charge (area)
+    std::vector<Float_t>  hit_ph;      //amplitude
+    std::vector<Float_t>  hit_startT;  //hit start time
+    std::vector<Float_t>  hit_endT;    //hit end time
+    std::vector<Float_t>  hit_nelec;   //hit number of electrons
+    std::vector<Float_t>  hit_energy;  //hit energy
+    std::vector<Short_t>  hit_trkid;   //is this hit associated with a reco track?
 
     // vertex information
     Short_t  nvtx;                     //number of vertices
@@ -527,7 +563,8 @@ namespace icarus {
       { if (unset) bits &= ~setbits; else bits |= setbits; }
       
     /// Constructor; clears all fields
-    AnalysisTreeDataStruct(size_t nTrackers = 0): bits(tdDefault) 
+    AnalysisTreeDataStruct(size_t nTrackers = 0, bool variableLengthHits = false)
+      : VariableLengthHits(variableLengthHits), bits(tdDefault) 
       { SetTrackers(nTrackers); Clear(); }
 
     TrackDataStruct& GetTrackerData(size_t iTracker)
@@ -544,7 +581,15 @@ namespace icarus {
     
     
     /// Allocates data structures for the given number of trackers (no Clear())
-    void SetTrackers(size_t nTrackers) { TrackData.resize(nTrackers); }
+    void SetTrackers(size_t nTrackers)
+      {
+        TrackData.resize(nTrackers);
+        for (TrackDataStruct& tracker: TrackData)
+          tracker.VariableLengthHits = VariableLengthHits;
+      }
+
+    /// Resize the data structure for hits (all values set to default)
+    void ResizeHits(size_t nHits);
 
     /// Resize the data structure for MCNeutrino particles
     void ResizeMCNeutrino(int nNeutrinos);
@@ -566,7 +611,7 @@ namespace icarus {
     size_t GetNTrackers() const { return TrackData.size(); }
     
     /// Returns the number of hits for which memory is allocated
-    size_t GetMaxHits() const { return kMaxHits; }
+    size_t GetMaxHits() const { return MaxHits; }
     
     /// Returns the number of trackers for which memory is allocated
     size_t GetMaxTrackers() const { return TrackData.capacity(); }
@@ -577,82 +622,6 @@ namespace icarus {
     /// Returns the number of GENIE primaries for which memory is allocated
     size_t GetMaxGeniePrimaries() const { return MaxGeniePrimaries; }
     
-    
-  private:
-    /// Little helper functor class to create or reset branches in a tree
-    class BranchCreator {
-        public:
-      TTree* pTree; ///< the tree to be worked on
-      BranchCreator(TTree* tree): pTree(tree) {}
-
-      //@{
-      /// Create a branch if it does not exist, and set its address
-      void operator()
-        (std::string name, void* address, std::string leaflist /*, int bufsize = 32000 */)
-        {
-          if (!pTree) return;
-          TBranch* pBranch = pTree->GetBranch(name.c_str());
-          if (!pBranch) {
-            pTree->Branch(name.c_str(), address, leaflist.c_str() /*, bufsize */);
-            MF_LOG_DEBUG("AnalysisTreeStructure")
-              << "Creating branch '" << name << " with leaf '" << leaflist << "'";
-          }
-          else if (pBranch->GetAddress() != address) {
-            pBranch->SetAddress(address);
-            MF_LOG_DEBUG("AnalysisTreeStructure")
-              << "Reassigning address to branch '" << name << "'";
-          }
-          else {
-            MF_LOG_DEBUG("AnalysisTreeStructure")
-              << "Branch '" << name << "' is fine";
-          }
-        } // operator()
-      void operator()
-        (std::string name, void* address, const std::stringstream& leaflist /*, int bufsize = 32000 */)
-        { return this->operator() (name, address, leaflist.str() /*, int bufsize = 32000 */); }
-      template <typename T>
-      void operator()
-        (std::string name, std::vector<T>& data, std::string leaflist /*, int bufsize = 32000 */)
-        { return this->operator() (name, (void*) data.data(), leaflist /*, int bufsize = 32000 */); }
-
-      template <typename T>
-      void operator() (std::string name, std::vector<T>& data)
-        {
-          // overload for a generic object expressed directly by reference
-          // (as opposed to a generic object expressed by a pointer or
-          // to a simple leaf sequence specification);
-          // TTree::Branch(name, T* obj, Int_t bufsize, splitlevel) and
-          // TTree::SetObject() are used.
-          if (!pTree) return;
-          TBranch* pBranch = pTree->GetBranch(name.c_str());
-          if (!pBranch) {
-            pTree->Branch(name.c_str(), &data);
-            // ROOT needs a TClass definition for T in order to create a branch,
-            // se we are sure that at this point the TClass exists
-            MF_LOG_DEBUG("AnalysisTreeStructure")
-              << "Creating object branch '" << name
-              << " with " << TClass::GetClass(typeid(T))->ClassName();
-          }
-          else if
-            (*(reinterpret_cast<std::vector<T>**>(pBranch->GetAddress())) != &data)
-          {
-            // when an object is provided directly, the address of the object
-            // is assigned in TBranchElement::fObject (via TObject::SetObject())
-            // and the address itself is set to the address of the fObject
-            // member. Here we check that the address of the object in fObject
-            // is the same as the address of our current data type
-            pBranch->SetObject(&data);
-            MF_LOG_DEBUG("AnalysisTreeStructure")
-              << "Reassigning object to branch '" << name << "'";
-          }
-          else {
-            MF_LOG_DEBUG("AnalysisTreeStructure")
-              << "Branch '" << name << "' is fine";
-          }
-        } // operator()
-      //@}
-    }; // class BranchCreator
-
   }; // class AnalysisTreeDataStruct
   
   
@@ -663,6 +632,10 @@ namespace icarus {
    * - <b>UseBuffers</b> (default: false): if enabled, memory is allocated for
    *   tree data for all the run; otherwise, it's allocated on each event, used
    *   and freed; use "true" for speed, "false" to save memory
+   * - <b>VariableLengthHits</b> (default: false): if enabled, event and track
+   *   hit information is written in variable length branches sized to the
+   *   actual content of the event, instead of fixed size arrays; the layout of
+   *   the track hit branches changes (see the notes on top of this file)
    * - <b>SaveAuxDetInfo</b> (default: false): if enabled, auxiliary detector
    *   data will be extracted and included in the tree
    */
@@ -707,6 +680,7 @@ namespace icarus {
     std::vector<std::string> fParticleIDModuleLabel;
     std::string fPOTModuleLabel;
     bool fUseBuffer; ///< whether to use a permanent buffer (faster, huge memory)    
+    bool fVariableLengthHits; ///< whether to write hits in variable length branches
     bool fSaveAuxDetInfo; ///< whether to extract and save auxiliary detector data
     bool fSaveCryInfo; ///whether to extract and save CRY particle data
     bool fSaveGenieInfo; ///whether to extract and save Genie information
@@ -728,7 +702,7 @@ namespace icarus {
     void CreateData(bool bClearData = false)
       {
         if (!fData) {
-          fData = new AnalysisTreeDataStruct(GetNTrackers());
+          fData = new AnalysisTreeDataStruct(GetNTrackers(), fVariableLengthHits);
           fData->SetBits(AnalysisTreeDataStruct::tdAuxDet, !fSaveAuxDetInfo);
           fData->SetBits(AnalysisTreeDataStruct::tdCry, !fSaveCryInfo);	  
           fData->SetBits(AnalysisTreeDataStruct::tdGenie, !fSaveGenieInfo);
@@ -880,13 +854,15 @@ void icarus::AnalysisTreeDataStruct::TrackDataStruct::Resize(size_t nTracks)
   trkpitchc.resize(MaxTracks);
   ntrkhits.resize(MaxTracks);
   
-  trkdedx.resize(MaxTracks);
-    trkxp.resize(MaxTracks);
-    trkyp.resize(MaxTracks);
-    trkzp.resize(MaxTracks);
-  trkdqdx.resize(MaxTracks);
-  trkresrg.resize(MaxTracks);
-  trkxyz.resize(MaxTracks);
+  // the fixed size hit pools are not allocated at all in variable length mode
+  const size_t MaxHitTracks = VariableLengthHits? 0: MaxTracks;
+  trkdedx.resize(MaxHitTracks);
+    trkxp.resize(MaxHitTracks);
+    trkyp.resize(MaxHitTracks);
+    trkzp.resize(MaxHitTracks);
+  trkdqdx.resize(MaxHitTracks);
+  trkresrg.resize(MaxHitTracks);
+  trkxyz.resize(MaxHitTracks);
   
 } // icarus::AnalysisTreeDataStruct::TrackDataStruct::Resize()
 
@@ -927,6 +903,15 @@ void icarus::AnalysisTreeDataStruct::TrackDataStruct::Clear() {
   FillWith(trksvtxid    , -1);
   FillWith(trkevtxid    , -1);
   FillWith(trkpidbestplane, -1); 
+  
+  // variable length hit data is just emptied (memory is kept)
+  flatdedx.clear();
+  flatxp.clear();
+  flatyp.clear();
+  flatzp.clear();
+  flatdqdx.clear();
+  flatresrg.clear();
+  flatxyz.clear();
  
   for (size_t iTrk = 0; iTrk < MaxTracks; ++iTrk){
     
@@ -949,14 +934,16 @@ void icarus::AnalysisTreeDataStruct::TrackDataStruct::Clear() {
     FillWith(trkpitchc[iTrk]  , -99999.);
     FillWith(ntrkhits[iTrk]   ,  -9999 );
     
-    FillWith(trkdedx[iTrk], 0.);
-      FillWith(trkxp[iTrk], 0.);
-      FillWith(trkyp[iTrk], 0.);
-      FillWith(trkzp[iTrk], 0.);
-    FillWith(trkdqdx[iTrk], 0.);
-    FillWith(trkresrg[iTrk], 0.);
-    
-    FillWith(trkxyz[iTrk], 0.);
+    if (!VariableLengthHits) {
+      FillWith(trkdedx[iTrk], 0.);
+        FillWith(trkxp[iTrk], 0.);
+        FillWith(trkyp[iTrk], 0.);
+        FillWith(trkzp[iTrk], 0.);
+      FillWith(trkdqdx[iTrk], 0.);
+      FillWith(trkresrg[iTrk], 0.);
+      
+      FillWith(trkxyz[iTrk], 0.);
+    }
  
     FillWith(trkpidpdg[iTrk]    , -1);
     FillWith(trkpidchi[iTrk]    , -99999.);
@@ -975,7 +962,7 @@ void icarus::AnalysisTreeDataStruct::TrackDataStruct::SetAddresses(
 ) {
   if (MaxTracks == 0) return; // no tracks, no tree!
   
-  icarus::AnalysisTreeDataStruct::BranchCreator CreateBranch(pTree);
+  icarus::BranchCreator CreateBranch(pTree);
 
   AutoResettingStringSteam sstr;
   sstr() << kMaxTrackHits;
@@ -1057,7 +1044,16 @@ void icarus::AnalysisTreeDataStruct::TrackDataStruct::SetAddresses(
   BranchName = "ntrkhits_" + TrackLabel;
   CreateBranch(BranchName, ntrkhits, BranchName + NTracksIndexStr + "[3]/S");
   
-  if (!isCosmics){
+  if (!isCosmics && VariableLengthHits){
+    CreateBranch("trkdedx_" + TrackLabel, flatdedx);
+    CreateBranch("trkxp_" + TrackLabel, flatxp);
+    CreateBranch("trkyp_" + TrackLabel, flatyp);
+    CreateBranch("trkzp_" + TrackLabel, flatzp);
+    CreateBranch("trkdqdx_" + TrackLabel, flatdqdx);
+    CreateBranch("trkresrg_" + TrackLabel, flatresrg);
+    CreateBranch("trkxyz_" + TrackLabel, flatxyz);
+  }
+  else if (!isCosmics){
     BranchName = "trkdedx_" + TrackLabel;
     CreateBranch(BranchName, trkdedx, BranchName + NTracksIndexStr + "[3]" + MaxTrackHitsIndexStr + "/F");
   
@@ -1181,6 +1177,28 @@ void icarus::AnalysisTreeDataStruct::TrackDataStruct::SetAddresses(
 
 } // icarus::AnalysisTreeDataStruct::TrackDataStruct::SetAddresses()
 
+
+void icarus::AnalysisTreeDataStruct::TrackDataStruct::AppendHits
+  (const anab::Calorimetry& calo)
+{
+  const std::vector<float>& dEdx = calo.dEdx();
+  const std::vector<float>& dQdx = calo.dQdx();
+  const std::vector<float>& resRange = calo.ResidualRange();
+  const auto& XYZ = calo.XYZ();
+  
+  flatdedx.insert(flatdedx.end(), dEdx.begin(), dEdx.end());
+  flatdqdx.insert(flatdqdx.end(), dQdx.begin(), dQdx.end());
+  flatresrg.insert(flatresrg.end(), resRange.begin(), resRange.end());
+  for (const auto& TrkPos: XYZ) {
+    flatxp.push_back(TrkPos.X());
+    flatyp.push_back(TrkPos.Y());
+    flatzp.push_back(TrkPos.Z());
+    flatxyz.push_back(TrkPos.X());
+    flatxyz.push_back(TrkPos.Y());
+    flatxyz.push_back(TrkPos.Z());
+  } // for track hits
+} // icarus::AnalysisTreeDataStruct::TrackDataStruct::AppendHits()
+
 //------------------------------------------------------------------------------
 //---  AnalysisTreeDataStruct
 //---
@@ -1200,18 +1218,8 @@ void icarus::AnalysisTreeDataStruct::ClearLocalData() {
 
   no_hits = 0;
  
-  std::fill(hit_tpc, hit_tpc + sizeof(hit_tpc)/sizeof(hit_tpc[0]), -9999);
-  std::fill(hit_plane, hit_plane + sizeof(hit_plane)/sizeof(hit_plane[0]), -9999);
-  std::fill(hit_wire, hit_wire + sizeof(hit_wire)/sizeof(hit_wire[0]), -9999);
-  std::fill(hit_channel, hit_channel + sizeof(hit_channel)/sizeof(hit_channel[0]), -9999);
-  std::fill(hit_peakT, hit_peakT + sizeof(hit_peakT)/sizeof(hit_peakT[0]), -99999.);
-  std::fill(hit_charge, hit_charge + sizeof(hit_charge)/sizeof(hit_charge[0]), -99999.);
-  std::fill(hit_ph, hit_ph + sizeof(hit_ph)/sizeof(hit_ph[0]), -99999.);
-  std::fill(hit_startT, hit_startT + sizeof(hit_startT)/sizeof(hit_startT[0]), -99999.);
-  std::fill(hit_endT, hit_endT + sizeof(hit_endT)/sizeof(hit_endT[0]), -99999.);
-  std::fill(hit_trkid, hit_trkid + sizeof(hit_trkid)/sizeof(hit_trkid[0]), -9999);
-  std::fill(hit_nelec, hit_nelec + sizeof(hit_nelec)/sizeof(hit_nelec[0]), -99999.);
-  std::fill(hit_energy, hit_energy + sizeof(hit_energy)/sizeof(hit_energy[0]), -99999.);
+  // in variable length mode hits are sized on each event by ResizeHits()
+  ResizeHits(VariableLengthHits? 0: kMaxHits);
 
   nvtx = 0;
   for (size_t ivtx = 0; ivtx < kMaxVertices; ++ivtx) {
@@ -1338,6 +1346,25 @@ void icarus::AnalysisTreeDataStruct::Clear() {
     (TrackData.begin(), TrackData.end(), std::mem_fn(&TrackDataStruct::Clear));
 } // icarus::AnalysisTreeDataStruct::Clear()
 
+void icarus::AnalysisTreeDataStruct::ResizeHits(size_t nHits){
+
+  MaxHits = nHits;
+  // assign() does not reallocate when the size is not increasing
+  hit_tpc.assign(MaxHits, -9999);
+  hit_plane.assign(MaxHits, -9999);
+  hit_wire.assign(MaxHits, -9999);
+  hit_channel.assign(MaxHits, -9999);
+  hit_peakT.assign(MaxHits, -99999.);
+  hit_charge.assign(MaxHits, -99999.);
+  hit_ph.assign(MaxHits, -99999.);
+  hit_startT.assign(MaxHits, -99999.);
+  hit_endT.assign(MaxHits, -99999.);
+  hit_trkid.assign(MaxHits, -9999);
+  hit_nelec.assign(MaxHits, -99999.);
+  hit_energy.assign(MaxHits, -99999.);
+
+} // icarus::AnalysisTreeDataStruct::ResizeHits()
+
 void icarus::AnalysisTreeDataStruct::ResizeMCNeutrino(int nNeutrinos){
 
   //min size is 1, to guarantee an address
@@ -1483,7 +1510,22 @@ void icarus::AnalysisTreeDataStruct::SetAddresses(
   CreateBranch("isdata",&isdata,"isdata/B");
   //CreateBranch("taulife",&taulife,"taulife/D");
 
-  if (hasHitInfo()){
+  if (hasHitInfo() && VariableLengthHits){
+    CreateBranch("no_hits",&no_hits,"no_hits/I");
+    CreateBranch("hit_tpc",hit_tpc);
+    CreateBranch("hit_plane",hit_plane);
+    CreateBranch("hit_wire",hit_wire);
+    CreateBranch("hit_channel",hit_channel);
+    CreateBranch("hit_peakT",hit_peakT);
+    CreateBranch("hit_charge",hit_charge);
+    CreateBranch("hit_ph",hit_ph);
+    CreateBranch("hit_startT",hit_startT);
+    CreateBranch("hit_endT",hit_endT);
+    CreateBranch("hit_trkid",hit_trkid);
+    CreateBranch("hit_nelec",hit_nelec);
+    CreateBranch("hit_energy",hit_energy);
+  }
+  else if (hasHitInfo()){
     CreateBranch("no_hits",&no_hits,"no_hits/I");
     CreateBranch("hit_tpc",hit_tpc,"hit_tpc[no_hits]/S");
     CreateBranch("hit_plane",hit_plane,"hit_plane[no_hits]/S");
@@ -1673,6 +1715,7 @@ icarus::AnalysisTree::AnalysisTree(fhicl::ParameterSet const& pset) :
   fParticleIDModuleLabel    (pset.get< std::vector<std::string> >("ParticleIDModuleLabel")   ),
   fPOTModuleLabel           (pset.get< std::string >("POTModuleLabel")          ),
   fUseBuffer                (pset.get< bool >("UseBuffers", false)),
+  fVariableLengthHits       (pset.get< bool >("VariableLengthHits", false)),
   fSaveAuxDetInfo           (pset.get< bool >("SaveAuxDetInfo", false)),
   fSaveCryInfo              (pset.get< bool >("SaveCryInfo", false)),  
   fSaveGenieInfo	    (pset.get< bool >("SaveGenieInfo", false)), 
@@ -1689,6 +1732,7 @@ icarus::AnalysisTree::AnalysisTree(fhicl::ParameterSet const& pset) :
   if (fSaveAuxDetInfo == true) fSaveGeantInfo = true;
   mf::LogInfo("AnalysisTree") << "Configuration:"
     << "\n  UseBuffers: " << std::boolalpha << fUseBuffer
+    << "\n  VariableLengthHits: " << std::boolalpha << fVariableLengthHits
     ;
   if (GetNTrackers() > kMaxTrackers) {
     throw art::Exception(art::errors::Configuration)
@@ -1917,13 +1961,14 @@ void icarus::AnalysisTree::analyze(const art::Event& evt)
   //hit information
   if (fSaveHitInfo){
     fData->no_hits = (int) NHits;
-    if (NHits > kMaxHits) {
+    if (fVariableLengthHits) fData->ResizeHits(NHits);
+    if (NHits > fData->GetMaxHits()) {
       // got this error? consider increasing kMaxHits
       // (or ask for a redesign using vectors)
       mf::LogError("AnalysisTree:limits") << "event has " << NHits
         << " hits, only kMaxHits=" << kMaxHits << " stored in tree";
     }
-    for (size_t i = 0; i < NHits && i < kMaxHits ; ++i){//loop over hits
+    for (size_t i = 0; i < NHits && i < fData->GetMaxHits() ; ++i){//loop over hits
       fData->hit_channel[i] = hitlist[i]->Channel();
       fData->hit_tpc[i]     = hitlist[i]->WireID().TPC;
       fData->hit_plane[i]   = hitlist[i]->WireID().Plane;
@@ -1967,7 +2012,7 @@ void icarus::AnalysisTree::analyze(const art::Event& evt)
     if (evt.getByLabel(fHitsModuleLabel,hitListHandle)){
       //Find tracks associated with hits
       art::FindManyP<recob::Track> fmtk(hitListHandle,evt,fTrackModuleLabel[0]);
-      for (size_t i = 0; i < NHits && i < kMaxHits ; ++i){//loop over hits
+      for (size_t i = 0; i < NHits && i < fData->GetMaxHits() ; ++i){//loop over hits
         if (fmtk.isValid()){
 	  if (fmtk.at(i).size()!=0){
 	    fData->hit_trkid[i] = fmtk.at(i)[0]->ID();
@@ -2186,6 +2231,7 @@ void icarus::AnalysisTree::analyze(const art::Event& evt)
             << " has " << calos.size() << " planes for calorimetry , only "
             << TrackerData.GetMaxPlanesPerTrack(iTrk) << " stored in tree";
         }
+        const anab::Calorimetry* planeCalos[kNplanes] = { nullptr };
         for (size_t ical = 0; ical<calos.size(); ++ical){
 	  if (!calos[ical]) continue;
 	  if (!calos[ical]->PlaneID().isValid) continue;
@@ -2205,7 +2251,8 @@ void icarus::AnalysisTree::analyze(const art::Event& evt)
               <<", only "
               << TrackerData.GetMaxHitsPerTrack(iTrk, planenum) << " stored in tree";
           }
-	  if (!isCosmics){
+	  planeCalos[planenum] = calos[ical];
+	  if (!isCosmics && !TrackerData.VariableLengthHits){
 	    for(size_t iTrkHit = 0; iTrkHit < NHits && iTrkHit < TrackerData.GetMaxHitsPerTrack(iTrk, planenum); ++iTrkHit) {
 	      TrackerData.trkdedx[iTrk][planenum][iTrkHit]  = (calos[ical] -> dEdx())[iTrkHit];
 	      TrackerData.trkdqdx[iTrk][planenum][iTrkHit]  = (calos[ical] -> dQdx())[iTrkHit];
@@ -2221,6 +2268,11 @@ void icarus::AnalysisTree::analyze(const art::Event& evt)
 	    } // for track hits
 	  }
 	} // for calorimetry info
+        // variable length mode: hits are appended in plane order
+        if (!isCosmics && TrackerData.VariableLengthHits){
+          for (const anab::Calorimetry* calo: planeCalos)
+            if (calo) TrackerData.AppendHits(*calo);
+        }
         if(TrackerData.ntrkhits[iTrk][0] > TrackerData.ntrkhits[iTrk][1] && TrackerData.ntrkhits[iTrk][0] > TrackerData.ntrkhits[iTrk][2]) TrackerData.trkpidbestplane[iTrk] = 0;
         else if(TrackerData.ntrkhits[iTrk][1] > TrackerData.ntrkhits[iTrk][0] && TrackerData.ntrkhits[iTrk][1] > TrackerData.ntrkhits[iTrk][2]) TrackerData.trkpidbestplane[iTrk] = 1;
         else if(TrackerData.ntrkhits[iTrk][2] > TrackerData.ntrkhits[iTrk][0] && TrackerData.ntrkhits[iTrk][2] > TrackerData.ntrkhits[iTrk][1]) TrackerData.trkpidbestplane[iTrk] = 2;
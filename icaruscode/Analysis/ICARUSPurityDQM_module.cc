@@ -17,6 +17,8 @@
 #include <string>
 #include <array>
 #include <fstream>
+#include <algorithm>
+#include <functional>
 
 //Framework includes
 #include "art/Framework/Core/ModuleMacros.h" 
@@ -54,13 +56,13 @@
 //purity info class
 #include "sbnobj/Common/Analysis/TPCPurityInfo.hh"
 
+#include "icaruscode/Analysis/Algorithms/PurityFitKernels.h"
+
 #include "art/Framework/Core/EDProducer.h"
 #include <TMath.h>
 #include <TH1F.h>
 #include "TH2D.h"
 #include "TProfile2D.h"
-#include <TGraph.h>
-#include <TGraphErrors.h>
 #include <TGraphAsymmErrors.h>
 #include "TF1.h"
 #include "TCanvas.h"
@@ -87,8 +89,6 @@ namespace icarus {
     void produce(art::Event& evt);
     void beginJob();
     void endJob();
-    int Nothere(std::vector<int>* a, int b);
-    int Notheref(std::vector<float>* a, float b);
     Double_t FoundMeanLog(std::vector<float>* a,float b);
 
   private:
@@ -201,56 +201,18 @@ namespace icarus{
   }
   
   
-  int ICARUSPurityDQM::Nothere(std::vector<int>* a, int b){
-    int Cisono=3;
-    for(int i=0; i<(int)a->size();i++)
-      {
-	if((*a)[i]==b)
-	  {
-	    Cisono=8;
-	  }
-      }
-    return Cisono;//se "ci sono" vale 8 allora l'intero b e' contenuto nel vettore a mentre se "ci sono" vale 3 a non contiene b.
-  }
-  
-  
-  int ICARUSPurityDQM::Notheref(std::vector<float>* a, float b){
-    int Cisono=3;
-    for(int i=0; i<(int)a->size();i++)
-      {
-	if((*a)[i]==b)
-	  {
-	    Cisono=8;
-	  }
-      }
-        
-    return Cisono;//se "ci sono" vale 8 allora l'intero b e' contenuto nel vettore a mentre se "ci sono" vale 3 a non contiene b.
-  }
-    
   Double_t ICARUSPurityDQM::FoundMeanLog(std::vector<float>* a,float b){
-        
+
     int punto_taglio=a->size()*(1-b)+0.5;
-    /////std::cout << punto_taglio << " e " << a->size() << std::endl;
-    //if(punto_taglio==0)punto_taglio=1;
-    std::vector<float>* usedhere=new std::vector<float>;
-    for(int jj=0;jj<punto_taglio+1;jj++)
-      {
-	//cout << jj << endl;
-	float maximum=0;
-	for(int j=0;j<(int)a->size();j++)
-	  {
-	    if((*a)[j]>maximum && Notheref(usedhere,(*a)[j])==3)
-	      {
-		maximum=(*a)[j];
-	      }
-	  }
-	//cout << maximum << endl;
-	usedhere->push_back(maximum);
-      }
-    //cout << (*usedhere)[punto_taglio] << endl;
-    return (*usedhere)[punto_taglio-1];
+    // the punto_taglio-th largest distinct positive value, 0 if there are not enough of them
+    std::vector<float> usedhere(*a);
+    std::sort(usedhere.begin(),usedhere.end(),std::greater<float>());
+    usedhere.erase(std::unique(usedhere.begin(),usedhere.end()),usedhere.end());
+    int quale=std::max(punto_taglio,1)-1;
+    if(quale>=(int)usedhere.size() || !(usedhere[quale]>0)) return 0;
+    return usedhere[quale];
   }
-      
+
   void ICARUSPurityDQM::produce(art::Event& evt)
   {
     
@@ -355,7 +317,6 @@ namespace icarus{
 	    //    if (plane==0) {
 	    if ((int)plane==fplanefcl && cryostat==fcryofcl){
 
-              TH1F *h111 = new TH1F("h111","delta aree",20000,0,0);
               for (unsigned int ijk=0; ijk<(fDataSize); ijk++)
                 {
 		  //h111->Fill(rawDigit->ADC(ijk)-pedestal2);
@@ -385,6 +346,10 @@ namespace icarus{
 	      h_basebase->Fill(basebase);
 	      //h_basediff2->Fill(base_massimo_before,base_massimo_after);
               float areaarea=0;
+              // RMS of the baseline samples (same as a histogram GetRMS())
+              double somma_base=0;
+              double somma2_base=0;
+              int quanti_base=0;
 	      /*
 		for (unsigned int ijk=quale_sample_massimo-50; ijk<quale_sample_massimo+50; ijk++)
 		{
@@ -398,12 +363,18 @@ namespace icarus{
 		    areaarea+=(rawDigit->ADC(ijk)-pedestal2);
                   }
                   else{
-		    h111->Fill(rawDigit->ADC(ijk)-pedestal2-basebase);
+		    double delta=rawDigit->ADC(ijk)-pedestal2-basebase;
+		    somma_base+=delta;
+		    somma2_base+=delta*delta;
+		    quanti_base+=1;
                   }
                   
 		}
-              sigma_pedestal=h111->GetRMS();
-              h111->Delete();
+              if(quanti_base>0){
+                double media_base=somma_base/quanti_base;
+                sigma_pedestal=sqrt(fabs(somma2_base/quanti_base-media_base*media_base));
+              }
+              else sigma_pedestal=0;
               //std::cout << "MASSIMO BASE " << massimo << " " << base_massimo_before << " " << base_massimo_after << std::endl;
               //h_basediff->Fill(fabs(base_massimo_after-base_massimo_before));
               //h_basediff2->Fill(fabs(base_massimo_after-base_massimo_before),sigma_pedestal);
@@ -749,53 +720,49 @@ namespace icarus{
 		if(whc->size()>30)//prima 0
 		  {
 		    float pendenza=0;float intercetta=0;int found_ok=0;
-		    std::vector<int> *escluse=new std::vector<int>;
+		    // straight line fit of the cluster hits, removing one by one the ones
+		    // farther than 3 from the line; the sums of the fit are updated in place
+		    std::vector<double> wires(whc->size());
+		    std::vector<double> samples(whc->size());
+		    std::vector<bool> esclusa(whc->size(),false);
+		    int escluse=0;
+		    icarus::purity::LinearRegression retta;
+		    for(int k=0;k<(int)whc->size();k++)
+		      {
+			wires[k]=(*whc)[k]*3;
+			samples[k]=(*shc)[k]*0.628;
+			retta.add(wires[k],samples[k]);
+		      }
 		    for(int j=0;j<(int)whc->size();j++)
 		      {
 			if(found_ok<1)
 			  {
-			    Double_t wires[10000];
-			    Double_t samples[10000];
-			    Double_t ex[10000];
-			    Double_t quale[10000];
-			    Double_t ey[10000];
-			    int quanti=0;
-			    for(int k=0;k<(int)whc->size();k++)
-			      {
-				if(Nothere(escluse,k)==3)
-				  {
-				    wires[quanti]=(*whc)[k]*3;
-				    samples[quanti]=(*shc)[k]*0.628;
-				    ex[quanti]=0;
-				    ey[quanti]=0;
-				    quale[quanti]=k;
-				    quanti+=1;
-				  }
-			      }
-			    //////std::cout << quanti << std::endl;
-			    TGraphErrors *gr3 = new TGraphErrors(quanti,wires,samples,ex,ey);
-			    gr3->Fit("pol1");
-			    TF1 *fitfunc = gr3->GetFunction("pol1");
-			    pendenza=fitfunc->GetParameter(1);
-			    intercetta=fitfunc->GetParameter(0);
+			    icarus::purity::LinearFitResult fitfunc=retta.fit();
+			    pendenza=fitfunc.slope;
+			    intercetta=fitfunc.intercept;
 			    float distance_maximal=3;
 			    int quella_a_distance_maximal=0;
 			    int found_max=0;
-			    for(int jj=0;jj<quanti;jj++)
+			    for(int jj=0;jj<(int)whc->size();jj++)
 			      {
+				if(esclusa[jj]) continue;
 				if((abs((pendenza)*(wires[jj])-samples[jj]+intercetta)/sqrt((pendenza)*pendenza+1))>distance_maximal)
 				  {
 				    found_max=1;
-				    quella_a_distance_maximal=quale[jj];
+				    quella_a_distance_maximal=jj;
 				    distance_maximal=(abs(pendenza*wires[jj]-samples[jj]+intercetta)/sqrt(pendenza*pendenza+1));
 				  }
 			      }
-			    if(found_max==1)escluse->push_back(quella_a_distance_maximal);
+			    if(found_max==1)
+			      {
+				esclusa[quella_a_distance_maximal]=true;
+				retta.remove(wires[quella_a_distance_maximal],samples[quella_a_distance_maximal]);
+				escluse+=1;
+			      }
 			    if(found_max==0)found_ok=1;
 			  }
 		      }
-		    std::cout << escluse->size() << " escluse " << whc->size() << " " << found_ok << std::endl;
-		    delete escluse;
+		    std::cout << escluse << " escluse " << whc->size() << " " << found_ok << std::endl;
 		    std::vector<float> *hittime=new std::vector<float>;
 		    std::vector<float> *hitwire=new std::vector<float>;
 		    std::vector<float> *hitarea=new std::vector<float>;
@@ -821,16 +788,6 @@ namespace icarus{
 				  }
 			      }
 			  }
-			//float result_rms=0.14;
-			//std::cout << result_rms << endl;
-			Double_t area[10000];
-			Double_t nologarea[10000];
-			Double_t tempo[10000];
-			Double_t ex[10000];
-			//Double_t quale[10000];
-			Double_t ey[10000];
-			Double_t ek[10000];
-			Double_t ez[10000];
 			std::cout <<  hitarea->size() << " dimensione hitarea" << std::endl;
 
 			std::cout<<""<<std::endl;
@@ -858,30 +815,33 @@ namespace icarus{
 			    //std::cout << starting_value_tau << " VALORE INDICATIVO TAU " << std::endl;
 			    //if(tpc_number==2 || tpc_number==5)starting_value_tau=6500;
 			    //if(tpc_number==10 || tpc_number==13)starting_value_tau=5700;
+			    // hit areas corrected with the indicative lifetime, computed once
+			    std::vector<double> hitareacorr(hitarea->size());
+			    for(int kk=0;kk<(int)hitarea->size();kk++)
+			      hitareacorr[kk]=(*hitarea)[kk]*exp((*hittime)[kk]/starting_value_tau);
 			    for(int stp=0;stp<=gruppi;stp++)
 			      {
-				std::vector<float>* hitpertaglio=new std::vector<float>;
+				std::vector<float> hitpertaglio;
 				//std::cout << 500+stp*steptime << " time " << 500+(stp+1)*(steptime) << std::endl;
 				/////////std::cout << minimo+stp*steptime << " " << minimo+(stp+1)*(steptime) << std::endl;
 				for(int kk=0;kk<(int)hitarea->size();kk++)
 				  {
 				    if((*hittime)[kk]>=(minimo+stp*steptime) && (*hittime)[kk]<=(minimo+(stp+1)*(steptime))) 
-				      hitpertaglio->push_back((*hitarea)[kk]*exp((*hittime)[kk]/starting_value_tau));
+				      hitpertaglio.push_back(hitareacorr[kk]);
 				  }
 				/////////std::cout << hitpertaglio->size() << std::endl;
-				float tagliomax=FoundMeanLog(hitpertaglio,0.90);//0.9com//0.8test1
-				float tagliomin=FoundMeanLog(hitpertaglio,0.05);//0.1com//0.05test1
+				float tagliomax=FoundMeanLog(&hitpertaglio,0.90);//0.9com//0.8test1
+				float tagliomin=FoundMeanLog(&hitpertaglio,0.05);//0.1com//0.05test1
 				//float tagliomin=0;
 				//float tagliomax=1000000;
-				delete hitpertaglio;
 				//std::cout << tagliomax << " t " << std::endl;
 				for(int kk=0;kk<(int)hitarea->size();kk++)
 				  {
 				    //std::cout << (*hittime)[kk] << " " << (*hitwire)[kk] << " " << (*hitarea)[kk] << " " << (minimo+stp*steptime) << " " << (minimo+(stp+1)*steptime) << " " << (*hitarea)[kk]*exp((*hittime)[kk]/starting_value_tau) << std::endl;
 				    if((*hittime)[kk]>(minimo+stp*steptime) && 
 				       (*hittime)[kk]<(minimo+(stp+1)*steptime) &&
-				       (*hitarea)[kk]*exp((*hittime)[kk]/starting_value_tau)<tagliomax && 
-				       (*hitarea)[kk]*exp((*hittime)[kk]/starting_value_tau)>tagliomin)
+				       hitareacorr[kk]<tagliomax &&
+				       hitareacorr[kk]>tagliomin)
 				      {
 					//std::cout << ((*hitarea)[kk]*exp((*hittime)[kk]/1400)) << " GOOD " << (*hitarea)[kk] << " " << (*hittime)[kk] << std::endl;
 					hitareagood->push_back((*hitarea)[kk]);
@@ -890,77 +850,68 @@ namespace icarus{
 				      }
 				  }
 			      }
-			    //std::cout << hitareagood->size() << " hitareagood" << std::endl;    
+			    //std::cout << hitareagood->size() << " hitareagood" << std::endl;
+			    std::vector<double> area;
+			    std::vector<double> nologarea;
+			    std::vector<double> tempo;
 			    for(int k=0;k<(int)hitareagood->size();k++)
 			      {
 				//if((*hittimegood)[k]-600*0.4<=1000)//correzione 15/08
 				if((*hittimegood)[k]<=2240)
 				  {
-				    tempo[k]=(*hittimegood)[k];
-				    area[k]=log((*hitareagood)[k]);
-				    //std::cout << (*hitareagood)[k] << " " << area[k] << std::endl;
-				    nologarea[k]=((*hitareagood)[k]);
-				    ex[k]=0;
-				    ez[k]=60;
-				    ey[k]=0.23;
+				    tempo.push_back((*hittimegood)[k]);
+				    area.push_back(log((*hitareagood)[k]));
+				    nologarea.push_back((*hitareagood)[k]);
 				  }
 			      }
 			    std::cout<<""<<std::endl;
 			    std::cout<<"HERE line 872"<<std::endl;
 			    std::cout<<""<<std::endl;
-			    TGraphErrors *gr31 = new TGraphErrors(hitareagood->size(),tempo,area,ex,ey);
-			    //TGraphErrors *gr4 = new TGraphErrors(hitareagood->size(),tempo,nologarea,ex,ey);
-			    gr31->Fit("pol1");
-			    TF1 *fit = gr31->GetFunction("pol1");
-			    float slope_purity=fit->GetParameter(1);
-			    //float error_slope_purity=fit->GetParError(1);
-			    float intercetta_purezza=fit->GetParameter(0);
-			    
+			    icarus::purity::LinearFitResult fit=icarus::purity::linearFit(tempo.data(),area.data(),tempo.size());
+			    float slope_purity=fit.slope;
+			    float intercetta_purezza=fit.intercept;
+
 			    TH1F *h111 = new TH1F("h111","delta aree",200,-10,10);
 			    float sum_per_rms_test=0;
-			    for(int k=0;k<(int)hitareagood->size();k++)
+			    for(int k=0;k<(int)tempo.size();k++)
 			      {
 				h111->Fill(area[k]-slope_purity*tempo[k]-intercetta_purezza);
 				sum_per_rms_test+=(area[k]-slope_purity*tempo[k]-intercetta_purezza)*(area[k]-slope_purity*tempo[k]-intercetta_purezza);
 			      }
-                       
+
                         h111->Fit("gaus");
                         TF1 *fitg = h111->GetFunction("gaus");
                         float error=fitg->GetParameter(2);
                         std::cout << " error " << error << std::endl;
-                        float error_2=sqrt(sum_per_rms_test/(hitareagood->size()-2));
+                        float error_2=sqrt(sum_per_rms_test/(tempo.size()-2));
                         std::cout << " error vero" << error_2 << std::endl;
                         h111->Delete();
-                        for(int k=0;k<(int)hitareagood->size();k++)
-                          {
-                            if((*hittimegood)[k]<=2240)
-                              {
-                                ek[k]=-nologarea[k]+exp(area[k]+error);
-                                ez[k]=nologarea[k]-exp(area[k]-error);
-                                ey[k]=error;
-                              }
-                          }
 			std::cout<<""<<std::endl;
 			std::cout<<"HERE line 906"<<std::endl;
 			std::cout<<""<<std::endl;
 
-                        TGraphErrors *gr32 = new TGraphErrors(hitareagood->size(),tempo,area,ex,ey);
-                        gr32->Fit("pol1");
-                  
-                        TF1 *fit2 = gr32->GetFunction("pol1");
-                        float slope_purity_2=fit2->GetParameter(1);
-                        float error_slope_purity_2=fit2->GetParError(1);
-                        //float intercetta_purezza_2=fit2->GetParameter(0);
-                        float chiquadro=fit2->GetChisquare()/(hitareagood->size()-2);
+                        icarus::purity::LinearFitResult fit2=icarus::purity::linearFit(tempo.data(),area.data(),tempo.size(),error);
+                        float slope_purity_2=fit2.slope;
+                        float error_slope_purity_2=fit2.slopeError;
+                        float chiquadro=fit2.chi2/(tempo.size()-2);
 			std::ofstream goodpuro("purity_results.out",std::ios::app);
                         std::ofstream goodpuro2("purity_results2.out",std::ios::app);
 			
                         //std::cout << -1/slope_purity_2 << std::endl;
                         //std::cout << -1/(slope_purity_2+error_slope_purity_2)+1/slope_purity_2 << std::endl;
                         //std::cout << 1/slope_purity_2-1/(slope_purity_2-error_slope_purity_2) << std::endl;
-                        TGraphAsymmErrors *gr41 = new TGraphAsymmErrors (hitareagood->size(),tempo,nologarea,ex,ex,ez,ek);
-                        gr41->Fit("expo");
-                        TF1 *fitexo = gr41->GetFunction("expo");
+                        // the asymmetric errors of the areas are +/- error on their logarithm
+                        std::vector<double> ex(tempo.size(),0);
+                        std::vector<double> ek(tempo.size());
+                        std::vector<double> ez(tempo.size());
+                        for(int k=0;k<(int)tempo.size();k++)
+                          {
+                            ek[k]=-nologarea[k]+exp(area[k]+error);
+                            ez[k]=nologarea[k]-exp(area[k]-error);
+                          }
+                        TGraphAsymmErrors gr41(tempo.size(),tempo.data(),nologarea.data(),ex.data(),ex.data(),ez.data(),ek.data());
+                        gr41.Fit("expo");
+                        TF1 *fitexo = gr41.GetFunction("expo");
                         float slope_purity_exo=fitexo->GetParameter(1);
                         float error_slope_purity_exo=fitexo->GetParError(1);
                         //fRunSubPurity2->Fill(evt.run(),evt.subRun(),-slope_purity_exo*1000.);
@@ -968,7 +919,7 @@ namespace icarus{
                         //std::cout << -1/slope_purity_exo << std::endl;
                         //std::cout << -1/(slope_purity_exo+error_slope_purity_exo)+1/slope_purity_exo << std::endl;
                         //std::cout << 1/slope_purity_exo-1/(slope_purity_exo-error_slope_purity_exo) << std::endl;
-                        //std::cout << fitexo->GetChisquare()/(hitareagood->size()-2) << std::endl;
+                        //std::cout << fitexo->GetChisquare()/(tempo.size()-2) << std::endl;
 			
 			
                         if((fabs(error_slope_purity_2/slope_purity_2)<5) && fabs(error_slope_purity_exo/slope_purity_exo)<5)
@@ -976,7 +927,7 @@ namespace icarus{
 			    if(fabs(slope_purity_2)<0.01)purityvalues->Fill(-slope_purity_2*1000.);
                             if(fabs(slope_purity_2)<0.01)goodpuro << evt.run() << " " << evt.subRun() << "  " << evt.event() << "  " << tpc_number << "  " << slope_purity_2 << "  " << error_slope_purity_2 << " " << chiquadro << " " << clusters_dw[icl] << " " << clusters_ds[icl] << std::endl;
 			    
-			    if(fabs(slope_purity_exo)<0.01)goodpuro2 << evt.run() << " " << evt.subRun() << " " << evt.event() << " " << tpc_number << " " << slope_purity_exo << " " << error_slope_purity_exo << " " << fitexo->GetChisquare()/(hitareagood->size()-2) << " " << clusters_dw[icl] << " " << clusters_ds[icl] << std::endl;
+			    if(fabs(slope_purity_exo)<0.01)goodpuro2 << evt.run() << " " << evt.subRun() << " " << evt.event() << " " << tpc_number << " " << slope_purity_exo << " " << error_slope_purity_exo << " " << fitexo->GetChisquare()/(tempo.size()-2) << " " << clusters_dw[icl] << " " << clusters_ds[icl] << std::endl;
 			    if(fabs(slope_purity_exo)<0.01)purityvalues2->Fill(-slope_purity_exo*1000.);
 			    if(fabs(slope_purity_exo)<0.01 && tpc_number==0)puritytpc0->Fill(-slope_purity_exo*1000.);
 			    if(fabs(slope_purity_exo)<0.01 && tpc_number==1)puritytpc1->Fill(-slope_purity_exo*1000.);
@@ -8,12 +8,15 @@
 #include "artdaq-core/Data/ContainerFragment.hh"
 #include "sbndaq-artdaq-core/Overlays/FragmentType.hh"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include <iostream>
 #include <bitset>
 
 #include "BernCRTTranslator.hh"
 
-icarus::crt::BernCRTTranslator icarus::crt::BernCRTTranslator::analyze_BernCRTZMQFragment(artdaq::Fragment & frag) {
+icarus::crt::BernCRTTranslator icarus::crt::BernCRTTranslator::analyze_BernCRTZMQFragment(artdaq::Fragment const & frag) {
   icarus::crt::BernCRTTranslator out;
 
   const sbndaq::BernCRTZMQFragment bern_fragment(frag);
@@ -55,7 +58,7 @@ icarus::crt::BernCRTTranslator icarus::crt::BernCRTTranslator::analyze_BernCRTZM
   return out;
 }
 
-icarus::crt::BernCRTTranslator icarus::crt::BernCRTTranslator::analyze_BernCRTFragment(artdaq::Fragment & frag) {
+icarus::crt::BernCRTTranslator icarus::crt::BernCRTTranslator::analyze_BernCRTFragment(artdaq::Fragment const & frag) {
   icarus::crt::BernCRTTranslator out;
 
   const sbndaq::BernCRTFragment bern_fragment(frag);
@@ -97,113 +100,154 @@ icarus::crt::BernCRTTranslator icarus::crt::BernCRTTranslator::analyze_BernCRTFr
   return out;
 }
 
-std::vector<icarus::crt::BernCRTTranslator> icarus::crt::BernCRTTranslator::analyze_BernCRTFragmentV2(artdaq::Fragment & frag) {
+icarus::crt::BernCRTTranslator* icarus::crt::BernCRTTranslator::analyze_BernCRTFragmentV2(artdaq::Fragment const & frag, icarus::crt::BernCRTTranslator* out) {
   
   const sbndaq::BernCRTFragmentV2 bern_fragment(frag);
   const sbndaq::BernCRTFragmentMetadataV2* md = bern_fragment.metadata();
 //  TLOG(TLVL_INFO)<<*bern_fragment;
 
   const unsigned int nhits      = md->hits_in_fragment();
-  std::vector<icarus::crt::BernCRTTranslator> OUT;
-  OUT.reserve(nhits);
-
-  for(unsigned int iHit = 0; iHit < nhits; iHit++) {
-    icarus::crt::BernCRTTranslator out;
 
+  for(unsigned int iHit = 0; iHit < nhits; iHit++, out++) {
     const sbndaq::BernCRTHitV2* bevt = bern_fragment.eventdata(iHit);
 
-    out.flags                     = bevt->flags;
-    out.lostcpu                   = bevt->lostcpu;
-    out.lostfpga                  = bevt->lostfpga;
-    out.ts0                       = bevt->ts0;
-    out.ts1                       = bevt->ts1;
-    out.coinc                     = bevt->coinc;
-    out.feb_hit_number            = bevt->feb_hit_number;
-    out.timestamp                 = bevt->timestamp;
-    out.last_accepted_timestamp   = bevt->last_accepted_timestamp;
-    out.lost_hits                 = bevt->lost_hits;
+    out->flags                     = bevt->flags;
+    out->lostcpu                   = bevt->lostcpu;
+    out->lostfpga                  = bevt->lostfpga;
+    out->ts0                       = bevt->ts0;
+    out->ts1                       = bevt->ts1;
+    out->coinc                     = bevt->coinc;
+    out->feb_hit_number            = bevt->feb_hit_number;
+    out->timestamp                 = bevt->timestamp;
+    out->last_accepted_timestamp   = bevt->last_accepted_timestamp;
+    out->lost_hits                 = bevt->lost_hits;
 
-    for(int ch=0; ch<32; ch++) out.adc[ch] = bevt->adc[ch];
+    for(int ch=0; ch<32; ch++) out->adc[ch] = bevt->adc[ch];
 
-    out.sequence_id               = frag.sequenceID();
+    out->sequence_id               = frag.sequenceID();
 
     //metadata
-    out.mac5                      = md->MAC5();
-    out.run_start_time            = md->run_start_time();
-    out.this_poll_start           = md->this_poll_start();
-    out.this_poll_end             = md->this_poll_end();
-    out.last_poll_start           = md->last_poll_start();
-    out.last_poll_end             = md->last_poll_end();
-    out.system_clock_deviation    = md->system_clock_deviation();
-    out.hits_in_poll              = md->hits_in_poll();
+    out->mac5                      = md->MAC5();
+    out->run_start_time            = md->run_start_time();
+    out->this_poll_start           = md->this_poll_start();
+    out->this_poll_end             = md->this_poll_end();
+    out->last_poll_start           = md->last_poll_start();
+    out->last_poll_end             = md->last_poll_end();
+    out->system_clock_deviation    = md->system_clock_deviation();
+    out->hits_in_poll              = md->hits_in_poll();
  
-    out.hits_in_fragment          = nhits;
-
-    OUT.push_back(out);
+    out->hits_in_fragment          = nhits;
   }
-  return OUT;
+  return out;
 } 
 
-std::vector<icarus::crt::BernCRTTranslator> icarus::crt::BernCRTTranslator::getCRTData(art::Event const & evt) {
+size_t icarus::crt::BernCRTTranslator::countHits(artdaq::Fragment const & frag, artdaq::Fragment::type_t type) {
+  switch(type) {
+    case sbndaq::detail::FragmentType::BERNCRTZMQ:
+    case sbndaq::detail::FragmentType::BERNCRT:
+      return 1;
+    case sbndaq::detail::FragmentType::BERNCRTV2:
+      return sbndaq::BernCRTFragmentV2(frag).metadata()->hits_in_fragment();
+  }
+  return 0;
+}
+
+icarus::crt::BernCRTTranslator* icarus::crt::BernCRTTranslator::decodeFragment(artdaq::Fragment const & frag, artdaq::Fragment::type_t type, icarus::crt::BernCRTTranslator* out) {
+  switch(type) {
+    case sbndaq::detail::FragmentType::BERNCRTZMQ:
+      *out = analyze_BernCRTZMQFragment(frag);
+      return out + 1;
+    case sbndaq::detail::FragmentType::BERNCRT:
+      *out = analyze_BernCRTFragment(frag);
+      return out + 1;
+    case sbndaq::detail::FragmentType::BERNCRTV2:
+      return analyze_BernCRTFragmentV2(frag, out);
+  }
+  return out;
+}
+
+std::vector<icarus::crt::BernCRTTranslator> icarus::crt::BernCRTTranslator::decodeContainer(artdaq::Fragment const & frag) {
   std::vector<icarus::crt::BernCRTTranslator> out;
 
+  //the blocks are handed out as copies by the container overlay, so each one
+  //is decoded as soon as it is extracted and released right after
+  const artdaq::ContainerFragment contf(frag);
+  const artdaq::Fragment::type_t type = contf.fragment_type();
+  for (size_t ii = 0; ii < contf.block_count(); ++ii) {
+    const std::unique_ptr<artdaq::Fragment> block = contf[ii];
+    const size_t nhits = countHits(*block, type);
+    if (nhits == 0) continue;
+    const size_t first = out.size();
+    out.resize(first + nhits);
+    decodeFragment(*block, type, out.data() + first);
+  }
+
+  return out;
+}
+
+std::vector<icarus::crt::BernCRTTranslator> icarus::crt::BernCRTTranslator::getCRTData(art::Event const & evt) {
+
+  //fragments are visited by reference, in the order of the handles;
+  //each one is decoded independently and its hits are placed at a
+  //position known from the hit counts, so the decoding runs in parallel
+  //and the output is identical to a sequential pass
+  struct FragmentToDecode {
+    artdaq::Fragment const* frag;
+    artdaq::Fragment::type_t type; //type of the whole handle, as set by its first fragment
+    bool container;
+    size_t nhits = 0;
+    size_t first = 0; //position of the first hit in the output
+    std::vector<icarus::crt::BernCRTTranslator> containerHits;
+  };
+
   std::vector<art::Handle<artdaq::Fragments>> fragmentHandles;
   evt.getManyByType(fragmentHandles);
-  for (auto handle : fragmentHandles) {
+
+  std::vector<FragmentToDecode> toDecode;
+  for (auto const& handle : fragmentHandles) {
     if (!handle.isValid() || handle->size() == 0)
       continue;
     
-    if (handle->front().type() == artdaq::Fragment::ContainerFragmentType) {
-      //Container fragment
-      for (auto cont : *handle) {
-        artdaq::ContainerFragment contf(cont);
-        switch(contf.fragment_type()) {
-          case sbndaq::detail::FragmentType::BERNCRTZMQ:
-            out.reserve(out.size() + contf.block_count());
-            for (size_t ii = 0; ii < contf.block_count(); ++ii) {
-              out.push_back(analyze_BernCRTZMQFragment(*contf[ii].get()));
-            }
-            break;
-          case sbndaq::detail::FragmentType::BERNCRT:
-            out.reserve(out.size() + contf.block_count());
-            for (size_t ii = 0; ii < contf.block_count(); ++ii) {
-              out.push_back(analyze_BernCRTFragment(*contf[ii].get()));
-            }
-            break;
-          case sbndaq::detail::FragmentType::BERNCRTV2:
-            for (size_t ii = 0; ii < contf.block_count(); ++ii) {
-              std::vector<icarus::crt::BernCRTTranslator> v = analyze_BernCRTFragmentV2(*contf[ii].get());
-              out.insert( out.end(), v.begin(), v.end() );
-            }
-            break; 
+    const artdaq::Fragment::type_t type = handle->front().type();
+    const bool container = (type == artdaq::Fragment::ContainerFragmentType);
+    for (artdaq::Fragment const& frag : *handle) {
+      toDecode.push_back({ &frag, type, container });
+    }
+  }
+
+  //hit counts: from the metadata of plain fragments, by decoding the containers
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, toDecode.size()),
+    [&toDecode](tbb::blocked_range<size_t> const& range) {
+      for (size_t i = range.begin(); i != range.end(); ++i) {
+        FragmentToDecode& f = toDecode[i];
+        if (f.container) {
+          f.containerHits = decodeContainer(*f.frag);
+          f.nhits = f.containerHits.size();
         }
+        else f.nhits = countHits(*f.frag, f.type);
       }
-    }
-    else {
-      //normal fragment
-      switch(handle->front().type()) {
-        case sbndaq::detail::FragmentType::BERNCRTZMQ:
-          out.reserve(out.size() + handle->size());
-          for (auto frag : *handle) {
-            out.push_back(analyze_BernCRTZMQFragment(frag));
-          }
-          break;
-        case sbndaq::detail::FragmentType::BERNCRT:
-          out.reserve(out.size() + handle->size());
-          for (auto frag : *handle) {
-            out.push_back(analyze_BernCRTFragment(frag));
-          }
-          break;
-        case sbndaq::detail::FragmentType::BERNCRTV2:
-          out.reserve(out.size() + handle->size());
-          for (auto frag : *handle) {
-            std::vector<icarus::crt::BernCRTTranslator> v = analyze_BernCRTFragmentV2(frag);
-            out.insert( out.end(), v.begin(), v.end() );
-          }
-          break; 
+    });
+
+  size_t nhits = 0;
+  for (FragmentToDecode& f : toDecode) {
+    f.first = nhits;
+    nhits += f.nhits;
+  }
+
+  std::vector<icarus::crt::BernCRTTranslator> out(nhits);
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, toDecode.size()),
+    [&toDecode, &out](tbb::blocked_range<size_t> const& range) {
+      for (size_t i = range.begin(); i != range.end(); ++i) {
+        FragmentToDecode& f = toDecode[i];
+        if (f.container) {
+          std::move(f.containerHits.begin(), f.containerHits.end(), out.begin() + f.first);
+          f.containerHits.clear();
+          f.containerHits.shrink_to_fit();
+        }
+        else decodeFragment(*f.frag, f.type, out.data() + f.first);
       }
-    }
-  } 
+    });
 
   return out;
 }
@@ -12,6 +12,7 @@
 #define icaruscode_CRT_CRTDecoder_BERNCRTTranslator_hh
 
 #include "art/Framework/Principal/Event.h"
+#include "artdaq-core/Data/Fragment.hh"
 
 #include <vector>
 
@@ -60,9 +61,17 @@ public:
 
 
 private:
-  static BernCRTTranslator analyze_BernCRTZMQFragment(artdaq::Fragment & frag); 
-  static BernCRTTranslator analyze_BernCRTFragment(artdaq::Fragment & frag); 
-  static std::vector<BernCRTTranslator> analyze_BernCRTFragmentV2(artdaq::Fragment & frag); 
+  static BernCRTTranslator analyze_BernCRTZMQFragment(artdaq::Fragment const & frag); 
+  static BernCRTTranslator analyze_BernCRTFragment(artdaq::Fragment const & frag); 
+  //writes hits_in_fragment hits starting at out, returns the end of the written range
+  static BernCRTTranslator* analyze_BernCRTFragmentV2(artdaq::Fragment const & frag, BernCRTTranslator* out); 
+
+  //number of hits in a (non-container) fragment of the specified type, 0 if not a Bern CRT type
+  static size_t countHits(artdaq::Fragment const & frag, artdaq::Fragment::type_t type);
+  //decodes a (non-container) fragment of the specified type into out, returns the end of the written range
+  static BernCRTTranslator* decodeFragment(artdaq::Fragment const & frag, artdaq::Fragment::type_t type, BernCRTTranslator* out);
+  //decodes all the blocks of a container fragment
+  static std::vector<BernCRTTranslator> decodeContainer(artdaq::Fragment const & frag);
 
 };
 
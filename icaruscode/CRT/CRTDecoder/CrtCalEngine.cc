@@ -0,0 +1,478 @@
+#ifndef CRT_CAL_ENGINE_CC
+#define CRT_CAL_ENGINE_CC
+
+#include "icaruscode/CRT/CRTDecoder/CrtCalEngine.h"
+
+#include "cetlib_except/exception.h"
+
+#include <TSpectrum.h>
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <iostream>
+
+using namespace icarus::crt;
+
+namespace {
+
+	// spectra of a FEB: kNChan rows of kNADC counts followed by the overflow
+	constexpr size_t kRowSize = CrtCalEngine::kNADC + 1;
+
+	// settings of CrtCal
+	constexpr size_t kActiveCutoff = 600;   // channel active if any count at or above this ADC
+	constexpr size_t kThreshLow    = 300;   // threshold searched as the minimum in [300,1000) ADC
+	constexpr size_t kThreshHigh   = 1000;
+	constexpr size_t kPedLow       = 1;     // pedestal peak searched in [1,300) ADC
+	constexpr size_t kPedHigh      = 300;
+	constexpr size_t kRebin        = 4;     // the gain fit works on spectra rebinned by 4...
+	constexpr size_t kGainLow      = 350;   // ...in the range [350,700) ADC
+	constexpr size_t kGainHigh     = 700;
+	constexpr float  kGainSeed     = 55.0;
+	constexpr double kSpectrumSigma     = 1.75;
+	constexpr double kSpectrumThreshold = 0.18;
+
+	using Matrix3 = std::array<std::array<double,3>,3>;
+
+	// inverse of a symmetric 3x3 matrix; false if singular
+	bool Invert(const Matrix3& m, Matrix3& inv) {
+
+		inv[0][0] = m[1][1]*m[2][2] - m[1][2]*m[2][1];
+		inv[0][1] = m[0][2]*m[2][1] - m[0][1]*m[2][2];
+		inv[0][2] = m[0][1]*m[1][2] - m[0][2]*m[1][1];
+		inv[1][0] = m[1][2]*m[2][0] - m[1][0]*m[2][2];
+		inv[1][1] = m[0][0]*m[2][2] - m[0][2]*m[2][0];
+		inv[1][2] = m[0][2]*m[1][0] - m[0][0]*m[1][2];
+		inv[2][0] = m[1][0]*m[2][1] - m[1][1]*m[2][0];
+		inv[2][1] = m[0][1]*m[2][0] - m[0][0]*m[2][1];
+		inv[2][2] = m[0][0]*m[1][1] - m[0][1]*m[1][0];
+
+		const double det = m[0][0]*inv[0][0] + m[0][1]*inv[1][0] + m[0][2]*inv[2][0];
+		if(det == 0. || !std::isfinite(det)) return false;
+
+		for(auto& row : inv) for(auto& v : row) v /= det;
+
+		return true;
+	}
+
+} // local namespace
+
+CrtCalEngine::Result::Result() {
+
+	for(size_t ch=0; ch<kNChan; ch++){
+		active[ch]       = false;
+		gain[ch]         = FLT_MAX;
+		gainErr[ch]      = FLT_MAX;
+		gainXsqr[ch]     = FLT_MAX;
+		gainNdf[ch]      = SHRT_MAX;
+		gainPed[ch]      = FLT_MAX;
+		gainPedErr[ch]   = FLT_MAX;
+		nPeak[ch]        = SHRT_MAX;
+		ped[ch]          = FLT_MAX;
+		pedErr[ch]       = FLT_MAX;
+		pedXsqr[ch]      = FLT_MAX;
+		pedNdf[ch]       = SHRT_MAX;
+		pedSigma[ch]     = FLT_MAX;
+		pedSigmaErr[ch]  = FLT_MAX;
+		pedNorm[ch]      = FLT_MAX;
+		pedNormErr[ch]   = FLT_MAX;
+		threshADC[ch]    = INT_MAX;
+		threshPE[ch]     = FLT_MAX;
+		nAbove[ch]       = INT_MAX;
+
+		for(size_t p=0; p<kNPeak; p++){
+			peakNorm[ch][p]     = FLT_MAX;
+			peakNormErr[ch][p]  = FLT_MAX;
+			peakSigma[ch][p]    = FLT_MAX;
+			peakSigmaErr[ch][p] = FLT_MAX;
+			peakMean[ch][p]     = FLT_MAX;
+			peakMeanErr[ch][p]  = FLT_MAX;
+			peakXsqr[ch][p]     = FLT_MAX;
+			peakNdf[ch][p]      = SHRT_MAX;
+		}
+	}
+}
+
+void CrtCalEngine::AddFEB(uint8_t mac5) {
+
+	if(HasFEB(mac5)) return;
+
+	fMacs.push_back(mac5);
+	fSpectra[mac5].assign(kNChan*kRowSize, 0);
+}
+
+void CrtCalEngine::Fill(uint8_t mac5, const uint16_t* adc) {
+
+	auto itSpectra = fSpectra.find(mac5);
+	if(itSpectra == fSpectra.end())
+		throw cet::exception("CrtCalEngine") << "no spectra for FEB mac5 " << (short)mac5 << "\n";
+
+	uint32_t* row = itSpectra->second.data();
+	for(size_t ch=0; ch<kNChan; ch++, row+=kRowSize)
+		++row[std::min<size_t>(adc[ch], kNADC)];
+}
+
+const uint32_t* CrtCalEngine::GetSpectrum(uint8_t mac5, size_t chan) const {
+
+	auto itSpectra = fSpectra.find(mac5);
+	if(itSpectra == fSpectra.end() || chan >= kNChan) return nullptr;
+
+	return itSpectra->second.data() + chan*kRowSize;
+}
+
+map<uint8_t,CrtCalEngine::Result> CrtCalEngine::Calibrate() const {
+
+	vector<Result> results(fMacs.size());
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, fMacs.size()),
+		[this, &results](tbb::blocked_range<size_t> const& range) {
+			for(size_t i=range.begin(); i!=range.end(); i++)
+				results[i] = CalibrateFEB(fMacs[i], fSpectra.at(fMacs[i]).data());
+		});
+
+	map<uint8_t,Result> out;
+	for(size_t i=0; i<fMacs.size(); i++) {
+		size_t nactive = std::count(results[i].active, results[i].active+kNChan, true);
+		std::cout << "mac5 " << (short)fMacs[i] << ": " << nactive << " active channels" << std::endl;
+		out.emplace(fMacs[i], results[i]);
+	}
+
+	return out;
+}
+
+CrtCalEngine::Result CrtCalEngine::CalibrateFEB(uint8_t mac5, const uint32_t* spectra) {
+
+	Result res;
+
+	for(size_t chan=0; chan<kNChan; chan++) {
+		const uint32_t* counts = spectra + chan*kRowSize;
+
+		// active channel scan and threshold, from the raw spectrum
+		res.active[chan] = std::any_of(counts+kActiveCutoff, counts+kNADC, [](uint32_t c){ return c != 0; });
+		if(res.active[chan]) {
+			res.threshADC[chan] = std::min_element(counts+kThreshLow, counts+kThreshHigh) - counts;
+
+			uint64_t nabove = 0;
+			for(size_t adc=std::max(res.threshADC[chan],0); adc<kRowSize; adc++) nabove += counts[adc];
+			res.nAbove[chan] = nabove;
+		}
+
+		// pedestal fit for all channels, gain only for active ones
+		const bool hasPed = PedCal(counts, chan, mac5, res);
+		if(!res.active[chan]) continue;
+
+		// the photopeaks are numbered from the pedestal: without it there is no gain
+		if(!hasPed) {
+			std::cout << "warning: no pedestal for gain fit mac5 " << (short)mac5 << ", ch. " << chan << std::endl;
+			continue;
+		}
+
+		GainCal(counts, chan, mac5, res);
+
+		res.threshPE[chan] = 1.0*(res.threshADC[chan]-res.ped[chan])/res.gain[chan];
+	}
+
+	return res;
+}
+
+bool CrtCalEngine::PedCal(const uint32_t* counts, size_t chan, uint8_t mac5, Result& res) {
+
+	const uint32_t* itMax = std::max_element(counts+kPedLow, counts+kPedHigh);
+	const double maxVal = *itMax;
+	const double maxADC = itMax - counts;
+	if(maxVal == 0) return false;
+
+	// bin centers of the spectrum
+	vector<double> x(kNADC), y(counts, counts+kNADC);
+	for(size_t adc=0; adc<kNADC; adc++) x[adc] = adc + 0.5;
+
+	GausFitResult fit = GausFit(x.data(), y.data(), kNADC, maxADC-12, maxADC+12,
+	                            { {maxVal, maxADC, 50.0} },
+	                            { {0.5*maxVal, maxADC-20, 1.} }, { {1000*maxVal, maxADC+20, 50.} });
+
+	if(fit.ndf > 0 && fit.chi2/fit.ndf > 10.0) {
+		const std::array<double,3> p = fit.par;
+		fit = GausFit(x.data(), y.data(), kNADC, p[1]-10, p[1]+10, p,
+		              { {p[0]-50, p[1]-10, p[2]-10} }, { {p[0]+50, p[1]+10, p[2]+10} });
+	}
+
+	if(fit.ndf > 0 && fit.chi2/fit.ndf > 200.0)
+		std::cout << "warning: possibly bad ped fit mac5 " << (short)mac5 << ", ch. "
+		          << chan << " X^2/NDF=" << fit.chi2/fit.ndf << " ADC" << std::endl;
+
+	res.pedNorm[chan]     = fit.par[0];
+	res.pedNormErr[chan]  = fit.err[0];
+	res.ped[chan]         = fit.par[1];
+	res.pedErr[chan]      = fit.err[1];
+	res.pedSigma[chan]    = fit.par[2];
+	res.pedSigmaErr[chan] = fit.err[2];
+	res.pedXsqr[chan]     = fit.chi2;
+	res.pedNdf[chan]      = fit.ndf;
+
+	return true;
+}
+
+void CrtCalEngine::GainCal(const uint32_t* counts, size_t chan, uint8_t mac5, Result& res) {
+
+	// spectrum rebinned by kRebin, as the histogram in CrtCal::GainFit()
+	const size_t nBins = kNADC/kRebin;
+	vector<double> x(nBins), y(nBins, 0.);
+	for(size_t bin=0; bin<nBins; bin++) {
+		x[bin] = kRebin*bin + 0.5*kRebin;
+		for(size_t i=0; i<kRebin; i++) y[bin] += counts[kRebin*bin+i];
+	}
+
+	// peak search in the fit range, with the same settings as TSpectrum::Search()
+	const size_t first = kGainLow/kRebin, last = kGainHigh/kRebin;
+	vector<double> source(y.begin()+first, y.begin()+last), dest(last-first);
+	TSpectrum spectrum;
+	const int nPeak = spectrum.SearchHighRes(source.data(), dest.data(), source.size(),
+	                                         kSpectrumSigma, 100*kSpectrumThreshold, true, 3, true, 3);
+
+	res.nPeak[chan] = nPeak;
+	if(nPeak <= 0) return;
+
+	//ascending list of candidate photopeak ADC positions
+	vector<float> peaks(nPeak);
+	for(int p=0; p<nPeak; p++) peaks[p] = x[first + (size_t)(spectrum.GetPositionX()[p] + 0.5)];
+	std::sort(peaks.begin(), peaks.end());
+
+	const float* peds    = res.ped;
+	const float* pwidths = res.pedSigma;
+
+	//peak number(x) vs. ADC value(y)
+	vector<float> px(nPeak), py(peaks);
+	const int peak_offset = std::round((peaks[0]-peds[chan])/kGainSeed); //estimate peak number
+	for(int j=0; j<nPeak; j++) px[j] = j+peak_offset;
+
+	//first peak in passing list is pedestal
+	vector<float> gx { 0 }, gy { peds[chan] }, gey { pwidths[chan] };
+
+	int nplow = 0; //no. peaks close to low hist edge
+	const float lowEdge  = 0 + 15;                            //as the low edge of the first bin...
+	const float highEdge = kRebin*(nBins-1) - 15;             //...and of the last bin of the full histogram
+
+	for(int g=0; g<nPeak && g<(int)kNPeak; g++) {
+
+		GausFitResult gfit = GausFit(x.data(), y.data(), nBins, py[g]-20, py[g]+20,
+		                             { {y[(size_t)py[g]/kRebin], py[g], 12.} },
+		                             { {0., py[g]-15., 8.} }, { {20000., py[g]+15., 40.} });
+
+		if(py[g]<lowEdge) nplow++;
+
+		//ignore edge peaks and peaks with fit mean > 15 from peak
+		if(!(py[g]>lowEdge && py[g]<highEdge && std::abs(py[g] - gfit.par[1]) < 15)) continue;
+
+		//skip false peaks (check it's not first or last peaks and within 30% of expected gain w.r.t adj.)
+		if(g!=0 && g!=nPeak-1 && (py[g+1]-py[g]<kGainSeed*0.7 || py[g]-py[g-1]<kGainSeed*0.7)) {
+			for(int j=g; j<nPeak; j++) px[j] -= 1;
+			continue;
+		}
+
+		//if not false peak, could there have been a skipped peak?
+		if(g!=0 && g!=nPeak-1 && py[g+1]-py[g]<kGainSeed*1.2 && py[g]-py[g-1]>kGainSeed*1.5)
+			for(int j=g; j<nPeak; j++) px[j] += 1;
+		//if last peak likely occuring after skipped peak
+		if(g!=0 && g==nPeak-1 && (py[g]-py[g-1])/kGainSeed > 1.5)
+			px[g] += (int)((py[g]-py[g-1])/kGainSeed);
+
+		const size_t gg = gx.size();
+		if(gg < kNPeak) {
+			res.peakXsqr[chan][gg]     = gfit.chi2;
+			res.peakNdf[chan][gg]      = gfit.ndf;
+			res.peakMean[chan][gg]     = gfit.par[1];
+			res.peakMeanErr[chan][gg]  = gfit.err[1];
+			res.peakNorm[chan][gg]     = gfit.par[0];
+			res.peakNormErr[chan][gg]  = gfit.err[0];
+			res.peakSigma[chan][gg]    = gfit.par[2];
+			res.peakSigmaErr[chan][gg] = gfit.err[2];
+		}
+
+		gx.push_back(px[g]);
+		gy.push_back(gfit.par[1]);
+		gey.push_back(std::sqrt(px[g]+gey[0]*gey[0]));
+	}
+
+	const size_t gg = gx.size();
+	if(nplow>0) for(size_t i=1; i<gg; i++) gx[i] -= (nplow-1);
+
+	if(gg < 2) {
+		std::cout << "warning: no photopeak for gain fit mac5 " << (short)mac5 << ", ch. " << chan << std::endl;
+		return;
+	}
+
+	//adc vs. photo-peak number
+	auto fitLine = [&]() {
+		return LineFit(gx, gy, gey, kGainSeed-20, kGainSeed+20, peds[chan]*0.8, peds[chan]*1.2);
+	};
+	LineFitResult fit = fitLine();
+
+	//if the gain fit is bad according to chi-square, try shifting all peaks by one
+	if(fit.ndf > 0 && fit.chi2/fit.ndf > 5.0) {
+		const double chisqr = fit.chi2;
+		for(size_t i=1; i<gg; i++) gx[i] += 1;
+		fit = fitLine();
+		if(!(fit.chi2 < chisqr)) {
+			for(size_t i=1; i<gg; i++) gx[i] -= 2;
+			fit = fitLine();
+			if(!(fit.chi2 < chisqr)) {
+				for(size_t i=1; i<gg; i++) gx[i] += 1;
+				fit = fitLine();
+			}
+		}
+	}
+
+	res.gain[chan]       = fit.gain;
+	res.gainErr[chan]    = fit.gainErr;
+	res.gainPed[chan]    = fit.ped;
+	res.gainPedErr[chan] = fit.pedErr;
+	res.gainXsqr[chan]   = fit.chi2;
+	res.gainNdf[chan]    = fit.ndf;
+}
+
+CrtCalEngine::LineFitResult CrtCalEngine::LineFit(const vector<float>& x, const vector<float>& y, const vector<float>& ey,
+                                                  double gainMin, double gainMax, double pedMin, double pedMax) {
+
+	LineFitResult res;
+	double s = 0., sx = 0., sy = 0., sxx = 0., sxy = 0.;
+	for(size_t i=0; i<x.size(); i++) {
+		const double w = 1./(ey[i]*ey[i]);
+		s   += w;
+		sx  += w*x[i];
+		sy  += w*y[i];
+		sxx += w*x[i]*x[i];
+		sxy += w*x[i]*y[i];
+	}
+
+	const double det = s*sxx - sx*sx;
+	if(det <= 0.) return res;
+
+	res.gain    = (s*sxy - sx*sy)/det;
+	res.ped     = (sxx*sy - sx*sxy)/det;
+	res.gainErr = std::sqrt(s/det);
+	res.pedErr  = std::sqrt(sxx/det);
+
+	// a parameter beyond its bound is fixed there and the other one refitted
+	if(res.gain < gainMin || res.gain > gainMax) {
+		res.gain = std::clamp(res.gain, gainMin, gainMax);
+		res.ped  = (sy - res.gain*sx)/s;
+	}
+	if(res.ped < pedMin || res.ped > pedMax) {
+		res.ped  = std::clamp(res.ped, pedMin, pedMax);
+		res.gain = std::clamp((sxy - res.ped*sx)/sxx, gainMin, gainMax);
+	}
+
+	for(size_t i=0; i<x.size(); i++) {
+		const double r = (y[i] - res.ped - res.gain*x[i])/ey[i];
+		res.chi2 += r*r;
+	}
+	res.ndf = x.size() - 2;
+
+	return res;
+}
+
+CrtCalEngine::GausFitResult CrtCalEngine::GausFit(const double* x, const double* y, size_t n,
+                                                  double xmin, double xmax,
+                                                  std::array<double,3> init,
+                                                  const std::array<double,3>& parMin, const std::array<double,3>& parMax) {
+
+	// Levenberg-Marquardt minimization of the chi-square with errors sqrt(y)
+	// (empty bins excluded), keeping the parameters within their bounds
+	GausFitResult res;
+
+	vector<size_t> points;
+	for(size_t i=0; i<n; i++)
+		if(x[i] >= xmin && x[i] <= xmax && y[i] > 0) points.push_back(i);
+
+	std::array<double,3> lower = parMin;
+	lower[2] = std::max(lower[2], 1e-6); // keep the width positive
+
+	auto clamp = [&](std::array<double,3>& p) {
+		for(size_t k=0; k<3; k++) p[k] = std::clamp(p[k], lower[k], std::max(lower[k], parMax[k]));
+	};
+
+	auto chi2 = [&](const std::array<double,3>& p) {
+		double c = 0.;
+		for(size_t i : points) {
+			const double d = (x[i]-p[1])/p[2];
+			const double r = y[i] - p[0]*std::exp(-0.5*d*d);
+			c += r*r/y[i];
+		}
+		return c;
+	};
+
+	// curvature matrix and gradient of the chi-square (halved)
+	auto linearize = [&](const std::array<double,3>& p, Matrix3& alpha, std::array<double,3>& beta) {
+		alpha = Matrix3{};
+		beta  = { {0., 0., 0.} };
+		for(size_t i : points) {
+			const double d = (x[i]-p[1])/p[2];
+			const double g = std::exp(-0.5*d*d);
+			const double r = y[i] - p[0]*g;
+			const double w = 1./y[i];
+			const std::array<double,3> j { {g, p[0]*g*d/p[2], p[0]*g*d*d/p[2]} };
+			for(size_t a=0; a<3; a++) {
+				beta[a] += w*r*j[a];
+				for(size_t b=0; b<3; b++) alpha[a][b] += w*j[a]*j[b];
+			}
+		}
+	};
+
+	std::array<double,3> p = init;
+	clamp(p);
+	res.par = p;
+	res.ndf = (int)points.size() - 3;
+	if(res.ndf < 0) return res;
+
+	double c = chi2(p);
+	double lambda = 1e-3;
+	Matrix3 alpha, inv;
+	std::array<double,3> beta;
+
+	for(int iter=0; iter<200; iter++) {
+		linearize(p, alpha, beta);
+
+		bool improved = false;
+		double cNew = c;
+		while(lambda < 1e10) {
+			Matrix3 m = alpha;
+			for(size_t a=0; a<3; a++) m[a][a] *= 1. + lambda;
+			if(!Invert(m, inv)) { lambda *= 10; continue; }
+
+			std::array<double,3> pNew = p;
+			for(size_t a=0; a<3; a++)
+				for(size_t b=0; b<3; b++) pNew[a] += inv[a][b]*beta[b];
+			clamp(pNew);
+
+			cNew = chi2(pNew);
+			if(cNew < c) {
+				p = pNew;
+				lambda = std::max(lambda/10, 1e-12);
+				improved = true;
+				break;
+			}
+			lambda *= 10;
+		}
+
+		if(!improved) break;
+		const bool converged = (c - cNew) < 1e-9*(1. + c);
+		c = cNew;
+		if(converged) break;
+	}
+
+	linearize(p, alpha, beta);
+	if(Invert(alpha, inv))
+		for(size_t k=0; k<3; k++) res.err[k] = std::sqrt(std::max(inv[k][k], 0.));
+
+	res.par   = p;
+	res.chi2  = c;
+	res.valid = true;
+
+	return res;
+}
+
+#endif
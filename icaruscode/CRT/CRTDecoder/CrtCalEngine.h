@@ -0,0 +1,123 @@
+#ifndef CRT_CAL_ENGINE_H
+#define CRT_CAL_ENGINE_H
+
+//c++ includes
+#include <vector>
+#include <map>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace icarus {
+ namespace crt {
+  class CrtCalEngine;
+ }
+}
+
+using std::vector;
+using std::map;
+
+/**
+ * Streaming version of the CrtCal channel calibration.
+ *
+ * The ADC spectra of the 32 channels of each FEB are accumulated as plain
+ * counts (one per ADC value, same binning as the histograms CrtCal works on)
+ * directly from the decoded hits. Calibrate() then runs the same steps as
+ * CrtCal::Cal() on these arrays: active channel scan, trigger threshold,
+ * pedestal fit and gain fit from the photoelectron peaks. The Gaussian fits
+ * use a small least squares fitter instead of TF1 fits on cloned histograms,
+ * and the FEBs are calibrated in parallel.
+ * No plots are produced; CrtCal is still available for that.
+ */
+class icarus::crt::CrtCalEngine {
+
+  public:
+	static constexpr size_t kNChan  = 32;   ///< channels per FEB
+	static constexpr size_t kNPeak  = 5;    ///< photoelectron peaks fitted per channel
+	static constexpr size_t kNADC   = 4100; ///< ADC values in the spectra (as the histograms)
+
+	/// Calibration of one FEB, with the layout of the calibration tree
+	struct Result {
+		bool   active[kNChan];
+		float  gain[kNChan];
+		float  gainErr[kNChan];
+		float  gainXsqr[kNChan];
+		short  gainNdf[kNChan];
+		float  gainPed[kNChan];
+		float  gainPedErr[kNChan];
+		short  nPeak[kNChan];
+		float  ped[kNChan];
+		float  pedErr[kNChan];
+		float  pedXsqr[kNChan];
+		short  pedNdf[kNChan];
+		float  pedSigma[kNChan];
+		float  pedSigmaErr[kNChan];
+		float  pedNorm[kNChan];
+		float  pedNormErr[kNChan];
+		int    threshADC[kNChan];
+		float  threshPE[kNChan];
+		int    nAbove[kNChan];
+		float  peakNorm[kNChan][kNPeak];
+		float  peakNormErr[kNChan][kNPeak];
+		float  peakSigma[kNChan][kNPeak];
+		float  peakSigmaErr[kNChan][kNPeak];
+		float  peakMean[kNChan][kNPeak];
+		float  peakMeanErr[kNChan][kNPeak];
+		float  peakXsqr[kNChan][kNPeak];
+		short  peakNdf[kNChan][kNPeak];
+
+		Result(); ///< all values set to the "not calibrated" defaults
+	};
+
+	/// Result of a Gaussian fit, [0]*exp(-0.5*((x-[1])/[2])^2)
+	struct GausFitResult {
+		std::array<double,3> par { {0., 0., 0.} };
+		std::array<double,3> err { {0., 0., 0.} };
+		double chi2 = 0.;
+		int    ndf  = 0;
+		bool   valid = false;
+	};
+
+	/// Result of a straight line fit, y = ped + gain*x
+	struct LineFitResult {
+		double ped = 0., pedErr = 0., gain = 0., gainErr = 0., chi2 = 0.;
+		int    ndf = 0;
+	};
+
+	void AddFEB(uint8_t mac5);
+	bool HasFEB(uint8_t mac5) const { return fSpectra.count(mac5) != 0; }
+
+	/// Adds the 32 ADC values of a hit to the spectra of its FEB (which must have been added)
+	void Fill(uint8_t mac5, const uint16_t* adc);
+
+	/// Counts of the specified channel, kNADC values followed by the overflow
+	const uint32_t* GetSpectrum(uint8_t mac5, size_t chan) const;
+
+	const vector<uint8_t>& GetMacs() const { return fMacs; }
+
+	/// Calibrates all the FEBs, in parallel
+	map<uint8_t,Result> Calibrate() const;
+
+	/// Calibrates the channels of a single FEB from its spectra
+	static Result CalibrateFEB(uint8_t mac5, const uint32_t* spectra);
+
+	/// Fits a Gaussian to the bins with center in [xmin,xmax], with bounds on the parameters
+	static GausFitResult GausFit(const double* x, const double* y, size_t n,
+	                             double xmin, double xmax,
+	                             std::array<double,3> init,
+	                             const std::array<double,3>& parMin, const std::array<double,3>& parMax);
+
+	/// Fits a straight line to points with errors ey, with bounds on both parameters
+	static LineFitResult LineFit(const vector<float>& x, const vector<float>& y, const vector<float>& ey,
+	                             double gainMin, double gainMax, double pedMin, double pedMax);
+
+  private:
+	/// Fits the pedestal peak; false (and no pedestal) if the channel has no counts below kPedHigh
+	static bool PedCal(const uint32_t* counts, size_t chan, uint8_t mac5, Result& res);
+	static void GainCal(const uint32_t* counts, size_t chan, uint8_t mac5, Result& res);
+
+	vector<uint8_t>              fMacs;    ///< FEBs in the order they were added
+	map<uint8_t,vector<uint32_t>> fSpectra; ///< per FEB, kNChan x (kNADC+1) counts
+};
+
+#endif
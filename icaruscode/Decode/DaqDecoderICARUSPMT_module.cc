@@ -60,9 +60,14 @@
 // ROOT libraries
 #include "TTree.h"
 
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 // C/C++ standard libraries
 #include <memory>
 #include <ostream>
+#include <algorithm> // std::equal()
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -147,6 +152,17 @@ namespace icarus { class DaqDecoderICARUSPMT; }
  *     option is set to `true` unless `TriggerTag` is specified empty.
  * * `DataTrees` (list of strings, default: none): list of data trees to be
  *     produced; if none (default), then `TFileService` is not required.
+ * * `ConcurrentBoards` (flag, default: `false`): if set, the fragments of
+ *     different readout boards are decoded in parallel (using TBB), each into
+ *     its own waveform buffer, and the buffers are then collected in input
+ *     order; the output is the same as in serial mode. Only the decoding is
+ *     parallel: the final sorting of all the waveforms (by channel, then time)
+ *     is still serial. Since filling the data trees is inherently sequential,
+ *     this option is ignored when any of `DataTrees` is requested.
+ * * `CheckConcurrentBoards` (flag, default: `false`): if set together with
+ *     `ConcurrentBoards`, the boards are also decoded serially, and an
+ *     exception is thrown if the two results differ in any waveform; this is a
+ *     validation option, which doubles the decoding time.
  * * `LogCategory` (string, default: `DaqDecoderICARUSPMT`): name of the message
  *     facility category where the output is sent.
  * 
@@ -491,6 +507,19 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
       std::vector<std::string>{} // default
       };
     
+    fhicl::Atom<bool> ConcurrentBoards {
+      Name("ConcurrentBoards"),
+      Comment
+        ("decode the fragments of different boards in parallel (sorting is serial)"),
+      false // default
+      };
+    
+    fhicl::Atom<bool> CheckConcurrentBoards {
+      Name("CheckConcurrentBoards"),
+      Comment("also decode serially and throw if the result differs (validation)"),
+      false // default
+      };
+    
     fhicl::Atom<std::string> LogCategory {
       Name("LogCategory"),
       Comment("name of the category for message stream"),
@@ -582,6 +611,11 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
   /// All board setup settings.
   std::vector<daq::details::BoardSetup_t> const fBoardSetup;
   
+  bool const fConcurrentBoards; ///< Whether to decode boards in parallel.
+  
+  /// Whether to check the parallel decoding against the serial one.
+  bool const fCheckConcurrentBoards;
+  
   std::string const fLogCategory; ///< Message facility category.
   
   // --- END ---- Configuration parameters -------------------------------------
@@ -825,6 +859,46 @@ class icarus::DaqDecoderICARUSPMT: public art::EDProducer {
     TriggerInfo_t const& triggerInfo
     );
   
+  /**
+   * @brief Decodes the fragments of all boards in parallel.
+   * @param boardFragments fragment collections, one per input board fragment
+   * @param triggerInfo information on the global trigger
+   * @return all the decoded waveforms, in the same order as in serial mode
+   * 
+   * Each board is decoded (and its waveforms merged) into its own buffer by a
+   * separate TBB task; the buffers are then concatenated in input order.
+   * The waveforms are not sorted: that is left to the caller (`produce()`
+   * sorts them serially, as in serial mode).
+   * No data tree must be enabled in this mode, since tree filling is not
+   * thread-safe.
+   */
+  std::vector<raw::OpDetWaveform> processBoardFragmentsConcurrently(
+    std::vector<artdaq::FragmentPtrs> const& boardFragments,
+    TriggerInfo_t const& triggerInfo
+    );
+  
+  /**
+   * @brief Checks that `waveforms` are the same as from serial decoding.
+   * @param waveforms waveforms from `processBoardFragmentsConcurrently()`
+   * @param boardFragments the fragments `waveforms` were decoded from
+   * @param triggerInfo information on the global trigger
+   * @throw cet::exception (category: `DaqDecoderICARUSPMT`) on any difference
+   * 
+   * The boards are decoded again one after the other, and the result must
+   * have the same waveforms in the same order, with the same channel, time
+   * stamp and samples.
+   */
+  void checkConcurrentDecoding(
+    std::vector<raw::OpDetWaveform> const& waveforms,
+    std::vector<artdaq::FragmentPtrs> const& boardFragments,
+    TriggerInfo_t const& triggerInfo
+    );
+  
+  /// Returns the number of channels the digitizer of the fragment is mapped to.
+  std::size_t expectedBoardChannels
+    (artdaq::Fragment::fragment_id_t fragment_id) const;
+  
+  
   // --- END ---- Input data management ----------------------------------------
   
   
@@ -1101,6 +1175,8 @@ icarus::DaqDecoderICARUSPMT::DaqDecoderICARUSPMT(Parameters const& params)
       .value_or(fTriggerTag.has_value())
     }
   , fBoardSetup{ params().BoardSetup() }
+  , fConcurrentBoards{ params().ConcurrentBoards() }
+  , fCheckConcurrentBoards{ params().CheckConcurrentBoards() }
   , fLogCategory{ params().LogCategory() }
   , fDetTimings
     { art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob() }
@@ -1176,6 +1252,18 @@ icarus::DaqDecoderICARUSPMT::DaqDecoderICARUSPMT(Parameters const& params)
       << params().PMTconfigTag.name() << "`"
       ;
   }
+  if (fConcurrentBoards) {
+    if (fTreeFragment) {
+      log << "\n * readout boards are decoded serially"
+        " (`" << params().ConcurrentBoards.name() << "` is ignored"
+        " because data trees are requested)";
+    }
+    else {
+      log << "\n * readout boards are decoded in parallel";
+      if (fCheckConcurrentBoards)
+        log << " (and serially, to check the result)";
+    }
+  }
   
   
   //
@@ -1255,14 +1343,21 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
   // processing
   //
   
+  // trees are filled while decoding, and that can't happen concurrently
+  bool const concurrent = fConcurrentBoards && !fTreeFragment;
+  
   std::unordered_map<BoardID_t, unsigned int> boardCounts;
   bool duplicateBoards = false;
   try { // catch-all
     auto const& fragments = readInputFragments(event);
     
+    // in concurrent mode, collect all the boards first and decode them later
+    std::vector<artdaq::FragmentPtrs> boardFragments;
+    if (concurrent) boardFragments.reserve(fragments.size());
+    
     for (artdaq::Fragment const& fragment: fragments) {
       
-      artdaq::FragmentPtrs const& fragmentCollection
+      artdaq::FragmentPtrs fragmentCollection
         = makeFragmentCollection(fragment);
       
       if (empty(fragmentCollection)) {
@@ -1276,6 +1371,11 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
         = extractFragmentBoardID(*(fragmentCollection.front()));
       if (++boardCounts[boardID] > 1U) duplicateBoards = true;
       
+      if (concurrent) {
+        boardFragments.push_back(std::move(fragmentCollection));
+        continue;
+      }
+      
       appendTo(
         opDetWaveforms,
         processBoardFragments(fragmentCollection, triggerInfo)
@@ -1283,6 +1383,13 @@ void icarus::DaqDecoderICARUSPMT::produce(art::Event& event) {
       
     } // for all input fragments
     
+    if (concurrent) {
+      opDetWaveforms
+        = processBoardFragmentsConcurrently(boardFragments, triggerInfo);
+      if (fCheckConcurrentBoards)
+        checkConcurrentDecoding(opDetWaveforms, boardFragments, triggerInfo);
+    }
+    
   }
   catch (cet::exception const& e) {
     if (!fSurviveExceptions) throw;
@@ -1719,17 +1826,117 @@ auto icarus::DaqDecoderICARUSPMT::processBoardFragments(
     << " - " << boardInfo.name << ": " << artdaqFragments.size()
     << " fragments";
   
+  // presize the buffer for one waveform per mapped channel per fragment
   std::vector<raw::OpDetWaveform> waveforms;
-  for (artdaq::FragmentPtr const& fragment: artdaqFragments)
-    appendTo(waveforms, processFragment(*fragment, boardInfo, triggerInfo));
+  waveforms.reserve(
+    artdaqFragments.size() * expectedBoardChannels(referenceFragment.fragmentID())
+    );
+  for (artdaq::FragmentPtr const& fragment: artdaqFragments) {
+    std::vector<raw::OpDetWaveform> fragmentWaveforms
+      = processFragment(*fragment, boardInfo, triggerInfo);
+    std::move(fragmentWaveforms.begin(), fragmentWaveforms.end(),
+      std::back_inserter(waveforms));
+  } // for
   
   mergeWaveforms(waveforms);
   
-  return { waveforms };
+  return waveforms;
   
 } // icarus::DaqDecoderICARUSPMT::processBoardFragments()
 
 
+//------------------------------------------------------------------------------
+auto icarus::DaqDecoderICARUSPMT::processBoardFragmentsConcurrently(
+  std::vector<artdaq::FragmentPtrs> const& boardFragments,
+  TriggerInfo_t const& triggerInfo
+) -> std::vector<raw::OpDetWaveform> {
+  
+  assert(!fTreeFragment); // tree filling is not thread-safe
+  
+  // each board gets its own buffer: no synchronization is needed
+  std::vector<std::vector<raw::OpDetWaveform>> boardWaveforms
+    (boardFragments.size());
+  
+  tbb::parallel_for(
+    tbb::blocked_range<std::size_t>(0U, boardFragments.size()),
+    [this, &boardFragments, &boardWaveforms, &triggerInfo]
+      (tbb::blocked_range<std::size_t> const& range)
+      {
+        for (std::size_t iBoard = range.begin(); iBoard < range.end(); ++iBoard)
+        {
+          boardWaveforms[iBoard]
+            = processBoardFragments(boardFragments[iBoard], triggerInfo);
+        }
+      }
+    );
+  
+  // collect the buffers in input order, as the serial decoding would
+  std::size_t nWaveforms = 0U;
+  for (std::vector<raw::OpDetWaveform> const& waveforms: boardWaveforms)
+    nWaveforms += waveforms.size();
+  
+  std::vector<raw::OpDetWaveform> allWaveforms;
+  allWaveforms.reserve(nWaveforms);
+  for (std::vector<raw::OpDetWaveform>& waveforms: boardWaveforms) {
+    std::move(waveforms.begin(), waveforms.end(),
+      std::back_inserter(allWaveforms));
+  }
+  
+  return allWaveforms;
+  
+} // icarus::DaqDecoderICARUSPMT::processBoardFragmentsConcurrently()
+
+
+//------------------------------------------------------------------------------
+void icarus::DaqDecoderICARUSPMT::checkConcurrentDecoding(
+  std::vector<raw::OpDetWaveform> const& waveforms,
+  std::vector<artdaq::FragmentPtrs> const& boardFragments,
+  TriggerInfo_t const& triggerInfo
+) {
+  
+  std::vector<raw::OpDetWaveform> serialWaveforms;
+  for (artdaq::FragmentPtrs const& fragments: boardFragments)
+    appendTo(serialWaveforms, processBoardFragments(fragments, triggerInfo));
+  
+  if (serialWaveforms.size() != waveforms.size()) {
+    throw cet::exception("DaqDecoderICARUSPMT")
+      << "Concurrent decoding produced " << waveforms.size()
+      << " waveforms, serial decoding " << serialWaveforms.size() << ".\n";
+  }
+  
+  for (auto const& [ iWaveform, serial ]: util::enumerate(serialWaveforms)) {
+    raw::OpDetWaveform const& waveform = waveforms[iWaveform];
+    if ((waveform.ChannelNumber() == serial.ChannelNumber())
+      && (waveform.TimeStamp() == serial.TimeStamp())
+      && std::equal
+        (waveform.begin(), waveform.end(), serial.begin(), serial.end())
+    ) {
+      continue;
+    }
+    throw cet::exception("DaqDecoderICARUSPMT")
+      << "Concurrent decoding differs from serial decoding at waveform #"
+      << iWaveform << ": channel " << waveform.ChannelNumber() << " at "
+      << waveform.TimeStamp() << " with " << waveform.size()
+      << " samples instead of channel " << serial.ChannelNumber() << " at "
+      << serial.TimeStamp() << " with " << serial.size() << " samples.\n";
+  } // for
+  
+  mf::LogTrace(fLogCategory) << "Concurrent decoding of "
+    << boardFragments.size() << " boards matches the serial one.";
+  
+} // icarus::DaqDecoderICARUSPMT::checkConcurrentDecoding()
+
+
+//------------------------------------------------------------------------------
+std::size_t icarus::DaqDecoderICARUSPMT::expectedBoardChannels
+  (artdaq::Fragment::fragment_id_t fragment_id) const
+{
+  std::size_t const eff_fragment_id = effectivePMTboardFragmentID(fragment_id);
+  return fChannelMap.hasPMTDigitizerID(eff_fragment_id)
+    ? fChannelMap.getChannelIDPairVec(eff_fragment_id).size(): 0U;
+} // icarus::DaqDecoderICARUSPMT::expectedBoardChannels()
+
+
 //------------------------------------------------------------------------------
 auto icarus::DaqDecoderICARUSPMT::processFragment(
   artdaq::Fragment const& artdaqFragment,
@@ -1786,6 +1993,8 @@ auto icarus::DaqDecoderICARUSPMT::createFragmentWaveforms
   if (diagOut)
     (*diagOut) << "      " << digitizerChannelVec.size() << " channels:";
   
+  opDetWaveforms.reserve(digitizerChannelVec.size());
+  
   // allocate the vector outside the loop since we'll reuse it over and over
   std::vector<std::uint16_t> wvfm(fragInfo.nSamplesPerChannel);
 
@@ -29,7 +29,7 @@
 #include "lardataobj/Simulation/BeamGateInfo.h"
 
 // Framework includes
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Utilities/make_tool.h"
 #include "art/Framework/Principal/DataViewImpl.h"
@@ -53,8 +53,15 @@
 #include "TTree.h"
 #include "TMath.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 #include <cmath>
 #include <string>
 #include <map>
@@ -65,10 +72,10 @@ namespace ophit{
 
 //class OpHitFinderICARUS;
 
-class OpHitFinderICARUS : public art::EDProducer
+class OpHitFinderICARUS : public art::SharedProducer
 {
 public:
-    explicit OpHitFinderICARUS(fhicl::ParameterSet const & p);
+    explicit OpHitFinderICARUS(fhicl::ParameterSet const & p, art::ProcessingFrame const&);
     // The compiler-generated destructor is fine for non-base
     // classes without bare pointers or other resource use.
 
@@ -79,32 +86,50 @@ public:
     OpHitFinderICARUS& operator = (OpHitFinderICARUS &&)       = delete;
 
     // Required functions.
-    void produce(art::Event & e) override;
+    void produce(art::Event & e, art::ProcessingFrame const&) override;
 
 private:
 
-    size_t fEvNumber;
+    using IOpHitFinderPtr = std::unique_ptr<light::IOpHitFinder>;
+
+    // Creates a hit finder tool (the tools keep state, so each thread has its own)
+    IOpHitFinderPtr makeOpHitFinder() const;
 
     std::string fInputModuleName;
+    bool        fParallelWaveforms;  ///< Find the hits of the waveforms of an event in parallel (reentrant tools only)
     
-    std::unique_ptr<light::IOpHitFinder> fOpHitFinder;
+    fhicl::ParameterSet                                   fOpHitFinderPSet;
+    mutable std::mutex                                    fToolMutex;     ///< Serializes the creation of the tools
+    mutable tbb::enumerable_thread_specific<IOpHitFinderPtr> fOpHitFinders;  ///< One hit finder tool per thread
 };
 
-OpHitFinderICARUS::OpHitFinderICARUS(fhicl::ParameterSet const & p) : EDProducer{p}
+OpHitFinderICARUS::OpHitFinderICARUS(fhicl::ParameterSet const & p, art::ProcessingFrame const&)
+    : art::SharedProducer{p}
+    , fOpHitFinders{[this](){ return makeOpHitFinder(); }}
 {
     produces<std::vector<recob::OpHit>>();
 
-    fInputModuleName = p.get< std::string >("InputModule" );
+    fInputModuleName   = p.get< std::string >("InputModule" );
+    fParallelWaveforms = p.get< bool        >("ParallelWaveforms", false);
+    fOpHitFinderPSet   = p.get<fhicl::ParameterSet>("OpHitFinder");
     
-    fOpHitFinder = art::make_tool<light::IOpHitFinder> (p.get<fhicl::ParameterSet>("OpHitFinder"));
+    // The tool of this thread is created now, so that configuration errors show up at construction
+    fOpHitFinders.local();
+
+    // Events are processed one at a time: OpHitFinderStandard fits through ROOT's global function list
+    serialize<art::InEvent>();
 }
 
-void OpHitFinderICARUS::produce(art::Event & e)
+OpHitFinderICARUS::IOpHitFinderPtr OpHitFinderICARUS::makeOpHitFinder() const
 {
-    std::cout << "My module on event #" << e.id().event() << std::endl;
+    std::lock_guard<std::mutex> lock(fToolMutex);
+
+    return art::make_tool<light::IOpHitFinder>(fOpHitFinderPSet);
+}
 
-    //art::ServiceHandle<art::TFileService> tfs;
-    fEvNumber = e.id().event();
+void OpHitFinderICARUS::produce(art::Event & e, art::ProcessingFrame const&)
+{
+    std::cout << "My module on event #" << e.id().event() << std::endl;
 
     std::unique_ptr<std::vector<recob::OpHit>> pulseVecPtr(std::make_unique<std::vector<recob::OpHit>>());  
 
@@ -118,16 +143,34 @@ void OpHitFinderICARUS::produce(art::Event & e)
 
     std::cout << "Dimensione primo " << wfHandle->size() << std::endl; 
 
-//    for(size_t wftime; wftime< wfHandle.size(); wftime++)
-    for(auto const& wvf : (*wfHandle))
+    std::vector<raw::OpDetWaveform> const& waveforms = *wfHandle;
+
+    // The hits of each waveform are collected separately and then concatenated
+    // in waveform order, so the output does not depend on the scheduling
+    std::vector<light::OpHitVec> opHitVecs(waveforms.size());
+
+    auto findOpHits = [this, &waveforms, &opHitVecs](tbb::blocked_range<size_t> const& range)
     {
-        light::OpHitVec opHitVec;
-        
-        fOpHitFinder->FindOpHits(wvf, opHitVec);
-        
-        for(auto& opHit : opHitVec)
-            pulseVecPtr->emplace_back(opHit);
-    }
+        light::IOpHitFinder const& opHitFinder = *fOpHitFinders.local();
+
+        for(size_t wfIdx = range.begin(); wfIdx < range.end(); wfIdx++)
+            opHitFinder.FindOpHits(waveforms[wfIdx], opHitVecs[wfIdx]);
+    };
+
+    tbb::blocked_range<size_t> const allWaveforms(0, waveforms.size());
+
+    if (fParallelWaveforms) tbb::parallel_for(allWaveforms, findOpHits);
+    else                    findOpHits(allWaveforms);
+
+    size_t nOpHits(0);
+
+    for(auto const& opHitVec : opHitVecs) nOpHits += opHitVec.size();
+
+    pulseVecPtr->reserve(nOpHits);
+
+    for(auto& opHitVec : opHitVecs)
+        std::move(opHitVec.begin(), opHitVec.end(), std::back_inserter(*pulseVecPtr));
+
     // Store results into the event
     e.put(std::move(pulseVecPtr));
 }
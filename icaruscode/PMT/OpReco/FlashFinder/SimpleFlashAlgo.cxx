@@ -2,6 +2,7 @@
 #define SIMPLEFLASHALGO_CXX
 
 #include "SimpleFlashAlgo.h"
+#include <algorithm>
 #include <set>
 namespace pmtana{
     
@@ -112,10 +113,6 @@ namespace pmtana{
         size_t max_ch = _opch_to_index_v.size() - 1;
         size_t NOpDet = _index_to_opch_v.size();
         
-        //static std::vector<double> pesum_v;
-        static std::vector<double> mult_v;  //< this is not strictly a multiplicity of PMTs, but multiplicity of hits
-        static std::vector<std::vector<double> > pespec_v;
-        static std::vector<std::vector<unsigned int> > hitidx_v;
         double min_time=1.1e20;
         double max_time=1.1e20;
         for(auto const& oph : ophits) {
@@ -128,16 +125,15 @@ namespace pmtana{
             std::cout << "T span: " << min_time << " => " << max_time << " ... " << (size_t)((max_time - min_time) / _time_res) << std::endl;
         
         size_t nbins_pesum_v = (size_t)((max_time - min_time) / _time_res) + 1;
-        if(_pesum_v.size() < nbins_pesum_v) _pesum_v.resize(nbins_pesum_v,0);
-        if(mult_v.size()   < nbins_pesum_v) mult_v.resize(nbins_pesum_v,0);
-        if(pespec_v.size() < nbins_pesum_v) pespec_v.resize(nbins_pesum_v,std::vector<double>(NOpDet));
-        if(hitidx_v.size() < nbins_pesum_v) hitidx_v.resize(nbins_pesum_v,std::vector<unsigned int>());
-        for(size_t i=0; i<_pesum_v.size(); ++i) {
-            _pesum_v[i] = 0;
-            mult_v[i]  = 0;
-            hitidx_v[i].clear();
-            for(auto& v : pespec_v[i]) v=0;
-        }
+        if(_pesum_v.size()  < nbins_pesum_v) _pesum_v.resize(nbins_pesum_v,0);
+        if(_mult_v.size()   < nbins_pesum_v) _mult_v.resize(nbins_pesum_v,0);
+        if(_hitidx_v.size() < nbins_pesum_v) _hitidx_v.resize(nbins_pesum_v);
+        // only the bins of this call are reset and used; bins past them are
+        // left untouched (the PE sum array is still fully cleared for PESumArray())
+        std::fill(_pesum_v.begin(), _pesum_v.end(), 0.);
+        std::fill(_mult_v.begin(), _mult_v.begin() + nbins_pesum_v, 0.);
+        for(size_t i=0; i<nbins_pesum_v; ++i) _hitidx_v[i].clear();
+        _pespec_v.assign(nbins_pesum_v * NOpDet, 0.);
         
         // Fill _pesum_v
         for(size_t hitidx = 0; hitidx < ophits.size(); ++hitidx) {
@@ -154,18 +150,27 @@ namespace pmtana{
 	    if(_min_pe_hit > 0. && oph.pe < _min_pe_hit) continue;
             size_t index = (size_t)((oph.peak_time - min_time) / _time_res);
             _pesum_v[index] += oph.pe;
-            mult_v[index] += 1;
-            pespec_v[index][_opch_to_index_v[oph.channel]] += oph.pe;
-            hitidx_v[index].push_back(hitidx);
+            _mult_v[index] += 1;
+            _pespec_v[index * NOpDet + _opch_to_index_v[oph.channel]] += oph.pe;
+            _hitidx_v[index].push_back(hitidx);
         }
         
-        // Order by pe (above threshold)
-        std::map<double,size_t> pesum_idx_map;
+        // Order by pe (above threshold):
+        // sorted by 1/PE, and for equal keys only the latest bin is kept
+        // (the behaviour of the tree map this replaces)
+        _pesum_idx_v.clear();
         for(size_t idx=0; idx<nbins_pesum_v; ++idx) {
             if(_pesum_v[idx] < _min_pe_coinc   ) continue;
-            if(mult_v[idx]  < _min_mult_coinc ) continue;
-            pesum_idx_map[1./(_pesum_v[idx])] = idx;
+            if(_mult_v[idx]  < _min_mult_coinc ) continue;
+            _pesum_idx_v.emplace_back(1./(_pesum_v[idx]), idx);
         }
+        std::sort(_pesum_idx_v.begin(), _pesum_idx_v.end(),
+                  [](auto const& a, auto const& b)
+                  { return (a.first != b.first)? a.first < b.first: a.second > b.second; });
+        _pesum_idx_v.erase(std::unique(_pesum_idx_v.begin(), _pesum_idx_v.end(),
+                                       [](auto const& a, auto const& b)
+                                       { return a.first == b.first; }),
+                           _pesum_idx_v.end());
         
         // Get candidate flash times
         std::vector<std::pair<size_t,size_t> > flash_period_v;
@@ -173,13 +178,13 @@ namespace pmtana{
         size_t veto_ctr = (size_t)(_veto_time / _time_res);
         size_t default_integral_ctr = (size_t)(_integral_time / _time_res);
         size_t precount = (size_t)(_pre_sample / _time_res);
-        flash_period_v.reserve(pesum_idx_map.size());
-        flash_time_v.reserve(pesum_idx_map.size());
+        flash_period_v.reserve(_pesum_idx_v.size());
+        flash_time_v.reserve(_pesum_idx_v.size());
         
         double sum_baseline = 0;
         //for(auto const& v : _pe_baseline_v) sum_baseline += v;
         
-        for(auto const& pe_idx : pesum_idx_map) {
+        for(auto const& pe_idx : _pesum_idx_v) {
             
             //auto const& pe  = 1./(pe_idx.first);
             auto const& idx = pe_idx.second;
@@ -246,11 +251,12 @@ namespace pmtana{
             auto const& time   = flash_time_v[flash_idx];
             
             std::vector<double> pe_v(max_ch+1,0);
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
+            for(size_t index=start; index<(start+period) && index<nbins_pesum_v; ++index) {
                 
+                double const* pespec = _pespec_v.data() + index * NOpDet;
                 for(size_t pmt_index=0; pmt_index<NOpDet; ++pmt_index)
                     
-                    pe_v[_index_to_opch_v[pmt_index]] += pespec_v[index][pmt_index];
+                    pe_v[_index_to_opch_v[pmt_index]] += pespec[pmt_index];
                 
             }
             
@@ -265,8 +271,8 @@ namespace pmtana{
             }
             
             std::vector<unsigned int> asshit_v;
-            for(size_t index=start; index<(start+period) && index<pespec_v.size(); ++index) {
-                for(auto const& idx : hitidx_v[index])
+            for(size_t index=start; index<(start+period) && index<nbins_pesum_v; ++index) {
+                for(auto const& idx : _hitidx_v[index])
                     asshit_v.push_back(idx);
             }
             
@@ -56,6 +56,12 @@ namespace pmtana
     // pw aum array
     std::vector<double> _pesum_v;
 
+    // per-instance work buffers (reused across calls, indexed by time bin)
+    std::vector<double> _mult_v;  //< multiplicity of hits (not of PMTs)
+    std::vector<double> _pespec_v; //< PE per bin and opdet index (flattened)
+    std::vector<std::vector<unsigned int> > _hitidx_v;
+    std::vector<std::pair<double,size_t> > _pesum_idx_v; //< (1/PE, bin) candidates
+
     // calibration: PEs to be subtracted from each opdet
     std::vector<double> _pe_baseline_v;
 
@@ -11,6 +11,7 @@
 #include "cetlib_except/exception.h"
 
 #include "icaruscode/PMT/OpticalTools/IOpHitFinder.h"
+#include "icaruscode/Utilities/ADCCountHistogram.h"
 #include "larreco/HitFinder/HitFinderTools/ICandidateHitFinder.h"
 
 #include <cmath>
@@ -165,36 +166,11 @@ void OpHitFinder::FindOpHits(const raw::OpDetWaveform& opDetWaveform,
 
 float OpHitFinder::getBaseline(const raw::OpDetWaveform& locWaveform) const
 {
-    // Fill a map to determine the most probable value
-    std::map<raw::ADC_Count_t,int> adcFrequencyMap;
+    // Histogram the ADC counts to determine the most probable value
+    icarus::ns::util::ADCCountHistogram<raw::ADC_Count_t> const adcCounts(locWaveform.begin(),locWaveform.end());
     
-    raw::ADC_Count_t maxBin(0);
-    int              maxCount(0);
-    
-    for(const auto& adc : locWaveform)
-    {
-        int& adcFrequency = adcFrequencyMap[adc];
-        
-        if (++adcFrequency > maxCount)
-        {
-            maxBin   = adc;
-            maxCount = adcFrequency;
-        }
-    }
-    
-    float mostProbableBaseline(0.);
-    int   mostProbableCount(0);
-    
-    for(raw::ADC_Count_t adcBin = maxBin - 3; adcBin <= maxBin + 3; adcBin++)
-    {
-        try{
-            mostProbableBaseline += adcFrequencyMap.at(adcBin) * float(adcBin);
-            mostProbableCount    += adcFrequencyMap.at(adcBin);
-        }
-        catch(...) {}
-    }
-    
-    mostProbableBaseline /= mostProbableCount;
+    // The baseline is the average of the values within 3 counts of it
+    float mostProbableBaseline = adcCounts.sumsAround(adcCounts.mode(), 3).mean();
    
     return mostProbableBaseline;
 }
@@ -10,6 +10,7 @@
 #include "sbnobj/Common/PMT/Data/V1730Configuration.h"
 #include "sbnobj/Common/PMT/Data/V1730channelConfiguration.h"
 #include "sbnobj/ICARUS/PMT/Data/WaveformBaseline.h"
+#include "icaruscode/Utilities/ADCCountHistogram.h"
 // #include "icaruscode/Utilities/DataProductPointerMap.h"
 
 // LArSoft libraries
@@ -255,13 +256,12 @@ namespace {
     
     using value_type = typename BIter::value_type;
     
-    std::vector<value_type> data{ begin, end };
-    assert(!data.empty());
+    // ADC counts are integral and in a limited range: counting them is cheaper
+    // than copying and partially sorting them
+    icarus::ns::util::ADCCountHistogram<value_type> const counts{ begin, end };
+    assert(!counts.empty());
     
-    auto const middle = data.begin() + data.size() / 2;
-    std::nth_element(data.begin(), middle, data.end());
-    
-    return *middle;
+    return counts.median();
     
   } // median()
   
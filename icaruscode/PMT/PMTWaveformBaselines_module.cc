@@ -7,6 +7,8 @@
 
 // ICARUS libraries
 #include "sbnobj/ICARUS/PMT/Data/WaveformBaseline.h"
+#include "icaruscode/Utilities/ADCCountHistogram.h"
+#include "icaruscode/Utilities/RunningADCMedian.h"
 // #include "icaruscode/Utilities/DataProductPointerMap.h"
 
 // LArSoft libraries
@@ -38,8 +40,10 @@
 
 // C/C++ standard libraries
 #include <vector>
-#include <algorithm> // std::partial_sort_copy()
+#include <algorithm> // std::partial_sort_copy(), std::stable_sort()
 #include <iterator> // std::distance()
+#include <numeric> // std::iota()
+#include <deque>
 #include <memory> // std::make_unique(), std::allocator
 #include <string>
 #include <cmath> // std::ceil()
@@ -54,8 +58,11 @@ namespace icarus { class PMTWaveformBaselines; }
  * This module produces a baseline data product for each optical detector
  * waveform.
  * 
- * The waveforms on the same channels are currently treated as independent
- * (which is less than ideal).
+ * By default, the waveforms on the same channels are treated as independent
+ * (which is less than ideal). If `RunningBaselineSamples` is set, the baseline
+ * of each waveform is instead the median of the last samples on its channel
+ * in the event, including the ones of the earlier waveforms on that channel
+ * (waveforms are considered in order of time stamp).
  * 
  * 
  * Output data products
@@ -110,6 +117,10 @@ namespace icarus { class PMTWaveformBaselines; }
  *   of the extracted baselines.
  * * `BaselineTimeAverage` (real number, default: `600.0`): binning of the
  *   baseline profile vs. time, in seconds. Requires `PlotBaselines` to be set.
+ * * `RunningBaselineSamples` (integer, default: `0`): if not `0`, the baseline
+ *   of each waveform is the median of the last `RunningBaselineSamples`
+ *   samples on the same channel up to the end of that waveform; otherwise,
+ *   the median of the samples of each waveform alone is used.
  * 
  */
 class icarus::PMTWaveformBaselines: public art::EDProducer {
@@ -146,6 +157,15 @@ class icarus::PMTWaveformBaselines: public art::EDProducer {
       600.0
       };
     
+    fhicl::Atom<unsigned int> RunningBaselineSamples {
+      Name("RunningBaselineSamples"),
+      Comment(
+        "if not 0, baseline is the median of these many last samples"
+        " on the channel, across waveforms"
+        ),
+      0U
+      };
+    
   }; // struct Config
   
   using Parameters = art::EDProducer::Table<Config>;
@@ -183,6 +203,9 @@ class icarus::PMTWaveformBaselines: public art::EDProducer {
   /// Width of baseline time profile binning [s]
   double const fBaselineTimeAverage { 0.0 };
   
+  /// Samples in the running baseline (`0`: waveform by waveform).
+  unsigned int const fRunningBaselineSamples;
+  
   std::string const fLogCategory; ///< Category name for the console output stream.
   
   // --- END Configuration variables -------------------------------------------
@@ -214,6 +237,10 @@ class icarus::PMTWaveformBaselines: public art::EDProducer {
   icarus::WaveformBaseline baselineFromMedian
     (raw::OpDetWaveform const& waveform) const;
   
+  /// Returns the running baseline of each of the `waveforms`, in their order.
+  std::vector<icarus::WaveformBaseline> runningBaselines
+    (std::vector<raw::OpDetWaveform> const& waveforms) const;
+  
 }; // icarus::PMTWaveformBaselines
 
 
@@ -229,13 +256,12 @@ namespace {
     
     using value_type = typename BIter::value_type;
     
-    std::vector<value_type> data{ begin, end };
-    assert(!data.empty());
-    
-    auto const middle = data.begin() + data.size() / 2;
-    std::nth_element(data.begin(), middle, data.end());
+    // ADC counts are integral and in a limited range: counting them is cheaper
+    // than copying and partially sorting them
+    icarus::ns::util::ADCCountHistogram<value_type> const counts{ begin, end };
+    assert(!counts.empty());
     
-    return *middle;
+    return counts.median();
     
   } // median()
   
@@ -252,6 +278,7 @@ icarus::PMTWaveformBaselines::PMTWaveformBaselines
   , fOpDetWaveformTag(config().OpticalWaveforms())
   , fPlotBaselines(config().PlotBaselines())
   , fBaselineTimeAverage(config().BaselineTimeAverage())
+  , fRunningBaselineSamples(config().RunningBaselineSamples())
   , fLogCategory(config().OutputCategory())
 {
   //
@@ -261,9 +288,17 @@ icarus::PMTWaveformBaselines::PMTWaveformBaselines
   //
   // configuration report (currently, more like a placeholder)
   //
-  mf::LogInfo(fLogCategory)
-    << "Using the standard (median) algorithm, waveform by waveform, on '"
-    << fOpDetWaveformTag.encode() << "'.";
+  if (fRunningBaselineSamples > 0U) {
+    mf::LogInfo(fLogCategory)
+      << "Using the running median algorithm on the last "
+      << fRunningBaselineSamples << " samples of each channel, on '"
+      << fOpDetWaveformTag.encode() << "'.";
+  }
+  else {
+    mf::LogInfo(fLogCategory)
+      << "Using the standard (median) algorithm, waveform by waveform, on '"
+      << fOpDetWaveformTag.encode() << "'.";
+  }
   
   //
   // declaration of input
@@ -315,6 +350,10 @@ void icarus::PMTWaveformBaselines::produce(art::Event& event) {
   std::vector<icarus::WaveformBaseline> baselines;
   baselines.reserve(waveforms.size());
   
+  std::vector<icarus::WaveformBaseline> const running
+    = (fRunningBaselineSamples > 0U)
+    ? runningBaselines(waveforms): std::vector<icarus::WaveformBaseline>{};
+  
   std::vector<lar::util::StatCollector<double>> averages;
   if (fHBaselines || !fBaselinesVsTime.empty())
     averages.resize(fNPlotChannels);
@@ -326,7 +365,8 @@ void icarus::PMTWaveformBaselines::produce(art::Event& event) {
   for (auto const& [ iWaveform, waveform ]: util::enumerate(waveforms)) {
     assert(iWaveform == baselines.size());
     
-    icarus::WaveformBaseline const baseline { baselineFromMedian(waveform) };
+    icarus::WaveformBaseline const baseline = running.empty()
+      ? baselineFromMedian(waveform): running[iWaveform];
     
     if (!averages.empty())
       averages[waveform.ChannelNumber()].add(baseline.baseline());
@@ -424,8 +464,10 @@ void icarus::PMTWaveformBaselines::buildBaselineGraphs() {
     if (timeAndBaselines.empty()) continue;
     
     // sort by time (entries with the same time would be sorted by baseline,
-    // but that does not really happen nor it mattered if it happened)
-    std::sort(timeAndBaselines.begin(), timeAndBaselines.end());
+    // but that does not really happen nor it mattered if it happened);
+    // events are usually already in time order
+    if (!std::is_sorted(timeAndBaselines.begin(), timeAndBaselines.end()))
+      std::sort(timeAndBaselines.begin(), timeAndBaselines.end());
     
     // graph, one point per event
     auto* const graph = graphDir.makeAndRegister<TGraph>(
@@ -483,6 +525,62 @@ icarus::WaveformBaseline icarus::PMTWaveformBaselines::baselineFromMedian
 } // icarus::PMTWaveformBaselines::baselineFromMedian()
 
 
+//------------------------------------------------------------------------------
+std::vector<icarus::WaveformBaseline>
+icarus::PMTWaveformBaselines::runningBaselines
+  (std::vector<raw::OpDetWaveform> const& waveforms) const
+{
+  using ADC_t = raw::OpDetWaveform::value_type;
+  
+  // waveforms grouped by channel, each group in time order
+  std::vector<std::size_t> order(waveforms.size());
+  std::iota(order.begin(), order.end(), 0U);
+  std::stable_sort(order.begin(), order.end(),
+    [&waveforms](std::size_t a, std::size_t b)
+      {
+        raw::OpDetWaveform const& A = waveforms[a];
+        raw::OpDetWaveform const& B = waveforms[b];
+        return (A.ChannelNumber() != B.ChannelNumber())
+          ? (A.ChannelNumber() < B.ChannelNumber())
+          : (A.TimeStamp() < B.TimeStamp());
+      }
+    );
+  
+  std::vector<float> values(waveforms.size(), 0.0f);
+  
+  icarus::ns::util::RunningADCMedian<ADC_t> median;
+  std::deque<ADC_t> window; // the samples currently in `median`, in order
+  raw::Channel_t channel = raw::Channel_t(-1);
+  for (std::size_t const iWaveform: order) {
+    raw::OpDetWaveform const& waveform = waveforms[iWaveform];
+    
+    if (window.empty() || (waveform.ChannelNumber() != channel)) {
+      channel = waveform.ChannelNumber();
+      median.clear();
+      window.clear();
+    }
+    
+    for (ADC_t const sample: waveform) {
+      median.add(sample);
+      window.push_back(sample);
+      if (window.size() > fRunningBaselineSamples) {
+        median.remove(window.front());
+        window.pop_front();
+      }
+    } // for samples
+    
+    if (!median.empty()) values[iWaveform] = median.median();
+    
+  } // for waveforms
+  
+  std::vector<icarus::WaveformBaseline> baselines;
+  baselines.reserve(values.size());
+  for (float const value: values) baselines.emplace_back(value);
+  return baselines;
+  
+} // icarus::PMTWaveformBaselines::runningBaselines()
+
+
 //------------------------------------------------------------------------------
 DEFINE_ART_MODULE(icarus::PMTWaveformBaselines)
 
@@ -51,6 +51,10 @@ namespace icarus::trigger {
  * The algorithm keeps track at each time of which are the thresholds enclosing
  * the signal level, and if the level crosses one of them, the gates associated
  * to those thresholds, and only them, are offered a chance to react.
+ * 
+ * All the thresholds are evaluated in a single pass on each waveform, with
+ * the thresholds converted into cuts on the raw ADC samples.
+ * The channels are processed in parallel.
  */
 class icarus::trigger::ManagedTriggerGateBuilder
   : public icarus::trigger::TriggerGateBuilder
@@ -101,6 +105,18 @@ class icarus::trigger::ManagedTriggerGateBuilder
     (std::vector<GateInfo>& channelGates, Waveforms const& channelWaveforms)
     const;
   
+  /**
+   * @brief Returns the thresholds as cuts on the raw samples of a waveform.
+   * @tparam WaveformOps type of waveform operations (negative polarity)
+   * @param waveOps operations on the waveform, including its baseline
+   * @return the largest raw sample passing each threshold, sorted as them
+   * 
+   * A raw sample passes a threshold if, after subtraction of the baseline and
+   * rounding, it is at or above that threshold.
+   */
+  template <typename WaveformOps>
+  std::vector<int> rawSampleThresholds(WaveformOps const& waveOps) const;
+  
 }; // class icarus::trigger::ManagedTriggerGateBuilder
 
 
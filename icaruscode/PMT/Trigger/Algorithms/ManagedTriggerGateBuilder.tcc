@@ -19,6 +19,7 @@
 
 // ICARUS libraries
 #include "icaruscode/PMT/Trigger/Algorithms/TriggerTypes.h" // icarus::trigger::ADCCounts_t
+#include "icaruscode/PMT/Trigger/Algorithms/details/ThresholdCrossings.h"
 #include "sbnobj/ICARUS/PMT/Trigger/Data/SingleChannelOpticalTriggerGate.h"
 #include "icarusalg/Utilities/WaveformOperations.h"
 
@@ -31,13 +32,17 @@
 #include "messagefacility/MessageLogger/MessageLogger.h" // MF_LOG_TRACE()
 
 // range library
-#include "range/v3/view/group_by.hpp"
+#include "range/v3/view/subrange.hpp"
+
+// TBB libraries
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 
 // C/C++ standard libraries
-#include <optional>
-#include <iterator> // std::next(), std::prev()
-#include <cmath> // std::round()
-#include <cstddef> // std::ptrdiff_t
+#include <vector>
+#include <algorithm> // std::find_if()
+#include <type_traits> // std::decay_t
+#include <cstddef> // std::ptrdiff_t, std::size_t
 
 
 //------------------------------------------------------------------------------
@@ -48,31 +53,33 @@ auto icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild
   (GateMgr&& gateManager, std::vector<WaveformWithBaseline> const& waveforms)
   const -> std::vector<TriggerGates>
 {
-  using GateManager_t = GateMgr;
+  using GateManager_t = std::decay_t<GateMgr>;
   using GateInfo_t = typename GateManager_t::GateInfo_t;
+  using WaveformIter_t = std::vector<WaveformWithBaseline>::const_iterator;
   
   /*
    * This is the simple algorithm where each channel is treated independently,
    * and we have as many trigger gates as we have channels.
+   * 
+   * 1. the waveforms are grouped by channel, and the gates of all channels
+   *    are created (this changes the gate collections and is done serially)
+   * 2. the gates of each channel are built from its waveforms, independently
+   *    of the other channels, and in parallel
    */
   
   // create an empty TriggerGates object for each threshold;
   // thresholds are kept relative
   std::vector<TriggerGates> allGates = prepareAllGates();
   
+  //
+  // 1. group the waveforms by channel (must be already sorted!)
+  //    and create the gates of each channel
+  //
+  std::vector<ranges::subrange<WaveformIter_t>> byChannel;
   raw::Channel_t channel = raw::InvalidChannel;
-  
-  // now group the waveforms by channel (must be already sorted!)
-  // and process waveforms channel by channel
-  auto sameChannel
-    = [] (WaveformWithBaseline const& a, WaveformWithBaseline const& b)
-      { return a.waveform().ChannelNumber() == b.waveform().ChannelNumber(); }
-    ;
-  
-  auto byChannel = waveforms | ranges::views::group_by(sameChannel);
-  for (auto const& channelWaveforms: byChannel) {
+  for (auto itBegin = waveforms.cbegin(); itBegin != waveforms.cend(); ) {
     
-    auto const& firstWaveform = channelWaveforms.front().waveform();
+    auto const& firstWaveform = itBegin->waveform();
     
     // assert that the waveforms are sorted by channel and then by time
     // and not overlapping
@@ -80,30 +87,68 @@ auto icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild
       !raw::isValidChannel(channel)
       || (firstWaveform.ChannelNumber() >= channel)
       );
-    if (firstWaveform.ChannelNumber() != channel)
-      channel = firstWaveform.ChannelNumber();
-    
-    // we don't know how many... (maybe C++20 ranges will tell us)
-    MF_LOG_TRACE(details::TriggerGateDebugLog)
-      << "Building trigger gates from waveforms on channel " << channel;
+    channel = firstWaveform.ChannelNumber();
     
-    std::vector<GateInfo_t> channelGates;
-    channelGates.reserve(nChannelThresholds());
-    for (TriggerGates& thrGates: allGates) {
-      channelGates.push_back 
-        (gateManager.create(thrGates.gateFor(firstWaveform)));
-    }
+    auto const itEnd = std::find_if(itBegin, waveforms.cend(),
+      [channel](WaveformWithBaseline const& waveform)
+        { return waveform.waveform().ChannelNumber() != channel; }
+      );
+    byChannel.emplace_back(itBegin, itEnd);
     
-    // this method will update the channel gates referenced in `channelGates`,
-    // which are owned by `allGates`
-    buildChannelGates(channelGates, channelWaveforms);
+    for (TriggerGates& thrGates: allGates) thrGates.gateFor(firstWaveform);
     
+    itBegin = itEnd;
   } // for channels
   
+  //
+  // 2. process waveforms channel by channel; gates are not added any more,
+  //    so references to them stay valid
+  //
+  auto buildChannels = [this,&gateManager,&allGates,&byChannel]
+    (tbb::blocked_range<std::size_t> const& range)
+    {
+      for (std::size_t iChannel = range.begin(); iChannel < range.end();
+        ++iChannel
+      ) {
+        auto const& channelWaveforms = byChannel[iChannel];
+        raw::Channel_t const waveformChannel
+          = channelWaveforms.front().waveform().ChannelNumber();
+        
+        MF_LOG_TRACE(details::TriggerGateDebugLog)
+          << "Building trigger gates from " << channelWaveforms.size()
+          << " waveforms on channel " << waveformChannel;
+        
+        std::vector<GateInfo_t> channelGates;
+        channelGates.reserve(nChannelThresholds());
+        for (TriggerGates& thrGates: allGates) {
+          auto* pGate = thrGates.findGate(waveformChannel);
+          assert(pGate);
+          channelGates.push_back(gateManager.create(*pGate));
+        }
+        
+        // this method will update the channel gates referenced in
+        // `channelGates`, which are owned by `allGates`
+        buildChannelGates(channelGates, channelWaveforms);
+      } // for channels
+    };
+  
+  tbb::parallel_for
+    (tbb::blocked_range<std::size_t>{ 0U, byChannel.size() }, buildChannels);
+  
   return allGates;
 } // icarus::trigger::ManagedTriggerGateBuilder::unifiedBuild()
 
 
+//------------------------------------------------------------------------------
+template <typename WaveformOps>
+std::vector<int>
+icarus::trigger::ManagedTriggerGateBuilder::rawSampleThresholds
+  (WaveformOps const& waveOps) const
+{
+  return details::rawSampleCuts(waveOps, channelThresholds());
+} // icarus::trigger::ManagedTriggerGateBuilder::rawSampleThresholds()
+
+
 //------------------------------------------------------------------------------
 template <typename GateInfo, typename Waveforms>
 void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
@@ -113,6 +158,9 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
 {
   using ops = icarus::waveform_operations::NegativePolarityOperations<float>;
   
+  /// Number of samples tested together for threshold crossings.
+  constexpr std::size_t BlockSize = 32U;
+  
   if (channelWaveforms.empty()) return;
   
   //
@@ -127,12 +175,22 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
   optical_tick lastWaveformTick [[gnu::unused]]
     = timeStampToOpticalTick(firstWaveform.TimeStamp());
   
+  assert(channelGates.size() == nChannelThresholds());
+  
   /*
    * The algorithm finds gate openings and closing.
    * The actual actions on opening and closing depends on the gate info class.
    * For example, while a dynamic gate duration algorithm will perform open and
    * close operations directly, a fixed gate duration algorithm may perform
    * both opening and closing at open time, and nothing at all at closing time.
+   * 
+   * The thresholds are converted into cuts on the raw samples of each
+   * waveform, so that samples are compared to all thresholds at once with
+   * integer operations: a sample passes threshold `i` if it is not larger
+   * than `cuts[i]` (negative polarity).
+   * Between crossings, whole blocks of samples within the current pair of
+   * thresholds are skipped with a single branchless test
+   * (see `details::scanThresholdCrossings()`).
    */
   unsigned int nWaveforms = 0U;
   for (auto const& waveformData: channelWaveforms) {
@@ -141,15 +199,6 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
     
     ops const waveOps { waveformData.baseline().baseline() };
     
-    // baseline subtraction is performed in floating point,
-    // but then rounding is applied again
-    auto subtractBaseline = [waveOps](float sample) -> ADCCounts_t
-      {
-        return
-          ADCCounts_t::castFrom(std::round(waveOps.subtractBaseline(sample)));
-      };
-    
-    
     ++nWaveforms;
     assert(waveform.ChannelNumber() == channel);
     
@@ -169,145 +218,42 @@ void icarus::trigger::ManagedTriggerGateBuilder::buildChannelGates(
     assert(lastWaveformTick <= waveformTickStart);
     lastWaveformTick = waveformTickEnd;
     
-    auto const tbegin = channelThresholds().begin();
-    auto const tend = channelThresholds().end();
-    
     // register this waveform with the gates (this feature is unused here)
     for (auto& gateInfo: channelGates) gateInfo.gate().add(waveform);
     
-    // all gates start closed; this gate is not necessarily closed, but the
-    // waveform is not above the gate threshold any more.
-    auto nextGateToOpen = channelGates.begin();
-    
-    // we keep track of whether we have no lower or higher thresholds available
-    // to simplify the checks;
-    // we name them "pp" because they behave (almost) like pointers to pointers
-    #if defined( __GNUC__ )
-    # pragma GCC diagnostic push
-    # if (__GNUC__ <= 9) // last tested with: GCC 9.3.0
-    #  pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-    # else
-    #  error "Maintenance required here. See comments in the code"
-    /* [20210715 petrillo@slac.stanford.edu] The comments in the code:
-     * GCC 9.3.0 erroneously thinks that `ppXxxerThreshold` value _might_ be
-     * used before initialization. Due to the logic of the program, that is
-     * not the case (unless I am wrong!), and the only "solution" I have found
-     * is to disable the warning; Clang 7 on the other end does not complain.
-     * When GCC is updated and support for GCC 9 is dropped, this situation
-     * should be revisited by attempting the compilation with the warning
-     * still enabled (by just commenting out the #error directive).
-     * If compilation succeeds, this whole block and the `pop` directive below
-     * have become unnecessary and should be removed. Otherwise, the GCC version
-     * in the check above should be bumped up to cover the last tested GCC
-     * (here I went lazy and stuck to just the major version).
-     * I do not know which newer GCC version, if any, solves this issue so far.
-     */
-    # endif // GCC version
-    #endif // GCC
-    using ThresholdIterPtr_t
-      = std::optional<std::vector<ADCCounts_t>::const_iterator>;
-    // start at bottom with no lower threshold:
-    ThresholdIterPtr_t ppLowerThreshold = std::nullopt;
-    ThresholdIterPtr_t ppUpperThreshold = std::nullopt;
-    if (!channelThresholds().empty())
-      ppUpperThreshold = channelThresholds().begin(); // std::optional behavior
+    std::vector<int> const cuts = rawSampleThresholds(waveOps);
     
-    for (auto iSample: util::counter<std::ptrdiff_t>(waveform.size())) {
-      
-      // baseline subtraction is always a subtraction (as in "A minus B"),
-      // regardless the polarity of the waveform
-      auto const sample = waveform[iSample];
-      ADCCounts_t const relSample = subtractBaseline(sample);
-      
-      /* // this is too much also for regular debugging...
-      MF_LOG_TRACE(details::TriggerGateDebugLog)
-        << "Sample #" << iSample << ": " << sample << " [=> " << relSample
-        << "]; thresholds lower: "
-          << (ppLowerThreshold? util::to_string(**ppLowerThreshold): "none")
-        << ", upper: "
-          << (ppUpperThreshold? util::to_string(**ppUpperThreshold): "none")
-        ;
-      */
-      
-      //
-      // if this sample is lower than the current lower threshold,
-      // we are just tracking the thresholds: gate closing has already happened
-      //
-      if (ppLowerThreshold && (relSample < **ppLowerThreshold)) {
-        
+    // all gates start closed; this gate is not necessarily closed, but the
+    // waveform is not above the gate threshold any more
+    auto const openGate
+      = [&](std::ptrdiff_t iSample, std::size_t iThreshold)
+      {
+        // note that it is not guaranteed that gates at lower thresholds
+        // are still open (that depends on the builder implementation)
         MF_LOG_TRACE(details::TriggerGateDebugLog)
-          << "Sample " << sample << " (" << relSample << " on "
-          << waveOps.baseline() << ") leaving thresholds at "
-          << waveformTickStart << " + " << optical_time_ticks{ iSample };
-        
-        do { // we keep opening gates at increasing thresholds
-          
-          // if there is an lower threshold, there must also be a open gate!
-          assert(nextGateToOpen != channelGates.begin());
-          
-          
-          (--nextGateToOpen)->belowThresholdAt
-            (waveformTickStart + optical_time_ticks{ iSample });
-          
-          MF_LOG_TRACE(details::TriggerGateDebugLog)
-            << "  => decreasing threshold " << **ppLowerThreshold;
-          
-          if (*ppLowerThreshold == tbegin) { // was this the bottom threshold?
-            ppLowerThreshold = std::nullopt;
-            break;
-          }
-          --*ppLowerThreshold; // point to previous threshold
-          
-        } while (relSample < **ppLowerThreshold);
-        
-        // we can't be at the top since we just closed a gate
-        ppUpperThreshold
-          = ppLowerThreshold? std::next(*ppLowerThreshold): tbegin;
-        
-      } // if closing gate
-      
-      //
-      // if this sample is greater or matching the next threshold,
-      // we *are* opening gate(s)
-      //
-      else if (ppUpperThreshold && (relSample >= **ppUpperThreshold)) {
-        
+          << "Sample " << waveform[iSample] << " (on " << waveOps.baseline()
+          << ") passing threshold " << channelThresholds()[iThreshold]
+          << " at " << waveformTickStart << " + "
+          << optical_time_ticks{ iSample };
+        channelGates[iThreshold].aboveThresholdAt
+          (waveformTickStart + optical_time_ticks{ iSample });
+      };
+    auto const closeGate
+      = [&](std::ptrdiff_t iSample, std::size_t iThreshold)
+      {
         MF_LOG_TRACE(details::TriggerGateDebugLog)
-          << "Sample " << sample << " (" << relSample << " on "
-          << waveOps.baseline() << ") passing thresholds at "
-          << waveformTickStart << " + " << optical_time_ticks{ iSample };
-        
-        do { // we keep opening gates at increasing thresholds
-          
-          // note that it is not guaranteed that gates at lower thresholds are
-          // still open (that depends on the builder implementation)
-          
-          // if there is an upper threshold, there must also be a closed gate!
-          assert(nextGateToOpen != channelGates.end());
-          
-          MF_LOG_TRACE(details::TriggerGateDebugLog)
-            << "Opening thr=" << (**ppUpperThreshold);
-          
-          (nextGateToOpen++)->aboveThresholdAt
-            (waveformTickStart + optical_time_ticks{ iSample });
-          
-          if (++*ppUpperThreshold == tend) { // was this the top threshold?
-            ppUpperThreshold = std::nullopt;
-            break;
-          }
-          
-        } while (relSample >= **ppUpperThreshold);
-        
-        // we can't be at the bottom since we just opened a gate
-        ppLowerThreshold = std::prev(ppUpperThreshold? *ppUpperThreshold: tend);
-        
-      } // if opening gate
-      
-    } // for threshold
-
-    #if defined( __GNUC__ )
-    # pragma GCC diagnostic pop
-    #endif // __clang__
+          << "Sample " << waveform[iSample] << " (on " << waveOps.baseline()
+          << ") leaving threshold " << channelThresholds()[iThreshold]
+          << " at " << waveformTickStart << " + "
+          << optical_time_ticks{ iSample };
+        channelGates[iThreshold].belowThresholdAt
+          (waveformTickStart + optical_time_ticks{ iSample });
+      };
+    
+    details::scanThresholdCrossings<BlockSize>(
+      waveform.data(), static_cast<std::ptrdiff_t>(waveform.size()),
+      cuts, openGate, closeGate
+      );
     
   } // for waveforms
   
@@ -63,8 +63,57 @@ auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
   // ensures input gates are in the same order as the configured windows
   verifyInputTopology(gates);
   
+  //
+  // 1.   apply the beam gate; if it has an end, gates are sampled within it
+  //
+  if (fBeamGate) {
+    auto const [ start, end ]
+      = DenseGate_t::openRange(fBeamGate->gate().gateLevels());
+    if (end != DenseGate_t::MaxTick) {
+      return simulateWindowResponses
+        (makeDenseGates(fBeamGate->applyToAll(gates), start, end));
+    }
+  } // if beam gate
+  
   auto const& inBeamGates = fBeamGate? fBeamGate->applyToAll(gates): gates;
   
+  return simulateWindowResponses(inBeamGates);
+} // icarus::trigger::SlidingWindowPatternAlg::simulateResponse()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
+  (DenseGates_t const& gates) const -> AllTriggerInfo_t
+{
+  if (gates.size() != fWindowTopology.nWindows()) {
+    throw cet::exception("SlidingWindowPatternAlg")
+      << "Got " << gates.size() << " sampled trigger gates for "
+      << fWindowTopology.nWindows() << " windows\n";
+  }
+  
+  return simulateWindowResponses(gates);
+} // icarus::trigger::SlidingWindowPatternAlg::simulateResponse()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::makeDenseGates(
+  TriggerGates_t const& gates,
+  DenseGate_t::ClockTick_t start, DenseGate_t::ClockTick_t end
+) -> DenseGates_t {
+  DenseGates_t denseGates;
+  denseGates.reserve(gates.size());
+  for (InputTriggerGate_t const& gate: gates)
+    denseGates.emplace_back(gate.gateLevels(), start, end);
+  return denseGates;
+} // icarus::trigger::SlidingWindowPatternAlg::makeDenseGates()
+
+
+//------------------------------------------------------------------------------
+template <typename Gates>
+auto icarus::trigger::SlidingWindowPatternAlg::simulateWindowResponses
+  (Gates const& inBeamGates) const -> AllTriggerInfo_t
+{
+  
   //
   // 2.   apply pattern:
   //
@@ -114,7 +163,7 @@ auto icarus::trigger::SlidingWindowPatternAlg::simulateResponse
   } // main window choice
   
   return { std::move(triggerInfo.info), MoreInfo_t{ triggerInfo.windowIndex } };
-} // icarus::trigger::SlidingWindowPatternAlg::simulateResponse()
+} // icarus::trigger::SlidingWindowPatternAlg::simulateWindowResponses()
 
 
 //------------------------------------------------------------------------------
@@ -318,10 +367,84 @@ auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
 
 
 //------------------------------------------------------------------------------
+auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
+  WindowTopology_t::WindowInfo_t const& windowInfo,
+  WindowPattern_t const& pattern,
+  DenseGates_t const& gates
+  ) const -> TriggerInfo_t
+{
+  
+  /*
+   * Same as the version on `TriggerGates_t`, except that the discriminated
+   * requirements are combined as bit masks and applied all at once.
+   */
+  TriggerInfo_t res; // no trigger by default
+  assert(!res);
+
+  if (pattern.requireUpstreamWindow && !windowInfo.hasUpstreamWindow())
+    return res;
+  if (pattern.requireDownstreamWindow && !windowInfo.hasDownstreamWindow())
+    return res;
+  
+  mfLogTrace()
+    << "Window info #" << windowInfo.index << " pattern " << pattern.tag()
+    << " (sampled gates)";
+  
+  std::optional<DenseGate_t> mainPlusOpposite;
+  if (pattern.minSumInOppositeWindows > 0U) {
+    mainPlusOpposite.emplace(gates[windowInfo.index]);
+    if (windowInfo.hasOppositeWindow())
+      mainPlusOpposite->Sum(gates[windowInfo.opposite]);
+  }
+  
+  DenseGate_t trigPrimitive
+    = mainPlusOpposite? *mainPlusOpposite: gates[windowInfo.index];
+  
+  // AND of all the requirements
+  std::optional<DenseGate_t::Bits_t> required;
+  auto const addRequirement
+    = [&required](DenseGate_t const& gate, unsigned int minCount)
+    {
+      DenseGate_t::Bits_t bits = gate.above(minCount);
+      if (required) *required &= bits;
+      else          required.emplace(std::move(bits));
+    };
+  
+  if (pattern.minInMainWindow > 0U)
+    addRequirement(gates[windowInfo.index], pattern.minInMainWindow);
+  if ((pattern.minInOppositeWindow > 0U) && windowInfo.hasOppositeWindow())
+    addRequirement(gates[windowInfo.opposite], pattern.minInOppositeWindow);
+  if (pattern.minSumInOppositeWindows > 0U)
+    addRequirement(*mainPlusOpposite, pattern.minSumInOppositeWindows);
+  if ((pattern.minInUpstreamWindow > 0U) && windowInfo.hasUpstreamWindow())
+    addRequirement(gates[windowInfo.upstream], pattern.minInUpstreamWindow);
+  if ((pattern.minInDownstreamWindow > 0U) && windowInfo.hasDownstreamWindow())
+    addRequirement(gates[windowInfo.downstream], pattern.minInDownstreamWindow);
+  
+  if (required) trigPrimitive.Mask(*required);
+  
+  icarus::trigger::details::GateOpeningInfoExtractor extractOpeningInfo
+    { trigPrimitive };
+
+  extractOpeningInfo.setLocation
+    (TriggerInfo_t::LocationID_t{ windowInfo.index });
+
+  while (extractOpeningInfo) {
+    auto info = extractOpeningInfo();
+    if (info) res.add(info.value());
+  } // while
+
+  return res;
+  
+} // icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern()
+
+
+//------------------------------------------------------------------------------
+template <typename Gates>
 auto icarus::trigger::SlidingWindowPatternAlg::applyWindowPattern(
   WindowPattern_t const& pattern,
   std::size_t iWindow,
-  TriggerGates_t const& gates
+  Gates const& gates
   ) const -> TriggerInfo_t
 {
   WindowTopology_t::WindowInfo_t const& windowInfo
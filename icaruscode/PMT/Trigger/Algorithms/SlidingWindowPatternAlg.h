@@ -15,6 +15,7 @@
 #include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
 #include "icaruscode/PMT/Trigger/Algorithms/ApplyBeamGate.h"
 #include "icaruscode/PMT/Trigger/Algorithms/details/TriggerInfo_t.h"
+#include "icaruscode/PMT/Trigger/Utilities/DenseTriggerGate.h"
 #include "icarusalg/Utilities/mfLoggingClass.h"
 #include "sbnobj/ICARUS/PMT/Trigger/Data/MultiChannelOpticalTriggerGate.h"
 
@@ -44,6 +45,14 @@ namespace icarus::trigger { class SlidingWindowPatternAlg; }
  * If a beam gate is present, it is applied to all input before simulating the
  * pattern. Otherwise, the full input is used.
  * 
+ * When the beam gate is present, the gates are sampled in the beam gate
+ * interval (`icarus::trigger::DenseTriggerGate`) and the pattern is evaluated
+ * on those samples: the result is the same, but the combination of the gates
+ * is a plain loop on the ticks instead of a merge of the opening changes.
+ * Input already in that form can be passed directly to
+ * `simulateResponse(DenseGates_t const&)`, which saves the conversion when
+ * more patterns are evaluated on the same input.
+ * 
  * For the definition of the windows, see `icarus::trigger::WindowChannelMap`.
  * 
  */
@@ -65,6 +74,12 @@ class icarus::trigger::SlidingWindowPatternAlg
   /// Type of gate data without channel information.
   using TriggerGateData_t = InputTriggerGate_t::GateData_t;
   
+  /// Type of gate data sampled on a tick interval.
+  using DenseGate_t = icarus::trigger::DenseTriggerGate<TriggerGateData_t>;
+  
+  /// A list of sampled trigger gates.
+  using DenseGates_t = std::vector<DenseGate_t>;
+  
   /// Type holding information about composition and topology of all windows.
   using WindowTopology_t = icarus::trigger::WindowChannelMap;
   
@@ -147,6 +162,24 @@ class icarus::trigger::SlidingWindowPatternAlg
    */
   AllTriggerInfo_t simulateResponse(TriggerGates_t const& gates) const;
   
+  /**
+   * @brief Returns the trigger response from the specified sampled `gates`.
+   * @param gates the trigger gates to be used as input, one per window
+   * @return the response to the configured pattern
+   * @throw cet::exception (category: `SlidingWindowPatternAlg`) if the number
+   *        of gates does not match the number of windows
+   * @see `makeDenseGates()`
+   * 
+   * The `gates` are expected to be already in coincidence with the beam gate
+   * (the configured beam gate is _not_ applied), and all sampled on the same
+   * tick interval; the result is the same as the one of
+   * `simulateResponse(TriggerGates_t const&)` on the gates they were sampled
+   * from.
+   * Since sampled gates carry no channel information, only the number of
+   * gates is checked against the window topology.
+   */
+  AllTriggerInfo_t simulateResponse(DenseGates_t const& gates) const;
+  
 
   /// Returns a new collection of gates, set each in coincidence with beam gate.
   TriggerGates_t applyBeamGate(TriggerGates_t const& gates) const;
@@ -160,6 +193,22 @@ class icarus::trigger::SlidingWindowPatternAlg
   /// Do not apply any beam gate.
   void clearBeamGate();
   
+  /**
+   * @brief Returns the `gates` sampled in the interval [ `start`, `end` [.
+   * @param gates the gates to be sampled
+   * @param start first tick of the sampled interval
+   * @param end tick after the last one of the sampled interval
+   * @return a list of sampled gates, in the same order as `gates`
+   * 
+   * Any opening of the `gates` outside the interval is lost.
+   * The interval is usually the one of the beam gate, which can be obtained
+   * from `DenseGate_t::openRange()`.
+   */
+  static DenseGates_t makeDenseGates(
+    TriggerGates_t const& gates,
+    DenseGate_t::ClockTick_t start, DenseGate_t::ClockTick_t end
+    );
+  
   
   /**
    * @brief Returns the trigger response for the specified window pattern.
@@ -190,6 +239,24 @@ class icarus::trigger::SlidingWindowPatternAlg
     TriggerGates_t const& gates
     ) const;
   
+  /**
+   * @brief Returns the trigger response for the specified window pattern.
+   * @param windowInfo the topology of the windows
+   * @param pattern the trigger requirement pattern
+   * @param gates sampled trigger gates, one per window
+   * @return a `TriggerInfo_t` record with the response of the pattern
+   * 
+   * This is the same as
+   * `applyWindowPattern(WindowTopology_t::WindowInfo_t const&, WindowPattern_t const&, TriggerGates_t const&)`,
+   * working on sampled gates: all the requirements are discriminated into a
+   * single bit mask, which is then applied to the base gate.
+   */
+  TriggerInfo_t applyWindowPattern(
+    WindowTopology_t::WindowInfo_t const& windowInfo,
+    WindowPattern_t const& pattern,
+    DenseGates_t const& gates
+    ) const;
+  
   
     private:
   
@@ -233,11 +300,16 @@ class icarus::trigger::SlidingWindowPatternAlg
    * 
    * See the static version of `applyWindowPattern()` for details.
    */
+  template <typename Gates>
   TriggerInfo_t applyWindowPattern(
     WindowPattern_t const& pattern, std::size_t iWindow,
-    TriggerGates_t const& gates
+    Gates const& gates
     ) const;
   
+  /// Applies the pattern to all windows and returns the earliest response.
+  template <typename Gates>
+  AllTriggerInfo_t simulateWindowResponses(Gates const& gates) const;
+  
   /**
    * @brief Checks `gates` are compatible with the current window configuration.
    * @param gates the combined sliding window trigger gates, per cryostat
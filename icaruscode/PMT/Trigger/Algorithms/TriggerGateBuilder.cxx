@@ -111,6 +111,18 @@ icarus::trigger::TriggerGateBuilder::TriggerGates::gateFor
 } // icarus::trigger::TriggerGateBuilder::TriggerGates::gateFor()
 
 
+//------------------------------------------------------------------------------
+icarus::trigger::SingleChannelOpticalTriggerGate*
+icarus::trigger::TriggerGateBuilder::TriggerGates::findGate
+  (raw::Channel_t channel)
+{
+  auto const iGate = std::lower_bound
+    (fGates.begin(), fGates.end(), channel, ::ChannelComparison<>());
+  return ((iGate != fGates.end()) && (iGate->channel() == channel))
+    ? &*iGate: nullptr;
+} // icarus::trigger::TriggerGateBuilder::TriggerGates::findGate()
+
+
 //------------------------------------------------------------------------------
 //--- icarus::trigger::TriggerGateBuilder
 //------------------------------------------------------------------------------
@@ -139,6 +139,10 @@ class icarus::trigger::TriggerGateBuilder {
     icarus::trigger::SingleChannelOpticalTriggerGate& gateFor
       (raw::OpDetWaveform const& waveform);
     
+    /// Returns the gate on the specified `channel`, `nullptr` if none.
+    icarus::trigger::SingleChannelOpticalTriggerGate* findGate
+      (raw::Channel_t channel);
+    
     /// Dumps the content of this set of gates into the `out` stream.
     template <typename Stream>
     void dump(Stream& out) const;
@@ -0,0 +1,202 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Algorithms/details/ThresholdCrossings.h
+ * @brief  Discrimination of a waveform against a sorted list of thresholds.
+ * @date   October 19, 2026
+ * @see    `icaruscode/PMT/Trigger/Algorithms/ManagedTriggerGateBuilder.tcc`
+ *
+ * This is a header-only library.
+ */
+
+#ifndef ICARUSCODE_PMT_TRIGGER_ALGORITHMS_DETAILS_THRESHOLDCROSSINGS_H
+#define ICARUSCODE_PMT_TRIGGER_ALGORITHMS_DETAILS_THRESHOLDCROSSINGS_H
+
+// C++ standard libraries
+#include <vector>
+#include <algorithm> // std::min()
+#include <limits> // std::numeric_limits<>
+#include <cmath> // std::round(), std::floor()
+#include <cstddef> // std::size_t, std::ptrdiff_t
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::trigger::details {
+
+  /**
+   * @brief Returns the thresholds as cuts on the raw samples of a waveform.
+   * @tparam WaveformOps type of waveform operations (negative polarity)
+   * @tparam Thresholds type of collection of thresholds
+   * @param waveOps operations on the waveform, including its baseline
+   * @param thresholds the thresholds, increasing
+   * @return the largest raw sample passing each threshold, sorted as them
+   *
+   * A raw sample passes a threshold if, after subtraction of the baseline in
+   * single precision and rounding, it is at or above that threshold.
+   * The threshold type must support `castFrom()` from a `float` value
+   * (like `util::quantities::counts_as`).
+   */
+  template <typename WaveformOps, typename Thresholds>
+  std::vector<int> rawSampleCuts
+    (WaveformOps const& waveOps, Thresholds const& thresholds);
+
+  /**
+   * @brief Reports all the crossings of `cuts` by the raw `samples`.
+   * @tparam BlockSize number of samples tested together for crossings
+   * @tparam Sample type of the raw samples
+   * @tparam OnOpen type of callable reporting a threshold being passed
+   * @tparam OnClose type of callable reporting a threshold being left
+   * @param samples the raw samples of the waveform
+   * @param nSamples number of samples in `samples`
+   * @param cuts the cuts on the raw samples (see `rawSampleCuts()`)
+   * @param onOpen called as `onOpen(iSample, iThreshold)`
+   * @param onClose called as `onClose(iSample, iThreshold)`
+   *
+   * The waveform starts below all thresholds. Threshold `i` is passed when
+   * a sample is not larger than `cuts[i]` (negative polarity), and left when
+   * a sample is larger than that.
+   * When more thresholds are passed (or left) on the same sample, they are
+   * reported from the lowest up (or from the highest down).
+   *
+   * The current level holds as long as the samples stay within the cut of the
+   * highest threshold passed and the one of the next threshold up; whole
+   * blocks of `BlockSize` samples satisfying that are skipped with a single
+   * branchless test.
+   */
+  template <
+    std::size_t BlockSize = 32U,
+    typename Sample, typename OnOpen, typename OnClose
+    >
+  void scanThresholdCrossings(
+    Sample const* samples, std::ptrdiff_t nSamples,
+    std::vector<int> const& cuts,
+    OnOpen&& onOpen, OnClose&& onClose
+    );
+
+} // namespace icarus::trigger::details
+
+
+// -----------------------------------------------------------------------------
+// --- template implementation
+// -----------------------------------------------------------------------------
+template <typename WaveformOps, typename Thresholds>
+std::vector<int> icarus::trigger::details::rawSampleCuts
+  (WaveformOps const& waveOps, Thresholds const& thresholds)
+{
+  using Threshold_t = typename Thresholds::value_type;
+
+  /*
+   * The sample value relative to the baseline must be computed exactly as the
+   * floating point algorithm did (in single precision, and rounded); since
+   * that value decreases as the raw sample increases, the cut is found
+   * starting from an estimation and then moving by one count until it is
+   * exact.
+   */
+  auto relSampleOf = [&waveOps](int sample) -> Threshold_t
+    {
+      return Threshold_t::castFrom
+        (std::round(waveOps.subtractBaseline(static_cast<float>(sample))));
+    };
+
+  std::vector<int> cuts;
+  cuts.reserve(thresholds.size());
+  for (Threshold_t const threshold: thresholds) {
+    int cut = static_cast<int>
+      (std::floor(waveOps.baseline() - static_cast<float>(threshold.value())));
+    while (relSampleOf(cut + 1) >= threshold) ++cut;
+    while (relSampleOf(cut) < threshold) --cut;
+    cuts.push_back(cut);
+  } // for
+
+  return cuts;
+} // icarus::trigger::details::rawSampleCuts()
+
+
+// -----------------------------------------------------------------------------
+template <
+  std::size_t BlockSize /* = 32U */,
+  typename Sample, typename OnOpen, typename OnClose
+  >
+void icarus::trigger::details::scanThresholdCrossings(
+  Sample const* samples, std::ptrdiff_t nSamples,
+  std::vector<int> const& cuts,
+  OnOpen&& onOpen, OnClose&& onClose
+) {
+
+  std::size_t const nThresholds = cuts.size();
+
+  // `level` is the number of thresholds the waveform is at or above
+  std::size_t level = 0U;
+
+  // the current level holds as long as `currentCut < sample <= nextCut`;
+  // raw samples decrease as the signal increases (negative polarity):
+  // a sample not larger than the cut of the next threshold up passes it,
+  // a sample larger than the cut of the current threshold leaves it
+  auto const nextCutOf = [&cuts,nThresholds](std::size_t level)
+    {
+      return (level < nThresholds)
+        ? cuts[level]: std::numeric_limits<int>::min();
+    };
+  auto const currentCutOf = [&cuts](std::size_t level)
+    {
+      return (level > 0U)
+        ? cuts[level - 1]: std::numeric_limits<int>::max();
+    };
+  int nextCut = nextCutOf(level);
+  int currentCut = currentCutOf(level);
+
+  std::ptrdiff_t iSample = 0;
+  while (iSample < nSamples) {
+
+    // skip a block of samples if none of them crosses a threshold
+    if (iSample + std::ptrdiff_t(BlockSize) <= nSamples) {
+      bool crossing = false;
+      for (std::size_t k = 0; k < BlockSize; ++k) {
+        int const sample = samples[iSample + k];
+        crossing |= (sample <= nextCut) | (sample > currentCut);
+      }
+      if (!crossing) {
+        iSample += BlockSize;
+        continue;
+      }
+    } // if full block
+
+    std::ptrdiff_t const blockEnd
+      = std::min(iSample + std::ptrdiff_t(BlockSize), nSamples);
+    for (; iSample < blockEnd; ++iSample) {
+
+      int const sample = samples[iSample];
+
+      //
+      // if this sample is below the current threshold (larger than its cut),
+      // we are closing gate(s)
+      //
+      if (sample > currentCut) {
+        do {
+          onClose(iSample, --level);
+        } while ((level > 0U) && (sample > cuts[level - 1]));
+      } // if closing gate
+
+      //
+      // if this sample is at or above the next threshold (not larger than its
+      // cut), we are opening gate(s)
+      //
+      else if (sample <= nextCut) {
+        do {
+          onOpen(iSample, level++);
+        } while ((level < nThresholds) && (sample <= cuts[level]));
+      } // if opening gate
+
+      else continue;
+
+      nextCut = nextCutOf(level);
+      currentCut = currentCutOf(level);
+
+    } // for samples in block
+
+  } // while samples
+
+} // icarus::trigger::details::scanThresholdCrossings()
+
+
+// -----------------------------------------------------------------------------
+
+#endif // ICARUSCODE_PMT_TRIGGER_ALGORITHMS_DETAILS_THRESHOLDCROSSINGS_H
@@ -568,7 +568,7 @@ void icarus::trigger::DiscriminatePMTwaveformsByChannel::produce(art::Event& eve
   
   // map address of waveform to art pointer to that waveform
   auto const& opDetWavePtrs
-    = util::mapDataProductPointers(event, waveformHandle);
+    = util::indexDataProductPointers(event, waveformHandle);
   
   //
   // retrieve the baseline information if provided event by event
@@ -389,7 +389,7 @@ void icarus::trigger::DiscriminatePMTwaveforms::produce(art::Event& event) {
   
   // map address of waveform to art pointer to that waveform
   auto const& opDetWavePtrs
-    = util::mapDataProductPointers(event, waveformHandle);
+    = util::indexDataProductPointers(event, waveformHandle);
   
   //
   // retrieve the baseline information
@@ -341,6 +341,14 @@ class icarus::trigger::MajorityTriggerEfficiencyPlots
   // --- END Internal variables ------------------------------------------------
 
   
+  /// Keys of the plots filled by this module.
+  struct ModulePlotKeys {
+    static inline PlotKey_t<TEfficiency> const Eff { "Eff" };
+    static inline PlotKey_t<TH2> const TriggerTick { "TriggerTick" };
+    static inline PlotKey_t<TH1> const NPrimitives { "NPrimitives" };
+  }; // struct ModulePlotKeys
+  
+  
   // @{
   /// Access to the helper.
   MajorityTriggerEfficiencyPlots const& helper() const { return *this; }
@@ -560,6 +568,9 @@ void icarus::trigger::MajorityTriggerEfficiencyPlots::beginJob() {
   // we use the default plot categories defined in
   // `TriggerEfficiencyPlotsBase::DefaultPlotCategories`
   helper().initializePlots(settings);
+  helper().registerPlotObjects(
+    ModulePlotKeys::Eff, ModulePlotKeys::TriggerTick, ModulePlotKeys::NPrimitives
+    );
   
 } // icarus::trigger::MajorityTriggerEfficiencyPlots::beginJob()
 
@@ -835,11 +846,11 @@ void icarus::trigger::MajorityTriggerEfficiencyPlots::plotResponses(
       HistGetter const get { plotSet };
       
       // simple efficiency
-      get.Eff("Eff"s).Fill(fired, minCount);
+      get.Eff(ModulePlotKeys::Eff).Fill(fired, minCount);
       
       // trigger time (if any)
       if (fired) {
-        get.Hist2D("TriggerTick"s).Fill(minCount, triggerInfo.atTick().value());
+        get.Hist2D(ModulePlotKeys::TriggerTick).Fill(minCount, triggerInfo.atTick().value());
       }
       
       //
@@ -884,7 +895,7 @@ void icarus::trigger::MajorityTriggerEfficiencyPlots::plotResponses(
     HistGetter const get(plotSet);
     
     // number of primitives
-    get.Hist("NPrimitives"s).Fill(maxPrimitives.second);
+    get.Hist(ModulePlotKeys::NPrimitives).Fill(maxPrimitives.second);
     
   } // for
 
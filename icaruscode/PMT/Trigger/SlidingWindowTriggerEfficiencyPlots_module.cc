@@ -47,6 +47,7 @@
 #include <vector>
 #include <array>
 #include <memory> // std::unique_ptr
+#include <optional>
 #include <utility> // std::pair<>, std::move()
 #include <limits> // std::numeric_limits<>
 #include <type_traits> // std::is_pointer_v, ...
@@ -406,6 +407,14 @@ class icarus::trigger::SlidingWindowTriggerEfficiencyPlots
   // --- END Internal variables ------------------------------------------------
 
   
+  /// Keys of the plots filled by this module.
+  struct ModulePlotKeys {
+    static inline PlotKey_t<TEfficiency> const Eff { "Eff" };
+    static inline PlotKey_t<TH1> const Triggers { "Triggers" };
+    static inline PlotKey_t<TH2> const TriggerTick { "TriggerTick" };
+  }; // struct ModulePlotKeys
+  
+  
   // @{
   /// Access to the helper.
   SlidingWindowTriggerEfficiencyPlots const& helper() const { return *this; }
@@ -616,6 +625,9 @@ void icarus::trigger::SlidingWindowTriggerEfficiencyPlots::beginJob() {
   // we use the default plot categories defined in
   // `TriggerEfficiencyPlotsBase::DefaultPlotCategories`
   helper().initializePlots(settings);
+  helper().registerPlotObjects(
+    ModulePlotKeys::Eff, ModulePlotKeys::Triggers, ModulePlotKeys::TriggerTick
+    );
   
 } // icarus::trigger::SlidingWindowTriggerEfficiencyPlots::beginJob()
 
@@ -774,6 +786,18 @@ void icarus::trigger::SlidingWindowTriggerEfficiencyPlots::simulateAndPlot(
   }
   // --- END DEBUG -------------------------------------------------------------
   
+  // the gates sampled in the beam gate are shared by all the patterns
+  using PatternAlg_t = icarus::trigger::SlidingWindowPatternAlg;
+  auto const [ beamStart, beamEnd ]
+    = PatternAlg_t::DenseGate_t::openRange(beamGate.gate().gateLevels());
+  std::optional<PatternAlg_t::DenseGates_t> const denseInBeamGates
+    = (beamEnd != PatternAlg_t::DenseGate_t::MaxTick)
+    ? std::optional{
+        PatternAlg_t::makeDenseGates(inBeamGates, beamStart, beamEnd)
+      }
+    : std::nullopt
+    ;
+  
   // get which gates are active during the beam gate
   PMTInfo_t const PMTinfo
     { threshold, helper().extractActiveChannels(gates) };
@@ -785,8 +809,10 @@ void icarus::trigger::SlidingWindowTriggerEfficiencyPlots::simulateAndPlot(
 
     auto& patternAlg = fPatternAlgs[iPattern];
     
-    WindowTriggerInfo_t const triggerInfo
-      = patternAlg.simulateResponse(inBeamGates);
+    WindowTriggerInfo_t const triggerInfo = denseInBeamGates
+      ? patternAlg.simulateResponse(*denseInBeamGates)
+      : patternAlg.simulateResponse(inBeamGates)
+      ;
     
     registerTriggerResult(thresholdIndex, iPattern, triggerInfo.info);
 
@@ -896,14 +922,14 @@ void icarus::trigger::SlidingWindowTriggerEfficiencyPlots::plotResponse(
     HistGetter const get { plotSet };
     
     // simple efficiency
-    get.Eff("Eff"s).Fill(fired, iPattern);
+    get.Eff(ModulePlotKeys::Eff).Fill(fired, iPattern);
     
     // simple count
-    if (fired) get.Hist("Triggers"s).Fill(iPattern);
+    if (fired) get.Hist(ModulePlotKeys::Triggers).Fill(iPattern);
     
     // trigger time (if any)
     if (fired) {
-      get.Hist2D("TriggerTick"s).Fill
+      get.Hist2D(ModulePlotKeys::TriggerTick).Fill
         (iPattern, triggerInfo.info.atTick().value());
     }
     
@@ -766,6 +766,22 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::initializePlots
     fThresholdPlots.push_back(std::move(thrPlots));
   } // for thresholds
   
+  // fast access to the plots filled for every event
+  registerPlotObjects(
+    PlotKeys::EnergyInSpill, PlotKeys::EnergyInSpillActive,
+    PlotKeys::EnergyInPreSpill, PlotKeys::EnergyInPreSpillActive,
+    PlotKeys::EnergyInPreSpillVsSpillActive,
+    PlotKeys::NeutrinoEnergy, PlotKeys::InteractionType,
+    PlotKeys::LeptonEnergy, PlotKeys::InteractionTypeNeutrinoEnergy,
+    PlotKeys::InteractionVertexYZ,
+    PlotKeys::ActivePMT,
+    PlotKeys::EffVsEnergyInSpill, PlotKeys::EffVsEnergyInPreSpill,
+    PlotKeys::EffVsEnergyInSpillActive, PlotKeys::EffVsEnergyInPreSpillActive,
+    PlotKeys::EffVsNeutrinoEnergy, PlotKeys::EffVsLeptonEnergy,
+    PlotKeys::TriggerTick, PlotKeys::TriggerTime, PlotKeys::OpeningTimes
+    );
+  registerPlotSandboxes(PlotKeys::Triggering, PlotKeys::NonTriggering);
+  
   mf::LogTrace log(fLogCategory);
   log << "Created " << fThresholdPlots.size() << " plot boxes:\n";
   for (auto const& box: fThresholdPlots) {
@@ -1083,19 +1099,17 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillEventPlots
   (EventInfo_t const& eventInfo, PlotSandbox const& plots) const
 {
   
-  using namespace std::string_literals;
-  
   HistGetter const getTrig { plots };
   
   if (useEDep()) {
     assert(eventInfo.hasDepEnergy());
-    getTrig.Hist("EnergyInSpill"s).Fill(double(eventInfo.DepositedEnergyInSpill()));
-    getTrig.Hist("EnergyInSpillActive"s).Fill(double(eventInfo.DepositedEnergyInSpillInActiveVolume()));
-    getTrig.Hist("EnergyInPreSpill"s)
+    getTrig.Hist(PlotKeys::EnergyInSpill).Fill(double(eventInfo.DepositedEnergyInSpill()));
+    getTrig.Hist(PlotKeys::EnergyInSpillActive).Fill(double(eventInfo.DepositedEnergyInSpillInActiveVolume()));
+    getTrig.Hist(PlotKeys::EnergyInPreSpill)
       .Fill(double(eventInfo.DepositedEnergyInPreSpill()));
-    getTrig.Hist("EnergyInPreSpillActive"s)
+    getTrig.Hist(PlotKeys::EnergyInPreSpillActive)
       .Fill(double(eventInfo.DepositedEnergyInPreSpillInActiveVolume()));
-    getTrig.Hist2D("EnergyInPreSpillVsSpillActive"s).Fill(
+    getTrig.Hist2D(PlotKeys::EnergyInPreSpillVsSpillActive).Fill(
       double(eventInfo.DepositedEnergyInSpillInActiveVolume()),
       double(eventInfo.DepositedEnergyInPreSpillInActiveVolume())
       );
@@ -1103,12 +1117,12 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillEventPlots
   if (useGen()) {
     if (eventInfo.isNeutrino()) {
       assert(eventInfo.hasGenerated());
-      getTrig.Hist("NeutrinoEnergy"s).Fill(double(eventInfo.NeutrinoEnergy()));
-      getTrig.Hist("InteractionType"s).Fill(eventInfo.InteractionType());
-      getTrig.Hist("LeptonEnergy"s).Fill(double(eventInfo.LeptonEnergy()));
-      getTrig.Hist("InteractionTypeNeutrinoEnergy"s).Fill(double(eventInfo.InteractionType()), double(eventInfo.NeutrinoEnergy()));
+      getTrig.Hist(PlotKeys::NeutrinoEnergy).Fill(double(eventInfo.NeutrinoEnergy()));
+      getTrig.Hist(PlotKeys::InteractionType).Fill(eventInfo.InteractionType());
+      getTrig.Hist(PlotKeys::LeptonEnergy).Fill(double(eventInfo.LeptonEnergy()));
+      getTrig.Hist(PlotKeys::InteractionTypeNeutrinoEnergy).Fill(double(eventInfo.InteractionType()), double(eventInfo.NeutrinoEnergy()));
     } // if neutrino event
-    TH2& vertexHist = getTrig.Hist2D("InteractionVertexYZ"s);
+    TH2& vertexHist = getTrig.Hist2D(PlotKeys::InteractionVertexYZ);
     for (auto const& point: eventInfo.Vertices())
       vertexHist.Fill(point.Z(), point.Y());
   } // if use generated information
@@ -1121,11 +1135,9 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillPMTplots
   (PMTInfo_t const& PMTinfo, PlotSandbox const& plots) const
 {
   
-  using namespace std::string_literals;
-  
   HistGetter const getTrig { plots };
   
-  auto& activePMThist = getTrig.Hist("ActivePMT"s);
+  auto& activePMThist = getTrig.Hist(PlotKeys::ActivePMT);
   for (raw::Channel_t const channel: PMTinfo.activeChannels())
     activePMThist.Fill(channel);
   
@@ -1139,7 +1151,6 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillEfficiencyPlots(
   PlotSandbox const& plots
 ) const {
   
-  using namespace std::string_literals;
   using OpeningInfo_t = icarus::trigger::details::TriggerInfo_t::OpeningInfo_t;
 
   auto const detTimings = icarus::ns::util::makeDetTimings();
@@ -1150,20 +1161,20 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillEfficiencyPlots(
 
   // efficiency plots
   if (useEDep()) {
-    getTrigEff.Eff("EffVsEnergyInSpill"s).Fill
+    getTrigEff.Eff(PlotKeys::EffVsEnergyInSpill).Fill
       (fired, double(eventInfo.DepositedEnergyInSpill()));
-    getTrigEff.Eff("EffVsEnergyInPreSpill"s).Fill
+    getTrigEff.Eff(PlotKeys::EffVsEnergyInPreSpill).Fill
       (fired, double(eventInfo.DepositedEnergyInPreSpill()));
-    getTrigEff.Eff("EffVsEnergyInSpillActive"s).Fill
+    getTrigEff.Eff(PlotKeys::EffVsEnergyInSpillActive).Fill
       (fired, double(eventInfo.DepositedEnergyInSpillInActiveVolume()));
-    getTrigEff.Eff("EffVsEnergyInPreSpillActive"s).Fill
+    getTrigEff.Eff(PlotKeys::EffVsEnergyInPreSpillActive).Fill
       (fired, double(eventInfo.DepositedEnergyInPreSpillInActiveVolume()));
   } // if use energy deposits
   if (useGen()) {
     if (eventInfo.isNeutrino()) {
-      getTrigEff.Eff("EffVsNeutrinoEnergy"s).Fill
+      getTrigEff.Eff(PlotKeys::EffVsNeutrinoEnergy).Fill
         (fired, double(eventInfo.NeutrinoEnergy()));
-      getTrigEff.Eff("EffVsLeptonEnergy"s).Fill
+      getTrigEff.Eff(PlotKeys::EffVsLeptonEnergy).Fill
         (fired, double(eventInfo.LeptonEnergy()));
     }
   } // if use generated information
@@ -1172,19 +1183,19 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillEfficiencyPlots(
     detinfo::timescales::electronics_time const nominalBeamTime
       = detTimings.BeamGateTime();
     
-    getTrigEff.Hist("TriggerTick"s).Fill(triggerInfo.atTick().value());
+    getTrigEff.Hist(PlotKeys::TriggerTick).Fill(triggerInfo.atTick().value());
     
     // converts the tick in the argument into electronics time:
     auto openingTime = [&detTimings](OpeningInfo_t const& info)
       { return detTimings.toElectronicsTime(info.tick); };
 
-    getTrigEff.Hist("TriggerTime"s).Fill
+    getTrigEff.Hist(PlotKeys::TriggerTime).Fill
       ((openingTime(triggerInfo.main()) - nominalBeamTime).value());
 
     std::vector<OpeningInfo_t> const& allTriggerOpenings = triggerInfo.all();
 
     for (OpeningInfo_t const& opening : allTriggerOpenings) {
-      getTrigEff.Hist("OpeningTimes"s).Fill
+      getTrigEff.Hist(PlotKeys::OpeningTimes).Fill
         ((openingTime(opening) - nominalBeamTime).value());
     } // for all trigger openings
     
@@ -1204,15 +1215,12 @@ void icarus::trigger::TriggerEfficiencyPlotsBase::fillAllEfficiencyPlots(
   fillEfficiencyPlots(eventInfo, triggerInfo, plots);
   
   // plotting split for triggering/not triggering events
-  fillEventPlots(
-    eventInfo,
-    plots.demandSandbox(triggerInfo.fired()? "triggering": "nontriggering")
-    );
+  PlotSandbox const& responsePlots = plots.demandSandbox
+    (triggerInfo.fired()? PlotKeys::Triggering: PlotKeys::NonTriggering);
   
-  fillPMTplots(
-    PMTinfo,
-    plots.demandSandbox(triggerInfo.fired()? "triggering": "nontriggering")
-    );
+  fillEventPlots(eventInfo, responsePlots);
+  
+  fillPMTplots(PMTinfo, responsePlots);
   
 } // icarus::trigger::TriggerEfficiencyPlotsBase::fillAllEfficiencyPlots()
 
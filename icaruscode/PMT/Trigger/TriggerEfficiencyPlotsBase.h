@@ -582,6 +582,21 @@ struct icarus::trigger::details::PlotInfoTree: public TreeHolder {
  * } // MyTriggerEfficiencyPlots::initializePlotSet()
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * 
+ * Plots filled for every event should be accessed via keys
+ * (`PlotSandbox::ObjectKey`) rather than by name: the keys are registered in
+ * all the plot boxes with `registerPlotObjects()` after `initializePlots()`,
+ * and `HistGetter` accepts them in place of the names:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * static inline PlotSandbox::ObjectKey<TEfficiency> const EffKey { "Eff" };
+ * 
+ * helper().initializePlots(settings);
+ * helper().registerPlotObjects(EffKey);
+ * 
+ * // ... and when filling:
+ * HistGetter const get { plotSet };
+ * get.Eff(EffKey).Fill(fired, iSetting);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * 
  * 
  * ### Plots depending on a specific trigger definition
  * 
@@ -1187,6 +1202,10 @@ class icarus::trigger::TriggerEfficiencyPlotsBase {
   
   //----------------------------------------------------------------------------
 
+  /// Type of key for fast access to plots of type `Obj` in the sandboxes.
+  template <typename Obj>
+  using PlotKey_t = PlotSandbox::ObjectKey<Obj>;
+  
   class HistGetter { // helper, since this seems "popular"
     PlotSandbox const& plots;
     
@@ -1200,8 +1219,55 @@ class icarus::trigger::TriggerEfficiencyPlotsBase {
     TEfficiency& Eff(std::string const& name) const
       { return plots.demand<TEfficiency>(name); }
     
+    TH1& Hist(PlotKey_t<TH1> const& key) const { return plots.demand(key); }
+    TH2& Hist2D(PlotKey_t<TH2> const& key) const { return plots.demand(key); }
+    TEfficiency& Eff(PlotKey_t<TEfficiency> const& key) const
+      { return plots.demand(key); }
+    
   }; // class HistGetter
   
+  /// Keys of the plots filled by this class.
+  struct PlotKeys {
+    
+    static inline PlotKey_t<TH1> const EnergyInSpill { "EnergyInSpill" };
+    static inline PlotKey_t<TH1> const EnergyInSpillActive
+      { "EnergyInSpillActive" };
+    static inline PlotKey_t<TH1> const EnergyInPreSpill { "EnergyInPreSpill" };
+    static inline PlotKey_t<TH1> const EnergyInPreSpillActive
+      { "EnergyInPreSpillActive" };
+    static inline PlotKey_t<TH2> const EnergyInPreSpillVsSpillActive
+      { "EnergyInPreSpillVsSpillActive" };
+    static inline PlotKey_t<TH1> const NeutrinoEnergy { "NeutrinoEnergy" };
+    static inline PlotKey_t<TH1> const InteractionType { "InteractionType" };
+    static inline PlotKey_t<TH1> const LeptonEnergy { "LeptonEnergy" };
+    static inline PlotKey_t<TH1> const InteractionTypeNeutrinoEnergy
+      { "InteractionTypeNeutrinoEnergy" };
+    static inline PlotKey_t<TH2> const InteractionVertexYZ
+      { "InteractionVertexYZ" };
+    static inline PlotKey_t<TH1> const ActivePMT { "ActivePMT" };
+    static inline PlotKey_t<TEfficiency> const EffVsEnergyInSpill
+      { "EffVsEnergyInSpill" };
+    static inline PlotKey_t<TEfficiency> const EffVsEnergyInPreSpill
+      { "EffVsEnergyInPreSpill" };
+    static inline PlotKey_t<TEfficiency> const EffVsEnergyInSpillActive
+      { "EffVsEnergyInSpillActive" };
+    static inline PlotKey_t<TEfficiency> const EffVsEnergyInPreSpillActive
+      { "EffVsEnergyInPreSpillActive" };
+    static inline PlotKey_t<TEfficiency> const EffVsNeutrinoEnergy
+      { "EffVsNeutrinoEnergy" };
+    static inline PlotKey_t<TEfficiency> const EffVsLeptonEnergy
+      { "EffVsLeptonEnergy" };
+    static inline PlotKey_t<TH1> const TriggerTick { "TriggerTick" };
+    static inline PlotKey_t<TH1> const TriggerTime { "TriggerTime" };
+    static inline PlotKey_t<TH1> const OpeningTimes { "OpeningTimes" };
+    
+    /// Keys of the boxes of triggering and non-triggering events.
+    static inline PlotSandbox::SandboxKey const Triggering { "triggering" };
+    static inline PlotSandbox::SandboxKey const NonTriggering
+      { "nontriggering" };
+    
+  }; // struct PlotKeys
+  
   //----------------------------------------------------------------------------
   
   /// Generic description of trigger settings.
@@ -1249,6 +1315,16 @@ class icarus::trigger::TriggerEfficiencyPlotsBase {
   /// Initializes sets of default plots, one per PMT threshold.
   void initializePlots(std::vector<SettingsInfo_t> const& settings)
     { initializePlots(DefaultPlotCategories, settings); }
+  
+  /// Registers the `keys` in all the plot boxes (after `initializePlots()`).
+  template <typename... Objs>
+  void registerPlotObjects(PlotKey_t<Objs> const&... keys)
+    { for (PlotSandbox& plots: fThresholdPlots) plots.registerObjects(keys...); }
+
+  /// Registers the sandbox `keys` in all the plot boxes.
+  template <typename... Keys>
+  void registerPlotSandboxes(Keys const&... keys)
+    { for (PlotSandbox& plots: fThresholdPlots) plots.registerSandboxes(keys...); }
 
   /// Initializes full set of plots for (ADC threshold + category) into `plots`.
   virtual void initializePlotSet
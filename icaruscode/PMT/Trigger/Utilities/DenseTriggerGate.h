@@ -0,0 +1,630 @@
+/**
+ * @file   icaruscode/PMT/Trigger/Utilities/DenseTriggerGate.h
+ * @brief  Trigger gate representations sampled on a contiguous tick range.
+ * @date   October 19, 2026
+ * @see    icaruscode/PMT/Trigger/Utilities/TriggerGateOperations.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef ICARUSCODE_PMT_TRIGGER_UTILITIES_DENSETRIGGERGATE_H
+#define ICARUSCODE_PMT_TRIGGER_UTILITIES_DENSETRIGGERGATE_H
+
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::min(), std::max(), std::fill()
+#include <iterator> // std::distance()
+#include <utility> // std::pair<>
+#include <limits>
+#include <cstdint> // std::uint64_t
+#include <cstddef> // std::size_t
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::trigger {
+
+  template <typename ClockTick> class TriggerGateBits;
+  template <typename GateData> class DenseTriggerGate;
+
+} // namespace icarus::trigger
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Open/closed status of a gate, one bit per tick.
+ * @tparam ClockTick type of the tick
+ *
+ * The status of the ticks in the range [ `startTick()`, `endTick()` [ is
+ * packed in 64-bit words, and the combination of gates (`operator&=()`,
+ * `operator|=()`, `atLeast()`) works on 64 ticks at a time.
+ * Outside that range the gate is closed.
+ * Combined gates must cover the same tick range.
+ */
+template <typename ClockTick>
+class icarus::trigger::TriggerGateBits {
+
+    public:
+
+  using ClockTick_t = ClockTick; ///< Type of the tick.
+  using Word_t = std::uint64_t; ///< Type of the word holding the bits.
+
+  /// Number of ticks in a word.
+  static constexpr std::size_t WordBits = std::numeric_limits<Word_t>::digits;
+
+  /// Constructor: all `nTicks` ticks from `startTick` closed, or `open`.
+  TriggerGateBits
+    (ClockTick_t startTick = 0, std::size_t nTicks = 0U, bool open = false);
+
+  /// Returns the first tick in the range.
+  ClockTick_t startTick() const { return fStartTick; }
+
+  /// Returns the tick after the last one in the range.
+  ClockTick_t endTick() const
+    { return fStartTick + static_cast<ClockTick_t>(fNTicks); }
+
+  /// Returns the number of ticks in the range.
+  std::size_t nTicks() const { return fNTicks; }
+
+  /// Returns whether the gate is open at `tick`.
+  bool isOpen(ClockTick_t tick) const;
+
+  /// Returns whether the gate is open at any tick.
+  bool any() const;
+
+  /// Returns the number of ticks the gate is open.
+  std::size_t count() const;
+
+  /// Opens the gate at the `offset`-th tick of the range.
+  void setOpenAt(std::size_t offset)
+    { fWords[offset / WordBits] |= Word_t{ 1U } << (offset % WordBits); }
+
+  /// Replaces the status of the 64 ticks of word `index` (see `words()`).
+  void setWord(std::size_t index, Word_t word) { fWords[index] = word; }
+
+  /// Keeps the gate open only where `other` is also open.
+  TriggerGateBits& operator&= (TriggerGateBits const& other);
+
+  /// Opens the gate also where `other` is open.
+  TriggerGateBits& operator|= (TriggerGateBits const& other);
+
+  /// Returns the packed words (bit `b` of word `w` is tick `w * 64 + b`).
+  std::vector<Word_t> const& words() const { return fWords; }
+
+  /**
+   * @brief Returns a gate open where at least `minCount` gates are open.
+   * @tparam BIter type of iterator to the gates
+   * @tparam EIter type of end iterator to the gates
+   * @param begin iterator to the first gate
+   * @param end iterator past the last gate
+   * @param minCount minimum number of open gates
+   * @return a gate open where at least `minCount` of the gates are open
+   *
+   * The counts are kept in bit-sliced form (one word per bit of the count),
+   * so that each input word is added to 64 counters at once.
+   * All the gates must cover the same tick range, and there must be at least
+   * one.
+   */
+  template <typename BIter, typename EIter>
+  static TriggerGateBits atLeast
+    (BIter begin, EIter end, std::size_t minCount);
+
+    private:
+
+  ClockTick_t fStartTick = 0; ///< First tick in the range.
+  std::size_t fNTicks = 0U; ///< Number of ticks in the range.
+  std::vector<Word_t> fWords; ///< Packed bits; bits past the range are `0`.
+
+  /// Returns whether `other` covers the same range as this gate.
+  bool sameRange(TriggerGateBits const& other) const
+    { return (fStartTick == other.fStartTick) && (fNTicks == other.fNTicks); }
+
+}; // icarus::trigger::TriggerGateBits
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Opening count of a gate, sampled at each tick in a range.
+ * @tparam GateData type of trigger gate data being represented
+ *
+ * The opening counts of the ticks in [ `startTick()`, `endTick()` [ are stored
+ * in a contiguous array, while outside that range the gate is closed.
+ * This is the case of gates which have already been put in coincidence with a
+ * beam gate, when the range covers that beam gate.
+ *
+ * Gate combinations (`Sum()`, `Max()`, `Mul()`, `Mask()`) and discrimination
+ * (`above()`) are loops on the arrays which the compiler can vectorize;
+ * the result is the same as the corresponding operation on `GateData`, and it
+ * can be converted back with `toGateData()`.
+ * Combined gates must cover the same tick range.
+ *
+ * The query interface (`openingCount()`, `findOpen()`, `findClose()`,
+ * `findMaxOpen()`) follows the one of `GateData`, so that algorithms like
+ * `icarus::trigger::details::GateOpeningInfoExtractor` work on both.
+ */
+template <typename GateData>
+class icarus::trigger::DenseTriggerGate {
+
+    public:
+
+  using GateData_t = GateData; ///< Type of the represented gate data.
+
+  using ClockTick_t = typename GateData_t::ClockTick_t; ///< Type of the tick.
+
+  /// Type of the gate opening count.
+  using OpeningCount_t = typename GateData_t::OpeningCount_t;
+
+  /// Type of the bit-packed representation of gates.
+  using Bits_t = icarus::trigger::TriggerGateBits<ClockTick_t>;
+
+  /// Lowest tick.
+  static constexpr ClockTick_t MinTick = GateData_t::MinTick;
+
+  /// Highest tick (also returned when a search finds nothing).
+  static constexpr ClockTick_t MaxTick = GateData_t::MaxTick;
+
+  /// Constructor: gate closed everywhere, with range from `startTick` on.
+  DenseTriggerGate(ClockTick_t startTick = 0, std::size_t nTicks = 0U)
+    : fStartTick(startTick), fLevels(nTicks, OpeningCount_t{ 0 }) {}
+
+  /**
+   * @brief Constructor: samples `gate` in [ `startTick`, `endTick` [.
+   * @param gate the gate to be sampled
+   * @param startTick first tick of the range
+   * @param endTick tick after the last one in the range
+   *
+   * The opening of `gate` outside the range is ignored.
+   */
+  DenseTriggerGate
+    (GateData_t const& gate, ClockTick_t startTick, ClockTick_t endTick);
+
+
+  // --- BEGIN -- Query --------------------------------------------------------
+  /// @name Query
+  /// @{
+
+  /// Returns the first tick in the range.
+  ClockTick_t startTick() const { return fStartTick; }
+
+  /// Returns the tick after the last one in the range.
+  ClockTick_t endTick() const
+    { return fStartTick + static_cast<ClockTick_t>(fLevels.size()); }
+
+  /// Returns the number of ticks in the range.
+  std::size_t nTicks() const { return fLevels.size(); }
+
+  /// Returns the opening counts, starting from `startTick()`.
+  std::vector<OpeningCount_t> const& levels() const { return fLevels; }
+
+  /// Returns the opening count at `tick` (`0` outside the range).
+  OpeningCount_t openingCount(ClockTick_t tick) const
+    { return contains(tick)? fLevels[offset(tick)]: OpeningCount_t{ 0 }; }
+
+  /// Returns the first tick from `start` with opening at least `minOpening`.
+  ClockTick_t findOpen
+    (OpeningCount_t minOpening = 1U, ClockTick_t start = MinTick) const;
+
+  /// Returns the first tick from `start` with opening below `minOpening`.
+  ClockTick_t findClose
+    (OpeningCount_t minOpening = 1U, ClockTick_t start = MinTick) const;
+
+  /// Returns the first tick with the largest opening in [ `start`, `end` [.
+  ClockTick_t findMaxOpen
+    (ClockTick_t start = MinTick, ClockTick_t end = MaxTick) const;
+
+  /// Returns whether the gate is never open.
+  bool alwaysClosed() const;
+
+  /// @}
+  // --- END ---- Query --------------------------------------------------------
+
+
+  // --- BEGIN -- Combination --------------------------------------------------
+  /// @name Combination
+  /// @{
+
+  /// Adds the opening counts of `other` to this gate.
+  DenseTriggerGate& Sum(DenseTriggerGate const& other);
+
+  /// Keeps at each tick the largest opening count of this gate and `other`.
+  DenseTriggerGate& Max(DenseTriggerGate const& other);
+
+  /// Multiplies the opening counts by the ones of `other`.
+  DenseTriggerGate& Mul(DenseTriggerGate const& other);
+
+  /// Closes this gate where `mask` is closed, leaving the rest unchanged.
+  DenseTriggerGate& Mask(Bits_t const& mask);
+
+  /// Returns a gate open where the opening count is at least `threshold`.
+  Bits_t above(OpeningCount_t threshold) const;
+
+  /// @}
+  // --- END ---- Combination --------------------------------------------------
+
+
+  /// Returns a gate data object with the same opening as this gate.
+  GateData_t toGateData() const;
+
+  /**
+   * @brief Returns the smallest range including all openings of `gate`.
+   * @tparam Gate type of gate data
+   * @param gate the gate to be inspected
+   * @return the first tick `gate` is open, and the tick of its last closing
+   *
+   * If `gate` is never open, an empty range is returned.
+   * If `gate` never closes, the end of the range is `MaxTick`.
+   * This is typically used on a beam gate to find the range of a dense gate.
+   */
+  template <typename Gate>
+  static std::pair<ClockTick_t, ClockTick_t> openRange(Gate const& gate);
+
+    private:
+
+  ClockTick_t fStartTick = 0; ///< First tick in the range.
+  std::vector<OpeningCount_t> fLevels; ///< Opening count at each tick.
+
+  /// Returns whether `tick` is in the range.
+  bool contains(ClockTick_t tick) const
+    { return (tick >= fStartTick) && (tick < endTick()); }
+
+  /// Returns the index of `tick` in the level array.
+  std::size_t offset(ClockTick_t tick) const
+    { return static_cast<std::size_t>(tick - fStartTick); }
+
+  /// Returns the tick of the level at index `offset`.
+  ClockTick_t tickAt(std::size_t offset) const
+    { return fStartTick + static_cast<ClockTick_t>(offset); }
+
+  /// Returns whether `other` covers the same range as this gate.
+  bool sameRange(DenseTriggerGate const& other) const
+    { return (fStartTick == other.fStartTick) && (nTicks() == other.nTicks()); }
+
+}; // icarus::trigger::DenseTriggerGate
+
+
+// =============================================================================
+// ===  template implementation
+// =============================================================================
+// ---  icarus::trigger::TriggerGateBits
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+icarus::trigger::TriggerGateBits<ClockTick>::TriggerGateBits
+  (ClockTick_t startTick /* = 0 */, std::size_t nTicks /* = 0U */,
+   bool open /* = false */)
+  : fStartTick(startTick)
+  , fNTicks(nTicks)
+  , fWords((nTicks + WordBits - 1) / WordBits, open? ~Word_t{ 0U }: Word_t{ 0U })
+{
+  // bits past the end of the range must stay closed
+  if (open && (fNTicks % WordBits))
+    fWords.back() = (Word_t{ 1U } << (fNTicks % WordBits)) - 1U;
+} // icarus::trigger::TriggerGateBits<>::TriggerGateBits()
+
+
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+bool icarus::trigger::TriggerGateBits<ClockTick>::isOpen
+  (ClockTick_t tick) const
+{
+  if ((tick < fStartTick) || (tick >= endTick())) return false;
+  std::size_t const offset = static_cast<std::size_t>(tick - fStartTick);
+  return (fWords[offset / WordBits] >> (offset % WordBits)) & 1U;
+} // icarus::trigger::TriggerGateBits<>::isOpen()
+
+
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+bool icarus::trigger::TriggerGateBits<ClockTick>::any() const {
+  Word_t all { 0U };
+  for (Word_t const word: fWords) all |= word;
+  return all != 0U;
+} // icarus::trigger::TriggerGateBits<>::any()
+
+
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+std::size_t icarus::trigger::TriggerGateBits<ClockTick>::count() const {
+  std::size_t n = 0U;
+  for (Word_t const word: fWords) n += __builtin_popcountll(word);
+  return n;
+} // icarus::trigger::TriggerGateBits<>::count()
+
+
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+auto icarus::trigger::TriggerGateBits<ClockTick>::operator&=
+  (TriggerGateBits const& other) -> TriggerGateBits&
+{
+  assert(sameRange(other));
+  Word_t* words = fWords.data();
+  Word_t const* otherWords = other.fWords.data();
+  std::size_t const nWords = fWords.size();
+  for (std::size_t i = 0; i < nWords; ++i) words[i] &= otherWords[i];
+  return *this;
+} // icarus::trigger::TriggerGateBits<>::operator&=()
+
+
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+auto icarus::trigger::TriggerGateBits<ClockTick>::operator|=
+  (TriggerGateBits const& other) -> TriggerGateBits&
+{
+  assert(sameRange(other));
+  Word_t* words = fWords.data();
+  Word_t const* otherWords = other.fWords.data();
+  std::size_t const nWords = fWords.size();
+  for (std::size_t i = 0; i < nWords; ++i) words[i] |= otherWords[i];
+  return *this;
+} // icarus::trigger::TriggerGateBits<>::operator|=()
+
+
+// -----------------------------------------------------------------------------
+template <typename ClockTick>
+template <typename BIter, typename EIter>
+auto icarus::trigger::TriggerGateBits<ClockTick>::atLeast
+  (BIter begin, EIter end, std::size_t minCount) -> TriggerGateBits
+{
+  assert(begin != end);
+  TriggerGateBits const& first = *begin;
+  std::size_t const nWords = first.fWords.size();
+
+  if (minCount == 0U) return { first.fStartTick, first.fNTicks, true };
+
+  // number of bits needed to count all the gates
+  std::size_t const nGates = std::distance(begin, end);
+  std::size_t nPlanes = 1U;
+  while ((nGates >> nPlanes) > 0U) ++nPlanes;
+
+  // bit-sliced counters: bit `b` of plane `p` is bit `p` of the count of tick
+  // `b` (all planes of a word are contiguous)
+  std::vector<Word_t> planes(nWords * nPlanes, Word_t{ 0U });
+  for (auto iGate = begin; iGate != end; ++iGate) {
+    TriggerGateBits const& gate = *iGate;
+    assert(gate.sameRange(first));
+    Word_t const* words = gate.fWords.data();
+    for (std::size_t i = 0; i < nWords; ++i) {
+      Word_t* counter = planes.data() + i * nPlanes;
+      Word_t carry = words[i];
+      for (std::size_t p = 0; (p < nPlanes) && carry; ++p) {
+        Word_t const nextCarry = counter[p] & carry;
+        counter[p] ^= carry;
+        carry = nextCarry;
+      } // for planes
+    } // for words
+  } // for gates
+
+  // comparison of the counters with `minCount`, from the most significant bit
+  TriggerGateBits result { first.fStartTick, first.fNTicks };
+  if ((minCount >> nPlanes) > 0U) return result; // more than the gates
+  for (std::size_t i = 0; i < nWords; ++i) {
+    Word_t const* counter = planes.data() + i * nPlanes;
+    Word_t greater { 0U };
+    Word_t equal = ~Word_t{ 0U };
+    for (std::size_t p = nPlanes; p-- > 0; ) {
+      if ((minCount >> p) & 1U) equal &= counter[p];
+      else {
+        greater |= equal & counter[p];
+        equal &= ~counter[p];
+      }
+    } // for planes
+    result.fWords[i] = greater | equal;
+  } // for words
+
+  // bits past the range have null counts, which pass only if `minCount` is 0
+  return result;
+} // icarus::trigger::TriggerGateBits<>::atLeast()
+
+
+// -----------------------------------------------------------------------------
+// ---  icarus::trigger::DenseTriggerGate
+// -----------------------------------------------------------------------------
+template <typename GateData>
+icarus::trigger::DenseTriggerGate<GateData>::DenseTriggerGate
+  (GateData_t const& gate, ClockTick_t startTick, ClockTick_t endTick)
+  : fStartTick(startTick)
+  , fLevels((endTick > startTick)? endTick - startTick: 0, OpeningCount_t{ 0 })
+{
+  // jump from one change of opening to the next one
+  ClockTick_t tick = startTick;
+  while (tick < endTick) {
+    OpeningCount_t const level = gate.openingCount(tick);
+    ClockTick_t next = gate.findOpen(level + 1, tick + 1);
+    if (level > 0) next = std::min(next, gate.findClose(level, tick + 1));
+    next = std::min(next, endTick);
+    std::fill
+      (fLevels.begin() + offset(tick), fLevels.begin() + offset(next), level);
+    tick = next;
+  } // while
+} // icarus::trigger::DenseTriggerGate<>::DenseTriggerGate()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::findOpen
+  (OpeningCount_t minOpening /* = 1U */, ClockTick_t start /* = MinTick */)
+  const -> ClockTick_t
+{
+  if (minOpening == 0) return start; // always open
+  if (start >= endTick()) return MaxTick; // closed past the range
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = (start > fStartTick)? offset(start): 0U; i < nTicks; ++i)
+    if (fLevels[i] >= minOpening) return tickAt(i);
+  return MaxTick;
+} // icarus::trigger::DenseTriggerGate<>::findOpen()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::findClose
+  (OpeningCount_t minOpening /* = 1U */, ClockTick_t start /* = MinTick */)
+  const -> ClockTick_t
+{
+  if (minOpening == 0) return MaxTick; // never closed
+  if (!contains(start)) return start; // closed outside the range
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = offset(start); i < nTicks; ++i)
+    if (fLevels[i] < minOpening) return tickAt(i);
+  return endTick();
+} // icarus::trigger::DenseTriggerGate<>::findClose()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::findMaxOpen
+  (ClockTick_t start /* = MinTick */, ClockTick_t end /* = MaxTick */) const
+  -> ClockTick_t
+{
+  ClockTick_t maxTick = start;
+  OpeningCount_t maxLevel = openingCount(start);
+
+  std::size_t const first = (start > fStartTick)? offset(start): 0U;
+  std::size_t const last = (end < endTick())
+    ? ((end > fStartTick)? offset(end): 0U): fLevels.size();
+  for (std::size_t i = first; i < last; ++i) {
+    if (fLevels[i] <= maxLevel) continue;
+    maxLevel = fLevels[i];
+    maxTick = tickAt(i);
+  } // for
+  return maxTick;
+} // icarus::trigger::DenseTriggerGate<>::findMaxOpen()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+bool icarus::trigger::DenseTriggerGate<GateData>::alwaysClosed() const {
+  OpeningCount_t all { 0 };
+  for (OpeningCount_t const level: fLevels) all |= level;
+  return all == 0;
+} // icarus::trigger::DenseTriggerGate<>::alwaysClosed()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::Sum
+  (DenseTriggerGate const& other) -> DenseTriggerGate&
+{
+  assert(sameRange(other));
+  OpeningCount_t* levels = fLevels.data();
+  OpeningCount_t const* otherLevels = other.fLevels.data();
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = 0; i < nTicks; ++i) levels[i] += otherLevels[i];
+  return *this;
+} // icarus::trigger::DenseTriggerGate<>::Sum()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::Max
+  (DenseTriggerGate const& other) -> DenseTriggerGate&
+{
+  assert(sameRange(other));
+  OpeningCount_t* levels = fLevels.data();
+  OpeningCount_t const* otherLevels = other.fLevels.data();
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = 0; i < nTicks; ++i)
+    levels[i] = std::max(levels[i], otherLevels[i]);
+  return *this;
+} // icarus::trigger::DenseTriggerGate<>::Max()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::Mul
+  (DenseTriggerGate const& other) -> DenseTriggerGate&
+{
+  assert(sameRange(other));
+  OpeningCount_t* levels = fLevels.data();
+  OpeningCount_t const* otherLevels = other.fLevels.data();
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = 0; i < nTicks; ++i) levels[i] *= otherLevels[i];
+  return *this;
+} // icarus::trigger::DenseTriggerGate<>::Mul()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::Mask(Bits_t const& mask)
+  -> DenseTriggerGate&
+{
+  assert(mask.startTick() == fStartTick);
+  assert(mask.nTicks() == fLevels.size());
+
+  constexpr std::size_t WordBits = Bits_t::WordBits;
+  std::vector<typename Bits_t::Word_t> const& words = mask.words();
+  OpeningCount_t* levels = fLevels.data();
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = 0; i < nTicks; ++i) {
+    OpeningCount_t const open = (words[i / WordBits] >> (i % WordBits)) & 1U;
+    levels[i] *= open;
+  }
+  return *this;
+} // icarus::trigger::DenseTriggerGate<>::Mask()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::above
+  (OpeningCount_t threshold) const -> Bits_t
+{
+  constexpr std::size_t WordBits = Bits_t::WordBits;
+  using Word_t = typename Bits_t::Word_t;
+
+  std::size_t const nTicks = fLevels.size();
+  Bits_t bits { fStartTick, nTicks };
+  if (threshold == 0) return { fStartTick, nTicks, true };
+
+  // a whole word of comparisons at a time
+  OpeningCount_t const* levels = fLevels.data();
+  for (std::size_t first = 0; first < nTicks; first += WordBits) {
+    std::size_t const n = std::min(WordBits, nTicks - first);
+    Word_t word { 0U };
+    for (std::size_t b = 0; b < n; ++b)
+      word |= Word_t(levels[first + b] >= threshold) << b;
+    bits.setWord(first / WordBits, word);
+  } // for words
+  return bits;
+} // icarus::trigger::DenseTriggerGate<>::above()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+auto icarus::trigger::DenseTriggerGate<GateData>::toGateData() const
+  -> GateData_t
+{
+  GateData_t gate; // starts closed
+  OpeningCount_t current { 0 };
+  std::size_t const nTicks = fLevels.size();
+  for (std::size_t i = 0; i < nTicks; ++i) {
+    OpeningCount_t const level = fLevels[i];
+    if (level > current) gate.openAt(tickAt(i), level - current);
+    else if (level < current) gate.closeAt(tickAt(i), current - level);
+    current = level;
+  } // for
+  if (current > 0) gate.closeAt(endTick(), current);
+  return gate;
+} // icarus::trigger::DenseTriggerGate<>::toGateData()
+
+
+// -----------------------------------------------------------------------------
+template <typename GateData>
+template <typename Gate>
+auto icarus::trigger::DenseTriggerGate<GateData>::openRange(Gate const& gate)
+  -> std::pair<ClockTick_t, ClockTick_t>
+{
+  ClockTick_t const open = gate.findOpen(1U, MinTick);
+  if (open == MaxTick) return { 0, 0 };
+  ClockTick_t close = gate.findClose(1U, open);
+  while (close != MaxTick) {
+    ClockTick_t const reopen = gate.findOpen(1U, close);
+    if (reopen == MaxTick) break;
+    close = gate.findClose(1U, reopen);
+  } // while
+  return { open, close };
+} // icarus::trigger::DenseTriggerGate<>::openRange()
+
+
+// -----------------------------------------------------------------------------
+
+
+#endif // ICARUSCODE_PMT_TRIGGER_UTILITIES_DENSETRIGGERGATE_H
@@ -20,6 +20,8 @@
 // ROOT libraries
 
 // C/C++ standard libraries
+#include <algorithm> // std::replace()
+#include <atomic>
 #include <string_view>
 #include <utility> // std::forward()
 #include <type_traits> // std::add_const_t<>
@@ -178,6 +180,8 @@ bool icarus::trigger::PlotSandbox::deleteSubSandbox(std::string const& name) {
   
   if (it->second) {
     auto&& subbox = std::move(it->second); // will get destroyed at end of scope
+    std::replace(fData.registeredBoxes.begin(), fData.registeredBoxes.end(),
+      subbox.get(), static_cast<PlotSandbox*>(nullptr));
     if (subbox->getDirectory()) delete subbox->getDirectory();
     if (getDirectory()) getDirectory()->Delete((name + ";*").c_str());
   }
@@ -187,6 +191,42 @@ bool icarus::trigger::PlotSandbox::deleteSubSandbox(std::string const& name) {
 } // icarus::trigger::PlotSandbox::deleteSubSandbox()
 
 
+//------------------------------------------------------------------------------
+auto icarus::trigger::PlotSandbox::registerSandbox(SandboxKey const& key)
+  -> PlotSandbox*
+{
+  PlotSandbox* box = findSandbox(key.name());
+  if (!box) return nullptr;
+  
+  auto& registered = fData.registeredBoxes;
+  if (registered.size() <= key.index())
+    registered.resize(key.index() + 1, nullptr);
+  registered[key.index()] = box;
+  return box;
+} // icarus::trigger::PlotSandbox::registerSandbox()
+
+
+//------------------------------------------------------------------------------
+auto icarus::trigger::PlotSandbox::demandSandbox(SandboxKey const& key) const
+  -> PlotSandbox const&
+{
+  auto const& registered = fData.registeredBoxes;
+  if ((key.index() < registered.size()) && registered[key.index()])
+    return *registered[key.index()];
+  return demandSandbox(key.name());
+} // icarus::trigger::PlotSandbox::demandSandbox(SandboxKey) const
+
+
+auto icarus::trigger::PlotSandbox::demandSandbox(SandboxKey const& key)
+  -> PlotSandbox&
+{
+  auto const& registered = fData.registeredBoxes;
+  if ((key.index() < registered.size()) && registered[key.index()])
+    return *registered[key.index()];
+  return demandSandbox(key.name());
+} // icarus::trigger::PlotSandbox::demandSandbox(SandboxKey)
+
+
 //------------------------------------------------------------------------------
 icarus::trigger::PlotSandbox::PlotSandbox
   (PlotSandbox const& parent, std::string name, std::string desc)
@@ -264,6 +304,13 @@ std::pair<std::string, std::string> icarus::trigger::PlotSandbox::splitPath
 } // icarus::trigger::PlotSandbox::splitPath()
 
 
+//------------------------------------------------------------------------------
+std::size_t icarus::trigger::PlotSandbox::nextObjectKeyIndex() {
+  static std::atomic<std::size_t> NextIndex { 0U };
+  return NextIndex++;
+} // icarus::trigger::PlotSandbox::nextObjectKeyIndex()
+
+
 //------------------------------------------------------------------------------
 std::string icarus::trigger::PlotSandbox::joinPath
   (std::initializer_list<std::string> pathElements, char sep /* = '/' */)
@@ -11,6 +11,7 @@
 
 // LArSoft libraries
 #include "larcorealg/CoreUtils/span.h" // util::make_transformed_span(), ...
+#include "larcorealg/CoreUtils/values.h" // util::values()
 
 // framework libraries
 #include "art_root_io/TFileDirectory.h"
@@ -27,11 +28,13 @@
 // C/C++ standard libraries
 #include <string>
 #include <map>
+#include <vector>
 #include <iterator> // std::prev()
 #include <utility> // std::pair<>
 #include <functional> // std::hash<>
 #include <initializer_list>
 #include <memory> // std::unique_ptr<>
+#include <type_traits> // std::is_same_v<>
 
 
 //------------------------------------------------------------------------------
@@ -86,6 +89,27 @@ namespace icarus::trigger { class PlotSandbox; }
  * 
  * @note By convention the subdirectory names are not processed.
  * 
+ * 
+ * Fast access to objects
+ * -----------------------
+ * 
+ * Fetching an object by name (`get()`, `use()`, `demand()`) processes the name
+ * through the whole chain of parent boxes and then looks it up in the ROOT
+ * directory, which is too slow to be done for every fill of every plot.
+ * An object can instead be accessed via an `ObjectKey`: the key is created
+ * once (typically as a static constant) from the unprocessed object name, and
+ * the object is associated to it in each box with `registerObject()` (or in a
+ * box and all its subboxes with `registerObjects()`), usually right after the
+ * plots are created. After that, `use()` and `demand()` with the key return
+ * the object from an index without any string processing.
+ * An object of a key that was not registered in a box is still looked up by
+ * name.
+ * Contained sandboxes can be accessed in the same way, with a `SandboxKey`
+ * registered with `registerSandbox()` (or `registerSandboxes()`) and used in
+ * `demandSandbox()`.
+ * 
+ * Registration is not thread-safe, while access via keys is.
+ * 
  */
 class icarus::trigger::PlotSandbox {
   
@@ -125,6 +149,12 @@ class icarus::trigger::PlotSandbox {
     /// Contained sand boxes.
     std::map<std::string, std::unique_ptr<PlotSandbox>> subBoxes;
     
+    /// Objects registered with a key (index: key index).
+    std::vector<TObject*> registered;
+    
+    /// Contained sand boxes registered with a key (index: key index).
+    std::vector<PlotSandbox*> registeredBoxes;
+    
     TFileDirectoryHelper outputDir; ///< Output ROOT directory of the sandbox.
     
     Data_t() = default;
@@ -155,6 +185,62 @@ class icarus::trigger::PlotSandbox {
   
     public:
   
+  /**
+   * @brief Key for fast access to an object in sandboxes.
+   * @tparam Obj type of the object
+   * @see `registerObject()`, `use()`, `demand()`
+   * 
+   * A key holds the unprocessed name of the object and an index unique in the
+   * process, so the same key can be used in all the boxes holding an object
+   * with that name.
+   */
+  template <typename Obj>
+  class ObjectKey {
+    
+    std::string fName; ///< Unprocessed name (and path) of the object.
+    std::size_t fIndex; ///< Index of the key.
+    
+      public:
+    
+    /// Constructor: a new key for objects with the unprocessed `name`.
+    explicit ObjectKey(std::string name)
+      : fName(std::move(name)), fIndex(nextObjectKeyIndex()) {}
+    
+    /// Returns the unprocessed name of the object.
+    std::string const& name() const { return fName; }
+    
+    /// Returns the index of this key.
+    std::size_t index() const { return fIndex; }
+    
+  }; // ObjectKey
+  
+  
+  /**
+   * @brief Key for fast access to a contained sandbox.
+   * @see `registerSandbox()`, `demandSandbox()`
+   * 
+   * This is the equivalent of `ObjectKey` for sandboxes contained in a box.
+   */
+  class SandboxKey {
+    
+    std::string fName; ///< Unprocessed name of the sandbox.
+    std::size_t fIndex; ///< Index of the key.
+    
+      public:
+    
+    /// Constructor: a new key for sandboxes with the unprocessed `name`.
+    explicit SandboxKey(std::string name)
+      : fName(std::move(name)), fIndex(nextObjectKeyIndex()) {}
+    
+    /// Returns the unprocessed name of the sandbox.
+    std::string const& name() const { return fName; }
+    
+    /// Returns the index of this key.
+    std::size_t index() const { return fIndex; }
+    
+  }; // SandboxKey
+  
+  
   /**
    * @brief Constructor: specifies all sandbox characteristics.
    * @param parentDir ROOT directory under which the sandbox is created
@@ -303,6 +389,55 @@ class icarus::trigger::PlotSandbox {
   template <typename Obj, typename... Args>
   Obj* make(std::string const& name, std::string const& title, Args&&... args);
   
+  /**
+   * @brief Associates the object with the name of `key` to the `key`.
+   * @tparam Obj type of the object
+   * @param key the key to register
+   * @return a pointer to the registered object, `nullptr` if not available
+   * @see `registerObjects()`
+   * 
+   * The object is looked up as in `use()`. If it is not available, the key is
+   * not registered and access via the key falls back to the name.
+   */
+  template <typename Obj>
+  Obj* registerObject(ObjectKey<Obj> const& key);
+  
+  /**
+   * @brief Registers all the `keys` in this box and in all the contained ones.
+   * @param keys the keys to register
+   * @see `registerObject()`
+   * 
+   * Boxes without an object for some of the keys are silently skipped.
+   */
+  template <typename... Objs>
+  void registerObjects(ObjectKey<Objs> const&... keys);
+  
+  /**
+   * @brief Fetches the object registered with `key` to be modified.
+   * @tparam Obj type of the object to fetch
+   * @param key key of the object
+   * @return a pointer to the requested object, or `nullptr` if not available
+   * 
+   * If `key` was not registered in this box, the object is looked up by name
+   * as in `use(std::string const&)`.
+   */
+  template <typename Obj>
+  Obj* use(ObjectKey<Obj> const& key) const;
+  
+  /**
+   * @brief Fetches the object registered with `key` to be modified.
+   * @tparam Obj type of the object to fetch
+   * @param key key of the object
+   * @return the requested object
+   * @throw cet::exception (category: `"PlotSandbox"`) if no object with the
+   *        name of `key` exists in the box
+   * 
+   * If `key` was not registered in this box, the object is looked up by name
+   * as in `demand(std::string const&)`.
+   */
+  template <typename Obj>
+  Obj& demand(ObjectKey<Obj> const& key) const;
+  
   /// @}
   // --- END -- ROOT object management -----------------------------------------
   
@@ -359,6 +494,42 @@ class icarus::trigger::PlotSandbox {
   PlotSandbox& demandSandbox(std::string const& name);
   // @}
   
+  /**
+   * @brief Associates the contained sandbox with the name of `key` to the key.
+   * @param key the key to register
+   * @return a pointer to the registered sandbox, `nullptr` if not available
+   * @see `registerSandboxes()`
+   * 
+   * If there is no contained sandbox with that name, the key is not
+   * registered and access via the key falls back to the name.
+   */
+  PlotSandbox* registerSandbox(SandboxKey const& key);
+  
+  /**
+   * @brief Registers all the `keys` in this box and in all the contained ones.
+   * @param keys the keys to register
+   * @see `registerSandbox()`
+   * 
+   * Boxes without a sandbox for some of the keys are silently skipped.
+   */
+  template <typename... Keys>
+  void registerSandboxes(Keys const&... keys);
+  
+  // @{
+  /**
+   * @brief Returns the contained sandbox registered with `key`.
+   * @param key key of the sandbox
+   * @return the requested contained sandbox
+   * @throw cet::exception (category: `"PlotSandbox"`) if no sandbox with the
+   *        name of `key` exists in the box
+   * 
+   * If `key` was not registered in this box, the sandbox is looked up by name
+   * as in `demandSandbox(std::string const&)`.
+   */
+  PlotSandbox const& demandSandbox(SandboxKey const& key) const;
+  PlotSandbox& demandSandbox(SandboxKey const& key);
+  // @}
+  
   // @{
   /// Returns an object proper to iterate through all contained sand boxes.
   decltype(auto) subSandboxes() const
@@ -433,6 +604,9 @@ class icarus::trigger::PlotSandbox {
   static std::pair<std::string, std::string> splitPath
     (std::string const& path, char sep = '/');
   
+  /// Returns a new index for an `ObjectKey`.
+  static std::size_t nextObjectKeyIndex();
+  
   /// Merges the pieces of path that are not empty into a path.
   /// One separator at the end of each piece is ignored.
   static std::string joinPath
@@ -558,6 +732,71 @@ Obj* icarus::trigger::PlotSandbox::make
 } // icarus::trigger::PlotSandbox::make()
 
 
+//------------------------------------------------------------------------------
+template <typename Obj>
+Obj* icarus::trigger::PlotSandbox::registerObject(ObjectKey<Obj> const& key) {
+  
+  Obj* obj = use<Obj>(key.name());
+  if (!obj) return nullptr;
+  
+  auto& registered = fData.registered;
+  if (registered.size() <= key.index())
+    registered.resize(key.index() + 1, nullptr);
+  registered[key.index()] = obj;
+  return obj;
+  
+} // icarus::trigger::PlotSandbox::registerObject()
+
+
+//------------------------------------------------------------------------------
+template <typename... Objs>
+void icarus::trigger::PlotSandbox::registerObjects
+  (ObjectKey<Objs> const&... keys)
+{
+  (registerObject(keys), ...);
+  for (auto& subbox: util::values(fData.subBoxes))
+    subbox->registerObjects(keys...);
+} // icarus::trigger::PlotSandbox::registerObjects()
+
+
+//------------------------------------------------------------------------------
+template <typename Obj>
+Obj* icarus::trigger::PlotSandbox::use(ObjectKey<Obj> const& key) const {
+  
+  // registration stored an object of type `Obj` (or none)
+  auto const& registered = fData.registered;
+  if ((key.index() < registered.size()) && registered[key.index()])
+    return static_cast<Obj*>(registered[key.index()]);
+  
+  return use<Obj>(key.name());
+  
+} // icarus::trigger::PlotSandbox::use(ObjectKey)
+
+
+//------------------------------------------------------------------------------
+template <typename Obj>
+Obj& icarus::trigger::PlotSandbox::demand(ObjectKey<Obj> const& key) const {
+  
+  auto const& registered = fData.registered;
+  if ((key.index() < registered.size()) && registered[key.index()])
+    return *static_cast<Obj*>(registered[key.index()]);
+  
+  return demand<Obj>(key.name());
+  
+} // icarus::trigger::PlotSandbox::demand(ObjectKey)
+
+
+//------------------------------------------------------------------------------
+template <typename... Keys>
+void icarus::trigger::PlotSandbox::registerSandboxes(Keys const&... keys) {
+  static_assert((std::is_same_v<Keys, SandboxKey> && ...),
+    "registerSandboxes() requires `PlotSandbox::SandboxKey` arguments");
+  (registerSandbox(keys), ...);
+  for (auto& subbox: util::values(fData.subBoxes))
+    subbox->registerSandboxes(keys...);
+} // icarus::trigger::PlotSandbox::registerSandboxes()
+
+
 //------------------------------------------------------------------------------
 template
   <typename SandboxType /* = icarus::trigger::PlotSandbox */, typename... Args>
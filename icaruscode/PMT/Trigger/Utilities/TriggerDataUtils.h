@@ -126,6 +126,7 @@ namespace icarus::trigger {
   /**
    * @brief Returns the trigger gates in serializable format.
    * @tparam Gates type of the source of trigger gate data
+   * @tparam OpDetWavePtrs type of map from waveform address to _art_ pointer
    * @param gates the data to be reformatted (*data will be stolen!*)
    * @param makeGatePtr _art_ pointer maker for the gate data
    * @param opDetWavePtrs map of art pointers to optical waveforms
@@ -191,7 +192,7 @@ namespace icarus::trigger {
    * // optical waveform to pointer map is required to create associations
    * // between the trigger gates and their waveforms
    * //
-   * auto const& opDetWavePtrs = util::mapDataProductPointers
+   * auto const& opDetWavePtrs = util::indexDataProductPointers
    *   (event, event.getValidHandle<std::vector<raw::OpDetWaveform>>("opdaq"));
    * // transform the data; after this line, `gates` is not usable any more
    * auto thresholdData = icarus::trigger::transformIntoOpticalTriggerGate
@@ -216,8 +217,12 @@ namespace icarus::trigger {
    * with the different outcome that now each trigger gate may be associated
    * to waveforms from different optical detector channels.
    *
+   * The map `opDetWavePtrs` can be either a `OpDetWaveformDataProductMap_t`
+   * (e.g. from `util::mapDataProductPointers()`) or an index from
+   * `util::indexDataProductPointers()`: it is only required to support
+   * `at(raw::OpDetWaveform const*)` returning the matching _art_ pointer.
    */
-  template <typename Gates>
+  template <typename Gates, typename OpDetWavePtrs>
   std::tuple<
     std::vector<icarus::trigger::OpticalTriggerGateData_t>,
     art::Assns<icarus::trigger::OpticalTriggerGateData_t, raw::OpDetWaveform>
@@ -225,7 +230,7 @@ namespace icarus::trigger {
   transformIntoOpticalTriggerGate(
     Gates&& gates,
     art::PtrMaker<icarus::trigger::OpticalTriggerGateData_t> const& makeGatePtr,
-    OpDetWaveformDataProductMap_t const& opDetWavePtrs
+    OpDetWavePtrs const& opDetWavePtrs
     );
 
 
@@ -399,7 +404,7 @@ icarus::trigger::transformIntoOpticalTriggerGate(Gates&& gates) {
 
 
 // -----------------------------------------------------------------------------
-template <typename Gates>
+template <typename Gates, typename OpDetWavePtrs>
 std::tuple<
   std::vector<icarus::trigger::OpticalTriggerGateData_t>,
   art::Assns<icarus::trigger::OpticalTriggerGateData_t, raw::OpDetWaveform>
@@ -407,7 +412,7 @@ std::tuple<
 icarus::trigger::transformIntoOpticalTriggerGate(
   Gates&& gates,
   art::PtrMaker<icarus::trigger::OpticalTriggerGateData_t> const& makeGatePtr,
-  OpDetWaveformDataProductMap_t const& opDetWavePtrs
+  OpDetWavePtrs const& opDetWavePtrs
   )
 {
   using TriggerGateData_t = icarus::trigger::OpticalTriggerGateData_t;
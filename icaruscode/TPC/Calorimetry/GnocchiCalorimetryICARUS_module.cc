@@ -10,6 +10,9 @@
 #include <optional>
 #include <cmath>
 #include <limits> // std::numeric_limits<>
+#include <numeric> // std::accumulate()
+#include <map>
+#include <tuple>
 
 #include "larreco/Calorimetry/CalorimetryAlg.h"
 #include "larcoreobj/SimpleTypesAndConstants/PhysicalConstants.h"
@@ -24,6 +27,8 @@
 #include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 #include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
 #include "lardata/ArtDataHelper/TrackUtils.h" // lar::util::TrackPitchInView()
+#include "larcore/Geometry/Geometry.h"
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
 #include "larcorealg/Geometry/PlaneGeo.h"
 #include "larcorealg/Geometry/WireGeo.h"
 #include "larcorealg/CoreUtils/NumericUtils.h" // util::absDiff()
@@ -47,6 +52,9 @@
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "cetlib/pow.h" // cet::sum_of_squares()
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 namespace calo {
 
 class GnocchiCalorimetryICARUS: public art::EDProducer {
@@ -106,6 +114,12 @@ class GnocchiCalorimetryICARUS: public art::EDProducer {
         1.
       };
 
+      fhicl::Atom<bool> ParallelTracks {
+        Name("ParallelTracks"),
+        Comment("Process the tracks of an event concurrently. The output is the same as the sequential processing."),
+        false
+      };
+
       fhicl::Table<calo::CalorimetryAlg::Config> CalorimetryAlgConfig {
         Name("CaloAlg"),
         Comment("Configuration for the calo::CalorimetryAlg")
@@ -124,23 +138,34 @@ class GnocchiCalorimetryICARUS: public art::EDProducer {
     Config fConfig;
     CalorimetryAlg fCaloAlg;
 
+    // the inputs of one track, resolved before any concurrent processing
+    struct TrackInput {
+      const recob::Track *track;
+      std::vector<const recob::Hit *> hits;
+      std::vector<const recob::TrackHitMeta *> thms;
+      std::vector<size_t> hitKeys;
+      double T0;
+    };
+
     // helper functions
-    std::vector<std::vector<unsigned>> OrganizeHits(const std::vector<art::Ptr<recob::Hit>> &hits, 
+    std::vector<std::vector<unsigned>> OrganizeHits(const std::vector<const recob::Hit *> &hits, 
                                                 const std::vector<const recob::TrackHitMeta *> &thms,
-                                                const recob::Track &track, unsigned nplanes);
-    std::vector<std::vector<unsigned>> OrganizeHitsIndividual(const std::vector<art::Ptr<recob::Hit>> &hits, 
+                                                const recob::Track &track, unsigned nplanes) const;
+    std::vector<std::vector<unsigned>> OrganizeHitsIndividual(const std::vector<const recob::Hit *> &hits, 
                                                           const std::vector<const recob::TrackHitMeta *> &thms,
-                                                          const recob::Track &track, unsigned nplanes);
-    std::vector<std::vector<unsigned>> OrganizeHitsSnippets(const std::vector<art::Ptr<recob::Hit>> &hits, 
+                                                          const recob::Track &track, unsigned nplanes) const;
+    std::vector<std::vector<unsigned>> OrganizeHitsSnippets(const std::vector<const recob::Hit *> &hits, 
                                                           const std::vector<const recob::TrackHitMeta *> &thms, 
-                                                          const recob::Track &track, unsigned nplanes);
-    bool HitIsValid(const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *thm, const recob::Track &track);
-    geo::Point_t GetLocation(const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta);
-    geo::Point_t GetLocationAtWires(const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta);
-    double GetPitch(const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta);
-    double GetCharge(const art::Ptr<recob::Hit> hit);
-    double GetEfield(detinfo::DetectorPropertiesData const& detProp,
-                     const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta);
+                                                          const recob::Track &track, unsigned nplanes) const;
+    bool HitIsValid(const recob::TrackHitMeta *thm, const recob::Track &track) const;
+    double GetCharge(const recob::Hit &hit) const;
+    anab::Calorimetry PlaneCalorimetry(detinfo::DetectorClocksData const& clockData,
+                                       detinfo::DetectorPropertiesData const& detProp,
+                                       geo::GeometryCore const& geom,
+                                       spacecharge::SpaceCharge const& sce,
+                                       const TrackInput &input,
+                                       const std::vector<unsigned> &hit_indices,
+                                       const geo::PlaneID &plane) const;
 };
 
 } // end namespace calo
@@ -156,9 +181,33 @@ calo::GnocchiCalorimetryICARUS::GnocchiCalorimetryICARUS(Parameters const& param
   
 }
 
+namespace {
+
+  // Space charge lookups for a whole plane of hits, through the provider interface
+  void GetCalPosOffsets(spacecharge::SpaceCharge const& sce, std::vector<geo::Point_t> const& points,
+                        std::vector<int> const& tpcs, std::vector<geo::Vector_t>& offsets) {
+    offsets.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) offsets[i] = sce.GetCalPosOffsets(points[i], tpcs[i]);
+  }
+
+  void GetPosOffsets(spacecharge::SpaceCharge const& sce, std::vector<geo::Point_t> const& points,
+                     std::vector<geo::Vector_t>& offsets) {
+    offsets.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) offsets[i] = sce.GetPosOffsets(points[i]);
+  }
+
+  void GetEfieldOffsets(spacecharge::SpaceCharge const& sce, std::vector<geo::Point_t> const& points,
+                        std::vector<geo::Vector_t>& offsets) {
+    offsets.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) offsets[i] = sce.GetEfieldOffsets(points[i]);
+  }
+
+} // local namespace
+
 void calo::GnocchiCalorimetryICARUS::produce(art::Event &evt) {
   // Get services
-  art::ServiceHandle<geo::Geometry const> geom;
+  geo::GeometryCore const* geom = lar::providerFrom<geo::Geometry>();
+  spacecharge::SpaceCharge const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
 
   size_t nplanes = geom->Nplanes();
 
@@ -184,149 +233,66 @@ void calo::GnocchiCalorimetryICARUS::produce(art::Event &evt) {
 
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService>()->DataFor(evt);
   auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService>()->DataFor(evt, clockData);
-  // iterate over all the tracks
+
+  // resolve all the input pointers here, so that the track processing only deals with plain data
+  std::vector<TrackInput> inputs(tracklist.size());
   for (unsigned trk_i = 0; trk_i < tracklist.size(); trk_i++) {
-    const recob::Track &track = *tracklist[trk_i];
+    TrackInput &input = inputs[trk_i];
+    input.track = tracklist[trk_i].get();
 
-    // collect input for this track
     const std::vector<art::Ptr<recob::Hit>> &hits = fmHits.at(trk_i);
-    const std::vector<const recob::TrackHitMeta *> &thms = fmHits.data(trk_i);
+    input.thms = fmHits.data(trk_i);
+    input.hits.reserve(hits.size());
+    input.hitKeys.reserve(hits.size());
+    for (const art::Ptr<recob::Hit> &hit: hits) {
+      input.hits.push_back(hit.get());
+      input.hitKeys.push_back(hit.key());
+    }
 
-    double T0 = 0;
+    input.T0 = 0;
     if (fConfig.T0ModuleLabel().size()) {
       const std::vector<art::Ptr<anab::T0>> &this_t0s = fmT0s.at(trk_i);
-      if (this_t0s.size()) T0 = this_t0s.at(0)->Time();
+      if (this_t0s.size()) input.T0 = this_t0s.at(0)->Time();
     }
+  }
+
+  // the calorimetry of each track on each plane
+  std::vector<std::vector<anab::Calorimetry>> trackCalos(tracklist.size());
+  std::vector<std::vector<size_t>> trackPlaneHits(tracklist.size());
+
+  auto processTrack = [&](unsigned trk_i) {
+    const TrackInput &input = inputs[trk_i];
 
     // organize the hits by plane
-    std::vector<std::vector<unsigned>> hit_indices = OrganizeHits(hits, thms, track, nplanes); 
+    std::vector<std::vector<unsigned>> hit_indices = OrganizeHits(input.hits, input.thms, *input.track, nplanes);
 
     for (unsigned plane_i = 0; plane_i < nplanes; plane_i++) {
-
-      float kinetic_energy = 0.;
-      std::vector<float> dEdxs;
-      std::vector<float> dQdxs;
-      std::vector<float> resranges;
-      std::vector<float> deadwireresranges;
-      float range = 0.;
-      std::vector<float> pitches;
-      std::vector<geo::Point_t> xyzs;
-      std::vector<size_t> tp_indices;
       geo::PlaneID plane(fConfig.Cryostat(),0,plane_i); 
+      trackPlaneHits[trk_i].push_back(hit_indices[plane_i].size());
+      trackCalos[trk_i].push_back(PlaneCalorimetry(clockData, detProp, *geom, *sce, input, hit_indices[plane_i], plane));
+    }
+  };
 
-      std::cout << "    - plane " << plane_i << " has " << hit_indices[plane_i].size() << " hits" << std::endl;
-
-      std::vector<float> lengths;
-      for (unsigned hit_i = 0; hit_i < hit_indices[plane_i].size(); hit_i++) {
-        unsigned hit_index = hit_indices[plane_i][hit_i];
-
-        // Get the location of this point
-        geo::Point_t location = GetLocation(track, hits[hit_index], thms[hit_index]);
-
-        // Get the pitch
-        double pitch = GetPitch(track, hits[hit_index], thms[hit_index]);
-
-        // And the charge
-        double charge = GetCharge(hits[hit_index]);
-
-        // Get the EField
-        double EField = GetEfield(detProp, track, hits[hit_index], thms[hit_index]);
-
-        double dQdx = charge / pitch;
-
-        // turn into dEdx
-        double dEdx = (fConfig.ChargeMethod() == calo::GnocchiCalorimetryICARUS::Config::cmAmplitude) ?
-          fCaloAlg.dEdx_AMP(clockData, detProp, dQdx, hits[hit_index]->PeakTime(), hits[hit_index]->WireID().Plane, T0, EField) :
-          fCaloAlg.dEdx_AREA(clockData, detProp, dQdx, hits[hit_index]->PeakTime(), hits[hit_index]->WireID().Plane, T0, EField);
-
-        // save the length between each pair of hits
-        if (xyzs.size() == 0) {
-          lengths.push_back(0.);
-        }
-        else {
-          lengths.push_back((location - xyzs.back()).r());
-        }
-
-        // save stuff
-        dEdxs.push_back(dEdx);
-        dQdxs.push_back(dQdx);
-        pitches.push_back(pitch);
-        xyzs.push_back(location);
-        kinetic_energy += dEdx * pitch;
-
-        // TODO: FIXME
-        // It seems weird that the "trajectory-point-index" actually is the 
-        // index of the hit... is this a bug in the documentation 
-        // of anab::Calorimetry?
-        //
-        // i.e. -- I think this piece of code should actually be:
-        // tp_indices.push_back(thms[hit_index]->Index());
-        tp_indices.push_back(hits[hit_index].key());
-     
-
-      } // end iterate over hits
-
-
-      // turn the lengths vector into a residual-range vector and total length
-      if (lengths.size() > 1) {
-        range = std::accumulate(lengths.begin(), lengths.end(), 0.);
-
-        // check the direction that the hits are going in the track:
-        // upstream (end-start) or downstream (start-end) 
-        bool is_downstream = \
-            (track.Trajectory().Start() - xyzs[0]).r() + (track.Trajectory().End()   - xyzs.back()).r() <
-            (track.Trajectory().End()   - xyzs[0]).r() + (track.Trajectory().Start() - xyzs.back()).r();
-
-        resranges.resize(lengths.size());
-        if (is_downstream) {
-          resranges[lengths.size() - 1] = lengths.back() / 2.;
-          for (int i_len = lengths.size() - 2; i_len >= 0; i_len --) {
-            resranges[i_len] = resranges[i_len+1] + lengths[i_len+1];
-          }
-        }
-        else {
-          resranges[0] = lengths[1] / 2.;
-          for (unsigned i_len = 1; i_len < lengths.size(); i_len ++) {
-            resranges[i_len] = resranges[i_len-1] + lengths[i_len];
-          }
-        }
-      }
+  if (fConfig.ParallelTracks()) {
+    tbb::parallel_for(tbb::blocked_range<unsigned>(0, tracklist.size()),
+      [&](tbb::blocked_range<unsigned> const& range) {
+        for (unsigned trk_i = range.begin(); trk_i != range.end(); trk_i++) processTrack(trk_i);
+      });
+  }
+  else {
+    for (unsigned trk_i = 0; trk_i < tracklist.size(); trk_i++) processTrack(trk_i);
+  }
 
-      std::cout << "    ~~> saving output with length " << lengths.size() << std::endl;
-
-      // save the Calorimetry output
-      //
-      // Bogus if less than two hits on this plane
-      if (lengths.size() > 1) {
-        outputCalo->push_back(anab::Calorimetry(kinetic_energy,
-                                                dEdxs,
-                                                dQdxs,
-                                                resranges,
-                                                deadwireresranges,
-                                                range,
-                                                pitches,
-                                                xyzs,
-                                                tp_indices,
-                                                plane));
-      }
-      else {
-        outputCalo->push_back(anab::Calorimetry(util::kBogusD,
-                                                {}, 
-                                                {},
-                                                {},
-                                                {}, 
-                                                util::kBogusD,
-                                                {},
-                                                {},
-                                                {},
-                                                plane)); 
-      }
+  // save the Calorimetry output, in track and plane order
+  for (unsigned trk_i = 0; trk_i < tracklist.size(); trk_i++) {
+    for (unsigned plane_i = 0; plane_i < nplanes; plane_i++) {
+      std::cout << "    - plane " << plane_i << " has " << trackPlaneHits[trk_i][plane_i] << " hits" << std::endl;
+      std::cout << "    ~~> saving output with length " << trackPlaneHits[trk_i][plane_i] << std::endl;
 
+      outputCalo->push_back(std::move(trackCalos[trk_i][plane_i]));
       util::CreateAssn(*this, evt, *outputCalo, tracklist[trk_i], *outputCaloAssn);
-
-    } // end iterate over planes
-
-  } // end iterate over tracks
+    }
+  }
 
   std::cout << "    ====>>> gnocchi is yummy with " << outputCalo->size() << " objects" << std::endl;
 
@@ -337,9 +303,207 @@ void calo::GnocchiCalorimetryICARUS::produce(art::Event &evt) {
 
 }
 
-std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHits(const std::vector<art::Ptr<recob::Hit>> &hits, 
+anab::Calorimetry calo::GnocchiCalorimetryICARUS::PlaneCalorimetry(detinfo::DetectorClocksData const& clockData,
+                                                                   detinfo::DetectorPropertiesData const& detProp,
+                                                                   geo::GeometryCore const& geom,
+                                                                   spacecharge::SpaceCharge const& sce,
+                                                                   const TrackInput &input,
+                                                                   const std::vector<unsigned> &hit_indices,
+                                                                   const geo::PlaneID &plane) const {
+  const recob::Track &track = *input.track;
+  const size_t nhits = hit_indices.size();
+
+  const bool calSpatial = sce.EnableCalSpatialSCE() && fConfig.FieldDistortion();
+  const bool trackCorrected = fConfig.TrackIsFieldDistortionCorrected();
+  const double xSign = fConfig.FieldDistortionCorrectionXSign();
+
+  auto applyOffset = [xSign](const geo::Point_t &loc, const geo::Vector_t &offset) {
+    return geo::Point_t{loc.X() + xSign * offset.X(), loc.Y() + offset.Y(), loc.Z() + offset.Z()};
+  };
+
+  // gather the trajectory and wire information of all the hits on this plane
+  std::vector<geo::Point_t> points(nhits);
+  std::vector<geo::Vector_t> trackDirs(nhits);
+  std::vector<int> tpcs(nhits);
+  std::vector<double> wirePitches(nhits);
+  std::vector<double> anglesToVert(nhits);
+  for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+    const recob::Hit &hit = *input.hits[hit_indices[hit_i]];
+    const unsigned tp_index = input.thms[hit_indices[hit_i]]->Index();
+
+    points[hit_i] = track.LocationAtPoint(tp_index);
+    trackDirs[hit_i] = track.DirectionAtPoint(tp_index);
+    tpcs[hit_i] = hit.WireID().TPC;
+    wirePitches[hit_i] = geom.WirePitch(hit.View());
+    anglesToVert[hit_i] = geom.WireAngleToVertical(hit.View(), hit.WireID().TPC, hit.WireID().Cryostat) - 0.5*::util::pi<>();
+  }
+
+  // Locations of the hits on the particle trajectory (xyzs) and as seen by the wires,
+  // the directions seen by the wires, and the calibration offsets at the wire locations.
+  // Each space charge lookup below is done once for the whole plane.
+  std::vector<geo::Point_t> locations = points;
+  std::vector<geo::Point_t> locsAtWires = points;
+  std::vector<geo::Vector_t> dirs = trackDirs;
+  std::vector<geo::Vector_t> locOffsets;
+
+  if (calSpatial && !trackCorrected) {
+    // the offsets at the wire locations also correct the locations
+    GetCalPosOffsets(sce, points, tpcs, locOffsets);
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) locations[hit_i] = applyOffset(points[hit_i], locOffsets[hit_i]);
+  }
+  else if (calSpatial && trackCorrected) {
+    // "dir" should be the direction that the wires see: de-apply the corrections
+    // to the point and to both ends of its pitch
+    std::vector<geo::Point_t> fwdPoints(3*nhits);
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+      fwdPoints[hit_i] = points[hit_i];
+      fwdPoints[nhits + hit_i] = points[hit_i] - trackDirs[hit_i] * (wirePitches[hit_i] / 2.);
+      fwdPoints[2*nhits + hit_i] = points[hit_i] + trackDirs[hit_i] * (wirePitches[hit_i] / 2.);
+    }
+    std::vector<geo::Vector_t> fwdOffsets;
+    GetPosOffsets(sce, fwdPoints, fwdOffsets);
+
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+      locsAtWires[hit_i] = applyOffset(points[hit_i], fwdOffsets[hit_i]);
+      const geo::Point_t loc_mdx = applyOffset(fwdPoints[nhits + hit_i], fwdOffsets[nhits + hit_i]);
+      const geo::Point_t loc_pdx = applyOffset(fwdPoints[2*nhits + hit_i], fwdOffsets[2*nhits + hit_i]);
+      dirs[hit_i] = (loc_pdx - loc_mdx) / (loc_mdx - loc_pdx).r();
+    }
+    GetCalPosOffsets(sce, locsAtWires, tpcs, locOffsets);
+  }
+
+  // pitch computed on the wires...
+  std::vector<double> pitches(nhits);
+  for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+    const double cosgamma = std::abs(std::sin(anglesToVert[hit_i])*dirs[hit_i].Y() + std::cos(anglesToVert[hit_i])*dirs[hit_i].Z());
+    pitches[hit_i] = cosgamma ? wirePitches[hit_i]/cosgamma : 0.;
+  }
+
+  // ...and corrected back to the particle trajectory
+  std::vector<geo::Vector_t> dirOffsets(nhits, geo::Vector_t{0., 0., 0.});
+  if (calSpatial) {
+    std::vector<geo::Point_t> pitchEnds(nhits);
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+      const geo::Point_t &loc_w = locsAtWires[hit_i];
+      const double pitch = pitches[hit_i];
+      pitchEnds[hit_i] = geo::Point_t{loc_w.X() + pitch*dirs[hit_i].X(), loc_w.Y() + pitch*dirs[hit_i].Y(), loc_w.Z() + pitch*dirs[hit_i].Z()};
+    }
+    GetCalPosOffsets(sce, pitchEnds, tpcs, dirOffsets);
+  }
+  else {
+    locOffsets.assign(nhits, geo::Vector_t{0., 0., 0.});
+  }
+  for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+    const double pitch = pitches[hit_i];
+    const geo::Vector_t &dir = dirs[hit_i];
+    const TVector3 dir_corr {pitch*dir.X() + xSign * (dirOffsets[hit_i].X() - locOffsets[hit_i].X()),
+                             pitch*dir.Y() + dirOffsets[hit_i].Y() - locOffsets[hit_i].Y(), pitch*dir.Z() + dirOffsets[hit_i].Z() - locOffsets[hit_i].Z()};
+    pitches[hit_i] = dir_corr.Mag();
+  }
+
+  // EField at the hit locations
+  std::vector<double> EFields(nhits, detProp.Efield());
+  if (sce.EnableSimEfieldSCE() && fConfig.FieldDistortion()) {
+    std::vector<geo::Vector_t> EFieldOffsets;
+    GetEfieldOffsets(sce, locations, EFieldOffsets);
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+      // Add 1 in X direction as this is the direction of the drift field,
+      // convert to absolute E field from relative, and only keep the magnitude for recombination
+      const geo::Vector_t EFieldAbs = detProp.Efield() * (EFieldOffsets[hit_i] + geo::Vector_t{1, 0, 0});
+      EFields[hit_i] = EFieldAbs.r();
+    }
+  }
+
+  float kinetic_energy = 0.;
+  std::vector<float> dEdxs(nhits);
+  std::vector<float> dQdxs(nhits);
+  std::vector<float> resranges;
+  std::vector<float> deadwireresranges;
+  float range = 0.;
+  std::vector<float> lengths(nhits);
+  std::vector<size_t> tp_indices(nhits);
+
+  for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+    const recob::Hit &hit = *input.hits[hit_indices[hit_i]];
+
+    double dQdx = GetCharge(hit) / pitches[hit_i];
+
+    // turn into dEdx
+    double dEdx = (fConfig.ChargeMethod() == calo::GnocchiCalorimetryICARUS::Config::cmAmplitude) ?
+      fCaloAlg.dEdx_AMP(clockData, detProp, dQdx, hit.PeakTime(), hit.WireID().Plane, input.T0, EFields[hit_i]) :
+      fCaloAlg.dEdx_AREA(clockData, detProp, dQdx, hit.PeakTime(), hit.WireID().Plane, input.T0, EFields[hit_i]);
+
+    // save the length between each pair of hits
+    lengths[hit_i] = (hit_i == 0) ? 0. : (locations[hit_i] - locations[hit_i-1]).r();
+
+    dEdxs[hit_i] = dEdx;
+    dQdxs[hit_i] = dQdx;
+    kinetic_energy += dEdx * pitches[hit_i];
+
+    // TODO: FIXME
+    // It seems weird that the "trajectory-point-index" actually is the 
+    // index of the hit... is this a bug in the documentation 
+    // of anab::Calorimetry?
+    //
+    // i.e. -- I think this piece of code should actually be:
+    // tp_indices.push_back(thms[hit_index]->Index());
+    tp_indices[hit_i] = input.hitKeys[hit_indices[hit_i]];
+  } // end iterate over hits
+
+  // Bogus if less than two hits on this plane
+  if (lengths.size() <= 1) {
+    return anab::Calorimetry(util::kBogusD,
+                             {}, 
+                             {},
+                             {},
+                             {}, 
+                             util::kBogusD,
+                             {},
+                             {},
+                             {},
+                             plane);
+  }
+
+  // turn the lengths vector into a residual-range vector and total length
+  range = std::accumulate(lengths.begin(), lengths.end(), 0.);
+
+  // check the direction that the hits are going in the track:
+  // upstream (end-start) or downstream (start-end) 
+  bool is_downstream = \
+      (track.Trajectory().Start() - locations[0]).r() + (track.Trajectory().End()   - locations.back()).r() <
+      (track.Trajectory().End()   - locations[0]).r() + (track.Trajectory().Start() - locations.back()).r();
+
+  resranges.resize(lengths.size());
+  if (is_downstream) {
+    resranges[lengths.size() - 1] = lengths.back() / 2.;
+    for (int i_len = lengths.size() - 2; i_len >= 0; i_len --) {
+      resranges[i_len] = resranges[i_len+1] + lengths[i_len+1];
+    }
+  }
+  else {
+    resranges[0] = lengths[1] / 2.;
+    for (unsigned i_len = 1; i_len < lengths.size(); i_len ++) {
+      resranges[i_len] = resranges[i_len-1] + lengths[i_len];
+    }
+  }
+
+  std::vector<float> pitchesOut(pitches.begin(), pitches.end());
+
+  return anab::Calorimetry(kinetic_energy,
+                           dEdxs,
+                           dQdxs,
+                           resranges,
+                           deadwireresranges,
+                           range,
+                           pitchesOut,
+                           locations,
+                           tp_indices,
+                           plane);
+}
+
+std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHits(const std::vector<const recob::Hit *> &hits, 
                                                 const std::vector<const recob::TrackHitMeta *> &thms,
-                                                const recob::Track &track, unsigned nplanes) {
+                                                const recob::Track &track, unsigned nplanes) const {
   // charge is computed per hit -- we organize hits indivudally
   if (fConfig.ChargeMethod() == calo::GnocchiCalorimetryICARUS::Config::cmIntegral || fConfig.ChargeMethod() == calo::GnocchiCalorimetryICARUS::Config::cmAmplitude) {
     return OrganizeHitsIndividual(hits, thms, track, nplanes);
@@ -350,12 +514,12 @@ std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHits(
   }
 }
 
-std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHitsIndividual(const std::vector<art::Ptr<recob::Hit>> &hits, 
+std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHitsIndividual(const std::vector<const recob::Hit *> &hits, 
                                                           const std::vector<const recob::TrackHitMeta *> &thms,
-                                                          const recob::Track &track, unsigned nplanes) {
+                                                          const recob::Track &track, unsigned nplanes) const {
   std::vector<std::vector<unsigned>> ret(nplanes);
   for (unsigned i = 0; i < hits.size(); i++) {
-    if (HitIsValid(hits[i], thms[i], track)) {
+    if (HitIsValid(thms[i], track)) {
       ret[hits[i]->WireID().Plane].push_back(i);
     } 
   } 
@@ -363,198 +527,54 @@ std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHitsI
   return ret;
 }
 
-std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHitsSnippets(const std::vector<art::Ptr<recob::Hit>> &hits, 
+std::vector<std::vector<unsigned>> calo::GnocchiCalorimetryICARUS::OrganizeHitsSnippets(const std::vector<const recob::Hit *> &hits, 
                                                           const std::vector<const recob::TrackHitMeta *> &thms, 
-                                                          const recob::Track &track, unsigned nplanes) {
+                                                          const recob::Track &track, unsigned nplanes) const {
   // In this case, we need to only accept one hit in each snippet
   // Snippets are counted by the Start, End, and Wire. If all these are the same for a hit, then they are on the same snippet.
   //
   // If there are multiple valid hits on the same snippet, we need a way to pick the best one. 
   // (TODO: find a good way). The current method is to take the one with the highest charge integral.
-  struct HitIdentifier {
-    int startTick;
-    int endTick;
-    int wire;
-    float integral;
-
-    // construct
-    explicit HitIdentifier(const recob::Hit &hit):
-      startTick(hit.StartTick()),
-      endTick(hit.EndTick()),
-      wire(hit.WireID().Wire),
-      integral(hit.Integral())
-    {}
-
-    // Defines whether two hits are on the same snippet
-    inline bool operator==(const HitIdentifier& rhs) const {
-      return startTick == rhs.startTick && endTick == rhs.endTick && wire == rhs.wire;
-    }
+  using SnippetID = std::tuple<int, int, int>; // start tick, end tick, wire
 
-    // Defines which hit to pick between two both on the same snippet
-    inline bool operator>(const HitIdentifier& rhs) const {
-      return integral > rhs.integral;
-    }
-  };
-  
   std::vector<std::vector<unsigned>> ret(nplanes);
-  std::vector<std::vector<HitIdentifier>> hit_idents(nplanes);
+  // position in ret of the hit chosen for each snippet found so far
+  std::vector<std::map<SnippetID, unsigned>> snippets(nplanes);
   for (unsigned i = 0; i < hits.size(); i++) {
-    if (HitIsValid(hits[i], thms[i], track)) {
-      HitIdentifier this_ident(*hits[i]); 
-
-      // check if we have found a hit on this snippet before
-      bool found_snippet = false;
-      for (unsigned j = 0; j < ret[hits[i]->WireID().Plane].size(); j++) {
-        if (this_ident == hit_idents[hits[i]->WireID().Plane][j]) {
-          found_snippet = true;
-          if (this_ident > hit_idents[hits[i]->WireID().Plane][j]) {
-            ret[hits[i]->WireID().Plane][j] = i;
-            hit_idents[hits[i]->WireID().Plane][j] = this_ident;
-          }
-          break;
-        }
+    if (HitIsValid(thms[i], track)) {
+      const recob::Hit &hit = *hits[i];
+      const unsigned plane = hit.WireID().Plane;
+
+      auto const [it, new_snippet] = snippets[plane].emplace(SnippetID{hit.StartTick(), hit.EndTick(), hit.WireID().Wire}, ret[plane].size());
+      if (new_snippet) {
+        ret[plane].push_back(i);
       }
-      if (!found_snippet) {
-        ret[hits[i]->WireID().Plane].push_back(i);
-        hit_idents[hits[i]->WireID().Plane].push_back(this_ident);
+      else if (hit.Integral() > hits[ret[plane][it->second]]->Integral()) {
+        ret[plane][it->second] = i;
       }
     } 
   } 
   return ret;
 }
 
-bool calo::GnocchiCalorimetryICARUS::HitIsValid(const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *thm, const recob::Track &track) {
+bool calo::GnocchiCalorimetryICARUS::HitIsValid(const recob::TrackHitMeta *thm, const recob::Track &track) const {
   if (thm->Index() == std::numeric_limits<unsigned int>::max()) return false;
   if (!track.HasValidPoint(thm->Index())) return false;
   return true;
 }
 
-geo::Point_t calo::GnocchiCalorimetryICARUS::GetLocation(const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta) {
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
-  geo::Point_t loc = track.LocationAtPoint(meta->Index());
-
-  if (sce->EnableCalSpatialSCE() && fConfig.FieldDistortion() && !fConfig.TrackIsFieldDistortionCorrected()) {
-    geo::Vector_t offset = sce->GetCalPosOffsets(loc, hit->WireID().TPC);
-    loc.SetX(loc.X() + fConfig.FieldDistortionCorrectionXSign() * offset.X());
-    loc.SetY(loc.Y() + offset.Y());
-    loc.SetZ(loc.Z() + offset.Z());
-  }
-
-  return loc;
-}
-
-geo::Point_t calo::GnocchiCalorimetryICARUS::GetLocationAtWires(const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta) {
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
-  geo::Point_t loc = track.LocationAtPoint(meta->Index());
-
-  if (sce->EnableCalSpatialSCE() && fConfig.FieldDistortion() && fConfig.TrackIsFieldDistortionCorrected()) {
-    // for some reason, one needs to flip the sign of the x-direction when correcting for field distortion
-    geo::Vector_t offset = sce->GetPosOffsets(loc);
-    loc.SetX(loc.X() + fConfig.FieldDistortionCorrectionXSign() * offset.X());
-    loc.SetY(loc.Y() + offset.Y());
-    loc.SetZ(loc.Z() + offset.Z());
-  }
-
-  return loc;
-}
-
-double calo::GnocchiCalorimetryICARUS::GetPitch(const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta) {
-  art::ServiceHandle<geo::Geometry const> geom;
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
-  double angleToVert = geom->WireAngleToVertical(hit->View(), hit->WireID().TPC, hit->WireID().Cryostat) - 0.5*::util::pi<>();
-
-  geo::Vector_t dir;
-
-  // "dir" should be the direction that the wires see. If the track already has the field
-  // distortion corrections applied, then we need to de-apply them to get the direction as
-  // seen by the wire planes
-  if (sce->EnableCalSpatialSCE() && fConfig.FieldDistortion() && fConfig.TrackIsFieldDistortionCorrected()) {
-    geo::Point_t loc = track.LocationAtPoint(meta->Index());
-
-    // compute the dir of the track trajectory
-    geo::Vector_t track_dir = track.DirectionAtPoint(meta->Index());
-    geo::Point_t loc_mdx = loc - track_dir * (geom->WirePitch(hit->View()) / 2.);
-    geo::Point_t loc_pdx = loc + track_dir * (geom->WirePitch(hit->View()) / 2.);
-
-    geo::Vector_t loc_mdx_offset = sce->GetPosOffsets(loc_mdx);
-    loc_mdx.SetX(loc_mdx.X() + fConfig.FieldDistortionCorrectionXSign() * loc_mdx_offset.X());
-    loc_mdx.SetY(loc_mdx.Y() + loc_mdx_offset.Y());
-    loc_mdx.SetZ(loc_mdx.Z() + loc_mdx_offset.Z());
-
-    geo::Vector_t loc_pdx_offset = sce->GetPosOffsets(loc_pdx);
-    loc_pdx.SetX(loc_pdx.X() + fConfig.FieldDistortionCorrectionXSign() * loc_pdx_offset.X());
-    loc_pdx.SetY(loc_pdx.Y() + loc_pdx_offset.Y());
-    loc_pdx.SetZ(loc_pdx.Z() + loc_pdx_offset.Z());
-
-    dir = (loc_pdx - loc_mdx) /  (loc_mdx - loc_pdx).r(); 
-  }
-  // If there is no space charge or the track is not yet corrected, then the dir
-  // is the track is what we want
-  else {
-    dir = track.DirectionAtPoint(meta->Index());
-  }
-
-  double cosgamma = std::abs(std::sin(angleToVert)*dir.Y() + std::cos(angleToVert)*dir.Z());
-  double pitch;
-  if (cosgamma) {
-    pitch = geom->WirePitch(hit->View())/cosgamma;
-  }
-  else {
-    pitch = 0.;
-  }
-
-  // now take the pitch computed on the wires and correct it back to the particle trajectory
-  geo::Point_t loc_w = GetLocationAtWires(track, hit, meta);
-
-  geo::Vector_t dirOffsets = {0., 0., 0.};
-  geo::Vector_t locOffsets = {0., 0., 0.};
-  if (sce->EnableCalSpatialSCE() && fConfig.FieldDistortion()) {
-    dirOffsets = sce->GetCalPosOffsets(geo::Point_t{loc_w.X()  + pitch*dir.X(), loc_w.Y() + pitch*dir.Y(), loc_w.Z() + pitch*dir.Z()}, hit->WireID().TPC);
-    locOffsets = sce->GetCalPosOffsets(loc_w, hit->WireID().TPC);
-  }
-
-  const TVector3 &dir_corr {pitch*dir.X() + fConfig.FieldDistortionCorrectionXSign() * (dirOffsets.X() - locOffsets.X()),  
-                            pitch*dir.Y() + dirOffsets.Y() - locOffsets.Y(), pitch*dir.Z() + dirOffsets.Z() - locOffsets.Z()};
-
-  pitch = dir_corr.Mag();
-
-  return pitch;
-}
-
-double calo::GnocchiCalorimetryICARUS::GetCharge(const art::Ptr<recob::Hit> hit) {
+double calo::GnocchiCalorimetryICARUS::GetCharge(const recob::Hit &hit) const {
   switch (fConfig.ChargeMethod()) {
     case calo::GnocchiCalorimetryICARUS::Config::cmIntegral:
-      return hit->Integral();
+      return hit.Integral();
     case calo::GnocchiCalorimetryICARUS::Config::cmAmplitude:
-      return hit->PeakAmplitude();
+      return hit.PeakAmplitude();
     case calo::GnocchiCalorimetryICARUS::Config::cmSummedADC:
-      return hit->SummedADC();
+      return hit.SummedADC();
     default:
       return 0.;
   }
   return 0.;
 }
 
-double calo::GnocchiCalorimetryICARUS::GetEfield(detinfo::DetectorPropertiesData const& detProp,
-                                                 const recob::Track &track, const art::Ptr<recob::Hit> hit, const recob::TrackHitMeta *meta) {
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
-  double EField = detProp.Efield();
-  if (sce->EnableSimEfieldSCE() && fConfig.FieldDistortion()) {
-      // Gets relative E field Distortions
-      geo::Vector_t EFieldOffsets = sce->GetEfieldOffsets(GetLocation(track, hit, meta));
-      // Add 1 in X direction as this is the direction of the drift field
-      EFieldOffsets = EFieldOffsets + geo::Vector_t{1, 0, 0};
-      // Convert to Absolute E Field from relative
-      EFieldOffsets = EField * EFieldOffsets;
-      // We only care about the magnitude for recombination
-      EField = EFieldOffsets.r();
-  }
-  return EField;
-
-}
-
 DEFINE_ART_MODULE(calo::GnocchiCalorimetryICARUS)
@@ -0,0 +1,138 @@
+#ifndef CORRELATEDNOISEBLOCK_H
+#define CORRELATEDNOISEBLOCK_H
+////////////////////////////////////////////////////////////////////////
+//
+// Class:       CorrelatedNoiseBlock
+// File:        CorrelatedNoiseBlock.h
+//
+//              Packed wires x ticks block of the pedestal corrected
+//              waveforms of a wire group, with the per tick correlated
+//              noise estimates (average or median over the wires) used by
+//              RawDigitCorrelatedCorrectionAlg
+//
+//              The memory is kept between groups: an instance is meant to
+//              be reused, one per thread.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace caldata
+{
+class CorrelatedNoiseBlock
+{
+public:
+
+    using SampleRange_t = std::pair<size_t,size_t>;
+
+    /// Prepares the block for numWires waveforms of numTicks samples each
+    void reset(size_t numWires, size_t numTicks)
+    {
+        fNumWires = numWires;
+        fNumTicks = numTicks;
+        fAdcBlock.resize(numWires * numTicks);
+        fSampleRanges.assign(numWires, SampleRange_t(0, 0));
+    }
+
+    size_t numWires() const { return fNumWires; }
+    size_t numTicks() const { return fNumTicks; }
+
+    /// Returns the samples of the wire at row wireIdx of the block
+    float*       row(size_t wireIdx)       { return fAdcBlock.data() + wireIdx * fNumTicks; }
+    const float* row(size_t wireIdx) const { return fAdcBlock.data() + wireIdx * fNumTicks; }
+
+    /// Sets the samples [first, last) of the wire to be used in the estimate (clamped to the block)
+    void setSampleRange(size_t wireIdx, size_t first, size_t last)
+        { fSampleRanges[wireIdx] = SampleRange_t(std::min(first, fNumTicks), std::min(last, fNumTicks)); }
+
+    const SampleRange_t& sampleRange(size_t wireIdx) const { return fSampleRanges[wireIdx]; }
+
+    /// Fills corValVec with the average over the wires in range at each tick
+    void averageCorrection(std::vector<float>& corValVec)
+    {
+        // Sum the rows of the block over their valid ranges; the accumulation is in double
+        // and in wire order, as a per tick std::accumulate would do
+        fAdcSumVec.assign(fNumTicks, 0.);
+        fAdcCntVec.assign(fNumTicks, 0);
+
+        for(size_t wireIdx = 0; wireIdx < fNumWires; wireIdx++)
+        {
+            const float* adcRow = row(wireIdx);
+
+            for(size_t sampleIdx = fSampleRanges[wireIdx].first; sampleIdx < fSampleRanges[wireIdx].second; sampleIdx++)
+            {
+                fAdcSumVec[sampleIdx] += adcRow[sampleIdx];
+                fAdcCntVec[sampleIdx]++;
+            }
+        }
+
+        corValVec.resize(fNumTicks);
+
+        for(size_t sampleIdx = 0; sampleIdx < fNumTicks; sampleIdx++)
+            corValVec[sampleIdx] = fAdcSumVec[sampleIdx] / float(fAdcCntVec[sampleIdx]);
+    }
+
+    /// Fills corValVec with the median over the wires in range at each tick (0 if none)
+    void medianCorrection(std::vector<float>& corValVec)
+    {
+        // Selection based median of each column, gathering the wires in range into a scratch buffer
+        fAdcValuesVec.resize(fNumWires);
+        corValVec.resize(fNumTicks);
+
+        for(size_t sampleIdx = 0; sampleIdx < fNumTicks; sampleIdx++)
+        {
+            size_t numValues(0);
+
+            for(size_t wireIdx = 0; wireIdx < fNumWires; wireIdx++)
+            {
+                if (sampleIdx < fSampleRanges[wireIdx].first || sampleIdx >= fSampleRanges[wireIdx].second) continue;
+
+                fAdcValuesVec[numValues++] = row(wireIdx)[sampleIdx];
+            }
+
+            corValVec[sampleIdx] = getMedian(fAdcValuesVec.begin(), fAdcValuesVec.begin() + numValues, float(0.));
+        }
+    }
+
+private:
+
+    template<class Iter> static typename std::iterator_traits<Iter>::value_type
+        getMedian(Iter startItr, Iter stopItr, typename std::iterator_traits<Iter>::value_type defaultValue)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+
+        T medianValue(defaultValue);
+
+        if (startItr != stopItr)
+        {
+            // Partial selection is enough, no need to sort the whole range
+            Iter medianItr = startItr + std::distance(startItr,stopItr) / 2;
+
+            std::nth_element(startItr,medianItr,stopItr);
+
+            medianValue = *medianItr;
+
+            // For an even number of values average with the largest of the lower half
+            if (std::distance(startItr,stopItr) % 2 == 0)
+                medianValue = (medianValue + *std::max_element(startItr,medianItr)) / 2;
+        }
+
+        return medianValue;
+    }
+
+    size_t                     fNumWires = 0;
+    size_t                     fNumTicks = 0;
+    std::vector<float>         fAdcBlock;      ///< Pedestal corrected waveforms, one row per wire
+    std::vector<SampleRange_t> fSampleRanges;  ///< Samples of each wire used in the estimate
+    std::vector<double>        fAdcSumVec;     ///< Scratch: per tick sums (average)
+    std::vector<size_t>        fAdcCntVec;     ///< Scratch: per tick number of wires (average)
+    std::vector<float>         fAdcValuesVec;  ///< Scratch: values of one tick (median)
+};
+
+} // end caldata namespace
+
+#endif
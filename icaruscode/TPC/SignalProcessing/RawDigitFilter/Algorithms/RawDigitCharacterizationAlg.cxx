@@ -4,6 +4,8 @@
 #include "art/Framework/Core/ModuleMacros.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include "icaruscode/Utilities/ADCCountHistogram.h"
+
 namespace caldata
 {
 //----------------------------------------------------------------------------
@@ -135,73 +137,41 @@ void RawDigitCharacterizationAlg::getWaveformParams(const RawDigitVector& rawWav
 {
     // We start by finding the most likely baseline which is most easily done by
     // finding the most populated bin and the average using the neighboring bins
-    // To do this we'll use a map with key the bin number and data the count in that bin
+    // A single histogram of the ADC counts serves all the statistics below
     int numTruncBins;
     
-    getMeanAndTruncRms(rawWaveform, truncMean, rms, truncRms, numTruncBins);
+    icarus::ns::util::ADCCountHistogram<short> const adcCounts(rawWaveform.begin(),rawWaveform.end());
+    
+    getMeanAndTruncRms(adcCounts, truncMean, rms, truncRms, numTruncBins);
     
     // The pedCorVal will transform from the average of waveform calculated here to the expected value of the pedestal.
     pedCorVal = 0.;
     
     // Determine the range of ADC values on this wire
-    std::pair<RawDigitVector::const_iterator,RawDigitVector::const_iterator> minMaxItrPair = std::minmax_element(rawWaveform.begin(),rawWaveform.end());
-    
-    minMax = std::min(*minMaxItrPair.second - *minMaxItrPair.first + 1, 199);  // for the purposes of histogramming
+    minMax = std::min(adcCounts.max() - adcCounts.min() + 1, 199);  // for the purposes of histogramming
 
     // We also want mean, median, rms, etc., for all ticks on the waveform
-    std::vector<short> localTimeVec = rawWaveform;
-    
-    std::sort(localTimeVec.begin(),localTimeVec.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
+    icarus::ns::util::ADCCountHistogram<short>::Sums allSums = adcCounts.deviations(0.);
     
-    float realMean(float(std::accumulate(localTimeVec.begin(),localTimeVec.end(),0))/float(localTimeVec.size()));
+    float realMean(float(allSums.sum)/float(allSums.n));
     
-    median = localTimeVec[localTimeVec.size()/2];
+    median = adcCounts.median();
     mean   = std::round(realMean);
     
-    std::vector<float> adcLessPedVec;
-    
-    adcLessPedVec.resize(localTimeVec.size());
-    
-    std::transform(localTimeVec.begin(),localTimeVec.end(),adcLessPedVec.begin(),std::bind(std::minus<float>(),std::placeholders::_1,realMean));
-    
-    rms      = std::sqrt(std::inner_product(adcLessPedVec.begin(), adcLessPedVec.end(), adcLessPedVec.begin(), 0.) / float(adcLessPedVec.size()));
+    rms      = adcCounts.deviations(realMean).rms();
     skewness = 3. * float(realMean - median) / rms;
     
     // Final task is to get the mode and neighbor ratio
-    // Define the map first
-    std::unordered_map<short,short> binAdcMap;
+    short maxCount(adcCounts.modeCount());
+    short leftNeighbor(maxCount);
+    short rightNeighbor(maxCount);
     
-    // Populate the map
-    for(const auto& adcVal : rawWaveform) binAdcMap[adcVal]++;
+    mode = adcCounts.mode();
     
-    // Find the max bin and the count
-    std::unordered_map<short,short>::iterator maxBinItr = std::max_element(binAdcMap.begin(),binAdcMap.end(),[](const auto& lhs,const auto& rhs){return lhs.second < rhs.second;});
-
-    short neighborSum(0);
-    short leftNeighbor(maxBinItr->second);
-    short rightNeighbor(maxBinItr->second);
-    short cnt(0);
+    if (adcCounts.count(mode-1) > 0) leftNeighbor  = adcCounts.count(mode-1);
+    if (adcCounts.count(mode+1) > 0) rightNeighbor = adcCounts.count(mode+1);
     
-    mode = maxBinItr->first;
-    
-    if (binAdcMap.find(mode-1) != binAdcMap.end())
-    {
-        leftNeighbor  = binAdcMap.find(mode-1)->second;
-        neighborSum  += leftNeighbor;
-        cnt++;
-    }
-    
-    if (binAdcMap.find(mode+1) != binAdcMap.end())
-    {
-        rightNeighbor  = binAdcMap.find(mode+1)->second;
-        neighborSum   += rightNeighbor;
-        cnt++;
-    }
-    
-    neighborRatio = float(neighborSum) / float(2*maxBinItr->second);
-
-    neighborRatio = float(std::min(leftNeighbor,rightNeighbor)) / float(maxBinItr->second);
-//    float leastNeighborRatio = float(std::min(leftNeighbor,rightNeighbor)) / float(maxBinItr->second);
+    neighborRatio = float(std::min(leftNeighbor,rightNeighbor)) / float(maxCount);
     
     // Fill some histograms here
     if (fHistsInitialized)
@@ -223,7 +193,7 @@ void RawDigitCharacterizationAlg::getWaveformParams(const RawDigitVector& rawWav
     
     if (wire / fNumWiresToGroup[view] == fHistsWireGroup[view])
     {
-        float  leastNeighborRatio = float(std::min(leftNeighbor,rightNeighbor)) / float(maxBinItr->second);
+        float  leastNeighborRatio = float(std::min(leftNeighbor,rightNeighbor)) / float(maxCount);
         size_t wireIdx            = wire % fNumWiresToGroup[view];
         
 //        if (skewness > 0. && leastNeighborRatio < 0.7)
@@ -247,21 +217,14 @@ void RawDigitCharacterizationAlg::getTruncatedRMS(const RawDigitVector& rawWavef
                                                   float&                pedestal,
                                                   float&                truncRms) const
 {
-    // do rms calculation - the old fashioned way and over all adc values
-    std::vector<float> adcLessPedVec;
-    
-    adcLessPedVec.resize(rawWaveform.size());
-    
-    // Fill the vector
-    std::transform(rawWaveform.begin(),rawWaveform.end(),adcLessPedVec.begin(),std::bind(std::minus<short>(),std::placeholders::_1,pedestal));
-    
-    // sort in ascending order so we can truncate the sume
-    std::sort(adcLessPedVec.begin(), adcLessPedVec.end(),[](const auto& left, const auto& right){return std::fabs(left) < std::fabs(right);});
+    // do rms calculation over the adc values closest to the (integer) pedestal,
+    // counting them in a histogram rather than sorting them
+    icarus::ns::util::ADCCountHistogram<short> const adcCounts(rawWaveform.begin(),rawWaveform.end());
     
     int minNumBins = (1. - fTruncMeanFraction) * rawWaveform.size();
     
     // Get the truncated sum
-    truncRms = std::inner_product(adcLessPedVec.begin(), adcLessPedVec.begin() + minNumBins, adcLessPedVec.begin(), 0.);
+    truncRms = adcCounts.closestTo(short(pedestal), minNumBins).sumSq;
     truncRms = std::sqrt(std::max(0.,truncRms / double(minNumBins)));
     
     return;
@@ -326,56 +289,32 @@ void RawDigitCharacterizationAlg::getMeanAndRms(const RawDigitVector& rawWavefor
                                                 float&                rmsVal,
                                                 int&                  numBins) const
 {
-    // The strategy for finding the average for a given wire will be to
-    // find the most populated bin and the average using the neighboring bins
-    // To do this we'll use a map with key the bin number and data the count in that bin
-    std::pair<RawDigitVector::const_iterator,RawDigitVector::const_iterator> minMaxValItr = std::minmax_element(rawWaveform.begin(),rawWaveform.end());
-    
-    int minVal = std::floor(*minMaxValItr.first);
-    int maxVal = std::ceil(*minMaxValItr.second);
-    int range  = maxVal - minVal + 1;
-    
-    std::vector<int> frequencyVec(range, 0);
-    int              mpCount(0);
-    int              mpVal(0);
+    icarus::ns::util::ADCCountHistogram<short> const adcCounts(rawWaveform.begin(),rawWaveform.end());
     
-    for(const auto& val : rawWaveform)
-    {
-        int intVal = std::round(val) - minVal;
-        
-        frequencyVec[intVal]++;
-        
-        if (frequencyVec.at(intVal) > mpCount)
-        {
-            mpCount = frequencyVec[intVal];
-            mpVal   = intVal;
-        }
-    }
+    getMeanAndRms(adcCounts, aveVal, rmsVal, numBins);
     
-    // take a weighted average of two neighbor bins
-    int meanCnt  = 0;
-    int meanSum  = 0;
-    int binRange = std::min(16, int(range/2 + 1));
+    return;
+}
 
-    for(int idx = mpVal-binRange; idx <= mpVal+binRange; idx++)
-    {
-        if (idx < 0 || idx >= range) continue;
-        
-        meanSum += (idx + minVal) * frequencyVec[idx];
-        meanCnt += frequencyVec[idx];
-    }
-    
-    aveVal = float(meanSum) / float(meanCnt);
+void RawDigitCharacterizationAlg::getMeanAndRms(const icarus::ns::util::ADCCountHistogram<short>& adcCounts,
+                                                float&                                            aveVal,
+                                                float&                                            rmsVal,
+                                                int&                                              numBins) const
+{
+    // The strategy for finding the average for a given wire will be to
+    // find the most populated bin and the average using the neighboring bins
+    // The histogram of the ADC counts gives us the most populated bin directly
+    int range    = adcCounts.max() - adcCounts.min() + 1;
+    int binRange = std::min(16, int(range/2 + 1));
     
-    // do rms calculation - the old fashioned way and over all adc values
-    std::vector<float> adcLessPedVec(rawWaveform.size());
+    // take a weighted average of the neighbor bins
+    icarus::ns::util::ADCCountHistogram<short>::Sums modeSums = adcCounts.sumsAround(adcCounts.mode(), binRange);
     
-    std::transform(rawWaveform.begin(),rawWaveform.end(),adcLessPedVec.begin(),std::bind(std::minus<float>(),std::placeholders::_1,aveVal));
+    aveVal  = modeSums.mean();
     
-    // recalculate the rms for truncation
-    rmsVal  = std::inner_product(adcLessPedVec.begin(), adcLessPedVec.end(), adcLessPedVec.begin(), 0.);
-    rmsVal  = std::sqrt(std::max(float(0.),rmsVal / float(adcLessPedVec.size())));
-    numBins = meanCnt;
+    // do rms calculation - over all adc values
+    rmsVal  = adcCounts.deviations(aveVal).rms();
+    numBins = modeSums.n;
     
     return;
 }
@@ -386,62 +325,27 @@ void RawDigitCharacterizationAlg::getMeanAndTruncRms(const RawDigitVector& rawWa
                                                      float&                rmsTrunc,
                                                      int&                  numBins) const
 {
-    // The strategy for finding the average for a given wire will be to
-    // find the most populated bin and the average using the neighboring bins
-    // To do this we'll use a map with key the bin number and data the count in that bin
-    std::pair<RawDigitVector::const_iterator,RawDigitVector::const_iterator> minMaxValItr = std::minmax_element(rawWaveform.begin(),rawWaveform.end());
-    
-    int minVal = std::floor(*minMaxValItr.first);
-    int maxVal = std::ceil(*minMaxValItr.second);
-    int range  = maxVal - minVal + 1;
+    icarus::ns::util::ADCCountHistogram<short> const adcCounts(rawWaveform.begin(),rawWaveform.end());
     
-    std::vector<int> frequencyVec(range, 0);
-    int              mpCount(0);
-    int              mpVal(0);
+    getMeanAndTruncRms(adcCounts, aveVal, rmsVal, rmsTrunc, numBins);
     
-    for(const auto& val : rawWaveform)
-    {
-        int intVal = std::round(val) - minVal;
-        
-        frequencyVec[intVal]++;
-        
-        if (frequencyVec.at(intVal) > mpCount)
-        {
-            mpCount = frequencyVec[intVal];
-            mpVal   = intVal;
-        }
-    }
-    
-    // take a weighted average of two neighbor bins
-    int meanCnt  = 0;
-    int meanSum  = 0;
-    int binRange = std::min(16, int(range/2 + 1));
-    
-    for(int idx = mpVal-binRange; idx <= mpVal+binRange; idx++)
-    {
-        if (idx < 0 || idx >= range) continue;
-        
-        meanSum += (idx + minVal) * frequencyVec[idx];
-        meanCnt += frequencyVec[idx];
-    }
-    
-    aveVal = float(meanSum) / float(meanCnt);
-    
-    // do rms calculation - the old fashioned way and over all adc values
-    std::vector<float> adcLessPedVec(rawWaveform.size());
-    
-    std::transform(rawWaveform.begin(),rawWaveform.end(),adcLessPedVec.begin(),std::bind(std::minus<float>(),std::placeholders::_1,aveVal));
-    
-    // recalculate the rms for truncation
-    rmsVal  = std::inner_product(adcLessPedVec.begin(), adcLessPedVec.end(), adcLessPedVec.begin(), 0.);
-    rmsVal  = std::sqrt(std::max(float(0.),rmsVal / float(adcLessPedVec.size())));
+    return;
+}
+
+void RawDigitCharacterizationAlg::getMeanAndTruncRms(const icarus::ns::util::ADCCountHistogram<short>& adcCounts,
+                                                     float&                                            aveVal,
+                                                     float&                                            rmsVal,
+                                                     float&                                            rmsTrunc,
+                                                     int&                                              numBins) const
+{
+    // Mean around the most populated bin and rms over all adc values
+    getMeanAndRms(adcCounts, aveVal, rmsVal, numBins);
     
     // Drop the "large" rms values and recompute
-    std::vector<float>::iterator newEndItr = std::remove_if(adcLessPedVec.begin(),adcLessPedVec.end(),[rmsVal](const auto& val){return std::abs(val) > 2.5*rmsVal;});
+    icarus::ns::util::ADCCountHistogram<short>::Sums truncSums = adcCounts.deviations(aveVal, 2.5*rmsVal);
     
-    rmsTrunc = std::inner_product(adcLessPedVec.begin(), newEndItr, adcLessPedVec.begin(), 0.);
-    numBins  = std::distance(adcLessPedVec.begin(),newEndItr);
-    rmsTrunc = std::sqrt(std::max(float(0.),rmsTrunc / float(numBins)));
+    rmsTrunc = truncSums.rms();
+    numBins  = truncSums.n;
     
     return;
 }
@@ -34,6 +34,7 @@
 #include "larevt/CalibrationDBI/Interface/DetPedestalProvider.h"
 
 #include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/ChannelGroups.h"
+#include "icaruscode/Utilities/ADCCountHistogram.h"
 
 #include "TH1.h"
 #include "TH2.h"
@@ -111,6 +112,18 @@ public:
     
 private:
 
+    // Same as above, from the histogram of the ADC counts of the waveform
+    void getMeanAndRms(const icarus::ns::util::ADCCountHistogram<short>& adcCounts,
+                       float&                                            aveVal,
+                       float&                                            rmsVal,
+                       int&                                              numBins) const;
+    
+    void getMeanAndTruncRms(const icarus::ns::util::ADCCountHistogram<short>& adcCounts,
+                            float&                                            aveVal,
+                            float&                                            rmsVal,
+                            float&                                            rmsTrunc,
+                            int&                                              numBins) const;
+
     // Fcl parameters.
     float                              fTruncMeanFraction;     ///< Fraction for truncated mean
     std::vector<float>                 fRmsRejectionCutHi;     ///< Maximum rms for input channels, reject if larger
@@ -0,0 +1,272 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   MorphologicalROIFinder.h
+///
+/// \brief  ROI search on the 2D dilation of an image of waveforms, either
+///         at full resolution or coarse to fine, used by the
+///         ROIMorphological2D tool
+///
+/// A tick is selected when the dilated waveform is above its median by more
+/// than the threshold factor times the rms of the lowest 75% of the values.
+///
+/// The coarse to fine search max-pools the ticks of the image, dilates it
+/// with a structuring element shrunk by the same factor and takes from this
+/// coarse image the median, the threshold and the candidate bins of each
+/// channel (plus a margin); the full resolution dilation is then computed
+/// only around the candidates, and compared to the coarse median and
+/// threshold.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef MorphologicalROIFinder_H
+#define MorphologicalROIFinder_H
+
+#include "icarus_signal_processing/Denoising.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace icarus_tool
+{
+    class MorphologicalROIFinder
+    {
+    public:
+        using VectorBool  = std::vector<bool>;
+        using VectorFloat = std::vector<float>;
+        using ArrayBool   = std::vector<VectorBool>;
+        using ArrayFloat  = std::vector<VectorFloat>;
+
+        /// Structuring element (channels, ticks) and threshold in units of the rms
+        MorphologicalROIFinder(const std::vector<size_t>& structuringElement, float threshold)
+            : fStructuringElement(structuringElement), fThreshold(threshold)
+        {}
+
+        // ROI search on the dilation of the full image
+        void findROIsFullResolution(const ArrayFloat&, ArrayBool&) const;
+
+        // ROI search on the dilation of the downsampled image, refined at full resolution around the candidates
+        void findROIsCoarseToFine(const ArrayFloat&, size_t pooling, size_t margin, ArrayBool&) const;
+
+        // Median and threshold of a morphed waveform
+        void getBaselineAndThreshold(const VectorFloat&, float&, float&) const;
+
+    private:
+        // This is for the baseline...
+        static float getMedian(VectorFloat, const unsigned int);
+
+        std::vector<size_t> fStructuringElement;  ///< Structuring element for morphological filter
+        float               fThreshold;           ///< Threshold to apply for saving signal
+    };
+
+    inline void MorphologicalROIFinder::findROIsFullResolution(const ArrayFloat& inputImage, ArrayBool& outputROIs) const
+    {
+        icarus_signal_processing::ArrayFloat morphedWaveforms(inputImage.size(),icarus_signal_processing::VectorFloat(inputImage[0].size(),0.));
+
+        // Use this to get the 2D Dilation of each waveform
+        icarus_signal_processing::Dilation2D(fStructuringElement[0],fStructuringElement[1])(inputImage.begin(),inputImage.size(),morphedWaveforms.begin());
+
+        // Now traverse each waveform and look for the ROIs
+        for(size_t waveIdx = 0; waveIdx < morphedWaveforms.size(); waveIdx++)
+        {
+            // We start working with the morphed waveform
+            const VectorFloat& morphedWave = morphedWaveforms[waveIdx];
+
+            float median(0.);
+            float threshold(0.);
+
+            getBaselineAndThreshold(morphedWave, median, threshold);
+
+            // Right size the selected values array
+            VectorBool& selVals = outputROIs[waveIdx];
+
+            selVals.resize(morphedWave.size(),false);
+
+            for(size_t idx = 0; idx < morphedWave.size(); idx++)
+            {
+//                if (std::abs(morphedWave[idx] - median) > threshold) selVals[idx] = true;
+                if (morphedWave[idx] - median > threshold) selVals[idx] = true;
+            }
+        }
+
+        return;
+    }
+
+    inline void MorphologicalROIFinder::findROIsCoarseToFine(const ArrayFloat& inputImage, size_t pooling, size_t margin, ArrayBool& outputROIs) const
+    {
+        // The coarse image keeps the maximum of each group of ticks, so that its dilation with a structuring element
+        // shrunk by the same factor covers the same ticks as the full dilation and has about the same noise distribution
+        size_t numChannels = inputImage.size();
+        size_t numTicks    = inputImage[0].size();
+        size_t numBins     = (numTicks + pooling - 1) / pooling;
+
+        icarus_signal_processing::ArrayFloat coarseImage(numChannels,icarus_signal_processing::VectorFloat(numBins,0.));
+
+        for(size_t waveIdx = 0; waveIdx < numChannels; waveIdx++)
+        {
+            const VectorFloat& inputWave  = inputImage[waveIdx];
+            VectorFloat&       coarseWave = coarseImage[waveIdx];
+
+            for(size_t bin = 0; bin < numBins; bin++)
+                coarseWave[bin] = *std::max_element(inputWave.begin() + bin * pooling, inputWave.begin() + std::min((bin + 1) * pooling, numTicks));
+        }
+
+        icarus_signal_processing::ArrayFloat coarseMorphed(numChannels,icarus_signal_processing::VectorFloat(numBins,0.));
+
+        icarus_signal_processing::Dilation2D(fStructuringElement[0],std::max(size_t(1),(fStructuringElement[1] + pooling - 1) / pooling))(coarseImage.begin(),numChannels,coarseMorphed.begin());
+
+        // Baseline, threshold and candidate bins (with their margin) of each channel, from the coarse image
+        std::vector<float> medians(numChannels,0.);
+        std::vector<float> thresholds(numChannels,0.);
+        ArrayBool          candidates(numChannels,VectorBool(numBins,false));
+        std::vector<bool>  hasCandidates(numChannels,false);
+
+        for(size_t waveIdx = 0; waveIdx < numChannels; waveIdx++)
+        {
+            const VectorFloat& morphedWave = coarseMorphed[waveIdx];
+
+            getBaselineAndThreshold(morphedWave, medians[waveIdx], thresholds[waveIdx]);
+
+            for(size_t bin = 0; bin < numBins; bin++)
+            {
+                if (morphedWave[bin] - medians[waveIdx] <= thresholds[waveIdx]) continue;
+
+                size_t firstBin = bin > margin ? bin - margin : 0;
+                size_t lastBin  = std::min(bin + margin + 1, numBins);
+
+                std::fill(candidates[waveIdx].begin() + firstBin, candidates[waveIdx].begin() + lastBin, true);
+
+                hasCandidates[waveIdx] = true;
+            }
+
+            outputROIs[waveIdx].assign(numTicks,false);
+        }
+
+        // Refine in blocks: each run of channels with candidates (merging runs closer than the structuring element)
+        // is dilated at full resolution over the union of its candidate ticks, padded by the structuring element so
+        // that the dilation within the candidates is the same as in the full image
+        size_t chanPad = fStructuringElement[0];
+        size_t tickPad = fStructuringElement[1];
+        size_t firstChan = 0;
+
+        while(firstChan < numChannels)
+        {
+            if (!hasCandidates[firstChan])
+            {
+                firstChan++;
+                continue;
+            }
+
+            size_t lastChan = firstChan;
+
+            for(size_t chan = firstChan + 1; chan < numChannels && chan <= lastChan + chanPad; chan++)
+                if (hasCandidates[chan]) lastChan = chan;
+
+            VectorBool runBins(numBins,false);
+
+            for(size_t chan = firstChan; chan <= lastChan; chan++)
+                for(size_t bin = 0; bin < numBins; bin++) if (candidates[chan][bin]) runBins[bin] = true;
+
+            size_t blockFirstChan = firstChan > chanPad ? firstChan - chanPad : 0;
+            size_t blockLastChan  = std::min(lastChan + chanPad + 1, numChannels);
+            size_t firstBin       = 0;
+
+            while(firstBin < numBins)
+            {
+                if (!runBins[firstBin])
+                {
+                    firstBin++;
+                    continue;
+                }
+
+                size_t lastBin = firstBin;
+
+                while(lastBin + 1 < numBins && runBins[lastBin + 1]) lastBin++;
+
+                size_t rangeFirstTick = firstBin * pooling;
+                size_t rangeLastTick  = std::min((lastBin + 1) * pooling, numTicks);
+                size_t blockFirstTick = rangeFirstTick > tickPad ? rangeFirstTick - tickPad : 0;
+                size_t blockLastTick  = std::min(rangeLastTick + tickPad, numTicks);
+
+                icarus_signal_processing::ArrayFloat blockImage(blockLastChan - blockFirstChan);
+                icarus_signal_processing::ArrayFloat blockMorphed(blockImage.size(),icarus_signal_processing::VectorFloat(blockLastTick - blockFirstTick,0.));
+
+                for(size_t chan = blockFirstChan; chan < blockLastChan; chan++)
+                    blockImage[chan - blockFirstChan].assign(inputImage[chan].begin() + blockFirstTick, inputImage[chan].begin() + blockLastTick);
+
+                icarus_signal_processing::Dilation2D(fStructuringElement[0],fStructuringElement[1])(blockImage.begin(),blockImage.size(),blockMorphed.begin());
+
+                for(size_t chan = firstChan; chan <= lastChan; chan++)
+                {
+                    if (!hasCandidates[chan]) continue;
+
+                    const VectorFloat& morphedWave = blockMorphed[chan - blockFirstChan];
+                    VectorBool&        selVals     = outputROIs[chan];
+
+                    for(size_t tick = rangeFirstTick; tick < rangeLastTick; tick++)
+                    {
+                        if (candidates[chan][tick / pooling] && morphedWave[tick - blockFirstTick] - medians[chan] > thresholds[chan]) selVals[tick] = true;
+                    }
+                }
+
+                firstBin = lastBin + 1;
+            }
+
+            firstChan = lastChan + 1;
+        }
+
+        return;
+    }
+
+    inline void MorphologicalROIFinder::getBaselineAndThreshold(const VectorFloat& morphedWave, float& median, float& threshold) const
+    {
+        // We need to zero suppress so we can find the rms
+        median = getMedian(morphedWave, morphedWave.size());
+
+        VectorFloat rmsVec(morphedWave.size());
+
+        for(size_t idx = 0; idx < morphedWave.size(); idx++) rmsVec[idx] = morphedWave[idx] - median;
+
+        size_t maxIdx = 0.75 * rmsVec.size();
+
+        std::nth_element(rmsVec.begin(), rmsVec.begin() + maxIdx, rmsVec.end());
+
+        float rms = std::sqrt(std::inner_product(rmsVec.begin(), rmsVec.begin() + maxIdx, rmsVec.begin(), 0.) / float(maxIdx));
+
+        threshold = rms * fThreshold;
+
+//        std::cout << "==> median: " << median << ", rms: " << rms << ", threshold: " << threshold << std::endl;
+
+        return;
+    }
+
+    inline float MorphologicalROIFinder::getMedian(icarus_signal_processing::VectorFloat vals, const unsigned int nVals)
+    {
+        float median(0.);
+
+        if (nVals > 2)
+        {
+            if (nVals % 2 == 0)
+            {
+                const auto m1 = vals.begin() + nVals / 2 - 1;
+                const auto m2 = vals.begin() + nVals / 2;
+                std::nth_element(vals.begin(), m1, vals.begin() + nVals);
+                const auto e1 = *m1;
+                std::nth_element(vals.begin(), m2, vals.begin() + nVals);
+                const auto e2 = *m2;
+                median = (e1 + e2) / 2.0;
+            }
+            else
+            {
+                const auto m = vals.begin() + nVals / 2;
+                std::nth_element(vals.begin(), m, vals.begin() + nVals);
+                median = *m;
+            }
+        }
+
+        return median;
+    }
+}
+
+#endif
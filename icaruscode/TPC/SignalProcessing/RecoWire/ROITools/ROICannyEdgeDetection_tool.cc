@@ -20,8 +20,14 @@
 #include "TH2F.h"
 #include "TProfile.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/task_arena.h"
+
 #include <fstream>
 #include <chrono>
+#include <algorithm>
 
 namespace icarus_tool
 {
@@ -39,6 +45,33 @@ public:
     
 private:
 
+    // Work images of the local stages (smoothing through non-maximum suppression)
+    struct LocalBuffers
+    {
+        icarus_signal_processing::ArrayFloat buffer;
+        icarus_signal_processing::ArrayFloat sobelX;
+        icarus_signal_processing::ArrayFloat sobelY;
+        icarus_signal_processing::ArrayFloat gradient;
+        icarus_signal_processing::ArrayFloat direction;
+
+        // Resizes the work images to numChannels x numTicks and sets them to 0
+        void reset(size_t numChannels, size_t numTicks);
+    };
+
+    // Tile input and output (with halo) together with its work images
+    struct TileBuffers
+    {
+        icarus_signal_processing::ArrayFloat input;
+        icarus_signal_processing::ArrayFloat output;
+        LocalBuffers                         work;
+    };
+
+    // Runs the local stages on the input image, the buffers must be reset
+    void enhanceEdges(const ArrayFloat& inputImage, ArrayFloat& output, LocalBuffers& buffers) const;
+
+    // Runs the local stages one channel tile at a time, with the tiles in parallel
+    void enhanceEdgesTiled(const ArrayFloat& inputImage, ArrayFloat& output) const;
+
     std::unique_ptr<icarus_signal_processing::BilateralFilters> fBilateralFilters;
     std::unique_ptr<icarus_signal_processing::EdgeDetection>    fEdgeDetection;
     std::unique_ptr<icarus_signal_processing::IROIFinder2D>     fROIFinder2D;
@@ -53,6 +86,12 @@ private:
     float                fHighThreshold;              ///<
     unsigned int         fBinaryDilation_SX;          ///<
     unsigned int         fBinaryDilation_SY;          ///<
+    unsigned int         fTileChannels;               ///< Channels per tile of the local stages (0 for the whole plane; experimental)
+    bool                 fValidateTiles;              ///< Compare the tiled result with the whole plane one, throw if they differ
+    unsigned int         fTileHalo;                   ///< Channels on each side a tile needs to be exact
+
+    // Tile work images, kept across calls by each thread
+    mutable tbb::enumerable_thread_specific<TileBuffers> fTileBuffers;
 };
     
 //----------------------------------------------------------------------
@@ -80,6 +119,14 @@ void ROICannyEdgeDetection::configure(const fhicl::ParameterSet& pset)
     fBinaryDilation_SX     = pset.get<unsigned int>("BinaryDilation_SX",  31);
     fBinaryDilation_SY     = pset.get<unsigned int>("BinaryDilation_SY",  31);
 
+    fTileChannels          = pset.get<unsigned int>("TileChannels",        0);
+    fValidateTiles         = pset.get<bool        >("ValidateTiles",   false);
+
+    // Each output channel depends on the input channels within the reach of the two
+    // Sobel passes and the non-maximum suppression (one channel each) plus the
+    // bilateral filter and the dilation windows; a full window width is a safe bound
+    fTileHalo              = 3 + 2 * std::max(fADFilter_SX, fADFilter_SY);
+
     fBilateralFilters = std::make_unique<icarus_signal_processing::BilateralFilters>();
     fEdgeDetection    = std::make_unique<icarus_signal_processing::EdgeDetection>();
     
@@ -93,51 +140,62 @@ void ROICannyEdgeDetection::FindROIs(const art::Event& event, const ArrayFloat&
   
     std::chrono::high_resolution_clock::time_point funcStartTime = std::chrono::high_resolution_clock::now();
 
-    // 5. Directional Smoothing
-    std::cout << "++> Step 5: Directional smoothing" << std::endl;
-    icarus_signal_processing::ArrayFloat buffer   (numChannels, icarus_signal_processing::VectorFloat(numTicks,0.));
-    icarus_signal_processing::ArrayFloat sobelX   (numChannels, icarus_signal_processing::VectorFloat(numTicks,0.));
-    icarus_signal_processing::ArrayFloat sobelY   (numChannels, icarus_signal_processing::VectorFloat(numTicks,0.));
-    icarus_signal_processing::ArrayFloat gradient (numChannels, icarus_signal_processing::VectorFloat(numTicks,0.));
-    icarus_signal_processing::ArrayFloat direction(numChannels, icarus_signal_processing::VectorFloat(numTicks,0.));
-    icarus_signal_processing::ArrayBool  rois     (numChannels, icarus_signal_processing::VectorBool( numTicks,false));
-
-    std::chrono::high_resolution_clock::time_point sobelStartTime = std::chrono::high_resolution_clock::now();
+    // Steps 5 to 8 (directional smoothing, morphological enhancing and edge
+    // thinning) only look at neighbouring channels and ticks
+    std::cout << "++> Steps 5-8: Directional smoothing and Canny edge detection" << std::endl;
 
-    fEdgeDetection->SepSobel(inputImage, sobelX, sobelY, gradient, direction);
+    if (fTileChannels > 0 && numChannels > fTileChannels)
+    {
+        enhanceEdgesTiled(inputImage, output);
 
-    std::chrono::high_resolution_clock::time_point sobelStopTime      = std::chrono::high_resolution_clock::now();
-    std::chrono::high_resolution_clock::time_point bilateralStartTime = sobelStopTime;
+        if (fValidateTiles)
+        {
+            icarus_signal_processing::ArrayFloat planeOutput(numChannels, icarus_signal_processing::VectorFloat(numTicks,0.));
+            LocalBuffers                         planeBuffers;
 
-    std::cout << "==> Step 6: Apply bilateral filter" << std::endl;
+            planeBuffers.reset(numChannels, numTicks);
 
-    fBilateralFilters->directional(inputImage, direction, buffer, fADFilter_SX, fADFilter_SY, fSigma_x, fSigma_y, fSigma_r, 360);
+            enhanceEdges(inputImage, planeOutput, planeBuffers);
 
-    std::chrono::high_resolution_clock::time_point bilateralStopTime = std::chrono::high_resolution_clock::now();
-    std::chrono::high_resolution_clock::time_point dilationStartTime = bilateralStopTime;
+            size_t numDifferent(0);
+            size_t firstChannel(0);
+            size_t firstTick(0);
 
-    std::cout << "==> Step 7: Apply Second Morphological Enhancing" << std::endl;
+            for(size_t channel = 0; channel < numChannels; channel++)
+            {
+                for(size_t tick = 0; tick < numTicks; tick++)
+                {
+                    if (planeOutput[channel][tick] == output[channel][tick]) continue;
 
-    icarus_signal_processing::Dilation2D(fADFilter_SX,fADFilter_SY)(buffer.begin(), numChannels, output.begin());
+                    if (numDifferent++ == 0)
+                    {
+                        firstChannel = channel;
+                        firstTick    = tick;
+                    }
+                }
+            }
 
-    std::chrono::high_resolution_clock::time_point dilationStopTime    = std::chrono::high_resolution_clock::now();
-    std::chrono::high_resolution_clock::time_point edgeInterpStartTime = dilationStopTime;
+            // The tiled path is only correct if it is exact: any difference is an error
+            if (numDifferent > 0)
+                throw cet::exception("ROICannyEdgeDetection") << "Tiled edge detection (TileChannels: " << fTileChannels << ") differs from the whole plane one in " << numDifferent << " of " << numChannels * numTicks << " entries, first at channel " << firstChannel << " tick " << firstTick << " (" << output[firstChannel][firstTick] << " instead of " << planeOutput[firstChannel][firstTick] << ")\n";
 
-    std::cout << "==> Step 8: Perform Canny Edge Detection" << std::endl;
+            mf::LogDebug("ROICannyEdgeDetection") << "Tiled edge detection matches the whole plane one";
+        }
+    }
+    else
+    {
+        LocalBuffers buffers;
 
-    // 6. Apply Canny Edge Detection
-    for(auto& gradVec : gradient) std::fill(gradVec.begin(),gradVec.end(),0.);
+        buffers.reset(numChannels, numTicks);
 
-    fEdgeDetection->SepSobel(output, sobelX, sobelY, gradient, direction);
-    fEdgeDetection->EdgeNMSInterpolation(gradient, sobelX, sobelY, direction, output);
+        enhanceEdges(inputImage, output, buffers);
+    }
 
-    std::chrono::high_resolution_clock::time_point edgeInterpStopTime  = std::chrono::high_resolution_clock::now();
-    std::chrono::high_resolution_clock::time_point hysterisisStartTime = edgeInterpStopTime;
+    std::chrono::high_resolution_clock::time_point edgeStopTime        = std::chrono::high_resolution_clock::now();
+    std::chrono::high_resolution_clock::time_point hysterisisStartTime = edgeStopTime;
 
-    std::vector<int> strongEdgeRows;
-    std::vector<int> strongEdgeCols;
-    std::vector<int> weakEdgeRows;
-    std::vector<int> weakEdgeCols;
+    // The hysteresis follows edges across the whole plane
+    icarus_signal_processing::ArrayBool rois(numChannels, icarus_signal_processing::VectorBool(numTicks,false));
 
     fEdgeDetection->SparseHysteresisThresholding(output, fLowThreshold, fHighThreshold, rois);
 
@@ -149,21 +207,93 @@ void ROICannyEdgeDetection::FindROIs(const art::Event& event, const ArrayFloat&
     icarus_signal_processing::Dilation2D(fBinaryDilation_SX,fBinaryDilation_SY)(rois.begin(), numChannels, outputROIs.begin());
 
     std::chrono::high_resolution_clock::time_point binaryDilationStopTime  = std::chrono::high_resolution_clock::now();
-    std::chrono::high_resolution_clock::time_point funcStopTime            = hysterisisStopTime;
+    std::chrono::high_resolution_clock::time_point funcStopTime            = binaryDilationStopTime;
   
     std::chrono::duration<double> funcTime       = std::chrono::duration_cast<std::chrono::duration<double>>(funcStopTime - funcStartTime);
-    std::chrono::duration<double> sobelTime      = std::chrono::duration_cast<std::chrono::duration<double>>(sobelStopTime - sobelStartTime);
-    std::chrono::duration<double> bilateralTime  = std::chrono::duration_cast<std::chrono::duration<double>>(bilateralStopTime - bilateralStartTime);
-    std::chrono::duration<double> dilationTime   = std::chrono::duration_cast<std::chrono::duration<double>>(dilationStopTime - dilationStartTime);
-    std::chrono::duration<double> edgeInterpTime = std::chrono::duration_cast<std::chrono::duration<double>>(edgeInterpStopTime - edgeInterpStartTime);
+    std::chrono::duration<double> edgeTime       = std::chrono::duration_cast<std::chrono::duration<double>>(edgeStopTime - funcStartTime);
     std::chrono::duration<double> hysterisisTime = std::chrono::duration_cast<std::chrono::duration<double>>(hysterisisStopTime - hysterisisStartTime);
     std::chrono::duration<double> binaryDilTime  = std::chrono::duration_cast<std::chrono::duration<double>>(binaryDilationStopTime - binaryDilationStartTime);
 
     std::cout << "--> ROICannyEdgeDetection finished!" << std::endl;
-    std::cout << "    - Total time: " << funcTime.count() << ", sobel: " << sobelTime.count() << ", bilateral: " << bilateralTime.count() << ", dilation: " << dilationTime.count() << ", Edge: " << edgeInterpTime.count() << ", hysterisis: " << hysterisisTime.count() << ", dilate: " << binaryDilTime.count() << std::endl;
+    std::cout << "    - Total time: " << funcTime.count() << ", smoothing and edges: " << edgeTime.count() << ", hysterisis: " << hysterisisTime.count() << ", dilate: " << binaryDilTime.count() << std::endl;
      
     return;
 }
 
+void ROICannyEdgeDetection::LocalBuffers::reset(size_t numChannels, size_t numTicks)
+{
+    // assign() keeps the capacity of the vectors, so tiles of the same size reuse the memory
+    for(icarus_signal_processing::ArrayFloat* image : {&buffer, &sobelX, &sobelY, &gradient, &direction})
+    {
+        image->resize(numChannels);
+
+        for(auto& channelVec : *image) channelVec.assign(numTicks, 0.);
+    }
+
+    return;
+}
+
+void ROICannyEdgeDetection::enhanceEdges(const ArrayFloat& inputImage, ArrayFloat& output, LocalBuffers& buffers) const
+{
+    unsigned int numChannels = inputImage.size();
+
+    // 5. Directional Smoothing
+    fEdgeDetection->SepSobel(inputImage, buffers.sobelX, buffers.sobelY, buffers.gradient, buffers.direction);
+
+    // 6. Apply bilateral filter
+    fBilateralFilters->directional(inputImage, buffers.direction, buffers.buffer, fADFilter_SX, fADFilter_SY, fSigma_x, fSigma_y, fSigma_r, 360);
+
+    // 7. Apply Second Morphological Enhancing
+    icarus_signal_processing::Dilation2D(fADFilter_SX,fADFilter_SY)(buffers.buffer.begin(), numChannels, output.begin());
+
+    // 8. Perform Canny Edge Detection
+    for(auto& gradVec : buffers.gradient) std::fill(gradVec.begin(),gradVec.end(),0.);
+
+    fEdgeDetection->SepSobel(output, buffers.sobelX, buffers.sobelY, buffers.gradient, buffers.direction);
+    fEdgeDetection->EdgeNMSInterpolation(buffers.gradient, buffers.sobelX, buffers.sobelY, buffers.direction, output);
+
+    return;
+}
+
+void ROICannyEdgeDetection::enhanceEdgesTiled(const ArrayFloat& inputImage, ArrayFloat& output) const
+{
+    size_t numChannels = inputImage.size();
+    size_t numTicks    = inputImage[0].size();
+    size_t numTiles    = (numChannels + fTileChannels - 1) / fTileChannels;
+
+    // Each tile is extended by a halo of channels on both sides so that its own
+    // channels come out exactly as from the whole plane; the halo results are dropped
+    auto processTiles = [&](const tbb::blocked_range<size_t>& tileRange)
+    {
+        TileBuffers& buffers = fTileBuffers.local();
+
+        for(size_t tileIdx = tileRange.begin(); tileIdx < tileRange.end(); tileIdx++)
+        {
+            size_t firstChannel = tileIdx * fTileChannels;
+            size_t lastChannel  = std::min(firstChannel + fTileChannels, numChannels);
+            size_t firstHalo    = firstChannel > fTileHalo ? firstChannel - fTileHalo : 0;
+            size_t lastHalo     = std::min(lastChannel + fTileHalo, numChannels);
+
+            buffers.input.assign(inputImage.begin() + firstHalo, inputImage.begin() + lastHalo);
+            buffers.output.resize(lastHalo - firstHalo);
+
+            for(auto& channelVec : buffers.output) channelVec.assign(numTicks, 0.);
+
+            buffers.work.reset(lastHalo - firstHalo, numTicks);
+
+            // Keep this thread from picking up another tile (and its buffers) while waiting
+            tbb::this_task_arena::isolate([&]{ enhanceEdges(buffers.input, buffers.output, buffers.work); });
+
+            std::copy(buffers.output.begin() + (firstChannel - firstHalo),
+                      buffers.output.begin() + (lastChannel  - firstHalo),
+                      output.begin() + firstChannel);
+        }
+    };
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numTiles), processTiles);
+
+    return;
+}
+
 DEFINE_ART_CLASS_TOOL(ROICannyEdgeDetection)
 }
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "icaruscode/TPC/SignalProcessing/RecoWire/ROITools/IROILocator.h"
+#include "icaruscode/TPC/SignalProcessing/RecoWire/ROITools/MorphologicalROIFinder.h"
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
 #include "art_root_io/TFileService.h"
@@ -20,6 +21,8 @@
 #include "TProfile.h"
 
 #include <fstream>
+#include <algorithm>
+#include <numeric>
 
 namespace icarus_tool
 {
@@ -36,12 +39,12 @@ public:
     void FindROIs(const art::Event&, const ArrayFloat&, const geo::PlaneID&, ArrayFloat&, ArrayBool&)    const override;
     
 private:
-    // This is for the baseline...
-    float getMedian(const icarus_signal_processing::VectorFloat, const unsigned int) const;
-
     // fhicl parameters
     std::vector<size_t>  fStructuringElement;         ///< Structuring element for morphological filter
     std::vector<float>   fThreshold;                  ///< Threshold to apply for saving signal
+    size_t               fCoarsePoolingFactor;        ///< Ticks pooled in the coarse image (1 = full resolution only)
+    size_t               fCoarseMargin;               ///< Coarse bins added around each candidate before refining
+    bool                 fValidateCoarseToFine;       ///< Also run at full resolution and report the differences
 };
     
 //----------------------------------------------------------------------
@@ -60,89 +63,55 @@ void ROIMorphological2D::configure(const fhicl::ParameterSet& pset)
     // Start by recovering the parameters
     fStructuringElement = pset.get<std::vector<size_t> >("StructuringElement", std::vector<size_t>()={8,16});
     fThreshold          = pset.get<std::vector<float>  >("Threshold",          std::vector<float>()={2.75,2.75,2.75});
+    fCoarsePoolingFactor  = pset.get<size_t             >("CoarsePoolingFactor",  1);
+    fCoarseMargin         = pset.get<size_t             >("CoarseMargin",         1);
+    fValidateCoarseToFine = pset.get<bool               >("ValidateCoarseToFine", false);
+
+    if (fCoarsePoolingFactor < 1)
+        throw cet::exception("ROIMorphological2D") << "CoarsePoolingFactor must be at least 1\n";
 
     return;
 }
 
 void ROIMorphological2D::FindROIs(const art::Event& event, const ArrayFloat& inputImage, const geo::PlaneID& planeID, ArrayFloat& output, ArrayBool& outputROIs) const
 {
-    icarus_signal_processing::ArrayFloat morphedWaveforms(inputImage.size(),icarus_signal_processing::VectorFloat(inputImage[0].size(),0.));
-
-    // Use this to get the 2D Dilation of each waveform
-    icarus_signal_processing::Dilation2D(fStructuringElement[0],fStructuringElement[1])(inputImage.begin(),inputImage.size(),morphedWaveforms.begin());
+    MorphologicalROIFinder const roiFinder(fStructuringElement, fThreshold[planeID.Plane]);
 
-    // Now traverse each waveform and look for the ROIs
-    for(size_t waveIdx = 0; waveIdx < morphedWaveforms.size(); waveIdx++)
+    if (fCoarsePoolingFactor < 2)
     {
-        // We start working with the morphed waveform
-        const VectorFloat& morphedWave = morphedWaveforms[waveIdx];
-
-        // We need to zero suppress so we can find the rms
-        float median = getMedian(morphedWave, morphedWave.size());
-
-        VectorFloat baseVec(morphedWave.size());
-
-        for(size_t idx = 0; idx < morphedWave.size(); idx++) baseVec[idx] = morphedWave[idx] - median;
-
-        VectorFloat rmsVec = baseVec;
-        size_t      maxIdx = 0.75 * rmsVec.size();
-
-        std::nth_element(rmsVec.begin(), rmsVec.begin() + maxIdx, rmsVec.end());
+        roiFinder.findROIsFullResolution(inputImage, outputROIs);
+        return;
+    }
 
-        float rms       = std::sqrt(std::inner_product(rmsVec.begin(), rmsVec.begin() + maxIdx, rmsVec.begin(), 0.) / float(maxIdx));
-        float threshold = rms * fThreshold[planeID.Plane];
+    roiFinder.findROIsCoarseToFine(inputImage, fCoarsePoolingFactor, fCoarseMargin, outputROIs);
 
-//        std::cout << "==> median: " << median << ", rms: " << rms << ", threshold: " << threshold << std::endl;
+    if (fValidateCoarseToFine)
+    {
+        ArrayBool fullROIs(inputImage.size());
 
-        // Right size the selected values array
-        VectorBool& selVals = outputROIs[waveIdx];
+        roiFinder.findROIsFullResolution(inputImage, fullROIs);
 
-        selVals.resize(morphedWave.size(),false);
+        size_t nFull(0), nCoarse(0), nMissed(0), nExtra(0);
 
-        for(size_t idx = 0; idx < baseVec.size(); idx++)
+        for(size_t waveIdx = 0; waveIdx < fullROIs.size(); waveIdx++)
         {
-//            if (std::abs(baseVec[idx]) > threshold) selVals[idx] = true;
-            if (baseVec[idx] > threshold) selVals[idx] = true;
+            for(size_t idx = 0; idx < fullROIs[waveIdx].size(); idx++)
+            {
+                bool full   = fullROIs[waveIdx][idx];
+                bool coarse = outputROIs[waveIdx][idx];
+
+                if (full)            nFull++;
+                if (coarse)          nCoarse++;
+                if (full && !coarse) nMissed++;
+                if (coarse && !full) nExtra++;
+            }
         }
 
-        // Check to see if we should save the baseVec
-//        if (fOutputMorphed)
-//        {
-//            raw::ChannelID_t channel = planeIDToDataPair.first[waveIdx];
-//            geo::View_t      view    = fGeometry->View(channel);
-//
-//            morphedVec.push_back(recob::WireCreator(std::move(baseVec),channel,view).move());
-//        }
-    }
-     
-    return;
-}
-
-float ROIMorphological2D::getMedian(icarus_signal_processing::VectorFloat vals, const unsigned int nVals) const
-{
-    float median(0.);
-
-    if (nVals > 2) 
-    {
-        if (nVals % 2 == 0) 
-        {
-            const auto m1 = vals.begin() + nVals / 2 - 1;
-            const auto m2 = vals.begin() + nVals / 2;
-            std::nth_element(vals.begin(), m1, vals.begin() + nVals);
-            const auto e1 = *m1;
-            std::nth_element(vals.begin(), m2, vals.begin() + nVals);
-            const auto e2 = *m2;
-            median = (e1 + e2) / 2.0;
-        } 
-        else 
-        {
-            const auto m = vals.begin() + nVals / 2;
-            std::nth_element(vals.begin(), m, vals.begin() + nVals);
-            median = *m;
-        }
+        mf::LogInfo("ROIMorphological2D") << "Coarse to fine validation, plane " << planeID.Plane << ": " << nFull << " ticks selected at full resolution, "
+                                          << nCoarse << " coarse to fine, " << nMissed << " missed, " << nExtra << " extra";
     }
 
-    return median;
+    return;
 }
 
 DEFINE_ART_CLASS_TOOL(ROIMorphological2D)
@@ -13,6 +13,7 @@
 // C/C++ standard library
 #include <stdexcept> // std::range_error
 #include <vector>
+#include <array>
 #include <string>
 #include <algorithm> // std::fill()
 #include <functional>
@@ -61,6 +62,12 @@
 #include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
 #include "tools/IGenNoise.h"
 #include "icarus_signal_processing/Filters/ICARUSFFT.h"
+// TBB
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
+#include <mutex>
 
 using namespace util;
 ///Detector simulation of raw signals on wires
@@ -85,7 +92,63 @@ private:
     void MakeADCVec(std::vector<short>& adc, icarusutil::TimeVec const& noise,
                     icarusutil::TimeVec const& charge, float ped_mean) const;
 
-    using TPCIDVec  = std::vector<geo::TPCID>;
+    using TPCIDVec     = std::vector<geo::TPCID>;
+    using NoiseToolVec = std::vector<std::unique_ptr<icarus_tool::IGenNoise>>;
+    using FFTPointer   = std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>>;
+    using HistEntryVec = std::vector<std::pair<unsigned int,short>>; ///< (wire, area) for the histograms
+
+    // Event-wide information needed to simulate the channels of a motherboard
+    struct EventContext
+    {
+        const lariov::DetPedestalProvider&      pedestals;
+        const lariov::ChannelStatusProvider&    channelStatus;
+        const detinfo::DetectorClocksData&      clockData;
+        const detinfo::DetectorPropertiesData&  detProp;
+        const std::vector<const sim::SimChannel*>& simChannels;
+        const DoubleVec2&                       noiseFactVec;
+        int                                     firstTDC;      ///< TDC of the first readout tick
+        bool                                    tdcContiguous; ///< Whether tick i has TDC firstTDC + i
+    };
+
+    // Fills chargeWork with the charge of simChan (in ADC-equivalent units, via gain);
+    // returns whether any charge was found in the readout window
+    bool FillChargeVector(const sim::SimChannel& simChan, const EventContext& context,
+                          double gain, icarusutil::TimeVec& chargeWork) const;
+
+    // Simulates all the channels of motherboard mb, appending the RawDigits to digits
+    void SimulateMotherboard(raw::ChannelID_t                  mb,
+                             const EventContext&               context,
+                             CLHEP::HepRandomEngine&           pedestalEngine,
+                             CLHEP::HepRandomEngine&           uncNoiseEngine,
+                             CLHEP::HepRandomEngine&           corNoiseEngine,
+                             NoiseToolVec&                     noiseToolVec,
+                             icarus_signal_processing::ICARUSFFT<double>& fft,
+                             std::vector<raw::RawDigit>&       digits,
+                             HistEntryVec&                     histEntries) const;
+
+    // Seed for the engine of a given motherboard and stream, derived from the event seed
+    static long MotherboardSeed(long eventSeed, raw::ChannelID_t mb, unsigned int stream);
+
+    // Simulates again the motherboards one by one in reverse order, and throws if any digit differs
+    void CheckMotherboards(const std::vector<raw::ChannelID_t>&             mbVec,
+                           const EventContext&                              context,
+                           const std::array<long, 3>&                       eventSeeds,
+                           const std::vector<std::vector<raw::RawDigit>>&   mbDigitVec);
+
+    // Noise tools and FFT object of a thread (parallel mode)
+    struct ThreadTools
+    {
+        NoiseToolVec noiseToolVec;
+        FFTPointer   fft;
+        std::string  serialTool;         ///< Type of a tool not supporting concurrent generation, if any
+        size_t       numEvents  = 0;     ///< Number of events the tools have been advanced to
+    };
+
+    // Creates a set of noise tools and FFT object for one thread
+    ThreadTools MakeThreadTools();
+
+    // Returns the tools of the current thread, creating them and bringing them to the current event if needed
+    ThreadTools& LocalThreadTools();
     
     art::InputTag                fDriftEModuleLabel; ///< module making the ionization electrons
     std::string                  fOutInstanceLabel;  ///< The label to apply to the output data product
@@ -100,8 +163,12 @@ private:
     bool                         fSuppressNoSignal;  ///< If no signal on wire (simchannel) then suppress the channel
     bool                         fSmearPedestals;    ///< If True then we smear the pedestals
     int                          fNumChanPerMB;      ///< Number of channels per motherboard
+    bool                         fParallelMB;        ///< If true, simulate the motherboards in parallel
+    bool                         fCheckParallelMB;   ///< If true, check the parallel simulation against a serial one
     
-    std::vector<std::unique_ptr<icarus_tool::IGenNoise>> fNoiseToolVec; ///< Tool for generating noise
+    NoiseToolVec                 fNoiseToolVec;       ///< Tool for generating noise
+    std::vector<fhicl::ParameterSet> fThreadNoiseToolParamSetVec; ///< Configuration of the noise tools of each thread
+    size_t                       fNumEvents = 0;      ///< Number of events processed so far
     
     bool                         fMakeHistograms;
     bool                         fTest; // for forcing a test case
@@ -133,8 +200,9 @@ private:
         size_t m_time;
     };
 
-    using FFTPointer = std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>>;
     FFTPointer                              fFFT;                   //< Object to handle thread safe FFT
+    std::mutex                              fThreadToolMutex;       //< Serializes the creation of the thread tools
+    tbb::enumerable_thread_specific<ThreadTools> fThreadTools;      //< Noise tools and FFT of each thread (parallel mode)
     
     //services
     const geo::GeometryCore&                fGeometry;
@@ -149,6 +217,7 @@ SimWireICARUS::SimWireICARUS(fhicl::ParameterSet const& pset)
     , fPedestalEngine(art::ServiceHandle<rndm::NuRandomService>()->createEngine(*this, "HepJamesRandom", "pedestal", pset, "SeedPedestal"))
     , fUncNoiseEngine(art::ServiceHandle<rndm::NuRandomService>()->createEngine(*this, "HepJamesRandom", "noise",    pset, "Seed"))
     , fCorNoiseEngine(art::ServiceHandle<rndm::NuRandomService>()->createEngine(*this, "HepJamesRandom", "cornoise", pset, "Seed"))
+    , fThreadTools([this](){ return MakeThreadTools(); })
     , fGeometry(*lar::providerFrom<geo::Geometry>())
 {
     this->reconfigure(pset);
@@ -174,6 +243,8 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     fMakeHistograms    = p.get< bool                >("MakeHistograms",                     false);
     fSmearPedestals    = p.get< bool                >("SmearPedestals",                      true);
     fNumChanPerMB      = p.get< int                 >("NumChanPerMB",                          32);
+    fParallelMB        = p.get< bool                >("ParallelMotherboards",               false);
+    fCheckParallelMB   = p.get< bool                >("CheckParallelMotherboards",          false);
     fTest              = p.get< bool                >("Test",                               false);
     fTestWire          = p.get< size_t              >("TestWire",                               0);
     fTestIndex         = p.get< std::vector<size_t> >("TestIndex",          std::vector<size_t>());
@@ -208,6 +279,30 @@ void SimWireICARUS::reconfigure(fhicl::ParameterSet const& p)
     fSignalShapingService = art::ServiceHandle<icarusutil::SignalShapingICARUSService>{}.get();
 
     fFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(fNTimeSamples);
+
+    // In parallel mode each thread gets its own copy of the noise tools and of the FFT object,
+    // created the first time the thread simulates a motherboard.
+    // The copies do not store histograms (the serial tools already did).
+    fThreadTools.clear();
+    fThreadNoiseToolParamSetVec.clear();
+
+    if (fParallelMB)
+    {
+        fThreadNoiseToolParamSetVec = noiseToolParamSetVec;
+
+        for(auto& noiseToolParams : fThreadNoiseToolParamSetVec) noiseToolParams.put_or_replace("StoreHistograms", false);
+
+        // The tools of this thread are created now, so that unsupported tools are found at construction
+        std::string const serialTool = fThreadTools.local().serialTool;
+
+        if (!serialTool.empty())
+        {
+            mf::LogWarning("SimWireICARUS") << "Noise tool '" << serialTool
+                                            << "' does not support concurrent generation: motherboards will be simulated serially";
+            fParallelMB = false;
+            fThreadTools.clear();
+        }
+    }
     
     return;
 }
@@ -298,20 +393,13 @@ void SimWireICARUS::produce(art::Event& evt)
     //
     //--------------------------------------------------------------------
     
-    // vectors for working in the following for loop
-    std::vector<short>  adcvec(fNTimeSamples, 0);
-    icarusutil::TimeVec chargeWork(fNTimeSamples,0.);
-    icarusutil::TimeVec zeroCharge(fNTimeSamples,0.);
-    icarusutil::TimeVec noisetmp(fNTimeSamples,0.);
-    
-    // make sure chargeWork is correct size
-    if (chargeWork.size() < fNTimeSamples) throw std::range_error("SimWireICARUS: chargeWork vector too small");
-    
     //detector properties information
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(evt);
     
     // Let the tools know to update to the next event
     for(const auto& noiseTool : fNoiseToolVec) noiseTool->nextEvent();
+    // (the tools of the threads catch up when they are next used)
+    fNumEvents++;
 
     // The original implementation would allow the option to skip channels for which there was no MC signal
     // present. We want to update this so that if there is an MC signal on any wire in a common group (a
@@ -365,121 +453,328 @@ void SimWireICARUS::produce(art::Event& evt)
         }
     }
     
-    // Ok, now we can simply loop over MB's...
-    for(const auto& mb : mbWithSignalSet)
+    // The noise factors are the same for all channels: copy them once
+    const DoubleVec2 noiseFactVec = fSignalShapingService->GetNoiseFactVec();
+
+    // The TDC of each readout tick is normally just shifted by a constant;
+    // if so, the SimChannel charge can be scattered directly into the ticks
+    int const firstTDC      = clockData.TPCTick2TDC(0);
+    bool      tdcContiguous = true;
+
+    for(size_t tick = 1; tick < fNTimeSamples; tick++)
     {
-        raw::ChannelID_t baseChannel = fNumChanPerMB * mb;
-        
-        // And for a given MB we can loop over the channels it contains
-        for(raw::ChannelID_t channel = baseChannel; channel < baseChannel + fNumChanPerMB; channel++)
+        if (int(clockData.TPCTick2TDC(tick)) != firstTDC + int(tick))
         {
-            //clean up working vectors from previous iteration of loop
-            adcvec.resize(fNTimeSamples, 0);  //compression may have changed the size of this vector
-            noisetmp.resize(fNTimeSamples, 0.);     //just in case
-            
-            //use channel number to set some useful numbers
-            std::vector<geo::WireID> widVec = fGeometry.ChannelToWire(channel);
-            size_t                   plane  = widVec[0].Plane;
-            
-            //Get pedestal with random gaussian variation
-            float ped_mean = pedestalRetrievalAlg.PedMean(channel);
-            
-            if (fSmearPedestals )
-            {
-                CLHEP::RandGaussQ rGaussPed(fPedestalEngine, 0.0, pedestalRetrievalAlg.PedRms(channel));
-                ped_mean += rGaussPed.fire();
-            }
-            
-            //Generate Noise
-            double noise_factor(0.);
-            auto   tempNoiseVec = fSignalShapingService->GetNoiseFactVec();
-            double shapingTime  = fSignalShapingService->GetShapingTime(channel);
-            double gain         = fSignalShapingService->GetASICGain(channel) * sampling_rate(clockData) * 1.e-3; // Gain returned is electrons/us, this converts to electrons/tick
-            int    timeOffset   = fSignalShapingService->ResponseTOffset(channel);
-            
-            // Recover the response function information for this channel
-            const icarus_tool::IResponse& response = fSignalShapingService->GetResponse(channel);
+            tdcContiguous = false;
+            break;
+        }
+    }
 
-            if (fShapingTimeOrder.find( shapingTime ) != fShapingTimeOrder.end() )
-                noise_factor = tempNoiseVec[plane].at( fShapingTimeOrder.find( shapingTime )->second );
-            //Throw exception...
-            else
+    EventContext const context{pedestalRetrievalAlg, ChannelStatusProvider, clockData, detProp, channels, noiseFactVec, firstTDC, tdcContiguous};
+    
+    HistEntryVec histEntries;
+
+    if (!fParallelMB)
+    {
+        // Ok, now we can simply loop over MB's...
+        for(const auto& mb : mbWithSignalSet)
+            SimulateMotherboard(mb, context, fPedestalEngine, fUncNoiseEngine, fCorNoiseEngine, fNoiseToolVec, *fFFT, *digcol, histEntries);
+    }
+    else
+    {
+        // Each motherboard gets its own engines, seeded from the event seeds and the motherboard number,
+        // so that the result does not depend on the number of threads or on the order of processing
+        long const pedestalSeed = CLHEP::RandFlat::shootInt(&fPedestalEngine, 900000000L);
+        long const uncNoiseSeed = CLHEP::RandFlat::shootInt(&fUncNoiseEngine, 900000000L);
+        long const corNoiseSeed = CLHEP::RandFlat::shootInt(&fCorNoiseEngine, 900000000L);
+
+        // Make sure the response functions are initialized before going multithread
+        fSignalShapingService->GetResponse(0);
+
+        std::vector<raw::ChannelID_t>           mbVec(mbWithSignalSet.begin(), mbWithSignalSet.end());
+        std::vector<std::vector<raw::RawDigit>> mbDigitVec(mbVec.size());
+        std::vector<HistEntryVec>               mbHistEntryVec(mbVec.size());
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, mbVec.size()), [&](const tbb::blocked_range<size_t>& range)
+        {
+            ThreadTools& threadTools = LocalThreadTools();
+
+            for(size_t mbIdx = range.begin(); mbIdx < range.end(); mbIdx++)
             {
-                throw cet::exception("SimWireICARUS")
-                << "\033[93m"
-                << "Shaping Time received from signalservices_icarus.fcl is not one of allowed values"
-                << std::endl
-                << "Allowed values: 0.6, 1.0, 1.3, 3.0 usec"
-                << "\033[00m"
-                << std::endl;
+                raw::ChannelID_t const mb = mbVec[mbIdx];
+
+                CLHEP::HepJamesRandom pedestalEngine(MotherboardSeed(pedestalSeed, mb, 0));
+                CLHEP::HepJamesRandom uncNoiseEngine(MotherboardSeed(uncNoiseSeed, mb, 1));
+                CLHEP::HepJamesRandom corNoiseEngine(MotherboardSeed(corNoiseSeed, mb, 2));
+
+                mbDigitVec[mbIdx].reserve(fNumChanPerMB);
+
+                SimulateMotherboard(mb, context, pedestalEngine, uncNoiseEngine, corNoiseEngine,
+                                    threadTools.noiseToolVec, *threadTools.fft,
+                                    mbDigitVec[mbIdx], mbHistEntryVec[mbIdx]);
             }
+        });
+
+        if (fCheckParallelMB) CheckMotherboards(mbVec, context, {pedestalSeed, uncNoiseSeed, corNoiseSeed}, mbDigitVec);
+
+        // Collect the digits in motherboard order
+        for(size_t mbIdx = 0; mbIdx < mbVec.size(); mbIdx++)
+        {
+            std::move(mbDigitVec[mbIdx].begin(), mbDigitVec[mbIdx].end(), std::back_inserter(*digcol));
+            histEntries.insert(histEntries.end(), mbHistEntryVec[mbIdx].begin(), mbHistEntryVec[mbIdx].end());
+        }
+    }
+
+    // Histograms are filled here since they can't be filled from multiple threads
+    for(const auto& [wire, area] : histEntries)
+    {
+        fSimCharge->Fill(area);
+        fSimChargeWire->Fill(wire,area);
+    }
+    
+    evt.put(std::move(digcol), fOutInstanceLabel);
+    
+    return;
+}
+//-------------------------------------------------
+SimWireICARUS::ThreadTools SimWireICARUS::MakeThreadTools()
+{
+    std::lock_guard<std::mutex> lock(fThreadToolMutex);
+
+    ThreadTools threadTools;
+
+    // Noise banks of the tools, if any, are not duplicated: all instances share one copy (NoiseBank::shared())
+    for(const auto& noiseToolParams : fThreadNoiseToolParamSetVec)
+    {
+        threadTools.noiseToolVec.push_back(art::make_tool<icarus_tool::IGenNoise>(noiseToolParams));
+
+        // Reproducibility requires the noise to be driven only by the engines we seed
+        if (!threadTools.noiseToolVec.back()->enableConcurrentGeneration())
+            threadTools.serialTool = noiseToolParams.get<std::string>("tool_type");
+    }
+
+    threadTools.fft = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(fNTimeSamples);
+
+    return threadTools;
+}
+//-------------------------------------------------
+SimWireICARUS::ThreadTools& SimWireICARUS::LocalThreadTools()
+{
+    ThreadTools& threadTools = fThreadTools.local();
+
+    // Tools created after the first event must see the same sequence of nextEvent() as the serial ones
+    for(; threadTools.numEvents < fNumEvents; threadTools.numEvents++)
+        for(const auto& noiseTool : threadTools.noiseToolVec) noiseTool->nextEvent();
+
+    return threadTools;
+}
+//-------------------------------------------------
+void SimWireICARUS::SimulateMotherboard(raw::ChannelID_t                  mb,
+                                        const EventContext&               context,
+                                        CLHEP::HepRandomEngine&           pedestalEngine,
+                                        CLHEP::HepRandomEngine&           uncNoiseEngine,
+                                        CLHEP::HepRandomEngine&           corNoiseEngine,
+                                        NoiseToolVec&                     noiseToolVec,
+                                        icarus_signal_processing::ICARUSFFT<double>& fft,
+                                        std::vector<raw::RawDigit>&       digits,
+                                        HistEntryVec&                     histEntries) const
+{
+    // vectors for working in the following for loop
+    std::vector<short>  adcvec(fNTimeSamples, 0);
+    icarusutil::TimeVec chargeWork(fNTimeSamples,0.);
+    icarusutil::TimeVec zeroCharge(fNTimeSamples,0.);
+    icarusutil::TimeVec noisetmp(fNTimeSamples,0.);
+    
+    // make sure chargeWork is correct size
+    if (chargeWork.size() < fNTimeSamples) throw std::range_error("SimWireICARUS: chargeWork vector too small");
+    
+    raw::ChannelID_t baseChannel = fNumChanPerMB * mb;
+    
+    // And for a given MB we can loop over the channels it contains
+    for(raw::ChannelID_t channel = baseChannel; channel < baseChannel + fNumChanPerMB; channel++)
+    {
+        //clean up working vectors from previous iteration of loop
+        adcvec.resize(fNTimeSamples, 0);  //compression may have changed the size of this vector
+        noisetmp.resize(fNTimeSamples, 0.);     //just in case
+        
+        //use channel number to set some useful numbers
+        std::vector<geo::WireID> widVec = fGeometry.ChannelToWire(channel);
+        size_t                   plane  = widVec[0].Plane;
+        
+        //Get pedestal with random gaussian variation
+        float ped_mean = context.pedestals.PedMean(channel);
+        
+        if (fSmearPedestals )
+        {
+            CLHEP::RandGaussQ rGaussPed(pedestalEngine, 0.0, context.pedestals.PedRms(channel));
+            ped_mean += rGaussPed.fire();
+        }
+        
+        //Generate Noise
+        double noise_factor(0.);
+        double shapingTime  = fSignalShapingService->GetShapingTime(channel);
+        double gain         = fSignalShapingService->GetASICGain(channel) * sampling_rate(context.clockData) * 1.e-3; // Gain returned is electrons/us, this converts to electrons/tick
+        int    timeOffset   = fSignalShapingService->ResponseTOffset(channel);
+        
+        // Recover the response function information for this channel
+        const icarus_tool::IResponse& response = fSignalShapingService->GetResponse(channel);
+
+        if (fShapingTimeOrder.find( shapingTime ) != fShapingTimeOrder.end() )
+            noise_factor = context.noiseFactVec[plane].at( fShapingTimeOrder.find( shapingTime )->second );
+        //Throw exception...
+        else
+        {
+            throw cet::exception("SimWireICARUS")
+            << "\033[93m"
+            << "Shaping Time received from signalservices_icarus.fcl is not one of allowed values"
+            << std::endl
+            << "Allowed values: 0.6, 1.0, 1.3, 3.0 usec"
+            << "\033[00m"
+            << std::endl;
+        }
+        
+        // Use the desired noise tool to actually generate the noise on this wire
+        noiseToolVec[plane]->generateNoise(uncNoiseEngine,
+                                           corNoiseEngine,
+                                           noisetmp,
+                                           context.detProp,
+                                           noise_factor,
+                                           channel);
+        
+        // Recover the SimChannel (if one) for this channel
+        const sim::SimChannel* simChan = context.simChannels[channel];
+        
+        // If there is something on this wire, and it is not dead, then add the signal to the wire
+        // If there is no charge in the readout window, the convolution is skipped
+        if(simChan && !(fSimDeadChannels && (context.channelStatus.IsBad(channel) || !context.channelStatus.IsPresent(channel)))
+           && FillChargeVector(*simChan, context, gain, chargeWork))
+        {
+            // now we have the tempWork for the adjacent wire of interest
+            // convolve it with the appropriate response function
+            fft.convolute(chargeWork, response.getConvKernel(), timeOffset);
             
-            // Use the desired noise tool to actually generate the noise on this wire
-            fNoiseToolVec[plane]->generateNoise(fUncNoiseEngine,
-                                                fCorNoiseEngine,
-                                                noisetmp,
-                                                detProp,
-                                                noise_factor,
-                                                channel);
-            
-            // Recover the SimChannel (if one) for this channel
-            const sim::SimChannel* simChan = channels[channel];
+            // "Make" the ADC vector
+            MakeADCVec(adcvec, noisetmp, chargeWork, ped_mean);
+        }
+        // "Make" an ADC vector with zero charge added
+        else MakeADCVec(adcvec, noisetmp, zeroCharge, ped_mean);
+        
+        // add this digit to the collection;
+        // adcvec is copied, not moved: in case of compression, adcvec will show
+        // less data: e.g. if the uncompressed adcvec has 9600 items, after
+        // compression it will have maybe 5000, but the memory of the other 4600
+        // is still there, although unused; a copy of adcvec will instead have
+        // only 5000 items. All 9600 items of adcvec will be recovered for free
+        // and used on the next loop.
+        raw::RawDigit rd(channel, fNTimeSamples, adcvec, fCompression);
+        
+        if(fMakeHistograms && plane==2)
+        {
+            short area = std::accumulate(adcvec.begin(),adcvec.end(),0,[](const auto& val,const auto& sum){return sum + val - 400;});
             
-            // If there is something on this wire, and it is not dead, then add the signal to the wire
-            if(simChan && !(fSimDeadChannels && (ChannelStatusProvider.IsBad(channel) || !ChannelStatusProvider.IsPresent(channel))))
-            {
-                std::fill(chargeWork.begin(), chargeWork.end(), 0.);
-                
-                // loop over the tdcs and grab the number of electrons for each
-                for(size_t tick = 0; tick < fNTimeSamples; tick++)
-                {
-                    int tdc = clockData.TPCTick2TDC(tick);
-                    
-                    // continue if tdc < 0
-                    if( tdc < 0 ) continue;
-                    
-                    double charge = simChan->Charge(tdc);  // Charge returned in number of electrons
-                    
-                    chargeWork[tick] += charge/gain;  // # electrons / (# electrons/tick)
-                } // loop over tdcs
-                // now we have the tempWork for the adjacent wire of interest
-                // convolve it with the appropriate response function
-                fFFT->convolute(chargeWork, response.getConvKernel(), timeOffset);
-                
-                // "Make" the ADC vector
-                MakeADCVec(adcvec, noisetmp, chargeWork, ped_mean);
-            }
-            // "Make" an ADC vector with zero charge added
-            else MakeADCVec(adcvec, noisetmp, zeroCharge, ped_mean);
+            if(area>0) histEntries.emplace_back(widVec[0].Wire, area);
+        }
+        
+        rd.SetPedestal(ped_mean);
+        digits.push_back(std::move(rd)); // we do move the raw digit copy, though
+    }
+    
+    return;
+}
+//-------------------------------------------------
+bool SimWireICARUS::FillChargeVector(const sim::SimChannel& simChan, const EventContext& context,
+                                     double gain, icarusutil::TimeVec& chargeWork) const
+{
+    std::fill(chargeWork.begin(), chargeWork.end(), 0.);
+
+    bool hasCharge(false);
+
+    if (context.tdcContiguous)
+    {
+        // Single pass over the (sparse) TDC entries of the channel
+        for(const auto& tdcide : simChan.TDCIDEMap())
+        {
+            int tick = int(tdcide.first) - context.firstTDC;
+
+            if (tick < 0 || tick >= int(fNTimeSamples) || tdcide.second.empty()) continue;
+
+            double charge(0.);  // number of electrons, summed as in sim::SimChannel::Charge()
+
+            for(const auto& ide : tdcide.second) charge += ide.numElectrons;
+
+            chargeWork[tick] += charge/gain;  // # electrons / (# electrons/tick)
+            hasCharge         = true;
+        }
+    }
+    else
+    {
+        // loop over the tdcs and grab the number of electrons for each
+        for(size_t tick = 0; tick < fNTimeSamples; tick++)
+        {
+            int tdc = context.clockData.TPCTick2TDC(tick);
             
-            // add this digit to the collection;
-            // adcvec is copied, not moved: in case of compression, adcvec will show
-            // less data: e.g. if the uncompressed adcvec has 9600 items, after
-            // compression it will have maybe 5000, but the memory of the other 4600
-            // is still there, although unused; a copy of adcvec will instead have
-            // only 5000 items. All 9600 items of adcvec will be recovered for free
-            // and used on the next loop.
-            raw::RawDigit rd(channel, fNTimeSamples, adcvec, fCompression);
+            // continue if tdc < 0
+            if( tdc < 0 ) continue;
             
-            if(fMakeHistograms && plane==2)
-            {
-                short area = std::accumulate(adcvec.begin(),adcvec.end(),0,[](const auto& val,const auto& sum){return sum + val - 400;});
-                
-                if(area>0)
-                {
-                    fSimCharge->Fill(area);
-                    fSimChargeWire->Fill(widVec[0].Wire,area);
-                }
-            }
+            double charge = simChan.Charge(tdc);  // Charge returned in number of electrons
+
+            if (charge == 0.) continue;
             
-            rd.SetPedestal(ped_mean);
-            digcol->push_back(std::move(rd)); // we do move the raw digit copy, though
+            chargeWork[tick] += charge/gain;  // # electrons / (# electrons/tick)
+            hasCharge         = true;
+        } // loop over tdcs
+    }
+
+    return hasCharge;
+}
+//-------------------------------------------------
+long SimWireICARUS::MotherboardSeed(long eventSeed, raw::ChannelID_t mb, unsigned int stream)
+{
+    // HepJamesRandom accepts seeds in [0, 900000000)
+    return (eventSeed + 3L * long(mb) + long(stream)) % 900000000L;
+}
+//-------------------------------------------------
+void SimWireICARUS::CheckMotherboards(const std::vector<raw::ChannelID_t>&             mbVec,
+                                      const EventContext&                              context,
+                                      const std::array<long, 3>&                       eventSeeds,
+                                      const std::vector<std::vector<raw::RawDigit>>&   mbDigitVec)
+{
+    // The digits of a motherboard must depend only on the event seeds and on the motherboard number:
+    // simulating it on this thread alone, after all the others and in reverse order, must give the same result
+    ThreadTools& threadTools = LocalThreadTools();
+
+    for(size_t mbIdx = mbVec.size(); mbIdx-- > 0;)
+    {
+        raw::ChannelID_t const mb = mbVec[mbIdx];
+
+        CLHEP::HepJamesRandom pedestalEngine(MotherboardSeed(eventSeeds[0], mb, 0));
+        CLHEP::HepJamesRandom uncNoiseEngine(MotherboardSeed(eventSeeds[1], mb, 1));
+        CLHEP::HepJamesRandom corNoiseEngine(MotherboardSeed(eventSeeds[2], mb, 2));
 
+        std::vector<raw::RawDigit> digits;
+        HistEntryVec               histEntries;
+
+        SimulateMotherboard(mb, context, pedestalEngine, uncNoiseEngine, corNoiseEngine,
+                            threadTools.noiseToolVec, *threadTools.fft, digits, histEntries);
+
+        const std::vector<raw::RawDigit>& parallelDigits = mbDigitVec[mbIdx];
+
+        if (digits.size() != parallelDigits.size())
+            throw cet::exception("SimWireICARUS") << "Motherboard " << mb << ": " << parallelDigits.size()
+                                                  << " digits simulated in parallel, " << digits.size() << " serially\n";
+
+        for(size_t digitIdx = 0; digitIdx < digits.size(); digitIdx++)
+        {
+            const raw::RawDigit& serial   = digits[digitIdx];
+            const raw::RawDigit& parallel = parallelDigits[digitIdx];
+
+            if (serial.Channel()     != parallel.Channel()     || serial.ADCs()     != parallel.ADCs() ||
+                serial.GetPedestal() != parallel.GetPedestal() || serial.GetSigma() != parallel.GetSigma())
+                throw cet::exception("SimWireICARUS") << "Motherboard " << mb << ": channel " << parallel.Channel()
+                                                      << " simulated in parallel differs from the serial simulation\n";
         }
     }
-    
-    evt.put(std::move(digcol), fOutInstanceLabel);
-    
+
     return;
 }
 //-------------------------------------------------
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "IGenNoise.h"
+#include "NoiseBank.h"
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
@@ -24,6 +25,7 @@
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Random/RandGaussQ.h"
+#include "CLHEP/Random/JamesRandom.h"
 
 #include "TH1F.h"
 #include "TProfile.h"
@@ -48,6 +50,8 @@ public:
     
     void nextEvent() override;
 
+    bool enableConcurrentGeneration() override;
+
     void generateNoise(CLHEP::HepRandomEngine& noise_engine,
                        CLHEP::HepRandomEngine& cornoise_engine,
                        icarusutil::TimeVec& noise,
@@ -60,6 +64,7 @@ private:
     void GenerateCorrelatedNoise(CLHEP::HepRandomEngine&, icarusutil::TimeVec&, double, unsigned int);
     void GenNoise(std::function<void (double[])>&, const icarusutil::TimeVec&, icarusutil::TimeVec&, double);
     void ExtractCorrelatedAmplitude(float&, int) const;
+    void MakeNoiseBanks();
     void SelectContinuousSpectrum() ;
     void FindPeaks() ;
     void makeHistograms();
@@ -76,6 +81,9 @@ private:
     std::string                                 fHistogramName;
     std::string                                 fCorrAmpHistFileName;
     std::string                                 fCorrAmpHistogramName;
+    size_t                                      fNoiseBankSize;
+    std::string                                 fNoiseBankFileName;
+    long                                        fNoiseBankSeed;
 
     using WaveformTools = icarus_signal_processing::WaveformTools<icarusutil::SigProcPrecision>;
 
@@ -94,9 +102,16 @@ private:
     // Container for doing the work
     icarusutil::FrequencyVec                    fNoiseFrequencyVec;
     
+    // Pre-generated unit scale waveforms, empty unless NoiseBankSize is set
+    std::shared_ptr<const NoiseBank>            fIncoherentNoiseBank;
+    std::shared_ptr<const NoiseBank>            fCoherentNoiseBank;
+    
     // Keep track of seed initialization for uncorrelated noise
     bool                                        fNeedFirstSeed=true;
     
+    // Avoid the global CLHEP engine for the motherboard amplitudes
+    bool                                        fUseLocalAmpEngine=false;
+    
     // Histograms
     TProfile*                                   fInputNoiseHist;
     TProfile*                                   fMedianNoiseHist;
@@ -117,6 +132,9 @@ CorrelatedNoise::CorrelatedNoise(const fhicl::ParameterSet& pset)
     // Now break out the coherent from the incoherent using the input overall spectrum
     SelectContinuousSpectrum();
     
+    // Optionally pre-generate the noise waveforms from the spectra
+    MakeNoiseBanks();
+    
     // Output some histograms to catalogue what's been done
     makeHistograms();
 }
@@ -139,6 +157,9 @@ void CorrelatedNoise::configure(const fhicl::ParameterSet& pset)
     fHistogramName          = pset.get< std::string >("HistogramName");
     fCorrAmpHistFileName    = pset.get< std::string >("CorrAmpHistFileName");
     fCorrAmpHistogramName   = pset.get< std::string >("CorrAmpHistogramName");
+    fNoiseBankSize          = pset.get< size_t      >("NoiseBankSize",     0);
+    fNoiseBankFileName      = pset.get< std::string >("NoiseBankFileName", "");
+    fNoiseBankSeed          = pset.get< long        >("NoiseBankSeed",     fUncorrelatedSeed);
     
     // Initialize the work vector
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
@@ -226,6 +247,15 @@ void CorrelatedNoise::nextEvent()
     return;
 }
 
+bool CorrelatedNoise::enableConcurrentGeneration()
+{
+    // The caller takes care of seeding the uncorrelated noise engine
+    fNeedFirstSeed     = false;
+    fUseLocalAmpEngine = true;
+    
+    return true;
+}
+
 void CorrelatedNoise::generateNoise(CLHEP::HepRandomEngine& engine_unc,
                                     CLHEP::HepRandomEngine& engine_corr,
                                     icarusutil::TimeVec&    noise,
@@ -272,7 +302,10 @@ void CorrelatedNoise::GenerateUncorrelatedNoise(CLHEP::HepRandomEngine& engine,
 
     double scaleFactor = fIncoherentNoiseFrac * noise_factor / fIncoherentNoiseRMS;
     
-    GenNoise(randGenFunc, fIncoherentNoiseVec, noise, scaleFactor);
+    if (fIncoherentNoiseBank && fIncoherentNoiseBank->nTicks() == noise.size())
+        fIncoherentNoiseBank->draw(engine, noise, scaleFactor);
+    else
+        GenNoise(randGenFunc, fIncoherentNoiseVec, noise, scaleFactor);
 
     return;
 }
@@ -299,7 +332,11 @@ void CorrelatedNoise::GenerateCorrelatedNoise(CLHEP::HepRandomEngine& engine, ic
         float fraction    = std::sqrt(1. - fIncoherentNoiseFrac * fIncoherentNoiseFrac);
         float scaleFactor = fraction * cf * noise_factor / fCoherentNoiseRMS;
         
-        GenNoise(randGenFunc, fCoherentNoiseVec, noise, scaleFactor);
+        // The bank draw only depends on the engine state, so all the channels of the board still share it
+        if (fCoherentNoiseBank && fCoherentNoiseBank->nTicks() == noise.size())
+            fCoherentNoiseBank->draw(engine, noise, scaleFactor);
+        else
+            GenNoise(randGenFunc, fCoherentNoiseVec, noise, scaleFactor);
     }
     
     return;
@@ -427,16 +464,63 @@ void CorrelatedNoise::SelectContinuousSpectrum()
     
 void CorrelatedNoise::ExtractCorrelatedAmplitude(float& corrFactor, int board) const
 {
-    CLHEP::RandGeneral amp_corr(fCorrAmpDistVec.data(),fCorrAmpDistVec.size(),0);
-    amp_corr.setTheSeed(board+1);
     double rnd_corr[1] = {0.};
     
-    amp_corr.fireArray(1,rnd_corr);
+    if (fUseLocalAmpEngine)
+    {
+        // Same seeding per board, but without touching the global engine
+        CLHEP::HepJamesRandom ampEngine(board+1);
+        CLHEP::RandGeneral    amp_corr(ampEngine,fCorrAmpDistVec.data(),fCorrAmpDistVec.size(),0);
+        
+        amp_corr.fireArray(1,rnd_corr);
+    }
+    else
+    {
+        CLHEP::RandGeneral amp_corr(fCorrAmpDistVec.data(),fCorrAmpDistVec.size(),0);
+        amp_corr.setTheSeed(board+1);
+        
+        amp_corr.fireArray(1,rnd_corr);
+    }
     
     float cfmedio=0.2287;
     corrFactor=rnd_corr[0]/cfmedio;
 }
     
+void CorrelatedNoise::MakeNoiseBanks()
+{
+    if (fNoiseBankSize == 0) return;
+    
+    size_t      nTicks   = fNoiseFrequencyVec.size();
+    std::string baseName = fNoiseBankFileName.empty() ? "" : fNoiseBankFileName + "_Plane" + std::to_string(fPlane);
+    
+    // Each bank has its own engine, not shared with the event engines nor with the other bank,
+    // so that its content depends only on its spectrum, the noise randomization and the seed
+    auto makeBank = [&](const std::string& fileName, const icarusutil::TimeVec& freqDist, long seed)
+    {
+        CLHEP::HepJamesRandom bankEngine(seed);
+        CLHEP::RandFlat       noiseGen(bankEngine,0,1);
+        
+        std::function<void (double[])> randGenFunc = [&noiseGen](double randArray[]){noiseGen.fireArray(2,randArray);};
+        
+        uint64_t bankKey = NoiseBank::KeyHasher().add(std::string("CorrelatedNoise")).add(freqDist).add(fNoiseRand).add(seed).value();
+        
+        return NoiseBank::shared(fileName, bankKey, fNoiseBankSize, nTicks,
+                                 [&](icarusutil::TimeVec& wave){GenNoise(randGenFunc, freqDist, wave, 1.);});
+    };
+    
+    if (fIncoherentNoiseFrac > 0.)
+        fIncoherentNoiseBank = makeBank(baseName.empty() ? "" : baseName + "_incoherent", fIncoherentNoiseVec, fNoiseBankSeed);
+    
+    if (fIncoherentNoiseFrac < 1.)
+        fCoherentNoiseBank = makeBank(baseName.empty() ? "" : baseName + "_coherent", fCoherentNoiseVec, fNoiseBankSeed + 1);
+    
+    mf::LogInfo("CorrelatedNoise") << "Plane " << fPlane << " noise bank: " << (fIncoherentNoiseBank ? fIncoherentNoiseBank->size() : 0)
+                                   << " incoherent and " << (fCoherentNoiseBank ? fCoherentNoiseBank->size() : 0)
+                                   << " coherent waveforms of " << nTicks << " ticks";
+    
+    return;
+}
+    
 void CorrelatedNoise::makeHistograms()
 {
     
@@ -38,6 +38,13 @@ namespace icarus_tool
                                    icarusutil::TimeVec&,
                                    detinfo::DetectorPropertiesData const& detProp,
                                    double, unsigned int = 0) = 0;
+        
+        /// Asks the tool to draw random numbers only from the engines passed to
+        /// `generateNoise()`, without reseeding the uncorrelated noise engine
+        /// and without any random state shared among tool instances, so that
+        /// several copies of the tool can run concurrently with engines seeded
+        /// by the caller. Returns whether the tool supports this mode.
+        virtual bool enableConcurrentGeneration() { return false; }
     };
 }
 
@@ -23,6 +23,8 @@ public:
     
     void nextEvent() override  {return;};
 
+    bool enableConcurrentGeneration() override {return true;};
+
     void generateNoise(CLHEP::HepRandomEngine&,
                        CLHEP::HepRandomEngine&,
                        icarusutil::TimeVec&,
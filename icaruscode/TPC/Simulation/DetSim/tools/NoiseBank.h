@@ -0,0 +1,354 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   NoiseBank.h
+///
+/// \brief  Pool of pre-generated noise waveforms for the noise tools
+///
+///         Instead of synthesizing every channel with an inverse FFT,
+///         a tool can fill a bank once at construction and then, per
+///         channel, copy a random entry with a random circular shift
+///         and sign. Noise from an inverse FFT is periodic over the
+///         waveform length, so neither operation alters its spectrum.
+///
+///         The bank can be written to a flat binary file and mapped
+///         back in by later jobs, so that the pool is generated once
+///         and its pages are shared among processes on the same node.
+///         The file name and header carry a key, a hash of everything
+///         the waveforms depend on (spectrum, parameters, seed, sizes),
+///         so that a change of configuration never reuses a stale bank.
+///         Files are written under a temporary name and then renamed,
+///         so that concurrent jobs never read a partial bank.
+///
+///         Within a job, `shared()` hands out a single copy of each bank
+///         to all the tool instances asking for it (e.g. the per-thread
+///         noise tools of SimWireICARUS), so that it is generated, and
+///         held in memory, only once.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef NoiseBank_H
+#define NoiseBank_H
+
+#include "icaruscode/TPC/Utilities/tools/SignalProcessingDefs.h"
+
+#include "cetlib_except/exception.h"
+
+// CLHEP libraries
+#include "CLHEP/Random/RandomEngine.h"
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace icarus_tool
+{
+
+class NoiseBank
+{
+public:
+    using Sample_t = float; ///< Storage precision of the bank samples
+
+    /// Builds the key of a bank (FNV-1a hash) from all that its waveforms depend on
+    class KeyHasher
+    {
+    public:
+        template <typename T>
+        KeyHasher& add(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be hashed");
+            return addBytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        KeyHasher& add(const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be hashed");
+            add(values.size());
+            return addBytes(values.data(), values.size() * sizeof(T));
+        }
+
+        KeyHasher& add(const std::string& value)
+        {
+            add(value.size());
+            return addBytes(value.data(), value.size());
+        }
+
+        uint64_t value() const {return fHash;}
+
+    private:
+        KeyHasher& addBytes(const void* data, size_t size)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+            for(size_t idx = 0; idx < size; idx++) fHash = (fHash ^ bytes[idx]) * 0x100000001b3ULL;
+
+            return *this;
+        }
+
+        uint64_t fHash = 0xcbf29ce484222325ULL;
+    };
+
+    NoiseBank() = default;
+
+    /**
+     * @brief Fills the bank with `nWaveforms` waveforms of `nTicks` samples.
+     * @param generator callable filling an `icarusutil::TimeVec&` of `nTicks`
+     *
+     * The waveforms are expected to be generated with unit scale; the scale
+     * of each channel is applied on `draw()`.
+     */
+    template <typename Generator>
+    void fill(size_t nWaveforms, size_t nTicks, Generator&& generator)
+    {
+        fMapping.reset();
+        fStorage.assign(nWaveforms * nTicks, 0.);
+
+        icarusutil::TimeVec waveform(nTicks, 0.);
+
+        for(size_t idx = 0; idx < nWaveforms; idx++)
+        {
+            generator(waveform);
+            std::copy(waveform.begin(), waveform.end(), fStorage.begin() + idx * nTicks);
+        }
+
+        fData       = fStorage.data();
+        fNWaveforms = nWaveforms;
+        fNTicks     = nTicks;
+        fKey        = 0;
+    }
+
+    /// Full key of a bank of `nWaveforms` waveforms of `nTicks` from generator with `configKey`
+    static uint64_t bankKey(uint64_t configKey, size_t nWaveforms, size_t nTicks)
+    {
+        return KeyHasher().add(configKey).add(uint64_t(nWaveforms)).add(uint64_t(nTicks)).value();
+    }
+
+    /// Name of the file of the bank with the specified key: `<baseName>_<hex key>.bank`
+    static std::string bankFileName(const std::string& baseName, uint64_t configKey, size_t nWaveforms, size_t nTicks)
+    {
+        char keyStr[17];
+
+        std::snprintf(keyStr, sizeof(keyStr), "%016llx", static_cast<unsigned long long>(bankKey(configKey, nWaveforms, nTicks)));
+
+        return baseName + "_" + keyStr + ".bank";
+    }
+
+    /**
+     * @brief Maps the bank from its file if it exists, otherwise fills it.
+     * @param baseName start of the file name; empty to just fill the bank
+     * @param configKey hash of the configuration of the generator (see `KeyHasher`)
+     *
+     * A freshly filled bank is written for later jobs to the file named
+     * after `baseName` and the key (see `bankFileName()`).
+     */
+    template <typename Generator>
+    void fillOrLoad(const std::string& baseName, uint64_t configKey, size_t nWaveforms, size_t nTicks, Generator&& generator)
+    {
+        std::string fileName = baseName.empty() ? "" : bankFileName(baseName, configKey, nWaveforms, nTicks);
+        uint64_t    key      = bankKey(configKey, nWaveforms, nTicks);
+
+        if (!fileName.empty() && ::access(fileName.c_str(), R_OK) == 0)
+        {
+            load(fileName);
+
+            if (fKey != key || fNWaveforms != nWaveforms || fNTicks != nTicks)
+                throw cet::exception("NoiseBank") << "Noise bank file " << fileName << " has " << fNWaveforms << " waveforms of "
+                                                  << fNTicks << " ticks (key " << std::hex << fKey << "), " << std::dec << nWaveforms
+                                                  << " of " << nTicks << " expected (key " << std::hex << key << ")" << std::endl;
+            return;
+        }
+
+        fill(nWaveforms, nTicks, std::forward<Generator>(generator));
+
+        fKey = key;
+
+        if (!fileName.empty()) save(fileName);
+    }
+
+    /**
+     * @brief Returns the bank with the specified key, shared within the job.
+     * @see `fillOrLoad()`
+     *
+     * The first request of a bank fills (or loads) it, and later requests of
+     * the same bank, from any thread, get that same copy for as long as it is
+     * held by someone. Requests are served one at a time, so a bank is never
+     * generated twice concurrently.
+     */
+    template <typename Generator>
+    static std::shared_ptr<const NoiseBank> shared(const std::string& baseName, uint64_t configKey, size_t nWaveforms, size_t nTicks, Generator&& generator)
+    {
+        static std::mutex                                         registryMutex;
+        static std::map<uint64_t, std::weak_ptr<const NoiseBank>> registry;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+
+        std::weak_ptr<const NoiseBank>& entry = registry[bankKey(configKey, nWaveforms, nTicks)];
+
+        std::shared_ptr<const NoiseBank> bank = entry.lock();
+
+        if (!bank)
+        {
+            auto newBank = std::make_shared<NoiseBank>();
+
+            newBank->fillOrLoad(baseName, configKey, nWaveforms, nTicks, std::forward<Generator>(generator));
+
+            entry = bank = std::move(newBank);
+        }
+
+        return bank;
+    }
+
+    /// Number of waveforms in the bank
+    size_t size()   const {return fNWaveforms;}
+
+    /// Number of samples of each waveform
+    size_t nTicks() const {return fNTicks;}
+
+    bool   empty()  const {return fNWaveforms == 0;}
+
+    /// Key of the bank (0 if filled directly)
+    uint64_t key()  const {return fKey;}
+
+    /// Pointer to the first sample of waveform `idx`
+    const Sample_t* waveform(size_t idx) const {return fData + idx * fNTicks;}
+
+    /**
+     * @brief Copies a random bank entry into `noise`, scaled by `scale`.
+     *
+     * The entry, its circular shift and its sign are all taken from `engine`,
+     * so reseeding the engine reproduces the same waveform (as done for the
+     * coherent noise of a board). `noise` must have `nTicks()` samples.
+     */
+    void draw(CLHEP::HepRandomEngine& engine, icarusutil::TimeVec& noise, double scale) const
+    {
+        size_t idx   = std::min(size_t(engine.flat() * fNWaveforms), fNWaveforms - 1);
+        size_t shift = std::min(size_t(engine.flat() * fNTicks),     fNTicks - 1);
+
+        if (engine.flat() < 0.5) scale = -scale;
+
+        const Sample_t* wave = waveform(idx);
+
+        // noise[tick] = wave[(tick + shift) % nTicks], in two straight runs
+        size_t tail = fNTicks - shift;
+
+        for(size_t tick = 0; tick < tail;    tick++) noise[tick]        = scale * wave[shift + tick];
+        for(size_t tick = 0; tick < shift;   tick++) noise[tail + tick] = scale * wave[tick];
+    }
+
+    /// Writes the bank to `fileName` (header followed by the raw samples), via a temporary file
+    void save(const std::string& fileName) const
+    {
+        std::string tempName = fileName + ".tmp" + std::to_string(::getpid());
+
+        {
+            std::unique_ptr<std::FILE, int(*)(std::FILE*)> file(std::fopen(tempName.c_str(), "wb"), &std::fclose);
+
+            if (!file)
+                throw cet::exception("NoiseBank") << "Unable to open output file: " << tempName << std::endl;
+
+            Header header {kMagic, fKey, fNWaveforms, fNTicks};
+
+            bool written = std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+                           std::fwrite(fData, sizeof(Sample_t), fNWaveforms * fNTicks, file.get()) == fNWaveforms * fNTicks &&
+                           std::fflush(file.get()) == 0;
+
+            if (!written)
+            {
+                file.reset();
+                std::remove(tempName.c_str());
+                throw cet::exception("NoiseBank") << "Failed writing noise bank to: " << tempName << std::endl;
+            }
+        }
+
+        if (std::rename(tempName.c_str(), fileName.c_str()) != 0)
+        {
+            std::remove(tempName.c_str());
+            throw cet::exception("NoiseBank") << "Unable to rename noise bank " << tempName << " to " << fileName << std::endl;
+        }
+    }
+
+    /// Maps a bank written by `save()`; its samples are not copied
+    void load(const std::string& fileName)
+    {
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            throw cet::exception("NoiseBank") << "Unable to open input file: " << fileName << std::endl;
+
+        struct stat fileStat;
+
+        if (::fstat(fd, &fileStat) != 0 || size_t(fileStat.st_size) < sizeof(Header))
+        {
+            ::close(fd);
+            throw cet::exception("NoiseBank") << "Invalid noise bank file: " << fileName << std::endl;
+        }
+
+        size_t length = fileStat.st_size;
+        void*  base   = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+
+        ::close(fd);
+
+        if (base == MAP_FAILED)
+            throw cet::exception("NoiseBank") << "Unable to map noise bank file: " << fileName << std::endl;
+
+        Mapping mapping(base, MappingDeleter{length});
+
+        const Header* header = static_cast<const Header*>(base);
+
+        if (header->magic != kMagic || length != sizeof(Header) + header->nWaveforms * header->nTicks * sizeof(Sample_t))
+            throw cet::exception("NoiseBank") << "Corrupted noise bank file: " << fileName << std::endl;
+
+        fStorage.clear();
+        fStorage.shrink_to_fit();
+
+        fMapping    = std::move(mapping);
+        fData       = reinterpret_cast<const Sample_t*>(static_cast<const char*>(base) + sizeof(Header));
+        fNWaveforms = header->nWaveforms;
+        fNTicks     = header->nTicks;
+        fKey        = header->key;
+    }
+
+private:
+    struct Header
+    {
+        uint64_t magic;
+        uint64_t key;
+        uint64_t nWaveforms;
+        uint64_t nTicks;
+    };
+
+    struct MappingDeleter
+    {
+        size_t length;
+        void operator()(void* base) const {::munmap(base, length);}
+    };
+
+    using Mapping = std::unique_ptr<void, MappingDeleter>;
+
+    static constexpr uint64_t kMagic = 0x4b4e4253494f4e32; ///< Changes with the file layout
+
+    std::vector<Sample_t> fStorage;                           ///< Samples when generated in this job
+    Mapping               fMapping{nullptr, MappingDeleter{0}}; ///< Samples when mapped from file
+    const Sample_t*       fData       = nullptr;
+    size_t                fNWaveforms = 0;
+    size_t                fNTicks     = 0;
+    uint64_t              fKey        = 0;
+};
+
+}
+
+#endif
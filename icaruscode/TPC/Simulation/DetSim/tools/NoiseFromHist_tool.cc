@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "IGenNoise.h"
+#include "NoiseBank.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Persistency/Provenance/ModuleContext.h"
 #include "art/Framework/Principal/Event.h"
@@ -24,6 +25,7 @@
 // CLHEP libraries
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandGaussQ.h"
+#include "CLHEP/Random/JamesRandom.h"
 
 #include "TH1D.h"
 #include "TFile.h"
@@ -44,6 +46,8 @@ public:
     
     void nextEvent() override  {return;};
 
+    bool enableConcurrentGeneration() override {return true;};
+
     void generateNoise(CLHEP::HepRandomEngine&,
                        CLHEP::HepRandomEngine&,
                        icarusutil::TimeVec&,
@@ -51,16 +55,24 @@ public:
                        double, unsigned int) override;
     
 private:
+    void GenNoise(CLHEP::RandFlat&, icarusutil::TimeVec&, double);
+    
     // Member variables from the fhicl file
     double              fNoiseRand;
     std::string         fInputNoiseHistFileName;
     std::string         fHistogramName;
+    size_t              fNoiseBankSize;
+    std::string         fNoiseBankFileName;
+    long                fNoiseBankSeed;
     
     double              fHistNormFactor;
 
     // We'll recover the bin contents and store in a vector
     // with the likely false hope this will be faster...
     std::vector<double> fNoiseHistVec;
+    
+    // Pre-generated waveforms for unit noise factor, empty unless NoiseBankSize is set
+    std::shared_ptr<const NoiseBank> fNoiseBank;
 
     std::unique_ptr<icarus_signal_processing::ICARUSFFT<double>> fFFT;
 };
@@ -83,6 +95,9 @@ void NoiseFromHist::configure(const fhicl::ParameterSet& pset)
     fInputNoiseHistFileName = pset.get<std::string>("NoiseHistFileName");
     fHistogramName          = pset.get<std::string>("HistogramName");
     fHistNormFactor         = pset.get<double>("HistNormFactor");
+    fNoiseBankSize          = pset.get<size_t>("NoiseBankSize", 0);
+    fNoiseBankFileName      = pset.get<std::string>("NoiseBankFileName", "");
+    fNoiseBankSeed          = pset.get<long>("NoiseBankSeed", 5000);
     
     std::string fullFileName;
     cet::search_path searchPath("FW_SEARCH_PATH");
@@ -111,6 +126,22 @@ void NoiseFromHist::configure(const fhicl::ParameterSet& pset)
     int numberTimeSamples = clockData.NumberTimeSamples();
 
     fFFT = std::make_unique<icarus_signal_processing::ICARUSFFT<double>>(numberTimeSamples);
+    
+    // Optionally pre-generate the waveforms, using a dedicated engine
+    if (fNoiseBankSize > 0)
+    {
+        CLHEP::HepJamesRandom bankEngine(fNoiseBankSeed);
+        CLHEP::RandFlat       flat(bankEngine,-1,1);
+        
+        // the waveforms depend on the spectrum, its parameters and the seed
+        uint64_t bankKey = NoiseBank::KeyHasher().add(std::string("NoiseFromHist")).add(fNoiseHistVec).add(fNoiseRand).add(fHistNormFactor).add(fNoiseBankSeed).value();
+        
+        fNoiseBank = NoiseBank::shared(fNoiseBankFileName.empty() ? "" : fNoiseBankFileName + "_" + fHistogramName,
+                                       bankKey, fNoiseBankSize, numberTimeSamples,
+                                       [&](icarusutil::TimeVec& wave){GenNoise(flat, wave, fHistNormFactor);});
+        
+        mf::LogInfo("NoiseFromHist") << "Noise bank: " << fNoiseBank->size() << " waveforms of " << fNoiseBank->nTicks() << " ticks";
+    }
    
     return;
 }
@@ -134,13 +165,24 @@ void NoiseFromHist::generateNoise(CLHEP::HepRandomEngine& engine,
         << "\033[00m"
         << std::endl;
     
+    if (fNoiseBank && fNoiseBank->nTicks() == nFFTTicks)
+        fNoiseBank->draw(engine, noise, noise_factor);
+    else
+        GenNoise(flat, noise, fHistNormFactor * noise_factor);
+
+    return;
+}
+
+void NoiseFromHist::GenNoise(CLHEP::RandFlat& flat, icarusutil::TimeVec& noise, double scaleFactor)
+{
+    size_t nFFTTicks = noise.size();
+    
     // noise in frequency space
     std::vector<std::complex<double>> noiseFrequency(nFFTTicks/2+1, 0.);
     
     double pval        = 0.;
     double phase       = 0.;
     double rnd[2]      = {0.};
-    double scaleFactor = fHistNormFactor * noise_factor;
     
     // width of frequencyBin in kHz
     
@@ -32,6 +32,8 @@ public:
     
     void nextEvent() override  {return;};
 
+    bool enableConcurrentGeneration() override {return true;};
+
     void generateNoise(CLHEP::HepRandomEngine& engine,
                        CLHEP::HepRandomEngine&,
                        icarusutil::TimeVec&,
@@ -5,6 +5,7 @@
 
 #include <cmath>
 #include "IGenNoise.h"
+#include "NoiseBank.h"
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Utilities/ToolMacros.h"
 #include "art/Utilities/make_tool.h"
@@ -23,6 +24,7 @@
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Random/RandGaussQ.h"
+#include "CLHEP/Random/JamesRandom.h"
 
 #include "TH1F.h"
 #include "TProfile.h"
@@ -48,6 +50,8 @@ public:
     
     void nextEvent() override;
 
+    bool enableConcurrentGeneration() override {fNeedFirstSeed = false; return true;};
+
     void generateNoise(CLHEP::HepRandomEngine& noise_engine,
                        CLHEP::HepRandomEngine& cornoise_engine,
                        icarusutil::TimeVec& noise,
@@ -60,6 +64,7 @@ private:
     void GenerateUncorrelatedNoise(CLHEP::HepRandomEngine&, icarusutil::TimeVec&, double, unsigned int);
     void GenNoise(std::function<void (double[])>&, const icarusutil::TimeVec&, icarusutil::TimeVec&, float);
     void ComputeRMSs();
+    void MakeNoiseBanks();
     void makeHistograms();
     
     // Member variables from the fhicl file
@@ -77,6 +82,9 @@ private:
     std::string                                 fCorrelatedRMSHistoName;
     std::string                                 fUncorrelatedRMSHistoName;
     std::string                                 fTotalRMSHistoName;
+    size_t                                      fNoiseBankSize;
+    std::string                                 fNoiseBankFileName;
+    long                                        fNoiseBankSeed;
 
     using WaveformTools = icarus_signal_processing::WaveformTools<icarusutil::SigProcPrecision>;
 
@@ -95,6 +103,10 @@ private:
     // Container for doing the work
     icarusutil::FrequencyVec                    fNoiseFrequencyVec;
     
+    // Pre-generated unit scale waveforms, null unless NoiseBankSize is set (shared among the tool instances)
+    std::shared_ptr<const NoiseBank>            fIncoherentNoiseBank;
+    std::shared_ptr<const NoiseBank>            fCoherentNoiseBank;
+    
     // Keep track of seed initialization for uncorrelated noise
     bool                                        fNeedFirstSeed=true;
     
@@ -123,6 +135,9 @@ SBNNoise::SBNNoise(const fhicl::ParameterSet& pset)
     configure(pset);
 ComputeRMSs();
     
+    // Optionally pre-generate the noise waveforms from the spectra
+    MakeNoiseBanks();
+    
     // Output some histograms to catalogue what's been done
     makeHistograms();
 }
@@ -147,6 +162,9 @@ void SBNNoise::configure(const fhicl::ParameterSet& pset)
     fCorrelatedRMSHistoName    = pset.get< std::string >("CorrelatedRMSHistoName");
     fUncorrelatedRMSHistoName  = pset.get< std::string >("UncorrelatedRMSHistoName");
     fTotalRMSHistoName         = pset.get< std::string >("TotalRMSHistoName");
+    fNoiseBankSize             = pset.get< size_t      >("NoiseBankSize",     0);
+    fNoiseBankFileName         = pset.get< std::string >("NoiseBankFileName", "");
+    fNoiseBankSeed             = pset.get< long        >("NoiseBankSeed",     fUncorrelatedSeed);
     // Initialize the work vector
     auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob();
     auto const detProp = art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob(clockData);
@@ -283,7 +301,10 @@ void SBNNoise::GenerateUncorrelatedNoise(CLHEP::HepRandomEngine& engine, icarusu
 
     float  scaleFactor = fIncoherentNoiseFrac * noise_factor / fIncoherentNoiseRMS;
     
-    GenNoise(randGenFunc, fIncoherentNoiseVec, noise, scaleFactor);
+    if (fIncoherentNoiseBank && fIncoherentNoiseBank->nTicks() == noise.size())
+        fIncoherentNoiseBank->draw(engine, noise, scaleFactor);
+    else
+        GenNoise(randGenFunc, fIncoherentNoiseVec, noise, scaleFactor);
 
     return;
 }
@@ -301,7 +322,11 @@ void SBNNoise::GenerateCorrelatedNoise(CLHEP::HepRandomEngine& engine, icarusuti
         float fraction    = std::sqrt(1. - fIncoherentNoiseFrac * fIncoherentNoiseFrac);
         float scaleFactor = fraction * noise_factor / fCoherentNoiseRMS;
         
-        GenNoise(randGenFunc, fCoherentNoiseVec, noise, scaleFactor);
+        // The bank draw only depends on the engine state, so all the channels of the board still share it
+        if (fCoherentNoiseBank && fCoherentNoiseBank->nTicks() == noise.size())
+            fCoherentNoiseBank->draw(engine, noise, scaleFactor);
+        else
+            GenNoise(randGenFunc, fCoherentNoiseVec, noise, scaleFactor);
     
     
     return;
@@ -331,6 +356,42 @@ void SBNNoise::GenNoise(std::function<void (double[])>& gen,const icarusutil::Ti
     return;
 }
 
+void SBNNoise::MakeNoiseBanks()
+{
+    if (fNoiseBankSize == 0) return;
+    
+    size_t      nTicks   = fNoiseFrequencyVec.size();
+    std::string baseName = fNoiseBankFileName.empty() ? "" : fNoiseBankFileName + "_Plane" + std::to_string(fPlane);
+    
+    // Each bank has its own engine, not shared with the event engines nor with the other bank,
+    // so that its content depends only on its spectrum, the noise randomization and the seed
+    auto makeBank = [&](const std::string& fileName, const icarusutil::TimeVec& freqDist, long seed)
+    {
+        CLHEP::HepJamesRandom bankEngine(seed);
+        CLHEP::RandFlat       noiseGen(bankEngine,0,1);
+        
+        std::function<void (double[])> randGenFunc = [&noiseGen](double randArray[]){noiseGen.fireArray(2,randArray);};
+        
+        uint64_t bankKey = NoiseBank::KeyHasher().add(std::string("SBNNoise")).add(freqDist).add(fNoiseRand).add(seed).value();
+        
+        return NoiseBank::shared(fileName, bankKey, fNoiseBankSize, nTicks,
+                                 [&](icarusutil::TimeVec& wave){GenNoise(randGenFunc, freqDist, wave, 1.);});
+    };
+    
+    // Note that ComputeRMSs may have reset the incoherent fraction from the RMS histograms
+    if (fIncoherentNoiseFrac > 0.)
+        fIncoherentNoiseBank = makeBank(baseName.empty() ? "" : baseName + "_incoherent", fIncoherentNoiseVec, fNoiseBankSeed);
+    
+    if (fIncoherentNoiseFrac < 1.)
+        fCoherentNoiseBank = makeBank(baseName.empty() ? "" : baseName + "_coherent", fCoherentNoiseVec, fNoiseBankSeed + 1);
+    
+    mf::LogInfo("SBNNoise") << "Plane " << fPlane << " noise bank: " << (fIncoherentNoiseBank ? fIncoherentNoiseBank->size() : 0)
+                            << " incoherent and " << (fCoherentNoiseBank ? fCoherentNoiseBank->size() : 0)
+                            << " coherent waveforms of " << nTicks << " ticks";
+    
+    return;
+}
+
 void SBNNoise::makeHistograms()
 {
     
@@ -77,6 +77,11 @@ bool spacecharge::SpaceChargeICARUS::Configure(fhicl::ParameterSet const& pset)
 		       hTrueBkwdX, hTrueBkwdY, hTrueBkwdZ,
 		       hTrueEFieldX, hTrueEFieldY, hTrueEFieldZ};
 
+      //flat copies used for the lookups, one interpolation per vector
+      fFwdGrid = SpaceChargeVoxelGrid(*hTrueFwdX, *hTrueFwdY, *hTrueFwdZ);
+      fBkwdGrid = SpaceChargeVoxelGrid(*hTrueBkwdX, *hTrueBkwdY, *hTrueBkwdZ);
+      fEfieldGrid = SpaceChargeVoxelGrid(*hTrueEFieldX, *hTrueEFieldY, *hTrueEFieldZ);
+      fVoxelized = true;
 
       std::cout << "...finished loading TH3s" << std::endl;
     }
@@ -125,83 +130,68 @@ bool spacecharge::SpaceChargeICARUS::EnableCalEfieldSCE() const
 // Primary working method of service that provides position offsets
 geo::Vector_t spacecharge::SpaceChargeICARUS::GetPosOffsets(geo::Point_t const& point) const
 {
-  std::vector<double> thePosOffsets;
+  if(!fVoxelized) return {0., 0., 0.};
+
   double xx=point.X(), yy=point.Y(), zz=point.Z();
   double cryo_corr=1., tpc_corr=1.;
 
-  if(fRepresentationType == "Voxelized_TH3"){
-    //handle OOAV by projecting edge cases
-    //also only have map for positive cryostat (assume symmetry)
-    //need to invert coordinates for cryo0 (cryo_corr)
-
-    //in larsim, this is how the offsets are used in DriftElectronstoPlane_module
-    // DriftDistance += -1.0 * thePosOffsets[0]
-    // thus need to apply correction to TPCs "left" of cryostat (tpc_corr)
-    // cathode spans x=220.14 and x=220.29 in pos cryostat
-    if(xx>0){
-      cryo_corr=1.0;
-      if(xx<220.14){
-	tpc_corr=-1.0;
-      }
-    }else{
-      cryo_corr=-1.0;
-      if(xx<-220.29){
-	tpc_corr=-1.0;
-      }
+  //handle OOAV by projecting edge cases
+  //also only have map for positive cryostat (assume symmetry)
+  //need to invert coordinates for cryo0 (cryo_corr)
+
+  //in larsim, this is how the offsets are used in DriftElectronstoPlane_module
+  // DriftDistance += -1.0 * thePosOffsets[0]
+  // thus need to apply correction to TPCs "left" of cryostat (tpc_corr)
+  // cathode spans x=220.14 and x=220.29 in pos cryostat
+  if(xx>0){
+    cryo_corr=1.0;
+    if(xx<220.14){
+      tpc_corr=-1.0;
     }
-    fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
-    double offset_x=0., offset_y=0., offset_z=0.;
-    offset_x = tpc_corr*cryo_corr*SCEhistograms.at(0)->Interpolate(xx,yy,zz);
-    offset_y = SCEhistograms.at(1)->Interpolate(xx,yy,zz);
-    offset_z = SCEhistograms.at(2)->Interpolate(xx,yy,zz);
-    thePosOffsets = {offset_x, offset_y, offset_z};
   }else{
-    thePosOffsets.resize(3, 0.0);
+    cryo_corr=-1.0;
+    if(xx<-220.29){
+      tpc_corr=-1.0;
+    }
   }
+  fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
+  auto const offset = fFwdGrid.Interpolate(xx, yy, zz);
 
-  return { thePosOffsets[0], thePosOffsets[1], thePosOffsets[2] };
+  return { tpc_corr*cryo_corr*offset[0], offset[1], offset[2] };
 }
 
 // Returns the SCE correction at a specific point in the AV
-  geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t const& point, int const& TPCid) const
+geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t const& point, int const& tpcid) const
 {
-  std::vector<double> theCalPosOffsets;
+  if(!fVoxelized) return {0., 0., 0.};
+
   //make copies of const vars to modify
   double xx=point.X(), yy=point.Y(), zz=point.Z();
-  int tpcid = TPCid;
-
-  if(fRepresentationType == "Voxelized_TH3"){
-    //handle OOAV by projecting edge cases
-    //also only have map for positive cryostat (assume symmetry)
-    //need to invert coordinates for cryo0
-    double corr=1.;
-    if(xx<0){
-      corr=-1.0;
-    }
 
-    bool x_is_pos = xx > 0;
+  //handle OOAV by projecting edge cases
+  //also only have map for positive cryostat (assume symmetry)
+  //need to invert coordinates for cryo0
+  double corr=1.;
+  if(xx<0){
+    corr=-1.0;
+  }
 
-    fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
-    //handle the depositions that was reconstructed in the wrong TPC   
-    //hard code in the cathode faces (got from dump_icarus_geometry.fcl)
-    //
-    //Gray Putnam: update this check to the split-wire Geometry
-    if (x_is_pos && (tpcid == 0 || tpcid == 1) && xx > 220.14 ) { xx = 220.14; }
-    if (x_is_pos && (tpcid == 2 || tpcid == 3) && xx < 220.29 ) { xx = 220.29; }
+  bool x_is_pos = xx > 0;
 
-    if (!x_is_pos && (tpcid == 2 || tpcid == 3) && xx > 220.14 ) { xx = 220.14; }
-    if (!x_is_pos && (tpcid == 0 || tpcid == 1) && xx < 220.29 ) { xx = 220.29; }
+  fixCoords(&xx, &yy, &zz); //bring into AV and x = abs(x)
+  //handle the depositions that was reconstructed in the wrong TPC
+  //hard code in the cathode faces (got from dump_icarus_geometry.fcl)
+  //
+  //Gray Putnam: update this check to the split-wire Geometry
+  if (x_is_pos && (tpcid == 0 || tpcid == 1) && xx > 220.14 ) { xx = 220.14; }
+  if (x_is_pos && (tpcid == 2 || tpcid == 3) && xx < 220.29 ) { xx = 220.29; }
 
-    double offset_x=0., offset_y=0., offset_z=0.;
-    offset_x = corr*SCEhistograms.at(3)->Interpolate(xx,yy,zz);
-    offset_y = SCEhistograms.at(4)->Interpolate(xx,yy,zz);
-    offset_z = SCEhistograms.at(5)->Interpolate(xx,yy,zz);
-    theCalPosOffsets = {offset_x, offset_y, offset_z};
-  }else{
-    theCalPosOffsets.resize(3, 0.0);
-  }
-  
-  return { theCalPosOffsets[0], theCalPosOffsets[1], theCalPosOffsets[2] };
+  if (!x_is_pos && (tpcid == 2 || tpcid == 3) && xx > 220.14 ) { xx = 220.14; }
+  if (!x_is_pos && (tpcid == 0 || tpcid == 1) && xx < 220.29 ) { xx = 220.29; }
+
+  auto const offset = fBkwdGrid.Interpolate(xx, yy, zz);
+
+  return { corr*offset[0], offset[1], offset[2] };
 }
 
 geo::Vector_t spacecharge::SpaceChargeICARUS::GetCalPosOffsets(geo::Point_t const& point, geo::TPCID const& TPCid ) const
@@ -214,21 +204,16 @@ geo::Vector_t spacecharge::SpaceChargeICARUS::GetEfieldOffsets(geo::Point_t cons
 {
   //chiefly utilized by larsim, ISCalculationSeparate
   //the magnitude of the Efield is most important
-  std::vector<double> theEfieldOffsets;
+  if(!fVoxelized) return {0., 0., 0.};
+
   double xx=point.X(), yy=point.Y(), zz=point.Z();
-  double offset_x=0., offset_y=0., offset_z=0.;
 
-  if(fRepresentationType == "Voxelized_TH3"){
-    //handle OOAV by projecting edge cases
-    //also only have map for positive cryostat (assume symmetry)
-    fixCoords(&xx, &yy, &zz);
-    offset_x = SCEhistograms.at(6)->Interpolate(xx, yy, zz);
-    offset_y = SCEhistograms.at(7)->Interpolate(xx, yy, zz);
-    offset_z = SCEhistograms.at(8)->Interpolate(xx, yy, zz);
+  //handle OOAV by projecting edge cases
+  //also only have map for positive cryostat (assume symmetry)
+  fixCoords(&xx, &yy, &zz);
+  auto const offset = fEfieldGrid.Interpolate(xx, yy, zz);
 
-    theEfieldOffsets = {offset_x, offset_y, offset_z};
-  }
-  return { theEfieldOffsets[0], theEfieldOffsets[1], theEfieldOffsets[2] };
+  return { offset[0], offset[1], offset[2] };
 }
 
 void spacecharge::SpaceChargeICARUS::fixCoords(double* xx, double* yy, double* zz) const{
@@ -11,6 +11,7 @@
 #define SPACECHARGE_SPACECHARGEICARUS_H
 
 // LArSoft libraries
+#include "icaruscode/TPC/Simulation/SpaceCharge/SpaceChargeVoxelGrid.h"
 #include "larevt/SpaceCharge/SpaceCharge.h"
 #include "larcore/Geometry/Geometry.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -73,6 +74,12 @@ namespace spacecharge
       ////////////////////////////
       std::vector<TH3F*> SCEhistograms = std::vector<TH3F*>(9);
 
+      //the same maps as contiguous grids: forward, backward and E field
+      SpaceChargeVoxelGrid fFwdGrid;
+      SpaceChargeVoxelGrid fBkwdGrid;
+      SpaceChargeVoxelGrid fEfieldGrid;
+      bool fVoxelized = false; //whether the Voxelized_TH3 maps are loaded
+
       //////////////////////////////
       // DECLARE FHICL PARAMETERS
       /////////////////////////////
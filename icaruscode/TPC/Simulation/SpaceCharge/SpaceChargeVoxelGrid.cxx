@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SpaceChargeVoxelGrid.cxx; brief flat voxel grid with a single three-component trilinear interpolation
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// C++ language includes
+#include <algorithm>
+#include <cmath>
+// LArSoft includes
+#include "icaruscode/TPC/Simulation/SpaceCharge/SpaceChargeVoxelGrid.h"
+
+// Framework includes
+#include "cetlib_except/exception.h"
+
+//ROOT
+#include <TAxis.h>
+#include <TH3.h>
+
+namespace {
+  bool sameBinning(TAxis const& a, TAxis const& b)
+  {
+    return (a.GetNbins() == b.GetNbins()) && (a.GetXmin() == b.GetXmin()) && (a.GetXmax() == b.GetXmax());
+  }
+}
+
+void spacecharge::SpaceChargeVoxelGrid::Axis::Set(TAxis const& axis)
+{
+  centers.resize(axis.GetNbins());
+  for(int bin = 1; bin <= axis.GetNbins(); bin++){
+    centers[bin-1] = axis.GetBinCenter(bin);
+  }
+  uniform = !axis.IsVariableBinSize();
+  first = centers.empty()? 0.: centers.front();
+  step = axis.GetNbins() > 0? axis.GetBinWidth(1): 0.;
+}
+
+bool spacecharge::SpaceChargeVoxelGrid::Axis::Locate(double v, std::size_t& idx, double& frac) const
+{
+  if(centers.size() < 2) return false;
+
+  if(uniform){
+    double const t = (v - first) / step;
+    //same domain as TH3::Interpolate: the upper center must be a real bin
+    if(!(t >= 0.) || !(t < double(centers.size() - 1))) return false;
+    idx = std::size_t(t);
+    frac = t - idx;
+    return true;
+  }
+
+  auto const upper = std::upper_bound(centers.begin(), centers.end(), v);
+  if((upper == centers.begin()) || (upper == centers.end())) return false;
+  idx = std::distance(centers.begin(), upper) - 1;
+  frac = (v - centers[idx]) / (centers[idx+1] - centers[idx]);
+  return true;
+}
+
+spacecharge::SpaceChargeVoxelGrid::SpaceChargeVoxelGrid(TH3 const& hX, TH3 const& hY, TH3 const& hZ)
+{
+  for(TH3 const* h: {&hY, &hZ}){
+    if(!sameBinning(*hX.GetXaxis(), *h->GetXaxis()) || !sameBinning(*hX.GetYaxis(), *h->GetYaxis())
+       || !sameBinning(*hX.GetZaxis(), *h->GetZaxis())){
+      throw cet::exception("SpaceChargeVoxelGrid") << "Histograms '" << hX.GetName() << "' and '" << h->GetName()
+                                                   << "' have different binning\n";
+    }
+  }
+
+  fX.Set(*hX.GetXaxis());
+  fY.Set(*hX.GetYaxis());
+  fZ.Set(*hX.GetZaxis());
+
+  std::size_t const nx = fX.centers.size(), ny = fY.centers.size(), nz = fZ.centers.size();
+  fValues.resize(nx * ny * nz * 3);
+
+  auto value = fValues.begin();
+  for(std::size_t ix = 0; ix < nx; ix++){
+    for(std::size_t iy = 0; iy < ny; iy++){
+      for(std::size_t iz = 0; iz < nz; iz++){
+        *value++ = hX.GetBinContent(ix+1, iy+1, iz+1);
+        *value++ = hY.GetBinContent(ix+1, iy+1, iz+1);
+        *value++ = hZ.GetBinContent(ix+1, iy+1, iz+1);
+      }
+    }
+  }
+}
+
+spacecharge::SpaceChargeVoxelGrid::Vector_t spacecharge::SpaceChargeVoxelGrid::Interpolate(double x, double y, double z) const
+{
+  std::size_t ix, iy, iz;
+  double fx, fy, fz;
+
+  if(!fX.Locate(x, ix, fx) || !fY.Locate(y, iy, fy) || !fZ.Locate(z, iz, fz)) return {0., 0., 0.};
+
+  std::size_t const strideZ = 3, strideY = fZ.centers.size() * strideZ, strideX = fY.centers.size() * strideY;
+  float const* base = fValues.data() + ix * strideX + iy * strideY + iz * strideZ;
+
+  double const wx[2] = {1. - fx, fx}, wy[2] = {1. - fy, fy}, wz[2] = {1. - fz, fz};
+
+  Vector_t result = {0., 0., 0.};
+  for(std::size_t dx = 0; dx < 2; dx++){
+    for(std::size_t dy = 0; dy < 2; dy++){
+      float const* row = base + dx * strideX + dy * strideY;
+      double const wxy = wx[dx] * wy[dy];
+      for(std::size_t dz = 0; dz < 2; dz++){
+        double const w = wxy * wz[dz];
+        result[0] += w * row[dz * strideZ + 0];
+        result[1] += w * row[dz * strideZ + 1];
+        result[2] += w * row[dz * strideZ + 2];
+      }
+    }
+  }
+  return result;
+}
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////
+// \file SpaceChargeVoxelGrid.h
+//
+// \brief flat voxel grid holding a three-component space charge map
+//
+// The three TH3 of a map (x, y and z component) are copied once into a
+// single contiguous float array, interleaving the components of each
+// voxel, so that one trilinear interpolation returns the full vector.
+// Results match TH3::Interpolate: interpolation is between bin centers,
+// and points beyond the outermost centers get a null vector.
+//
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SPACECHARGE_SPACECHARGEVOXELGRID_H
+#define SPACECHARGE_SPACECHARGEVOXELGRID_H
+
+// c++
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class TAxis;
+class TH3;
+
+namespace spacecharge
+{
+    class SpaceChargeVoxelGrid
+    {
+
+    public:
+
+      using Vector_t = std::array<double, 3>;
+
+      SpaceChargeVoxelGrid() = default;
+
+      // all three histograms must share the same binning
+      SpaceChargeVoxelGrid(TH3 const& hX, TH3 const& hY, TH3 const& hZ);
+
+      bool empty() const { return fValues.empty(); }
+
+      // trilinear interpolation of the three components at (x, y, z)
+      Vector_t Interpolate(double x, double y, double z) const;
+
+    private:
+
+      struct Axis
+      {
+        std::vector<double> centers;
+        double first = 0.;
+        double step  = 0.;
+        bool uniform = true;
+
+        void Set(TAxis const& axis);
+
+        // lower bin index and fractional distance to the next center;
+        // false when v is not between two bin centers
+        bool Locate(double v, std::size_t& idx, double& frac) const;
+      };
+
+      Axis fX, fY, fZ;
+
+      // voxel (ix, iy, iz) component c at ((ix*ny + iy)*nz + iz)*3 + c
+      std::vector<float> fValues;
+
+    }; // class SpaceChargeVoxelGrid
+} //namespace spacecharge
+#endif // SPACECHARGE_SPACECHARGEVOXELGRID_H
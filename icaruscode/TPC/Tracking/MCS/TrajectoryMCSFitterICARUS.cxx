@@ -149,49 +149,69 @@ void TrajectoryMCSFitterICARUS::breakTrajInSegments(const recob::TrackTrajectory
 }
 
 const TrajectoryMCSFitterICARUS::ScanResult TrajectoryMCSFitterICARUS::doLikelihoodScan(std::vector<float>& dtheta, std::vector<float>& seg_nradlengths, std::vector<float>& cumLen, bool fwdFit, bool momDepConst, int pid) const {
+  //
+  // the likelihood is evaluated lazily on the pScan_ points, so that the coarse-to-fine
+  // search and the uncertainty walk below only pay for the points they actually look at
+  //
+  const int nScan = pScan_.size();
+  std::vector<double> vlogL(nScan, 0.);
+  std::vector<bool>   done(nScan, false);
   int    best_idx  = -1;
   double best_logL = std::numeric_limits<double>::max();
-  double best_p    = -1.0;
-  std::vector<float> vlogL;
- for (double p_test = pMin_; p_test <= pMax_; p_test+=pStep_) {
-    double logL = mcsLikelihood(p_test, angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
-    if (logL < best_logL) {
-      best_p    = p_test;
-      best_logL = logL;
-      best_idx  = vlogL.size();
+  auto logLAt = [&](int k) {
+    if (!done[k]) {
+      vlogL[k] = mcsLikelihood(pScan_[k], angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
+      done[k] = true;
     }
-// std::cout << " ptest " << p_test << " likeli " << logL << " bestp "<< best_p << std::endl;
-//compute likelihood for MC momentum
-  /*  double logL = mcsLikelihood(2., angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
-    if (logL < best_logL) {
-      best_p    = 2.;
+    return vlogL[k];
+  };
+  //keep the lowest point among equal likelihoods, as the full scan does
+  auto consider = [&](int k) {
+    const double logL = logLAt(k);
+    if (logL < best_logL || (logL == best_logL && k < best_idx)) {
       best_logL = logL;
-      best_idx  = vlogL.size();
-    }*/
-    vlogL.push_back(logL);
+      best_idx  = k;
+    }
+  };
+  //
+  const int stride = coarseScanStride_;
+  for (int k = 0; k < nScan; k += stride) consider(k);
+  if (nScan > 0) consider(nScan-1);
+  //
+  //refine around the coarse minimum, moving the window until the minimum is
+  //at least a stride away from its edges (or at the end of the scan range)
+  if (stride > 1 && best_idx >= 0) {
+    int lo = best_idx, hi = best_idx;
+    int prev_idx = -1;
+    while (prev_idx != best_idx) {
+      prev_idx = best_idx;
+      const int newLo = std::max(0, best_idx-stride);
+      const int newHi = std::min(nScan-1, best_idx+stride);
+      for (int k = newLo; k < lo; k++) consider(k);
+      for (int k = hi+1; k <= newHi; k++) consider(k);
+      lo = std::min(lo, newLo);
+      hi = std::max(hi, newHi);
+    }
   }
+  if (best_idx < 0) return ScanResult(-1.0, -1.0, best_logL);
   //
   //uncertainty from left side scan
   double lunc = -1.0;
-  if (best_idx>0) {
-    for (int j=best_idx-1;j>=0;j--) {
-      double dLL = vlogL[j]-vlogL[best_idx];
-      if ( dLL<0.5 ) {
-	lunc = (best_idx-j)*pStep_;
-      } else break;
-    }
+  for (int j=best_idx-1;j>=0;j--) {
+    double dLL = logLAt(j)-best_logL;
+    if ( dLL<0.5 ) {
+      lunc = (best_idx-j)*pStep_;
+    } else break;
   }
   //uncertainty from right side scan
   double runc = -1.0;
-  if (best_idx<int(vlogL.size()-1)) {  
-    for (unsigned int j=best_idx+1;j<vlogL.size();j++) {
-      double dLL = vlogL[j]-vlogL[best_idx];
-      if ( dLL<0.5 ) {
-	runc = (j-best_idx)*pStep_;
-      } else break;
-    }
+  for (int j=best_idx+1;j<nScan;j++) {
+    double dLL = logLAt(j)-best_logL;
+    if ( dLL<0.5 ) {
+      runc = (j-best_idx)*pStep_;
+    } else break;
   }
-  return ScanResult(best_p, std::max(lunc,runc), best_logL);
+  return ScanResult(pScan_[best_idx], std::max(lunc,runc), best_logL);
 }
 void TrajectoryMCSFitterICARUS::findSegmentBarycenter(const recob::TrackTrajectory& traj, const size_t firstPoint, const size_t lastPoint, Vector_t& bary) const {
   int npoints = 0;
@@ -271,6 +291,8 @@ double TrajectoryMCSFitterICARUS::mcsLikelihood(double p, double theta0x, std::v
   //
   const double m = mass(pid);
   const double m2 = m*m;
+  auto const itTable = rangeTables_.find(std::abs(pid));
+  const RangeTable* table = (itTable == rangeTables_.end() ? nullptr : &(itTable->second));
   const double Etot = sqrt(p*p + m2);//Initial energy
   double Eij2 = 0.;
   //
@@ -289,7 +311,7 @@ double TrajectoryMCSFitterICARUS::mcsLikelihood(double p, double theta0x, std::v
       Eij2 = Eij*Eij;
     } else {
       // Non constant energy loss distribution
-      const double Eij = GetE(Etot,cumLen[i],m);
+      const double Eij = (table ? GetE(*table,Etot,cumLen[i]) : GetE(Etot,cumLen[i],m));
       Eij2 = Eij*Eij;
     }
     //
@@ -380,6 +402,69 @@ double TrajectoryMCSFitterICARUS::GetE(const double initial_E, const double leng
   }
   return current_E;
 }
+//
+TrajectoryMCSFitterICARUS::RangeTable TrajectoryMCSFitterICARUS::makeRangeTable(const double m) const {
+  //
+  // CSDA range R(T) = int_0^T dT'/(dE/dx), tabulated from 1 MeV up to beyond the highest scanned momentum.
+  // The loss rate is the one used by the stepping in GetE; for the Landau MPV, which depends on the
+  // thickness crossed, the rate is taken over one nominal segment length.
+  //
+  constexpr int nPoints = 2000;
+  constexpr double TMin = 0.001;
+  const double TMax = 1.1*(std::sqrt(pMax_*pMax_ + m*m) - m) + 0.1;
+  //
+  RangeTable table;
+  table.mass = m;
+  table.logTMin = std::log(TMin);
+  table.dLogT = (std::log(TMax) - table.logTMin) / (nPoints - 1);
+  table.range.resize(nPoints);
+  //
+  auto lossRate = [this,m](double T) {
+    const double E = T + m;
+    const double rate = (eLossMode_==2 ? energyLossBetheBloch(m,E) : energyLossLandau(m*m,E*E,segLen_)/segLen_);
+    return std::max(rate, 1.E-6);//keep the range finite where the parametrization vanishes
+  };
+  //
+  // integrate T/(dE/dx) in log(T); below TMin the loss rate goes roughly as 1/T, so R ~ T/(2 dE/dx)
+  double prevIntegrand = TMin/lossRate(TMin);
+  table.range[0] = 0.5*prevIntegrand;
+  for (int i = 1; i < nPoints; i++) {
+    const double T = std::exp(table.logTMin + i*table.dLogT);
+    const double integrand = T/lossRate(T);
+    table.range[i] = table.range[i-1] + 0.5*(integrand + prevIntegrand)*table.dLogT;
+    prevIntegrand = integrand;
+  }
+  return table;
+}
+//
+double TrajectoryMCSFitterICARUS::RangeTable::rangeAt(double T) const {
+  const double x = (std::log(T) - logTMin) / dLogT;
+  if (x < 0.) return range.front() * T / std::exp(logTMin);
+  const size_t i = size_t(x);
+  if (i+1 >= range.size()) return -1.;
+  const double f = x - i;
+  return range[i]*(1.-f) + range[i+1]*f;
+}
+//
+double TrajectoryMCSFitterICARUS::RangeTable::kineticAt(double R) const {
+  if (R <= range.front()) return 0.;
+  const size_t i = std::upper_bound(range.begin(), range.end(), R) - range.begin() - 1;
+  if (i+1 >= range.size()) return std::exp(logTMin + i*dLogT);
+  const double f = (R - range[i]) / (range[i+1] - range[i]);
+  return std::exp(logTMin + (i+f)*dLogT);
+}
+//
+double TrajectoryMCSFitterICARUS::GetE(const RangeTable& table, const double initial_E, const double length_travelled) const {
+  //
+  const double R = table.rangeAt(initial_E - table.mass);
+  // out of the table: fall back to stepping
+  if (R < 0.) return GetE(initial_E, length_travelled, table.mass);
+  //
+  const double T = table.kineticAt(R - length_travelled);
+  // stopped, as GetE does when the energy reaches the mass
+  if (T <= 0.) return 0.;
+  return table.mass + T;
+}
 double TrajectoryMCSFitterICARUS::GetOptimalSegLen(const double guess_p, const int n_points, const int plane, const double length_travelled) const {
   //
 // check units of measurment! (energy, length...)
@@ -10,6 +10,10 @@
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardata/RecoObjects/TrackState.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 namespace trkf {
   /**
    * @file  larreco/RecoAlg/TrajectoryMCSFitterICARUS.h
@@ -89,10 +93,20 @@ namespace trkf {
 	Comment("Angular resolution parameter used in modified Highland formula. Unit is mrad."),
 	3.0
       };
+      fhicl::Atom<bool> rangeTable {
+        Name("rangeTable"),
+	Comment("Get the energy upstream of each segment from a precomputed CSDA range table per particle hypothesis instead of stepping (eLossMode 0 and 2)."),
+	false
+      };
+      fhicl::Atom<int> coarseScanStride {
+        Name("coarseScanStride"),
+	Comment("Scan the likelihood every this many pSteps, then refine in pStep around the minimum. 1 scans every pStep."),
+	1
+      };
     };
     using Parameters = fhicl::Table<Config>;
     //
-    TrajectoryMCSFitterICARUS(int pIdHyp, int minNSegs, double segLen, int minHitsPerSegment, int nElossSteps, int eLossMode, double pMin, double pMax, double pStep, double angResol){
+    TrajectoryMCSFitterICARUS(int pIdHyp, int minNSegs, double segLen, int minHitsPerSegment, int nElossSteps, int eLossMode, double pMin, double pMax, double pStep, double angResol, bool rangeTable = false, int coarseScanStride = 1){
       pIdHyp_ = pIdHyp;
       minNSegs_ = minNSegs;
       segLen_ = segLen;
@@ -103,9 +117,15 @@ namespace trkf {
       pMax_ = pMax;
       pStep_ = pStep;
       angResol_ = angResol;
+      coarseScanStride_ = std::max(coarseScanStride, 1);
+      //scan points accumulated once, exactly as the scan loop used to do
+      for (double p_test = pMin_; p_test <= pMax_; p_test+=pStep_) pScan_.push_back(p_test);
+      if (rangeTable) {
+        for (int pid : {13, 211, 321, 2212}) rangeTables_.emplace(pid, makeRangeTable(mass(pid)));
+      }
     }
     explicit TrajectoryMCSFitterICARUS(const Parameters & p)
-      : TrajectoryMCSFitterICARUS(p().pIdHypothesis(),p().minNumSegments(),p().segmentLength(),p().minHitsPerSegment(),p().nElossSteps(),p().eLossMode(),p().pMin(),p().pMax(),p().pStep(),p().angResol()) {}
+      : TrajectoryMCSFitterICARUS(p().pIdHypothesis(),p().minNumSegments(),p().segmentLength(),p().minHitsPerSegment(),p().nElossSteps(),p().eLossMode(),p().pMin(),p().pMax(),p().pStep(),p().angResol(),p().rangeTable(),p().coarseScanStride()) {}
     //
     recob::MCSFitResult fitMcs(const recob::TrackTrajectory& traj, bool momDepConst = true) const { return fitMcs(traj,pIdHyp_,momDepConst); }
     recob::MCSFitResult fitMcs(const recob::Track& track,          bool momDepConst = true) const { return fitMcs(track,pIdHyp_,momDepConst); }
@@ -154,6 +174,18 @@ void ComputeD3P()   ;
     double energyLossLandau(const double mass2,const double E2, const double x) const;
     //
     double GetE(const double initial_E, const double length_travelled, const double mass) const;
+    //
+    /// CSDA range versus kinetic energy for one mass, with log spaced energies
+    struct RangeTable {
+      double mass = 0.;
+      double logTMin = 0.;
+      double dLogT = 0.;
+      std::vector<double> range; ///< range [cm] at kinetic energy exp(logTMin+i*dLogT) [GeV]
+      double rangeAt(double T) const;  ///< negative if T is beyond the table
+      double kineticAt(double R) const; ///< zero if R is below the table
+    };
+    RangeTable makeRangeTable(const double mass) const;
+    double GetE(const RangeTable& table, const double initial_E, const double length_travelled) const;
     void set2DHits(std::vector<recob::Hit> h) {hits2d=h;}
   //  void projectHitsOnPlane(art::Event & e,const recob::Track& traj,int p) const
     //
@@ -168,6 +200,10 @@ void ComputeD3P()   ;
     double pMax_;
     double pStep_;
     double angResol_;
+    int    coarseScanStride_;
+
+    std::vector<double> pScan_;
+    std::map<int, RangeTable> rangeTables_; ///< by absolute PDG code; empty unless rangeTable is set
 
     std::vector<recob::Hit> hits2d;
     float d3p;
@@ -28,22 +28,19 @@
 #include "tools/IElectronicsResponse.h"
 #include "tools/IFilter.h"
 
-#include "tbb/spin_mutex.h"
-
 #include <fstream>
 
 namespace icarusutil
 {
-    
-tbb::spin_mutex signalShapingSpinMutex;
 
 //----------------------------------------------------------------------
 // Constructor.
 SignalShapingICARUSService::SignalShapingICARUSService(const fhicl::ParameterSet& pset,
-                                                             art::ActivityRegistry& /* reg */)
-: fInit(false)
+                                                             art::ActivityRegistry& reg)
 {
     reconfigure(pset);
+    
+    reg.sPostBeginJob.watch(this, &SignalShapingICARUSService::postBeginJob);
 }
 
 //----------------------------------------------------------------------
@@ -73,7 +70,8 @@ void SignalShapingICARUSService::reconfigure(const fhicl::ParameterSet& pset)
     fNoiseFactVec           = pset.get<DoubleVec2>("NoiseFactVec"         );
     fStoreHistograms        = pset.get<bool>(      "StoreHistograms"      );
     
-    fInit = false;
+    // Initialize here, once, rather than on first use from (possibly concurrent) accessors
+    init();
     
     return;
 }
@@ -96,72 +94,81 @@ void SignalShapingICARUSService::reconfigure(const fhicl::ParameterSet& pset)
 
 const icarus_tool::IResponse& SignalShapingICARUSService::GetResponse(size_t channel) const
 {
-    if (!fInit) init();
-    
-    art::ServiceHandle<geo::Geometry> geom;
-    
-        //use channel number to set some useful numbers
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-
-    return *fPlaneToResponseMap.at(planeIdx).front();
+    return channelResponse(channel);
 }
 
 
 //----------------------------------------------------------------------
 // Initialization method.
-// Here we do initialization that can't be done in the constructor.
-// All public methods should ensure that this method is called as necessary.
+// Here we do the initialization that needs the other services: the responses
+// and the tables mapping each channel to its plane and response.
 void SignalShapingICARUSService::init()
 {
-    // First get a lock to make sure we are clear to run
-    tbb::spin_mutex::scoped_lock lock(signalShapingSpinMutex);
-
-    if(!fInit)
-    {
-        // Do ICARUS-specific configuration of SignalShaping by providing
-        // ICARUS response and filter functions.
-        art::ServiceHandle<geo::Geometry> geo;
+    // Do ICARUS-specific configuration of SignalShaping by providing
+    // ICARUS response and filter functions.
+    art::ServiceHandle<geo::Geometry> geo;
 
-        auto const samplingRate = sampling_rate(art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob());
+    auto const samplingRate = sampling_rate(art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob());
 
-        // Get the normalization from the field response for the collection plane
-        double integral = fPlaneToResponseMap.at(fPlaneForNormalization).front().get()->getFieldResponse()->getIntegral();
-        double weight   = 1. / integral;
-        
-        for(size_t planeIdx = 0; planeIdx < geo->Nplanes(); planeIdx++)
-        {
-          fPlaneToResponseMap[planeIdx].front().get()->setResponse(samplingRate, weight);
-        }
+    // Get the normalization from the field response for the collection plane
+    double integral = fPlaneToResponseMap.at(fPlaneForNormalization).front().get()->getFieldResponse()->getIntegral();
+    double weight   = 1. / integral;
+    
+    fPlaneToResponse.clear();
+    
+    for(size_t planeIdx = 0; planeIdx < geo->Nplanes(); planeIdx++)
+    {
+        fPlaneToResponseMap[planeIdx].front().get()->setResponse(samplingRate, weight);
+        fPlaneToResponse.push_back(fPlaneToResponseMap[planeIdx].front().get());
+    }
+    
+    // The plane of each channel, from the first of its wires
+    fChannelToPlane.assign(geo->Nchannels(), InvalidPlane);
+    
+    for(unsigned int channel = 0; channel < fChannelToPlane.size(); channel++)
+    {
+        std::vector<geo::WireID> const wireIDs = geo->ChannelToWire(channel);
         
-        // Check to see if we want histogram output
-        if (fStoreHistograms)
-        {
-            art::ServiceHandle<art::TFileService> tfs;
-            
-            // Make sure we are at the top level
-            tfs->file().cd();
-            
-            // Make a directory for these histograms
-            art::TFileDirectory dir = tfs->mkdir("SignalShaping");
-            
-            // Loop through response tools first
-            for(const auto& response: fPlaneToResponseMap) response.second.front().get()->outputHistograms(samplingRate, dir);
-
-        }
-
-        fInit = true;
+        if (!wireIDs.empty()) fChannelToPlane[channel] = wireIDs.front().Plane;
     }
     
     return;
 }
 
+void SignalShapingICARUSService::postBeginJob()
+{
+    // Check to see if we want histogram output
+    if (!fStoreHistograms) return;
+    
+    auto const samplingRate = sampling_rate(art::ServiceHandle<detinfo::DetectorClocksService const>()->DataForJob());
+    
+    art::ServiceHandle<art::TFileService> tfs;
+    
+    // Make sure we are at the top level
+    tfs->file().cd();
+    
+    // Make a directory for these histograms
+    art::TFileDirectory dir = tfs->mkdir("SignalShaping");
+    
+    // Loop through response tools first
+    for(const auto& response: fPlaneToResponseMap) response.second.front().get()->outputHistograms(samplingRate, dir);
+    
+    return;
+}
+
+size_t SignalShapingICARUSService::channelPlane(unsigned int const channel) const
+{
+    if (channel >= fChannelToPlane.size() || fChannelToPlane[channel] == InvalidPlane)
+        throw cet::exception("SignalShapingICARUSService") << "No plane associated to channel " << channel << "\n";
+    
+    return fChannelToPlane[channel];
+}
+
 void SignalShapingICARUSService::SetDecon(double const samplingRate,
                                           size_t fftsize, size_t channel)
 {
     art::ServiceHandle<geo::Geometry> geo;
     
-    if (!fInit) init();
-    
     // Assume we need to reset the kernels
     double integral = fPlaneToResponseMap.at(fPlaneForNormalization).front().get()->getFieldResponse()->getIntegral();
     double weight   = 1. / integral;
@@ -177,9 +184,7 @@ double SignalShapingICARUSService::GetASICGain(unsigned int  channel) const
 {
     static const double fcToElectrons(6241.50975);
     
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-    double gain     = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getFCperADCMicroS() * fcToElectrons;
+    double gain     = channelResponse(channel).getElectronicsResponse()->getFCperADCMicroS() * fcToElectrons;
     
     return gain;
 }
@@ -187,20 +192,17 @@ double SignalShapingICARUSService::GetASICGain(unsigned int  channel) const
 //-----Give Shaping time to SimWire-----
 double SignalShapingICARUSService::GetShapingTime(unsigned int  channel) const
 {
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx     = geom->ChannelToWire(channel)[0].Plane;
-    double shaping_time = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getASICShapingTime();
+    double shaping_time = channelResponse(channel).getElectronicsResponse()->getASICShapingTime();
 
     return shaping_time;
 }
 
 double SignalShapingICARUSService::GetRawNoise(unsigned int const channel) const
 {
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
+    size_t planeIdx = channelPlane(channel);
     
-    double gain         = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getFCperADCMicroS();
-    double shaping_time = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getASICShapingTime();
+    double gain         = fPlaneToResponse[planeIdx]->getElectronicsResponse()->getFCperADCMicroS();
+    double shaping_time = fPlaneToResponse[planeIdx]->getElectronicsResponse()->getASICShapingTime();
     int    temp;
     
     if (std::abs(shaping_time - 0.6)<1e-6){
@@ -215,7 +217,7 @@ double SignalShapingICARUSService::GetRawNoise(unsigned int const channel) const
     
     double rawNoise;
     
-    auto tempNoise = fNoiseFactVec.at(planeIdx);
+    const DoubleVec& tempNoise = fNoiseFactVec.at(planeIdx);
     rawNoise = tempNoise.at(temp);
     
     rawNoise *= gain/4.7;
@@ -224,10 +226,9 @@ double SignalShapingICARUSService::GetRawNoise(unsigned int const channel) const
 
 double SignalShapingICARUSService::GetDeconNoise(unsigned int const channel) const
 {
-    art::ServiceHandle<geo::Geometry> geom;
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
+    size_t planeIdx = channelPlane(channel);
     
-    double shaping_time = fPlaneToResponseMap.at(planeIdx).front()->getElectronicsResponse()->getASICShapingTime();
+    double shaping_time = fPlaneToResponse[planeIdx]->getElectronicsResponse()->getASICShapingTime();
     int temp;
     
     if (std::abs(shaping_time - 0.6)<1e-6){
@@ -239,7 +240,7 @@ double SignalShapingICARUSService::GetDeconNoise(unsigned int const channel) con
     }else{
         temp = 3;
     }
-    auto   tempNoise  = fNoiseFactVec.at(planeIdx);
+    const DoubleVec& tempNoise  = fNoiseFactVec.at(planeIdx);
     double deconNoise = tempNoise.at(temp);
     
     //deconNoise = deconNoise /4096.*2000./4.7 *6.241*1000/fDeconNorm; <== I don't know where these numbers come from...
@@ -249,13 +250,7 @@ double SignalShapingICARUSService::GetDeconNoise(unsigned int const channel) con
 
 int SignalShapingICARUSService::ResponseTOffset(unsigned int const channel) const
 {
-    if (!fInit) init();
-    
-    art::ServiceHandle<geo::Geometry> geom;
-    
-    size_t planeIdx = geom->ChannelToWire(channel)[0].Plane;
-
-    return fPlaneToResponseMap.at(planeIdx).front()->getTOffset();
+    return channelResponse(channel).getTOffset();
 }
 }
 
@@ -80,6 +80,7 @@
 
 #include <vector>
 #include <map>
+#include <limits>
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceMacros.h"
@@ -105,7 +106,7 @@ public:
     void                          reconfigure(const fhicl::ParameterSet& pset);
     
     // Accessors.
-    DoubleVec2                    GetNoiseFactVec() { return fNoiseFactVec; }
+    const DoubleVec2&             GetNoiseFactVec()                                  const { return fNoiseFactVec; }
     
     double                        GetASICGain(unsigned int const channel)            const;
     double                        GetShapingTime(unsigned int const channel)         const;
@@ -128,13 +129,18 @@ private:
     using ResponseVec              = std::vector<IResponsePtr>;
     using PlaneToResponseMap       = std::map<size_t, ResponseVec>;
     
-    // Post-constructor initialization.
-    void init() const{const_cast<SignalShapingICARUSService*>(this)->init();}
+    // Initialization of the responses and of the channel tables, done at configuration
     void init();
     
-    // Attributes.
-    bool fInit;                                                 ///< Initialization flag
+    // Histograms of the responses, stored once the job has begun
+    void postBeginJob();
     
+    // Plane of the channel and its response, looked up in the channel tables
+    size_t                        channelPlane(unsigned int const channel)           const;
+    const icarus_tool::IResponse& channelResponse(unsigned int const channel)        const
+        { return *fPlaneToResponse[channelPlane(channel)]; }
+    
+
     // Fcl parameters.
     size_t             fPlaneForNormalization; ///< Normalize responses to this plane
     double             fDeconNorm;             ///< Final normalization to apply
@@ -145,6 +151,12 @@ private:
     
     // Field response tools
     PlaneToResponseMap fPlaneToResponseMap;
+    
+    // Tables filled at initialization, so that accessors need no geometry query
+    static constexpr unsigned short InvalidPlane = std::numeric_limits<unsigned short>::max();
+    
+    std::vector<unsigned short>               fChannelToPlane;   ///< Plane of each channel (InvalidPlane if none)
+    std::vector<const icarus_tool::IResponse*> fPlaneToResponse;  ///< Response used for each plane
 };
 
 } // end of namespace
@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   ResponseCache.h
+///
+/// \brief  On-disk cache of the combined responses and of the convolution
+///         and deconvolution kernels computed by the response tools
+///
+/// Each entry is a single binary file with a fixed size header followed by
+/// the arrays, so that it can be memory mapped and copied out directly:
+///
+///     ResponseCacheHeader
+///     response             (numResponse   x double)
+///     convolution kernel   (numConvKernel x std::complex<double>)
+///     deconvolution kernel (numDeconv     x std::complex<double>)
+///
+/// The file name contains the key of the entry, i.e. the hash (FHiCL
+/// parameter set ID) of the configuration combined with a hash of the field
+/// response histogram content (see responseCacheConfigID()), the number of
+/// time samples (FFT size), the sampling rate and the normalization weight;
+/// the header repeats them and is checked on reading. Changing the layout
+/// requires bumping ResponseCacheVersion.
+///
+/// Entries are written to a temporary file and then renamed, so that
+/// concurrent jobs sharing a cache directory never read a partial entry.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef ResponseCache_H
+#define ResponseCache_H
+
+#include "icaruscode/TPC/Utilities/tools/SignalProcessingDefs.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace icarus_tool
+{
+    /// Version of the layout of the cache files
+    constexpr std::uint32_t ResponseCacheVersion = 1;
+
+    /// Content of the cache, in the units used by the response tools
+    struct ResponseCacheEntry
+    {
+        double                   t0Offset = 0.;
+        icarusutil::TimeVec      response;
+        icarusutil::FrequencyVec convKernel;
+        icarusutil::FrequencyVec deconvKernel;
+    };
+
+    /// Header at the start of each cache file
+    struct ResponseCacheHeader
+    {
+        char          magic[8];           ///< "ICRSPCCH"
+        std::uint32_t version;            ///< ResponseCacheVersion
+        std::uint32_t plane;              ///< Plane of the response
+        std::uint64_t numberTimeSamples;  ///< FFT size
+        std::uint64_t numResponse;        ///< Entries of the response
+        std::uint64_t numConvKernel;      ///< Entries of the convolution kernel
+        std::uint64_t numDeconvKernel;    ///< Entries of the deconvolution kernel
+        double        samplingRate;       ///< Sampling rate the response was computed with
+        double        weight;             ///< Normalization weight the response was computed with
+        double        t0Offset;           ///< T0 offset of the response [ticks]
+        char          configID[64];       ///< Hash of the configuration (null terminated)
+    };
+
+    static constexpr char ResponseCacheMagic[8] = {'I','C','R','S','P','C','C','H'};
+
+    /// Combines the configuration hash with a hash (FNV-1a) of the field response content
+    inline std::string responseCacheConfigID(const std::string&         psetID,
+                                             const std::vector<double>& fieldResponse)
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+
+        for(double value : fieldResponse)
+        {
+            unsigned char bytes[sizeof(double)];
+
+            std::memcpy(bytes, &value, sizeof(double));
+
+            for(unsigned char byte : bytes)
+            {
+                hash ^= byte;
+                hash *= 1099511628211ULL;
+            }
+        }
+
+        std::ostringstream configID;
+
+        configID << psetID << "_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+
+        return configID.str();
+    }
+
+    /// Returns the path of the cache file for the specified key
+    inline std::string responseCachePath(const std::string& cacheDir,
+                                         const std::string& configID,
+                                         size_t             plane,
+                                         size_t             numberTimeSamples,
+                                         double             samplingRate,
+                                         double             weight)
+    {
+        std::ostringstream path;
+
+        // hexadecimal floating point keeps the rate and weight exact
+        path << cacheDir << "/ICARUSResponse_v" << ResponseCacheVersion << "_" << configID
+             << "_plane" << plane << "_" << numberTimeSamples
+             << "_" << std::hexfloat << samplingRate << "_" << weight << ".bin";
+
+        return path.str();
+    }
+
+    /// Fills entry from the cache file at path; returns false if missing or not matching the key
+    inline bool readResponseCache(const std::string&  path,
+                                  const std::string&  configID,
+                                  size_t              plane,
+                                  size_t              numberTimeSamples,
+                                  double              samplingRate,
+                                  double              weight,
+                                  ResponseCacheEntry& entry)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0) return false;
+
+        struct stat fileStat;
+
+        if (::fstat(fd, &fileStat) != 0 || size_t(fileStat.st_size) < sizeof(ResponseCacheHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        size_t fileSize = fileStat.st_size;
+        void*  mapped   = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        ::close(fd);
+
+        if (mapped == MAP_FAILED) return false;
+
+        const char*         data = static_cast<const char*>(mapped);
+        ResponseCacheHeader header;
+
+        std::memcpy(&header, data, sizeof(header));
+
+        size_t numBytes = sizeof(header) + header.numResponse * sizeof(icarusutil::SigProcPrecision)
+                        + (header.numConvKernel + header.numDeconvKernel) * sizeof(icarusutil::ComplexVal);
+
+        bool matches = std::memcmp(header.magic, ResponseCacheMagic, sizeof(header.magic)) == 0
+                    && header.version           == ResponseCacheVersion
+                    && header.plane             == plane
+                    && header.numberTimeSamples == numberTimeSamples
+                    && header.samplingRate      == samplingRate
+                    && header.weight            == weight
+                    && header.configID[sizeof(header.configID) - 1] == '\0'
+                    && configID                 == header.configID
+                    && numBytes                 == fileSize;
+
+        if (matches)
+        {
+            const auto* responsePtr = reinterpret_cast<const icarusutil::SigProcPrecision*>(data + sizeof(header));
+            const auto* convPtr     = reinterpret_cast<const icarusutil::ComplexVal*>(responsePtr + header.numResponse);
+            const auto* deconvPtr   = convPtr + header.numConvKernel;
+
+            entry.t0Offset = header.t0Offset;
+            entry.response.assign(responsePtr, responsePtr + header.numResponse);
+            entry.convKernel.assign(convPtr, convPtr + header.numConvKernel);
+            entry.deconvKernel.assign(deconvPtr, deconvPtr + header.numDeconvKernel);
+        }
+
+        ::munmap(mapped, fileSize);
+
+        return matches;
+    }
+
+    /// Writes entry into the cache file at path; returns false on failure
+    inline bool writeResponseCache(const std::string&        path,
+                                   const std::string&        configID,
+                                   size_t                    plane,
+                                   size_t                    numberTimeSamples,
+                                   double                    samplingRate,
+                                   double                    weight,
+                                   const ResponseCacheEntry& entry)
+    {
+        if (configID.size() >= sizeof(ResponseCacheHeader::configID)) return false;
+
+        ResponseCacheHeader header;
+
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, ResponseCacheMagic, sizeof(header.magic));
+        std::strncpy(header.configID, configID.c_str(), sizeof(header.configID) - 1);
+
+        header.version           = ResponseCacheVersion;
+        header.plane             = plane;
+        header.numberTimeSamples = numberTimeSamples;
+        header.numResponse       = entry.response.size();
+        header.numConvKernel     = entry.convKernel.size();
+        header.numDeconvKernel   = entry.deconvKernel.size();
+        header.samplingRate      = samplingRate;
+        header.weight            = weight;
+        header.t0Offset          = entry.t0Offset;
+
+        std::string tempPath = path + ".tmp" + std::to_string(::getpid());
+
+        {
+            std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+
+            outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            outFile.write(reinterpret_cast<const char*>(entry.response.data()),     entry.response.size()     * sizeof(icarusutil::SigProcPrecision));
+            outFile.write(reinterpret_cast<const char*>(entry.convKernel.data()),   entry.convKernel.size()   * sizeof(icarusutil::ComplexVal));
+            outFile.write(reinterpret_cast<const char*>(entry.deconvKernel.data()), entry.deconvKernel.size() * sizeof(icarusutil::ComplexVal));
+
+            if (!outFile)
+            {
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
+
+#endif
@@ -20,6 +20,7 @@
 #include "IFieldResponse.h"
 #include "IElectronicsResponse.h"
 #include "IFilter.h"
+#include "ResponseCache.h"
 
 #include "TProfile.h"
 
@@ -59,6 +60,10 @@ private:
     void                                    calculateResponse(double sampling_rate,
                                                               double weight);
 
+    // Recover the response and kernels from the cache, or compute and store them
+    bool                                    loadFromCache(double sampling_rate, double weight);
+    void                                    saveToCache(double sampling_rate, double weight) const;
+
     // Utility routine for converting numbers to strings
     std::string                             numberToString(int number);
 
@@ -69,6 +74,9 @@ private:
     size_t                                            fThisPlane;
     double                                            f3DCorrection;
     double                                            fTimeScaleFactor;
+    std::string                                       fResponseCacheDir;     ///< Directory of the response cache, empty to disable
+    std::string                                       fConfigID;             ///< Hash of the configuration and field response, key of the cache
+    bool                                              fResponseFromCache;    ///< Response and kernels were read from the cache
     
     using IFieldResponsePtr       = std::unique_ptr<icarus_tool::IFieldResponse>;
     using IElectronicsResponsePtr = std::unique_ptr<icarus_tool::IElectronicsResponse>;
@@ -103,11 +111,30 @@ void Response::configure(const fhicl::ParameterSet& pset)
     fThisPlane           = pset.get<size_t>("Plane");
     f3DCorrection        = pset.get<size_t>("Correction3D");
     fTimeScaleFactor     = pset.get<size_t>("TimeScaleFactor");
+    fResponseCacheDir    = pset.get<std::string>("ResponseCacheDir", "");
 
     fResponseHasBeenSet  = false;
+    fResponseFromCache   = false;
 
     // Build out the underlying tools we'll be using
     fFieldResponse       = art::make_tool<icarus_tool::IFieldResponse>(pset.get<fhicl::ParameterSet>("FieldResponse"));
+
+    // The key of the cache is the full configuration, minus the location of the cache itself,
+    // and the content of the field response histogram, which may change under the same file name
+    fhicl::ParameterSet keyPSet(pset);
+
+    keyPSet.erase("ResponseCacheDir");
+
+    std::vector<double> fieldResponseContent;
+
+    fieldResponseContent.reserve(fFieldResponse->getNumBins() + 3);
+    fieldResponseContent.push_back(fFieldResponse->getLowEdge());
+    fieldResponseContent.push_back(fFieldResponse->getHighEdge());
+    fieldResponseContent.push_back(fFieldResponse->getTOffset());
+
+    for(size_t bin = 1; bin <= fFieldResponse->getNumBins(); bin++) fieldResponseContent.push_back(fFieldResponse->getBinContent(bin));
+
+    fConfigID            = icarus_tool::responseCacheConfigID(keyPSet.id().to_string(), fieldResponseContent);
     fElectronicsResponse = art::make_tool<icarus_tool::IElectronicsResponse>(pset.get<fhicl::ParameterSet>("ElectronicsResponse"));
     fFilter              = art::make_tool<icarus_tool::IFilter>(pset.get<fhicl::ParameterSet>("Filter"));
 
@@ -125,15 +152,22 @@ void Response::configure(const fhicl::ParameterSet& pset)
     // If we have already done the setup then can return
     if (fResponseHasBeenSet) return;
 
+    // Set up the filter for use in the deconvolution
+    fFilter->setResponse(fNumberTimeSamples, f3DCorrection, fTimeScaleFactor);
+
+    // Recover the finished response and kernels if this configuration was already computed
+    if (loadFromCache(sampling_rate, weight))
+    {
+        fResponseHasBeenSet = true;
+        return;
+    }
+
     // Calculate the combined field and electronics shaping response
     calculateResponse(sampling_rate, weight);
 
     // Now we compute the convolution kernel which is a straigtforward operation
     fFFT->forwardFFT(fResponse, fConvolutionKernel);
 
-    // Set up the filter for use in the deconvolution
-    fFilter->setResponse(fNumberTimeSamples, f3DCorrection, fTimeScaleFactor);
-
     // Now compute the deconvolution kernel
     fDeconvolutionKernel = fFilter->getResponseVec();
 
@@ -173,11 +207,53 @@ void Response::configure(const fhicl::ParameterSet& pset)
 //
 //    mf::LogInfo("Response_tool") << "Checking recovery of the filter, # differences: " << diffCount << ", max diff seen: " << maxRhoDiff << std::endl;
 
+    saveToCache(sampling_rate, weight);
+
     fResponseHasBeenSet = true;
 
     return;
 }
 
+bool Response::loadFromCache(double sampling_rate, double weight)
+{
+    if (fResponseCacheDir.empty()) return false;
+
+    std::string                     cachePath = responseCachePath(fResponseCacheDir, fConfigID, fThisPlane, fNumberTimeSamples, sampling_rate, weight);
+    icarus_tool::ResponseCacheEntry entry;
+
+    if (!readResponseCache(cachePath, fConfigID, fThisPlane, fNumberTimeSamples, sampling_rate, weight, entry)) return false;
+
+    fT0Offset             = entry.t0Offset;
+    fResponse             = std::move(entry.response);
+    fConvolutionKernel    = std::move(entry.convKernel);
+    fDeconvolutionKernel  = std::move(entry.deconvKernel);
+    fResponseFromCache    = true;
+
+    mf::LogInfo("Response_tool") << "***** Response for plane: " << fThisPlane << " read from cache: " << cachePath << "\n"
+                                 << "      T0Offset: " << fT0Offset << std::endl;
+
+    return true;
+}
+
+void Response::saveToCache(double sampling_rate, double weight) const
+{
+    if (fResponseCacheDir.empty()) return;
+
+    std::string                     cachePath = responseCachePath(fResponseCacheDir, fConfigID, fThisPlane, fNumberTimeSamples, sampling_rate, weight);
+    icarus_tool::ResponseCacheEntry entry;
+
+    entry.t0Offset     = fT0Offset;
+    entry.response     = fResponse;
+    entry.convKernel   = fConvolutionKernel;
+    entry.deconvKernel = fDeconvolutionKernel;
+
+    // A failure to write only costs the computation in the next job
+    if (!writeResponseCache(cachePath, fConfigID, fThisPlane, fNumberTimeSamples, sampling_rate, weight, entry))
+        mf::LogWarning("Response_tool") << "Could not write response cache file: " << cachePath << std::endl;
+
+    return;
+}
+
 void Response::calculateResponse(double sampling_rate,
                                  double weight)
 {
@@ -309,9 +385,14 @@ void Response::outputHistograms(double sampling_rate,
     
     art::TFileDirectory dir = histDir.mkdir(thisResponse.c_str());
     
-    // Do the field response histograms
-    fFieldResponse->outputHistograms(dir);
-    fElectronicsResponse->outputHistograms(dir);
+    // Do the field response histograms (not computed if the response came from the cache)
+    if (!fResponseFromCache)
+    {
+        fFieldResponse->outputHistograms(dir);
+        fElectronicsResponse->outputHistograms(dir);
+    }
+    else mf::LogInfo("Response_tool") << "Response for plane " << fThisPlane << " read from cache, no field and electronics response histograms" << std::endl;
+
     fFilter->outputHistograms(dir);
     
     // Now make hists for the full response
@@ -0,0 +1,349 @@
+/**
+ * @file   icaruscode/Utilities/ADCCountHistogram.h
+ * @brief  Counting histogram of integral ADC values and its statistics.
+ * @date   October 19, 2026
+ *
+ * This library is header only.
+ */
+
+#ifndef ICARUSCODE_UTILITIES_ADCCOUNTHISTOGRAM_H
+#define ICARUSCODE_UTILITIES_ADCCOUNTHISTOGRAM_H
+
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::minmax_element(), std::min()
+#include <limits> // std::numeric_limits<>
+#include <type_traits> // std::is_integral_v
+#include <cmath> // std::sqrt(), std::abs()
+#include <cstddef> // std::size_t
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::ns::util {
+
+  template <typename ADC = short> class ADCCountHistogram;
+
+} // namespace icarus::ns::util
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Counts of each ADC value in a waveform, with statistics from them.
+ * @tparam ADC type of the ADC values (must be integral)
+ *
+ * Waveform samples are integral numbers spanning a limited range (12 or 14
+ * bits at most), so a histogram with one bin per ADC value holds all the
+ * information needed by order statistics (mode, median, truncation by
+ * distance from a reference) without sorting the samples.
+ * The histogram spans only the range between the smallest and largest sample
+ * of the waveform; filling it takes a pass to find that range and one to
+ * count, and the statistics cost a walk through the bins at most.
+ *
+ * The same object can be filled again with another waveform, reusing its
+ * memory.
+ *
+ * Example:
+ * ~~~~{.cpp}
+ * icarus::ns::util::ADCCountHistogram<short> const counts
+ *   { waveform.begin(), waveform.end() };
+ *
+ * // average of the samples within 3 counts of the most probable one
+ * float const baseline = counts.sumsAround(counts.mode(), 3).mean();
+ * ~~~~
+ *
+ */
+template <typename ADC>
+class icarus::ns::util::ADCCountHistogram {
+
+  static_assert(std::is_integral_v<ADC>, "ADC values must be integral.");
+
+    public:
+
+  using ADC_t = ADC; ///< Type of ADC value.
+  using Count_t = unsigned int; ///< Type of the count in a bin.
+
+  /**
+   * @brief Sums of the deviations of entries from a reference value.
+   *
+   * Each included entry with value `v` contributes `v - reference` to `sum`
+   * and its square to `sumSq`.
+   */
+  struct Sums {
+    double reference = 0.0; ///< Value the deviations are computed from.
+    std::size_t n = 0U; ///< Number of entries included.
+    double sum = 0.0; ///< Sum of the deviations.
+    double sumSq = 0.0; ///< Sum of the squares of the deviations.
+
+    /// Returns the average of the included entries (`reference` if none).
+    double mean() const { return n? reference + sum / n: reference; }
+
+    /// Returns the RMS of the entries around `reference` (`0` if none).
+    double rms() const { return n? std::sqrt(sumSq / n): 0.0; }
+
+  }; // Sums
+
+
+  /// Constructor: an empty histogram.
+  ADCCountHistogram() = default;
+
+  /// Constructor: counts all the values between `begin` and `end`.
+  template <typename BIter, typename EIter>
+  ADCCountHistogram(BIter begin, EIter end) { fill(begin, end); }
+
+
+  /// Replaces the content of the histogram with the values in the range.
+  template <typename BIter, typename EIter>
+  void fill(BIter begin, EIter end);
+
+
+  // --- BEGIN -- Content ------------------------------------------------------
+  /// @name Content
+  /// @{
+
+  /// Returns whether no value was counted.
+  bool empty() const { return fEntries == 0U; }
+
+  /// Returns the number of counted values.
+  std::size_t nEntries() const { return fEntries; }
+
+  /// Returns the smallest counted value (undefined if `empty()`).
+  ADC_t min() const { return fMin; }
+
+  /// Returns the largest counted value (undefined if `empty()`).
+  ADC_t max() const { return fMin + static_cast<ADC_t>(fCounts.size() - 1); }
+
+  /// Returns how many times `value` was counted.
+  Count_t count(ADC_t value) const;
+
+  /// @}
+  // --- END ---- Content ------------------------------------------------------
+
+
+  // --- BEGIN -- Statistics ---------------------------------------------------
+  /// @name Statistics
+  /// @{
+
+  /**
+   * @brief Returns the most frequent value (undefined if `empty()`).
+   *
+   * When more values share the largest count, the one which reached that
+   * count first while filling is returned.
+   */
+  ADC_t mode() const { return fMode; }
+
+  /// Returns the number of entries with the most frequent value.
+  Count_t modeCount() const { return fModeCount; }
+
+  /**
+   * @brief Returns the value which would be at position `index` if sorted.
+   * @param index position in the sorted sample (`0` is the smallest)
+   * @return the value at `index`, or `max()` if `index` is out of range
+   */
+  ADC_t nthValue(std::size_t index) const;
+
+  /// Returns the median, as the value in the middle of the sorted sample.
+  ADC_t median() const { return nthValue(fEntries / 2); }
+
+  /**
+   * @brief Sums of the values within `halfWidth` of `center`.
+   * @param center the central value of the window
+   * @param halfWidth the entries within this distance from center are used
+   * @return the sums of deviations from `center` of the values in the window
+   */
+  Sums sumsAround(ADC_t center, unsigned int halfWidth) const;
+
+  /**
+   * @brief Sums of the values no farther than `maxDeviation` from `reference`.
+   * @param reference the value to compute the deviations from
+   * @param maxDeviation entries deviating more than this are excluded
+   * @return the sums of deviations from `reference` of the selected values
+   *
+   * With the default `maxDeviation`, all the entries are included.
+   */
+  Sums deviations(
+    double reference,
+    double maxDeviation = std::numeric_limits<double>::infinity()
+    ) const;
+
+  /**
+   * @brief Sums of the `nKeep` values closest to `reference`.
+   * @param reference the value to compute the deviations from
+   * @param nKeep how many entries to include
+   * @return the sums of deviations from `reference` of the selected values
+   *
+   * This is the sum of a truncated sample, sorted by distance from
+   * `reference`. If `nKeep` is larger than the number of entries, all entries
+   * are included.
+   */
+  Sums closestTo(double reference, std::size_t nKeep) const;
+
+  /// @}
+  // --- END ---- Statistics ---------------------------------------------------
+
+
+    private:
+
+  std::vector<Count_t> fCounts; ///< Count per value, starting from `fMin`.
+  ADC_t fMin = 0; ///< Value of the first bin.
+  std::size_t fEntries = 0U; ///< Number of counted values.
+  ADC_t fMode = 0; ///< Most frequent value.
+  Count_t fModeCount = 0U; ///< Count of the most frequent value.
+
+  /// Returns the value of the bin with the specified index.
+  ADC_t binValue(std::size_t iBin) const
+    { return fMin + static_cast<ADC_t>(iBin); }
+
+  /// Adds the content of the bin with the specified index to `sums`.
+  void addBin(Sums& sums, std::size_t iBin, Count_t count) const;
+
+}; // icarus::ns::util::ADCCountHistogram<>
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename ADC>
+template <typename BIter, typename EIter>
+void icarus::ns::util::ADCCountHistogram<ADC>::fill(BIter begin, EIter end) {
+
+  fEntries = 0U;
+  fModeCount = 0U;
+  fCounts.clear();
+  if (begin == end) return;
+
+  auto const [ itMin, itMax ] = std::minmax_element(begin, end);
+  fMin = *itMin;
+  fCounts.assign(static_cast<std::size_t>(*itMax - *itMin) + 1U, 0U);
+
+  for (auto it = begin; it != end; ++it) {
+    Count_t const count = ++fCounts[static_cast<std::size_t>(*it - fMin)];
+    if (count > fModeCount) {
+      fModeCount = count;
+      fMode = *it;
+    }
+    ++fEntries;
+  } // for
+
+} // icarus::ns::util::ADCCountHistogram<>::fill()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+auto icarus::ns::util::ADCCountHistogram<ADC>::count(ADC_t value) const
+  -> Count_t
+{
+  if (empty() || (value < fMin)) return 0U;
+  std::size_t const iBin = static_cast<std::size_t>(value - fMin);
+  return (iBin < fCounts.size())? fCounts[iBin]: 0U;
+} // icarus::ns::util::ADCCountHistogram<>::count()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+auto icarus::ns::util::ADCCountHistogram<ADC>::nthValue
+  (std::size_t index) const -> ADC_t
+{
+  std::size_t cumulative = 0U;
+  for (std::size_t iBin = 0U; iBin < fCounts.size(); ++iBin) {
+    cumulative += fCounts[iBin];
+    if (cumulative > index) return binValue(iBin);
+  }
+  return max();
+} // icarus::ns::util::ADCCountHistogram<>::nthValue()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+auto icarus::ns::util::ADCCountHistogram<ADC>::sumsAround
+  (ADC_t center, unsigned int halfWidth) const -> Sums
+{
+  Sums sums;
+  sums.reference = center;
+  if (empty()) return sums;
+
+  // work with signed bin indices, since the window may start before `fMin`
+  long int const first = std::max(
+    static_cast<long int>(center) - static_cast<long int>(halfWidth)
+      - static_cast<long int>(fMin),
+    0L
+    );
+  long int const last = std::min(
+    static_cast<long int>(center) + static_cast<long int>(halfWidth)
+      - static_cast<long int>(fMin),
+    static_cast<long int>(fCounts.size()) - 1L
+    );
+  for (long int iBin = first; iBin <= last; ++iBin)
+    addBin(sums, static_cast<std::size_t>(iBin), fCounts[iBin]);
+
+  return sums;
+} // icarus::ns::util::ADCCountHistogram<>::sumsAround()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+auto icarus::ns::util::ADCCountHistogram<ADC>::deviations
+  (double reference, double maxDeviation) const -> Sums
+{
+  Sums sums;
+  sums.reference = reference;
+  for (std::size_t iBin = 0U; iBin < fCounts.size(); ++iBin) {
+    if (fCounts[iBin] == 0U) continue;
+    if (std::abs(binValue(iBin) - reference) > maxDeviation) continue;
+    addBin(sums, iBin, fCounts[iBin]);
+  }
+  return sums;
+} // icarus::ns::util::ADCCountHistogram<>::deviations()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+auto icarus::ns::util::ADCCountHistogram<ADC>::closestTo
+  (double reference, std::size_t nKeep) const -> Sums
+{
+  Sums sums;
+  sums.reference = reference;
+  if (empty()) return sums;
+
+  // two fronts move away from the reference, the closer one advancing first;
+  // `below` is one past the next bin below, `above` the next bin above
+  long int const nBins = static_cast<long int>(fCounts.size());
+  long int above = std::clamp(
+    static_cast<long int>(std::ceil(reference - fMin)), 0L, nBins
+    );
+  long int below = above;
+
+  std::size_t left = std::min(nKeep, fEntries);
+  while (left > 0U) {
+    bool const takeBelow = (above >= nBins) || ((below > 0L)
+      && (reference - binValue(below - 1) <= binValue(above) - reference));
+    long int const iBin = takeBelow? --below: above++;
+
+    Count_t const count = static_cast<Count_t>
+      (std::min<std::size_t>(fCounts[iBin], left));
+    addBin(sums, static_cast<std::size_t>(iBin), count);
+    left -= count;
+  } // while
+
+  return sums;
+} // icarus::ns::util::ADCCountHistogram<>::closestTo()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+void icarus::ns::util::ADCCountHistogram<ADC>::addBin
+  (Sums& sums, std::size_t iBin, Count_t count) const
+{
+  if (count == 0U) return;
+  double const dev = binValue(iBin) - sums.reference;
+  sums.n += count;
+  sums.sum += count * dev;
+  sums.sumSq += count * dev * dev;
+} // icarus::ns::util::ADCCountHistogram<>::addBin()
+
+
+// -----------------------------------------------------------------------------
+
+
+#endif // ICARUSCODE_UTILITIES_ADCCOUNTHISTOGRAM_H
@@ -18,11 +18,19 @@
 #include "art/Framework/Principal/Event.h"
 #include "art/Persistency/Common/PtrMaker.h"
 #include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Common/EDProductGetter.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
 
 // C/C++ standard libraries
 #include <map>
 #include <vector>
+#include <algorithm> // std::upper_bound(), std::sort()
+#include <functional> // std::less<>
+#include <iterator> // std::prev()
+#include <stdexcept> // std::out_of_range
+#include <string>
 #include <type_traits> // std::is_same_v
+#include <cstddef> // std::size_t, std::ptrdiff_t
 
 
 namespace util {
@@ -45,6 +53,8 @@ namespace util {
   template <typename T>
   using DataProductPointerMap_t = details::DataProductPointerMap_t<T>;
 
+  template <typename T> class DataProductPointerIndex;
+
 
   // ---------------------------------------------------------------------------
   /**
@@ -95,23 +105,150 @@ namespace util {
    * a small overhead, but it uses more memory.
    *
    * @note The returned object is currently a C++ STL data container.
-   *       Optimizations are possible using a different data structure
-   *       (for example, a vector-based container with index based on the
-   *       difference described in the example above) and they may in future
-   *       be implemented. Because of this reason, it is recommended that the
+   *       Because of this reason, it is recommended that the
    *       produced map is stored in variables declared with an `auto const&`
    *       type or as a `DataProductPointerMap_t` instance, rather than with
    *       the currently underlying data type.
+   *       An object based on the difference of addresses described in the
+   *       example above is returned by `indexDataProductPointers()`, which is
+   *       faster to create and uses almost no memory.
    */
   template <typename Handle>
   DataProductPointerMap_t<ArtHandleData_t<Handle>> mapDataProductPointers
     (art::Event const& event, Handle const& handle);
 
+
+  /**
+   * @brief Creates an index from address of data product element to _art_
+   *        pointer to it.
+   * @tparam Handle type of handle to data product (e.g. `art::ValidHandle`)
+   * @tparam OtherHandles types of handles to more data products
+   * @param event the _art_ event the data products belong to
+   * @param handle _art_ handle to the data product
+   * @param otherHandles _art_ handles to more data products of the same type
+   * @return an index from data product element pointer to _art_ pointer
+   * @see `mapDataProductPointers()`, `util::DataProductPointerIndex`
+   *
+   * This is an alternative to `mapDataProductPointers()` with the same
+   * interface, which instead of storing a pointer for each element computes
+   * the index of the element from its address in the data product vector.
+   * Its creation does not depend on the size of the data products.
+   * Elements from all the data products of the specified handles can be
+   * looked up.
+   */
+  template <typename Handle, typename... OtherHandles>
+  DataProductPointerIndex<ArtHandleData_t<Handle>> indexDataProductPointers(
+    art::Event const& event,
+    Handle const& handle, OtherHandles const&... otherHandles
+    );
+
   // ---------------------------------------------------------------------------
 
 } // namespace util
 
 
+// -----------------------------------------------------------------------------
+/**
+ * @brief Finds the _art_ pointer to an element of vector data products.
+ * @tparam T type of the data product elements
+ * @see `util::indexDataProductPointers()`
+ *
+ * The object keeps the address range of each registered data product
+ * (`std::vector<T>`), and the _art_ pointer to an element is made out of
+ * the distance of the element address from the start of its data product.
+ * The interface is the same as the one of the maps returned by
+ * `util::mapDataProductPointers()`, except that the _art_ pointers are
+ * returned by value.
+ *
+ * Lookup in a single data product takes a constant time; with more data
+ * products, a binary search on the products is performed.
+ * The data products must stay in memory as long as this object is used
+ * (which is the case for data products read from the current _art_ event).
+ */
+template <typename T>
+class util::DataProductPointerIndex {
+
+    public:
+
+  using Data_t = T; ///< Type of the elements of the data products.
+
+  /// Type of _art_ pointer returned.
+  using Ptr_t = art::Ptr<Data_t>;
+
+  /// Registers all the elements of the data product in `handle`.
+  template <typename Handle>
+  void add(art::Event const& event, Handle const& handle);
+
+  /**
+   * @brief Registers all the elements of the data product `data`.
+   * @param data the content of the data product
+   * @param id ID of the data product
+   * @param productGetter getter of the data product (for dereferencing)
+   *
+   * The _art_ pointers are created with `id` and `productGetter`; an empty
+   * `data` is not registered.
+   */
+  void add(
+    std::vector<Data_t> const& data,
+    art::ProductID const& id, art::EDProductGetter const* productGetter
+    );
+
+  /// Returns the _art_ pointer to `ptr` (undefined if not registered).
+  Ptr_t operator[] (Data_t const* ptr) const
+    { Product_t const& product = *findProduct(ptr); return product.ptr(ptr); }
+
+  /// Returns the _art_ pointer to `ptr`.
+  /// @throw std::out_of_range if `ptr` is not an element of any data product
+  Ptr_t at(Data_t const* ptr) const;
+
+  /// Returns whether `ptr` points to an element of a registered data product.
+  bool contains(Data_t const* ptr) const;
+
+  /// Returns whether no elements are registered.
+  bool empty() const { return size() == 0U; }
+
+  /// Returns the total number of elements registered.
+  std::size_t size() const;
+
+  /// Removes all the registered data products.
+  void clear() { fProducts.clear(); }
+
+    private:
+
+  /// Record of one data product.
+  struct Product_t {
+
+    Data_t const* begin = nullptr; ///< Address of the first element.
+    Data_t const* end = nullptr; ///< Address past the last element.
+    art::ProductID id; ///< ID of this product.
+    art::EDProductGetter const* productGetter = nullptr; ///< Its getter.
+
+    /// Returns whether `ptr` is an element of this product.
+    bool contains(Data_t const* ptr) const
+      {
+        return std::less<>{}(ptr, end) && !std::less<>{}(ptr, begin);
+      }
+
+    /// Returns the _art_ pointer to `elem`, element of this product.
+    Ptr_t ptr(Data_t const* elem) const
+      {
+        return Ptr_t{
+          id, static_cast<typename Ptr_t::key_type>(elem - begin),
+          productGetter
+          };
+      }
+
+  }; // Product_t
+
+  /// All registered data products, sorted by address.
+  std::vector<Product_t> fProducts;
+
+  /// Returns the product which may contain `ptr` (`nullptr` if surely none).
+  Product_t const* findProduct(Data_t const* ptr) const;
+
+}; // util::DataProductPointerIndex
+
+
 // -----------------------------------------------------------------------------
 // ---  template implementation
 // -----------------------------------------------------------------------------
@@ -136,6 +273,101 @@ auto util::mapDataProductPointers(art::Event const& event, Handle const& handle)
 } // util::mapDataProductPointers()
 
 
+//------------------------------------------------------------------------------
+template <typename Handle, typename... OtherHandles>
+auto util::indexDataProductPointers(
+  art::Event const& event,
+  Handle const& handle, OtherHandles const&... otherHandles
+) -> DataProductPointerIndex<ArtHandleData_t<Handle>>
+{
+  DataProductPointerIndex<ArtHandleData_t<Handle>> index;
+  index.add(event, handle);
+  (index.add(event, otherHandles), ...);
+  return index;
+} // util::indexDataProductPointers()
+
+
+// -----------------------------------------------------------------------------
+// --- util::DataProductPointerIndex
+// -----------------------------------------------------------------------------
+template <typename T>
+template <typename Handle>
+void util::DataProductPointerIndex<T>::add
+  (art::Event const& event, Handle const& handle)
+{
+  static_assert(
+    std::is_same_v<std::vector<Data_t>, typename Handle::element_type>,
+    "DataProductPointerIndex::add() requires handles to STL vectors of data"
+    );
+
+  add(*handle, handle.id(), event.productGetter(handle.id()));
+} // util::DataProductPointerIndex<>::add()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void util::DataProductPointerIndex<T>::add(
+  std::vector<Data_t> const& data,
+  art::ProductID const& id, art::EDProductGetter const* productGetter
+) {
+  if (data.empty()) return;
+
+  fProducts.push_back
+    ({ data.data(), data.data() + data.size(), id, productGetter });
+  std::sort(fProducts.begin(), fProducts.end(),
+    [](Product_t const& a, Product_t const& b)
+      { return std::less<>{}(a.begin, b.begin); }
+    );
+} // util::DataProductPointerIndex<>::add()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+auto util::DataProductPointerIndex<T>::at(Data_t const* ptr) const -> Ptr_t {
+  Product_t const* product = findProduct(ptr);
+  if (!product || !product->contains(ptr)) {
+    throw std::out_of_range(
+      "util::DataProductPointerIndex: element not in any registered data product"
+      );
+  }
+  return product->ptr(ptr);
+} // util::DataProductPointerIndex<>::at()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+bool util::DataProductPointerIndex<T>::contains(Data_t const* ptr) const {
+  Product_t const* product = findProduct(ptr);
+  return product && product->contains(ptr);
+} // util::DataProductPointerIndex<>::contains()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+std::size_t util::DataProductPointerIndex<T>::size() const {
+  std::size_t n = 0U;
+  for (Product_t const& product: fProducts) n += product.end - product.begin;
+  return n;
+} // util::DataProductPointerIndex<>::size()
+
+
+// -----------------------------------------------------------------------------
+template <typename T>
+auto util::DataProductPointerIndex<T>::findProduct(Data_t const* ptr) const
+  -> Product_t const*
+{
+  // the common case of a single data product
+  if (fProducts.size() == 1U) return &fProducts.front();
+
+  // last product starting at or before `ptr`
+  auto const iNext = std::upper_bound(fProducts.begin(), fProducts.end(), ptr,
+    [](Data_t const* ptr, Product_t const& product)
+      { return std::less<>{}(ptr, product.begin); }
+    );
+  return (iNext == fProducts.begin())? nullptr: &*std::prev(iNext);
+} // util::DataProductPointerIndex<>::findProduct()
+
+
 // -----------------------------------------------------------------------------
 
 #endif // ICARUSCODE_UTILITIES_DATAPRODUCTPOINTERMAP_H
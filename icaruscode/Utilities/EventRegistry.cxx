@@ -83,10 +83,11 @@ auto sbn::EventRegistry::eventRecord(art::EventID const& event) const
   -> std::optional<EventRecord_t>
 {
   
-  auto const lg = lockEventRegistry();
+  EventRegistryShard_t const& shard = shardFor(event);
+  auto const lg = lockShard(shard);
   // BEGIN needs lock
-  auto const iRecord = fEventRegistry.find(event);
-  return (iRecord != fEventRegistry.end())
+  auto const iRecord = shard.events.find(event);
+  return (iRecord != shard.events.end())
     ? std::optional{ iRecord->second }: std::nullopt;
   // END needs lock
   
@@ -97,9 +98,10 @@ auto sbn::EventRegistry::eventRecord(art::EventID const& event) const
 auto sbn::EventRegistry::recordEvent
   (EventID_t const& event, FileID_t sourceFileID) -> EventRecord_t
 {
-  auto const lg = lockEventRegistry();
+  EventRegistryShard_t& shard = shardFor(event);
+  auto const lg = lockShard(shard);
   // BEGIN needs lock
-  auto& record = fEventRegistry[event];
+  auto& record = shard.events[event];
   record.sourceFiles.push_back(sourceFileID);
   return record;
   // END needs lock
@@ -121,19 +123,40 @@ auto sbn::EventRegistry::findSource(std::string const& fileName) const
 void sbn::EventRegistry::copyEventRecordsInto
   (std::vector<EventIDandRecord_t>& recordCopy) const
 {
-  recordCopy.reserve(fEventRegistry.size()); // bet size does not change
-  auto const lg = lockEventRegistry();
-  // BEGIN needs lock
-  recordCopy.reserve(fEventRegistry.size()); // has size() changed already?
-  std::copy(fEventRegistry.cbegin(), fEventRegistry.cend(),
-    std::back_inserter(recordCopy));
-  // END needs lock
-} // sbn::EventRegistry::records()
+  for (EventRegistryShard_t const& shard: fEventRegistry) {
+    auto const lg = lockShard(shard);
+    // BEGIN needs lock
+    recordCopy.reserve(recordCopy.size() + shard.events.size());
+    std::copy(shard.events.cbegin(), shard.events.cend(),
+      std::back_inserter(recordCopy));
+    // END needs lock
+  } // for shards
+} // sbn::EventRegistry::copyEventRecordsInto()
+
+
+// -----------------------------------------------------------------------------
+auto sbn::EventRegistry::shardFor(EventID_t const& event)
+  -> EventRegistryShard_t&
+  { return fEventRegistry[shardIndex(event)]; }
+
+auto sbn::EventRegistry::shardFor(EventID_t const& event) const
+  -> EventRegistryShard_t const&
+  { return fEventRegistry[shardIndex(event)]; }
+
+
+// -----------------------------------------------------------------------------
+std::lock_guard<std::mutex> sbn::EventRegistry::lockShard
+  (EventRegistryShard_t const& shard)
+  { return std::lock_guard{ shard.lock }; }
 
 
 // -----------------------------------------------------------------------------
-std::lock_guard<std::mutex> sbn::EventRegistry::lockEventRegistry() const
-  { return std::lock_guard{ fEventRegistryLock }; }
+std::size_t sbn::EventRegistry::shardIndex(EventID_t const& event) {
+  // the hash of the ID is mixed, since the standard one may be the identity
+  std::uint64_t const hash = std::hash<EventID_t>{}(event);
+  return static_cast<std::size_t>((hash * 0x9E3779B97F4A7C15ULL) >> 32U)
+    % NShards;
+} // sbn::EventRegistry::shardIndex()
 
 
 // -----------------------------------------------------------------------------
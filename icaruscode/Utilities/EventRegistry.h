@@ -21,6 +21,7 @@
 // C/C++ standard libraries
 #include <unordered_map>
 #include <vector>
+#include <array>
 #include <mutex>
 #include <utility> // std::pair<>
 #include <string>
@@ -28,6 +29,7 @@
 #include <optional>
 #include <limits> // std::numeric_limits<>
 #include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
 
 
 // -----------------------------------------------------------------------------
@@ -69,6 +71,13 @@ namespace sbn { class EventRegistry; }
  * Registration of events can happen concurrently (thread-safe).
  * Registration of source files, instead, is not protected.
  * 
+ * The event records are split in `NShards` independent maps, each with its own
+ * lock, and each event is assigned to one of them by its ID: concurrent
+ * registration of different events rarely contends for the same lock.
+ * A copy of all the records (`records()`) locks one shard at a time, and
+ * therefore it is not an atomic snapshot of the registry when events are being
+ * registered at the same time.
+ * 
  * It is guaranteed that the source file records are never modified once
  * registered (i.e. neither removed from the registry, nor the path of a source
  * record changed).
@@ -96,6 +105,9 @@ class sbn::EventRegistry {
   /// Mnemonic for no file ID.
   static constexpr FileID_t NoFileID = std::numeric_limits<FileID_t>::max();
   
+  /// Number of independently locked parts of the event registry.
+  static constexpr std::size_t NShards = 64U;
+  
   
   // -- BEGIN -- Source interface ----------------------------------------------
   /// @name Source interface
@@ -176,10 +188,18 @@ class sbn::EventRegistry {
   /// Registered source file, by file ID key.
   std::vector<std::string> fSourceFiles;
   
-  /// Registry of all events.
-  std::unordered_map<EventID_t, EventRecord_t> fEventRegistry;
+  /// A part of the event registry, with its lock.
+  struct alignas(64) EventRegistryShard_t {
+    
+    /// Registry of the events in this shard.
+    std::unordered_map<EventID_t, EventRecord_t> events;
+    
+    mutable std::mutex lock; ///< Lock for `events`.
+    
+  }; // EventRegistryShard_t
   
-  mutable std::mutex fEventRegistryLock; ///< Lock for `fEventRegistry`.
+  /// Registry of all events, split in shards.
+  std::array<EventRegistryShard_t, NShards> fEventRegistry;
   
   //@{
   /// Returns an iterator pointing to the specified file registry entry.
@@ -190,8 +210,16 @@ class sbn::EventRegistry {
   /// Copies all event records into `recordCopy`.
   void copyEventRecordsInto(std::vector<EventIDandRecord_t>& recordCopy) const;
 
-  /// Returns a lock guard around `fEventRegistry`.
-  std::lock_guard<std::mutex> lockEventRegistry() const;
+  /// Returns the shard of the registry hosting the specified `event`.
+  EventRegistryShard_t& shardFor(EventID_t const& event);
+  EventRegistryShard_t const& shardFor(EventID_t const& event) const;
+  
+  /// Returns a lock guard around the specified `shard`.
+  static std::lock_guard<std::mutex> lockShard
+    (EventRegistryShard_t const& shard);
+  
+  /// Returns the index of the shard hosting the specified `event`.
+  static std::size_t shardIndex(EventID_t const& event);
   
   
   /// Converts an internal index in file source registry into a `FileID_t`.
@@ -0,0 +1,243 @@
+/**
+ * @file   icaruscode/Utilities/RunningADCMedian.h
+ * @brief  Median of a changing set of integral ADC values.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Utilities/ADCCountHistogram.h`
+ *
+ * This library is header only.
+ */
+
+#ifndef ICARUSCODE_UTILITIES_RUNNINGADCMEDIAN_H
+#define ICARUSCODE_UTILITIES_RUNNINGADCMEDIAN_H
+
+
+// C/C++ standard libraries
+#include <vector>
+#include <algorithm> // std::max()
+#include <iterator> // std::distance()
+#include <limits> // std::numeric_limits<>
+#include <type_traits> // std::is_integral_v
+#include <cstddef> // std::size_t
+#include <cassert>
+
+
+// -----------------------------------------------------------------------------
+namespace icarus::ns::util {
+
+  template <typename ADC = short> class RunningADCMedian;
+
+} // namespace icarus::ns::util
+
+
+// -----------------------------------------------------------------------------
+/**
+ * @brief Median of ADC values which can be added and removed one by one.
+ * @tparam ADC type of the ADC values (must be integral)
+ *
+ * Like `ADCCountHistogram`, this object counts how many times each ADC value
+ * is present; in addition, it keeps track of the bin of the median and of the
+ * number of entries below it. Adding or removing a value moves that bin by at
+ * most one entry, so that in a baseline, where values cluster within few
+ * counts, the cost of each update does not depend on the number of values.
+ * The range of the counts grows as needed to include all added values.
+ *
+ * The median is defined as in `ADCCountHistogram::median()`, i.e. the value
+ * which would be at position `N / 2` (starting from `0`) in the sorted set.
+ *
+ * Example of a median of 101 consecutive samples, around each sample:
+ * ~~~~{.cpp}
+ * std::vector<short> const baselines = icarus::ns::util::RunningADCMedian<short>
+ *   ::slidingMedian(waveform.begin(), waveform.end(), 50U);
+ * ~~~~
+ */
+template <typename ADC>
+class icarus::ns::util::RunningADCMedian {
+
+  static_assert(std::is_integral_v<ADC>, "ADC values must be integral.");
+
+    public:
+
+  using ADC_t = ADC; ///< Type of ADC value.
+  using Count_t = unsigned int; ///< Type of the count in a bin.
+
+
+  /// Adds a value.
+  void add(ADC_t value);
+
+  /// Removes a value, which must have been added before.
+  void remove(ADC_t value);
+
+  /// Removes all values (the memory for the counts is kept).
+  void clear();
+
+  /// Returns whether there is no value.
+  bool empty() const { return fEntries == 0U; }
+
+  /// Returns the number of values.
+  std::size_t size() const { return fEntries; }
+
+  /// Returns the median of the current values (undefined if `empty()`).
+  ADC_t median() const { return binValue(fMedianBin); }
+
+
+  /**
+   * @brief Returns the median of the values around each one in a range.
+   * @param begin iterator to the first value
+   * @param end iterator past the last value
+   * @param halfWindow number of values before and after each one to include
+   * @return the median of the window around each value in the range
+   *
+   * Windows at the border of the range are truncated.
+   */
+  template <typename BIter, typename EIter>
+  static std::vector<ADC_t> slidingMedian
+    (BIter begin, EIter end, std::size_t halfWindow);
+
+
+    private:
+
+  std::vector<Count_t> fCounts; ///< Count per value, starting from `fMin`.
+  ADC_t fMin = 0; ///< Value of the first bin.
+  std::size_t fEntries = 0U; ///< Number of values.
+  std::size_t fMedianBin = 0U; ///< Bin of the median value.
+  std::size_t fBelow = 0U; ///< Number of values in bins before `fMedianBin`.
+
+  /// Returns the value of the bin with the specified index.
+  ADC_t binValue(std::size_t iBin) const
+    { return fMin + static_cast<ADC_t>(iBin); }
+
+  /// Extends the counts to include `value`, returning its bin.
+  std::size_t binFor(ADC_t value);
+
+  /// Moves the median bin to the one holding the entry at position `N / 2`.
+  void updateMedian();
+
+}; // icarus::ns::util::RunningADCMedian<>
+
+
+// -----------------------------------------------------------------------------
+// ---  template implementation
+// -----------------------------------------------------------------------------
+template <typename ADC>
+void icarus::ns::util::RunningADCMedian<ADC>::add(ADC_t value) {
+
+  std::size_t const iBin = binFor(value);
+  ++fCounts[iBin];
+  ++fEntries;
+  if (iBin < fMedianBin) ++fBelow;
+  updateMedian();
+
+} // icarus::ns::util::RunningADCMedian<>::add()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+void icarus::ns::util::RunningADCMedian<ADC>::remove(ADC_t value) {
+
+  assert(!empty());
+  assert(value >= fMin);
+  std::size_t const iBin = static_cast<std::size_t>(value - fMin);
+  assert(iBin < fCounts.size());
+  assert(fCounts[iBin] > 0U);
+
+  --fCounts[iBin];
+  --fEntries;
+  if (iBin < fMedianBin) --fBelow;
+  if (empty()) fMedianBin = fBelow = 0U;
+  else updateMedian();
+
+} // icarus::ns::util::RunningADCMedian<>::remove()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+void icarus::ns::util::RunningADCMedian<ADC>::clear() {
+
+  std::fill(fCounts.begin(), fCounts.end(), 0U);
+  fEntries = fMedianBin = fBelow = 0U;
+
+} // icarus::ns::util::RunningADCMedian<>::clear()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+template <typename BIter, typename EIter>
+auto icarus::ns::util::RunningADCMedian<ADC>::slidingMedian
+  (BIter begin, EIter end, std::size_t halfWindow) -> std::vector<ADC_t>
+{
+  std::size_t const n = std::distance(begin, end);
+  std::vector<ADC_t> medians;
+  medians.reserve(n);
+
+  RunningADCMedian<ADC> window;
+
+  // `front` is the next value to enter the window, `back` the next to leave
+  BIter front = begin, back = begin;
+  std::size_t iFront = 0U;
+  for (; (iFront < n) && (iFront < halfWindow); ++iFront, ++front)
+    window.add(*front);
+
+  for (std::size_t i = 0U; i < n; ++i) {
+    if (iFront < n) {
+      window.add(*front);
+      ++front;
+      ++iFront;
+    }
+    if (i > halfWindow) {
+      window.remove(*back);
+      ++back;
+    }
+    medians.push_back(window.median());
+  } // for
+
+  return medians;
+} // icarus::ns::util::RunningADCMedian<>::slidingMedian()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+std::size_t icarus::ns::util::RunningADCMedian<ADC>::binFor(ADC_t value) {
+
+  if (fCounts.empty()) {
+    fMin = value;
+    fCounts.assign(1U, 0U);
+    return 0U;
+  }
+
+  if (value < fMin) {
+    // grow downward (at least doubling, within the range of `ADC_t`),
+    // shifting all the bins
+    std::size_t const nNew = std::min(
+      std::max(static_cast<std::size_t>(fMin - value), fCounts.size()),
+      static_cast<std::size_t>(fMin - std::numeric_limits<ADC_t>::lowest())
+      );
+    fCounts.insert(fCounts.begin(), nNew, 0U);
+    fMin -= static_cast<ADC_t>(nNew);
+    fMedianBin += nNew;
+  }
+  std::size_t const iBin = static_cast<std::size_t>(value - fMin);
+  if (iBin >= fCounts.size())
+    fCounts.resize(std::max(iBin + 1U, 2U * fCounts.size()), 0U);
+
+  return iBin;
+
+} // icarus::ns::util::RunningADCMedian<>::binFor()
+
+
+// -----------------------------------------------------------------------------
+template <typename ADC>
+void icarus::ns::util::RunningADCMedian<ADC>::updateMedian() {
+
+  std::size_t const target = fEntries / 2;
+
+  // invariant: fBelow <= target < fBelow + fCounts[fMedianBin]
+  while (target < fBelow) fBelow -= fCounts[--fMedianBin];
+  while (target >= fBelow + fCounts[fMedianBin]) fBelow += fCounts[fMedianBin++];
+
+} // icarus::ns::util::RunningADCMedian<>::updateMedian()
+
+
+// -----------------------------------------------------------------------------
+
+
+#endif // ICARUSCODE_UTILITIES_RUNNINGADCMEDIAN_H
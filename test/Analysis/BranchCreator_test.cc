@@ -0,0 +1,157 @@
+/**
+ * @file   test/Analysis/BranchCreator_test.cc
+ * @brief  Unit test for `BranchCreator.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Analysis/Algorithms/BranchCreator.h`
+ *
+ * The variable length branches of `AnalysisTree` (`VariableLengthHits` mode)
+ * are created from vectors of fundamental types: their content must be read
+ * back entry by entry with its own size, also after the vectors are moved
+ * and the branches reconnected, as done with `UseBuffers: false`.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Analysis/Algorithms/BranchCreator.h"
+
+// ROOT libraries
+#include "TTree.h"
+#include "TBranch.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( BranchCreator_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Content of the event `iEntry` (its size changes with the entry).
+  template <typename T>
+  std::vector<T> entryContent(int iEntry, int offset)
+    {
+      std::vector<T> content;
+      for (int i = 0; i < (iEntry * 7) % 5; ++i)
+        content.push_back(static_cast<T>(offset + 10 * iEntry + i));
+      return content;
+    }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- BranchCreator tests
+// -----------------------------------------------------------------------------
+void BranchCreator_variableLength_test() {
+
+  constexpr int NEntries = 6;
+
+  auto tree = std::make_unique<TTree>("BranchCreatorTest", "BranchCreator test");
+  tree->SetDirectory(nullptr);
+
+  Int_t no_hits = 0;
+  auto wire = std::make_unique<std::vector<Short_t>>();
+  auto charge = std::make_unique<std::vector<Float_t>>();
+  auto nHits = std::make_unique<std::vector<Int_t>>();
+
+  icarus::BranchCreator CreateBranch(tree.get());
+
+  // the branches are created, one per name, with the vector type
+  CreateBranch("no_hits", &no_hits, "no_hits/I");
+  CreateBranch("hit_wire", *wire);
+  CreateBranch("hit_charge", *charge);
+  CreateBranch("ntrkhits", *nHits);
+  BOOST_CHECK_EQUAL(tree->GetListOfBranches()->GetEntries(), 4);
+  BOOST_TEST_REQUIRE(tree->GetBranch("hit_wire"));
+  BOOST_CHECK_EQUAL
+    (std::string(tree->GetBranch("hit_wire")->GetClassName()), "vector<short>");
+  BOOST_CHECK_EQUAL
+    (std::string(tree->GetBranch("hit_charge")->GetClassName()), "vector<float>");
+  BOOST_CHECK_EQUAL
+    (std::string(tree->GetBranch("ntrkhits")->GetClassName()), "vector<int>");
+
+  // a second call with the same data leaves the branches alone
+  CreateBranch("hit_wire", *wire);
+  BOOST_CHECK_EQUAL(tree->GetListOfBranches()->GetEntries(), 4);
+
+  for (int iEntry = 0; iEntry < NEntries; ++iEntry) {
+
+    // on some entries the data is replaced by a new object, and reconnected
+    if (iEntry % 2 == 1) {
+      wire = std::make_unique<std::vector<Short_t>>();
+      charge = std::make_unique<std::vector<Float_t>>();
+      CreateBranch("hit_wire", *wire);
+      CreateBranch("hit_charge", *charge);
+      CreateBranch("ntrkhits", *nHits);
+    }
+
+    *wire = entryContent<Short_t>(iEntry, 0);
+    *charge = entryContent<Float_t>(iEntry, 1000);
+    *nHits = entryContent<Int_t>(iEntry + 1, -5);
+    no_hits = wire->size();
+    tree->Fill();
+  } // for
+  BOOST_CHECK_EQUAL(tree->GetListOfBranches()->GetEntries(), 4);
+  BOOST_CHECK_EQUAL(tree->GetEntries(), NEntries);
+
+  // read back the content, into new objects
+  std::vector<Short_t> readWire;
+  std::vector<Float_t> readCharge;
+  std::vector<Int_t> readNHits;
+  CreateBranch("hit_wire", readWire);
+  CreateBranch("hit_charge", readCharge);
+  CreateBranch("ntrkhits", readNHits);
+
+  for (int iEntry = 0; iEntry < NEntries; ++iEntry) {
+    BOOST_TEST_MESSAGE("Entry #" << iEntry);
+    tree->GetEntry(iEntry);
+
+    std::vector<Short_t> const expectedWire = entryContent<Short_t>(iEntry, 0);
+    std::vector<Float_t> const expectedCharge
+      = entryContent<Float_t>(iEntry, 1000);
+    std::vector<Int_t> const expectedNHits = entryContent<Int_t>(iEntry + 1, -5);
+
+    BOOST_CHECK_EQUAL(no_hits, static_cast<Int_t>(expectedWire.size()));
+    BOOST_CHECK_EQUAL_COLLECTIONS(readWire.begin(), readWire.end(),
+      expectedWire.begin(), expectedWire.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(readCharge.begin(), readCharge.end(),
+      expectedCharge.begin(), expectedCharge.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(readNHits.begin(), readNHits.end(),
+      expectedNHits.begin(), expectedNHits.end());
+  } // for
+
+} // BranchCreator_variableLength_test()
+
+
+void BranchCreator_noTree_test() {
+
+  // without a tree, nothing happens
+  std::vector<Float_t> data { 1.0f, 2.0f };
+  Int_t n = 2;
+  icarus::BranchCreator CreateBranch(nullptr);
+  CreateBranch("data", data);
+  CreateBranch("n", &n, "n/I");
+  BOOST_CHECK_EQUAL(data.size(), 2U);
+
+} // BranchCreator_noTree_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(BranchCreator_testcase) {
+
+  BranchCreator_variableLength_test();
+  BranchCreator_noTree_test();
+
+} // BOOST_AUTO_TEST_CASE(BranchCreator_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+/**
+ * @file   test/Analysis/PurityFitKernels_test.cc
+ * @brief  Unit test for `PurityFitKernels.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Analysis/Algorithms/PurityFitKernels.h`
+ *
+ * The closed-form fits are checked against exact straight lines and against
+ * lines with known Gaussian residuals, and the incremental regression is
+ * checked to match a fit from scratch after points are removed.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Analysis/Algorithms/PurityFitKernels.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PurityFitKernels_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK_CLOSE()
+
+// C/C++ standard library
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+// --- PurityFitKernels tests
+// -----------------------------------------------------------------------------
+void PurityFitKernels_exactLine_test() {
+
+  // log(area) vs. drift time for a 3 ms lifetime
+  std::vector<double> time, logArea;
+  for (int i = 0; i < 50; ++i) {
+    time.push_back(100.0 + 40.0 * i);
+    logArea.push_back(std::log(1500.0) - time.back() / 3000.0);
+  }
+
+  auto const fit
+    = icarus::purity::linearFit(time.data(), logArea.data(), time.size());
+  BOOST_CHECK(fit.valid);
+  BOOST_CHECK_EQUAL(fit.nPoints, time.size());
+  BOOST_CHECK_CLOSE(fit.slope, -1.0 / 3000.0, 1e-8);
+  BOOST_CHECK_CLOSE(fit.intercept, std::log(1500.0), 1e-8);
+  BOOST_CHECK_SMALL(fit.chi2, 1e-12);
+
+  // a single point (or a single x) is not a line
+  auto const bad = icarus::purity::linearFit(time.data(), logArea.data(), 1);
+  BOOST_CHECK(!bad.valid);
+
+} // PurityFitKernels_exactLine_test()
+
+
+void PurityFitKernels_noisyLine_test() {
+
+  constexpr double Sigma = 0.25;
+
+  std::mt19937 gen { 1234 };
+  std::normal_distribution<double> gaus { 0.0, Sigma };
+
+  std::vector<double> x, y;
+  for (int i = 0; i < 5000; ++i) {
+    x.push_back(0.5 * i);
+    y.push_back(2.0 - 0.001 * x.back() + gaus(gen));
+  }
+
+  auto const fit = icarus::purity::linearFit(x.data(), y.data(), x.size(), Sigma);
+
+  BOOST_CHECK_CLOSE(
+    icarus::purity::linearFitChi2(fit, x.data(), y.data(), x.size(), Sigma),
+    fit.chi2, 1e-8
+    );
+
+  BOOST_CHECK_LT(std::abs(fit.slope + 0.001), 5.0 * fit.slopeError);
+  BOOST_CHECK_CLOSE(fit.chi2 / (x.size() - 2), 1.0, 5.0 /* percent */);
+
+} // PurityFitKernels_noisyLine_test()
+
+
+void PurityFitKernels_regression_test() {
+
+  std::vector<double> const x { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+  std::vector<double> const y { 1.1, 1.9, 3.2, 30.0, 4.9, 6.1 };
+
+  icarus::purity::LinearRegression regression;
+  for (std::size_t i = 0; i < x.size(); ++i) regression.add(x[i], y[i]);
+  BOOST_CHECK_EQUAL(regression.nPoints(), x.size());
+
+  // removing the outlier gives the fit of the remaining points
+  regression.remove(x[3], y[3]);
+  BOOST_CHECK_EQUAL(regression.nPoints(), x.size() - 1);
+
+  std::vector<double> const xIn { 1.0, 2.0, 3.0, 5.0, 6.0 };
+  std::vector<double> const yIn { 1.1, 1.9, 3.2, 4.9, 6.1 };
+  auto const expected
+    = icarus::purity::linearFit(xIn.data(), yIn.data(), xIn.size());
+  auto const fit = regression.fit();
+
+  BOOST_CHECK(fit.valid);
+  BOOST_CHECK_CLOSE(fit.slope, expected.slope, 1e-8);
+  BOOST_CHECK_CLOSE(fit.intercept, expected.intercept, 1e-8);
+
+  // points are counted regardless of their weight
+  regression.add(7.0, 7.0, 0.0);
+  BOOST_CHECK_EQUAL(regression.nPoints(), x.size());
+  regression.remove(7.0, 7.0, 0.0);
+  BOOST_CHECK_EQUAL(regression.nPoints(), x.size() - 1);
+
+} // PurityFitKernels_regression_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PurityFitKernels_testcase) {
+
+  PurityFitKernels_exactLine_test();
+  PurityFitKernels_noisyLine_test();
+  PurityFitKernels_regression_test();
+
+} // BOOST_AUTO_TEST_CASE(PurityFitKernels_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
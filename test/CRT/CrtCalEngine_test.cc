@@ -0,0 +1,212 @@
+/**
+ * @file   test/CRT/CrtCalEngine_test.cc
+ * @brief  Unit test for `CrtCalEngine`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/CRT/CRTDecoder/CrtCalEngine.h`
+ *
+ * The Gaussian and straight line fitters are checked on exact data, and the
+ * full calibration of a FEB on synthetic spectra with a known pedestal and
+ * gain, including channels missing some of the expected features.
+ */
+
+// ICARUS libraries
+#include "icaruscode/CRT/CRTDecoder/CrtCalEngine.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( CrtCalEngine_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <array>
+#include <cfloat> // FLT_MAX
+#include <climits> // SHRT_MAX
+#include <cmath>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+using CrtCalEngine = icarus::crt::CrtCalEngine;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  constexpr std::size_t RowSize = CrtCalEngine::kNADC + 1;
+
+  constexpr double Pedestal = 150.3;
+  constexpr double PedestalSigma = 9.0;
+  constexpr double Gain = 55.0;
+  constexpr double PeakSigma = 10.0;
+
+  double gaus(double x, double norm, double mean, double sigma)
+    { const double d = (x - mean) / sigma; return norm * std::exp(-0.5 * d * d); }
+
+
+  /**
+   * @brief Adds a synthetic spectrum to `row`.
+   * @param withPedestal whether to add the pedestal peak
+   * @param firstPeak photoelectrons of the first peak
+   * @param lastPeak photoelectrons of the last peak
+   *
+   * Contents are the expected values, rounded, so that the test is exactly
+   * reproducible.
+   */
+  void fillSpectrum
+    (uint32_t* row, bool withPedestal, unsigned int firstPeak, unsigned int lastPeak)
+  {
+    for (std::size_t adc = 0; adc < CrtCalEngine::kNADC; ++adc) {
+      double const x = adc + 0.5;
+      double content = withPedestal? gaus(x, 5000., Pedestal, PedestalSigma): 0.;
+      for (unsigned int k = firstPeak; k <= lastPeak; ++k)
+        content += gaus(x, 3000. * std::exp(-0.25 * k), Pedestal + Gain * k, PeakSigma);
+      row[adc] = static_cast<uint32_t>(std::round(content));
+    } // for
+  } // fillSpectrum()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- CrtCalEngine tests
+// -----------------------------------------------------------------------------
+void CrtCalEngine_GausFit_test() {
+
+  std::vector<double> x, y;
+  for (int i = 0; i < 200; ++i) {
+    x.push_back(i + 0.5);
+    y.push_back(gaus(i + 0.5, 800., 97.2, 6.5));
+  }
+
+  // free fit from a displaced starting point recovers the parameters
+  CrtCalEngine::GausFitResult const fit = CrtCalEngine::GausFit(
+    x.data(), y.data(), x.size(), 80., 115.,
+    { { 600., 94., 10. } }, { { 0., 80., 1. } }, { { 5000., 115., 50. } }
+    );
+  BOOST_CHECK(fit.valid);
+  BOOST_CHECK_CLOSE(fit.par[0], 800., 1e-4);
+  BOOST_CHECK_CLOSE(fit.par[1], 97.2, 1e-4);
+  BOOST_CHECK_CLOSE(fit.par[2], 6.5, 1e-4);
+  BOOST_CHECK_SMALL(fit.chi2, 1e-6);
+  BOOST_CHECK_EQUAL(fit.ndf, 35 - 3); // points with center in [80,115]
+  for (double const err: fit.err) BOOST_CHECK_GT(err, 0.);
+
+  // the mean is kept within its bounds
+  CrtCalEngine::GausFitResult const bounded = CrtCalEngine::GausFit(
+    x.data(), y.data(), x.size(), 80., 115.,
+    { { 600., 94., 10. } }, { { 0., 80., 1. } }, { { 5000., 95., 50. } }
+    );
+  BOOST_CHECK(bounded.valid);
+  BOOST_CHECK_LE(bounded.par[1], 95.);
+  BOOST_CHECK_GT(bounded.chi2, fit.chi2);
+
+  // no points in the range: no fit
+  CrtCalEngine::GausFitResult const empty = CrtCalEngine::GausFit(
+    x.data(), y.data(), x.size(), 300., 400.,
+    { { 600., 350., 10. } }, { { 0., 300., 1. } }, { { 5000., 400., 50. } }
+    );
+  BOOST_CHECK(!empty.valid);
+  BOOST_CHECK_LT(empty.ndf, 0);
+
+} // CrtCalEngine_GausFit_test()
+
+
+void CrtCalEngine_LineFit_test() {
+
+  std::vector<float> const x { 0.f, 4.f, 5.f, 6.f, 7.f };
+  std::vector<float> y, ey;
+  for (float const px: x) {
+    y.push_back(150.f + 55.f * px);
+    ey.push_back(std::sqrt(px + 81.f));
+  }
+
+  // exact points, within the bounds
+  CrtCalEngine::LineFitResult const fit
+    = CrtCalEngine::LineFit(x, y, ey, 35., 75., 120., 180.);
+  BOOST_CHECK_CLOSE(fit.gain, 55., 1e-4);
+  BOOST_CHECK_CLOSE(fit.ped, 150., 1e-4);
+  BOOST_CHECK_SMALL(fit.chi2, 1e-6);
+  BOOST_CHECK_EQUAL(fit.ndf, 3);
+  BOOST_CHECK_GT(fit.gainErr, 0.);
+  BOOST_CHECK_GT(fit.pedErr, 0.);
+
+  // a gain beyond its bound is fixed there, and the pedestal refitted
+  CrtCalEngine::LineFitResult const bounded
+    = CrtCalEngine::LineFit(x, y, ey, 35., 50., 0., 1000.);
+  BOOST_CHECK_EQUAL(bounded.gain, 50.);
+  BOOST_CHECK_GT(bounded.ped, 150.);
+  BOOST_CHECK_GT(bounded.chi2, 1.);
+
+  // all points at the same x: no fit
+  CrtCalEngine::LineFitResult const degenerate = CrtCalEngine::LineFit
+    ({ 3.f, 3.f }, { 300.f, 310.f }, { 1.f, 1.f }, 35., 75., 120., 180.);
+  BOOST_CHECK_EQUAL(degenerate.ndf, 0);
+  BOOST_CHECK_EQUAL(degenerate.chi2, 0.);
+
+} // CrtCalEngine_LineFit_test()
+
+
+void CrtCalEngine_CalibrateFEB_test() {
+
+  constexpr uint8_t Mac5 = 7;
+
+  std::vector<uint32_t> spectra(CrtCalEngine::kNChan * RowSize, 0U);
+  auto row = [&spectra](std::size_t chan){ return spectra.data() + chan * RowSize; };
+
+  fillSpectrum(row(0), true, 1U, 20U);  // complete spectrum
+  fillSpectrum(row(1), true, 1U, 0U);   // pedestal only: not active
+  fillSpectrum(row(2), false, 4U, 20U); // active, but nothing in the pedestal range
+  // channel 3 and following are empty
+
+  CrtCalEngine::Result const res = CrtCalEngine::CalibrateFEB(Mac5, spectra.data());
+
+  // complete channel: pedestal and gain are found
+  BOOST_CHECK(res.active[0]);
+  BOOST_CHECK_CLOSE(res.ped[0], Pedestal, 0.5);
+  BOOST_CHECK_CLOSE(res.pedSigma[0], PedestalSigma, 5.);
+  BOOST_CHECK_GT(res.nPeak[0], 1);
+  BOOST_CHECK_CLOSE(res.gain[0], Gain, 3.);
+  BOOST_CHECK_CLOSE(res.gainPed[0], Pedestal, 3.);
+  BOOST_CHECK_LT(res.threshADC[0], 1000);
+  BOOST_CHECK_GE(res.threshADC[0], 300);
+  BOOST_CHECK_CLOSE(res.threshPE[0], (res.threshADC[0] - res.ped[0]) / res.gain[0], 1e-4);
+  BOOST_CHECK_GT(res.nAbove[0], 0);
+
+  // pedestal only: pedestal without gain
+  BOOST_CHECK(!res.active[1]);
+  BOOST_CHECK_CLOSE(res.ped[1], Pedestal, 0.5);
+  BOOST_CHECK_EQUAL(res.gain[1], FLT_MAX);
+
+  // active without pedestal: the gain fit is not attempted
+  BOOST_CHECK(res.active[2]);
+  BOOST_CHECK_EQUAL(res.ped[2], FLT_MAX);
+  BOOST_CHECK_EQUAL(res.gain[2], FLT_MAX);
+  BOOST_CHECK_EQUAL(res.nPeak[2], SHRT_MAX);
+  BOOST_CHECK_EQUAL(res.threshPE[2], FLT_MAX);
+
+  // empty channels are left at the defaults
+  for (std::size_t chan = 3; chan < CrtCalEngine::kNChan; ++chan) {
+    BOOST_TEST_MESSAGE("Channel " << chan);
+    BOOST_CHECK(!res.active[chan]);
+    BOOST_CHECK_EQUAL(res.ped[chan], FLT_MAX);
+    BOOST_CHECK_EQUAL(res.gain[chan], FLT_MAX);
+  }
+
+} // CrtCalEngine_CalibrateFEB_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CrtCalEngine_testcase) {
+
+  CrtCalEngine_GausFit_test();
+  CrtCalEngine_LineFit_test();
+  CrtCalEngine_CalibrateFEB_test();
+
+} // BOOST_AUTO_TEST_CASE(CrtCalEngine_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,266 @@
+/**
+ * @file   test/PMT/Trigger/Algorithms/SlidingWindowPatternAlg_test.cc
+ * @brief  Unit test for `SlidingWindowPatternAlg`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h`
+ *
+ * The response on sampled gates (`DenseTriggerGate`) is checked against the
+ * one on the gates they are sampled from, on random gates and on a set of
+ * patterns exercising all the window requirements.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/SlidingWindowPatternAlg.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowChannelMap.h"
+#include "icaruscode/PMT/Trigger/Algorithms/WindowPattern.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( SlidingWindowPatternAlg_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <random>
+#include <vector>
+#include <algorithm> // std::min()
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+using SlidingWindowPatternAlg = icarus::trigger::SlidingWindowPatternAlg;
+using WindowChannelMap = icarus::trigger::WindowChannelMap;
+using WindowPattern = icarus::trigger::WindowPattern;
+using TriggerGates_t = SlidingWindowPatternAlg::TriggerGates_t;
+using TriggerGateData_t = SlidingWindowPatternAlg::TriggerGateData_t;
+using ClockTick_t = SlidingWindowPatternAlg::DenseGate_t::ClockTick_t;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Start of the sampled interval (plays the role of the beam gate).
+  constexpr ClockTick_t Start = 100;
+
+  /// End of the sampled interval (not a multiple of 64 ticks from `Start`).
+  constexpr ClockTick_t End = 437;
+
+  /// Number of windows in each of the two rows of `makeTopology()`.
+  constexpr std::size_t NWindowsPerRow = 3U;
+
+  /// Number of channels in each window.
+  constexpr unsigned int NChannelsPerWindow = 2U;
+
+
+  /**
+   * @brief Returns a topology of two facing rows of windows.
+   *
+   * Windows `0` to `NWindowsPerRow - 1` are one row, from upstream to
+   * downstream, and the following ones are the opposite row, in the same
+   * order.
+   */
+  WindowChannelMap makeTopology() {
+
+    std::vector<WindowChannelMap::WindowInfo_t> windows(2 * NWindowsPerRow);
+    for (std::size_t iWindow = 0; iWindow < windows.size(); ++iWindow) {
+      WindowChannelMap::WindowInfo_t& info = windows[iWindow];
+      std::size_t const iRow = iWindow / NWindowsPerRow;
+      std::size_t const iInRow = iWindow % NWindowsPerRow;
+
+      info.index = iWindow;
+      info.opposite = (1 - iRow) * NWindowsPerRow + iInRow;
+      if (iInRow > 0) info.upstream = iWindow - 1;
+      if (iInRow + 1 < NWindowsPerRow) info.downstream = iWindow + 1;
+      for (unsigned int i = 0; i < NChannelsPerWindow; ++i)
+        info.channels.push_back(iWindow * NChannelsPerWindow + i);
+    } // for
+
+    return WindowChannelMap{ std::move(windows) };
+  } // makeTopology()
+
+
+  /**
+   * @brief Returns one random gate per window of `topology`.
+   *
+   * The openings span also outside [ `Start`, `End` [; the returned gates
+   * are then set in coincidence with that interval, as the beam gate would.
+   */
+  TriggerGates_t makeRandomGates
+    (std::mt19937& gen, WindowChannelMap const& topology)
+  {
+    std::uniform_int_distribution<ClockTick_t> startDist
+      { Start - 50, End + 10 };
+    std::uniform_int_distribution<ClockTick_t> lengthDist { 1, 40 };
+    std::uniform_int_distribution<unsigned int> countDist { 1U, 3U };
+
+    TriggerGateData_t beamGate;
+    beamGate.openBetween(Start, End);
+
+    TriggerGates_t gates(topology.nWindows());
+    for (std::size_t iWindow = 0; iWindow < gates.size(); ++iWindow) {
+      auto& gate = gates[iWindow];
+      for (auto const channel: topology.info(iWindow).channels)
+        gate.addChannel(channel);
+      for (int i = 0; i < 25; ++i) {
+        gate.gateLevels()
+          .openFor(startDist(gen), lengthDist(gen), countDist(gen));
+      }
+      gate.gateLevels().Mul(beamGate);
+    } // for
+
+    return gates;
+  } // makeRandomGates()
+
+
+  /// Returns a set of patterns exercising all the window requirements.
+  std::vector<WindowPattern> testPatterns() {
+
+    std::vector<WindowPattern> patterns;
+
+    WindowPattern pattern;
+
+    pattern = {};
+    pattern.minInMainWindow = 2U;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minInMainWindow = 4U;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minInMainWindow = 2U;
+    pattern.minInOppositeWindow = 2U;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minSumInOppositeWindows = 5U;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minInMainWindow = 1U;
+    pattern.minSumInOppositeWindows = 4U;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minInMainWindow = 2U;
+    pattern.minInUpstreamWindow = 1U;
+    pattern.minInDownstreamWindow = 1U;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minInMainWindow = 1U;
+    pattern.minInDownstreamWindow = 2U;
+    pattern.requireDownstreamWindow = true;
+    patterns.push_back(pattern);
+
+    pattern = {};
+    pattern.minInMainWindow = 1U;
+    pattern.minInUpstreamWindow = 2U;
+    pattern.requireUpstreamWindow = true;
+    patterns.push_back(pattern);
+
+    return patterns;
+  } // testPatterns()
+
+
+  /// Checks that two responses are identical.
+  void checkSameResponse(
+    SlidingWindowPatternAlg::AllTriggerInfo_t const& dense,
+    SlidingWindowPatternAlg::AllTriggerInfo_t const& sparse
+  ) {
+    BOOST_CHECK_EQUAL(dense.info.fired(), sparse.info.fired());
+    BOOST_CHECK_EQUAL(dense.extra.windowIndex, sparse.extra.windowIndex);
+    if (!dense.info.fired() || !sparse.info.fired()) return;
+
+    BOOST_CHECK_EQUAL(dense.info.atTick(), sparse.info.atTick());
+    BOOST_CHECK_EQUAL(dense.info.level(), sparse.info.level());
+    BOOST_CHECK_EQUAL(dense.info.location(), sparse.info.location());
+    BOOST_CHECK_EQUAL(dense.info.nTriggers(), sparse.info.nTriggers());
+
+    auto const& denseTriggers = dense.info.all();
+    auto const& sparseTriggers = sparse.info.all();
+    std::size_t const n = std::min(denseTriggers.size(), sparseTriggers.size());
+    for (std::size_t i = 0; i < n; ++i) {
+      BOOST_TEST_MESSAGE("  trigger #" << i);
+      BOOST_CHECK_EQUAL(denseTriggers[i].tick, sparseTriggers[i].tick);
+      BOOST_CHECK_EQUAL(denseTriggers[i].level, sparseTriggers[i].level);
+      BOOST_CHECK_EQUAL
+        (denseTriggers[i].locationID, sparseTriggers[i].locationID);
+    } // for
+  } // checkSameResponse()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- SlidingWindowPatternAlg tests
+// -----------------------------------------------------------------------------
+void SlidingWindowPatternAlg_denseVsSparse_test() {
+
+  WindowChannelMap const topology = makeTopology();
+  std::vector<WindowPattern> const patterns = testPatterns();
+
+  std::mt19937 gen { 2026 };
+
+  unsigned int nFired = 0U;
+  for (int iTrial = 0; iTrial < 50; ++iTrial) {
+
+    TriggerGates_t const gates = makeRandomGates(gen, topology);
+    SlidingWindowPatternAlg::DenseGates_t const denseGates
+      = SlidingWindowPatternAlg::makeDenseGates(gates, Start, End);
+
+    for (WindowPattern const& pattern: patterns) {
+      BOOST_TEST_MESSAGE("Trial #" << iTrial << ", pattern " << pattern.tag());
+
+      // no beam gate: the gates are already in coincidence with it
+      SlidingWindowPatternAlg const alg { topology, pattern };
+
+      auto const sparse = alg.simulateResponse(gates);
+      auto const dense = alg.simulateResponse(denseGates);
+
+      checkSameResponse(dense, sparse);
+      if (sparse.info.fired()) ++nFired;
+    } // for patterns
+  } // for trials
+
+  // make sure the comparison is not trivially between two empty responses
+  BOOST_TEST_MESSAGE("Patterns fired " << nFired << " times");
+  BOOST_CHECK_GT(nFired, 0U);
+  BOOST_CHECK_LT(nFired, 50U * patterns.size());
+
+} // SlidingWindowPatternAlg_denseVsSparse_test()
+
+
+void SlidingWindowPatternAlg_denseGateCount_test() {
+
+  WindowChannelMap const topology = makeTopology();
+  WindowPattern pattern;
+  pattern.minInMainWindow = 1U;
+  SlidingWindowPatternAlg const alg { topology, pattern };
+
+  std::mt19937 gen { 12 };
+  TriggerGates_t gates = makeRandomGates(gen, topology);
+  gates.pop_back();
+
+  BOOST_CHECK_THROW(
+    alg.simulateResponse
+      (SlidingWindowPatternAlg::makeDenseGates(gates, Start, End)),
+    cet::exception
+    );
+
+} // SlidingWindowPatternAlg_denseGateCount_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SlidingWindowPatternAlg_testcase) {
+
+  SlidingWindowPatternAlg_denseVsSparse_test();
+  SlidingWindowPatternAlg_denseGateCount_test();
+
+} // BOOST_AUTO_TEST_CASE(SlidingWindowPatternAlg_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+/**
+ * @file   test/PMT/Trigger/Algorithms/ThresholdCrossings_test.cc
+ * @brief  Unit test for `details/ThresholdCrossings.h`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/PMT/Trigger/Algorithms/details/ThresholdCrossings.h`
+ *
+ * The crossings found on the raw samples with integer cuts are checked
+ * against the ones of the serial floating point discrimination that
+ * `ManagedTriggerGateBuilder` used before, on random waveforms.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Algorithms/details/ThresholdCrossings.h"
+#include "icaruscode/PMT/Trigger/Algorithms/TriggerTypes.h" // ADCCounts_t
+#include "icarusalg/Utilities/WaveformOperations.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ThresholdCrossings_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <ostream>
+#include <random>
+#include <vector>
+#include <algorithm> // std::clamp()
+#include <cmath> // std::round()
+#include <cstddef> // std::size_t, std::ptrdiff_t
+
+
+// -----------------------------------------------------------------------------
+using ADCCounts_t = icarus::trigger::ADCCounts_t;
+using WaveformOps_t
+  = icarus::waveform_operations::NegativePolarityOperations<float>;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// A gate opening or closing.
+  struct Crossing_t {
+    std::ptrdiff_t sample; ///< Index of the sample of the crossing.
+    std::size_t threshold; ///< Index of the threshold crossed.
+    bool open; ///< Whether the threshold is passed (or left).
+
+    bool operator== (Crossing_t const& other) const
+      {
+        return (sample == other.sample) && (threshold == other.threshold)
+          && (open == other.open);
+      }
+    bool operator!= (Crossing_t const& other) const
+      { return !(*this == other); }
+  }; // Crossing_t
+
+  std::ostream& operator<< (std::ostream& out, Crossing_t const& crossing)
+    {
+      out << (crossing.open? "open": "close") << " thr. #" << crossing.threshold
+        << " at sample #" << crossing.sample;
+      return out;
+    }
+
+
+  /**
+   * @brief Reference discrimination: serial, in floating point.
+   *
+   * Each sample is subtracted the baseline in single precision and rounded,
+   * and then compared to the thresholds, as `ManagedTriggerGateBuilder` did
+   * before using integer cuts.
+   */
+  std::vector<Crossing_t> referenceCrossings(
+    std::vector<raw::ADC_Count_t> const& samples,
+    float baseline,
+    std::vector<ADCCounts_t> const& thresholds
+  ) {
+    WaveformOps_t const waveOps { baseline };
+    std::size_t const nThresholds = thresholds.size();
+
+    std::vector<Crossing_t> crossings;
+    std::size_t nOpen = 0U; // number of thresholds passed
+    for (std::size_t iSample = 0; iSample < samples.size(); ++iSample) {
+
+      ADCCounts_t const relSample = ADCCounts_t::castFrom
+        (std::round(waveOps.subtractBaseline(samples[iSample])));
+
+      std::ptrdiff_t const tick = iSample;
+      if ((nOpen > 0U) && (relSample < thresholds[nOpen - 1])) {
+        do {
+          --nOpen;
+          crossings.push_back({ tick, nOpen, false });
+        } while ((nOpen > 0U) && (relSample < thresholds[nOpen - 1]));
+      }
+      else if ((nOpen < nThresholds) && (relSample >= thresholds[nOpen])) {
+        do {
+          crossings.push_back({ tick, nOpen, true });
+          ++nOpen;
+        } while ((nOpen < nThresholds) && (relSample >= thresholds[nOpen]));
+      }
+    } // for samples
+
+    return crossings;
+  } // referenceCrossings()
+
+
+  /// Returns the crossings from `scanThresholdCrossings()`.
+  template <std::size_t BlockSize>
+  std::vector<Crossing_t> scannedCrossings(
+    std::vector<raw::ADC_Count_t> const& samples,
+    float baseline,
+    std::vector<ADCCounts_t> const& thresholds
+  ) {
+    WaveformOps_t const waveOps { baseline };
+
+    std::vector<Crossing_t> crossings;
+    icarus::trigger::details::scanThresholdCrossings<BlockSize>(
+      samples.data(), static_cast<std::ptrdiff_t>(samples.size()),
+      icarus::trigger::details::rawSampleCuts(waveOps, thresholds),
+      [&crossings](std::ptrdiff_t iSample, std::size_t iThreshold)
+        { crossings.push_back({ iSample, iThreshold, true }); },
+      [&crossings](std::ptrdiff_t iSample, std::size_t iThreshold)
+        { crossings.push_back({ iSample, iThreshold, false }); }
+      );
+    return crossings;
+  } // scannedCrossings()
+
+
+  /// Returns `n` random increasing thresholds.
+  std::vector<ADCCounts_t> makeRandomThresholds
+    (std::mt19937& gen, std::size_t n)
+  {
+    std::uniform_int_distribution<int> stepDist { 1, 30 };
+    std::vector<ADCCounts_t> thresholds;
+    int threshold = 0;
+    while (thresholds.size() < n) {
+      threshold += stepDist(gen);
+      thresholds.emplace_back(threshold);
+    }
+    return thresholds;
+  } // makeRandomThresholds()
+
+
+  /**
+   * @brief Returns a random waveform on the specified `baseline`.
+   *
+   * The waveform is noise around the baseline with some negative pulses of
+   * random amplitude; its length is usually not a multiple of a block size.
+   */
+  std::vector<raw::ADC_Count_t> makeRandomWaveform
+    (std::mt19937& gen, float baseline)
+  {
+    std::uniform_int_distribution<std::size_t> lengthDist { 1U, 700U };
+    std::normal_distribution<float> noiseDist { 0.0f, 2.0f };
+    std::uniform_real_distribution<float> flatDist { 0.0f, 1.0f };
+    std::uniform_real_distribution<float> amplitudeDist { 1.0f, 250.0f };
+
+    std::vector<raw::ADC_Count_t> samples(lengthDist(gen));
+    float pulse = 0.0f;
+    for (raw::ADC_Count_t& sample: samples) {
+      if (flatDist(gen) < 0.02f) pulse += amplitudeDist(gen);
+      pulse *= 0.8f;
+      float const value = baseline - pulse + noiseDist(gen);
+      sample = static_cast<raw::ADC_Count_t>
+        (std::clamp(std::round(value), 0.0f, 16383.0f));
+    } // for
+    return samples;
+  } // makeRandomWaveform()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- ThresholdCrossings tests
+// -----------------------------------------------------------------------------
+void ThresholdCrossings_cuts_test() {
+
+  /*
+   * Each cut must split the raw samples exactly as the floating point
+   * discrimination does, including at the rounding boundaries.
+   */
+  std::mt19937 gen { 2019 };
+  std::uniform_real_distribution<float> baselineDist { 14800.0f, 15200.0f };
+
+  for (int iTrial = 0; iTrial < 200; ++iTrial) {
+    // half of the baselines have a half-count fraction (rounding boundary)
+    float const baseline = (iTrial % 2)
+      ? std::round(baselineDist(gen)) + 0.5f: baselineDist(gen);
+    WaveformOps_t const waveOps { baseline };
+    std::vector<ADCCounts_t> const thresholds = makeRandomThresholds(gen, 6U);
+
+    std::vector<int> const cuts
+      = icarus::trigger::details::rawSampleCuts(waveOps, thresholds);
+    BOOST_TEST_REQUIRE(cuts.size() == thresholds.size());
+
+    for (std::size_t iThr = 0; iThr < thresholds.size(); ++iThr) {
+      for (int sample = cuts[iThr] - 5; sample <= cuts[iThr] + 5; ++sample) {
+        ADCCounts_t const relSample = ADCCounts_t::castFrom
+          (std::round(waveOps.subtractBaseline(static_cast<float>(sample))));
+        BOOST_TEST_MESSAGE("Baseline " << baseline << ", threshold "
+          << thresholds[iThr] << ", sample " << sample);
+        BOOST_CHECK_EQUAL
+          (sample <= cuts[iThr], relSample >= thresholds[iThr]);
+      } // for samples
+    } // for thresholds
+  } // for trials
+
+} // ThresholdCrossings_cuts_test()
+
+
+template <std::size_t BlockSize>
+void ThresholdCrossings_reference_test() {
+
+  std::mt19937 gen { 1234 };
+  std::uniform_real_distribution<float> baselineDist { 14800.0f, 15200.0f };
+  std::uniform_int_distribution<std::size_t> nThresholdsDist { 0U, 5U };
+
+  std::size_t nCrossings = 0U;
+  for (int iTrial = 0; iTrial < 500; ++iTrial) {
+    float const baseline = (iTrial % 3 == 0)
+      ? std::round(baselineDist(gen)) + 0.5f: baselineDist(gen);
+    std::vector<ADCCounts_t> const thresholds
+      = makeRandomThresholds(gen, nThresholdsDist(gen));
+    std::vector<raw::ADC_Count_t> const samples
+      = makeRandomWaveform(gen, baseline);
+
+    BOOST_TEST_MESSAGE("Trial #" << iTrial << ": " << samples.size()
+      << " samples, " << thresholds.size() << " thresholds, baseline "
+      << baseline);
+
+    std::vector<Crossing_t> const expected
+      = referenceCrossings(samples, baseline, thresholds);
+    std::vector<Crossing_t> const crossings
+      = scannedCrossings<BlockSize>(samples, baseline, thresholds);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+      crossings.cbegin(), crossings.cend(), expected.cbegin(), expected.cend()
+      );
+    nCrossings += expected.size();
+  } // for trials
+
+  // make sure the comparison is not trivially between empty lists
+  BOOST_TEST_MESSAGE(nCrossings << " crossings compared");
+  BOOST_CHECK_GT(nCrossings, 1000U);
+
+} // ThresholdCrossings_reference_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ThresholdCrossings_testcase) {
+
+  ThresholdCrossings_cuts_test();
+  ThresholdCrossings_reference_test<32U>(); // the one used in production
+  ThresholdCrossings_reference_test<4U>();
+  ThresholdCrossings_reference_test<1U>();
+
+} // BOOST_AUTO_TEST_CASE(ThresholdCrossings_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,176 @@
+/**
+ * @file   test/PMT/Trigger/Utilities/DenseTriggerGate_test.cc
+ * @brief  Unit test for `DenseTriggerGate.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/PMT/Trigger/Utilities/DenseTriggerGate.h`
+ *
+ * The operations on sampled gates are checked against the same operations
+ * on `TriggerGateData` on random gates.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Utilities/DenseTriggerGate.h"
+#include "icaruscode/PMT/Trigger/Utilities/TriggerGateOperations.h"
+#include "sbnobj/ICARUS/PMT/Trigger/Data/TriggerGateData.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( DenseTriggerGate_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+using GateData_t = icarus::trigger::TriggerGateData<int, int>;
+using DenseGate_t = icarus::trigger::DenseTriggerGate<GateData_t>;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Returns `nGates` gates with random, overlapping openings.
+  std::vector<GateData_t> makeRandomGates(std::mt19937& gen, unsigned int nGates)
+  {
+    std::uniform_int_distribution<int> startDist { -50, 400 };
+    std::uniform_int_distribution<int> lengthDist { 1, 60 };
+
+    std::vector<GateData_t> gates(nGates);
+    for (GateData_t& gate: gates) {
+      for (int i = 0; i < 12; ++i) gate.openFor(startDist(gen), lengthDist(gen));
+    }
+    return gates;
+  } // makeRandomGates()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- DenseTriggerGate tests
+// -----------------------------------------------------------------------------
+void DenseTriggerGate_sampling_test() {
+
+  constexpr int Start = 20;
+  constexpr int End = 317; // not a multiple of 64 ticks
+
+  std::mt19937 gen { 1234 };
+  std::vector<GateData_t> const gates = makeRandomGates(gen, 4);
+
+  for (GateData_t const& gate: gates) {
+    DenseGate_t const dense { gate, Start, End };
+    BOOST_CHECK_EQUAL(dense.startTick(), Start);
+    BOOST_CHECK_EQUAL(dense.endTick(), End);
+    for (int tick = Start - 10; tick < End + 10; ++tick) {
+      BOOST_TEST_MESSAGE("Tick " << tick);
+      BOOST_CHECK_EQUAL(dense.openingCount(tick),
+        ((tick >= Start) && (tick < End))? gate.openingCount(tick): 0);
+    }
+
+    // round trip
+    GateData_t const gateInRange = dense.toGateData();
+    DenseGate_t const back { gateInRange, Start, End };
+    BOOST_CHECK(back.levels() == dense.levels());
+    for (int tick = Start; tick < End; tick += 7) {
+      BOOST_CHECK_EQUAL(dense.findOpen(2, tick), gateInRange.findOpen(2, tick));
+      BOOST_CHECK_EQUAL
+        (dense.findClose(2, tick), gateInRange.findClose(2, tick));
+    }
+  } // for
+
+} // DenseTriggerGate_sampling_test()
+
+
+void DenseTriggerGate_operations_test() {
+
+  constexpr int Start = -30;
+  constexpr int End = 400;
+
+  std::mt19937 gen { 4321 };
+  std::vector<GateData_t> const gates = makeRandomGates(gen, 2);
+  DenseGate_t const A { gates[0], Start, End };
+  DenseGate_t const B { gates[1], Start, End };
+
+  GateData_t const sum = icarus::trigger::sumGates(gates[0], gates[1]);
+  GateData_t const max = icarus::trigger::maxGates(gates[0], gates[1]);
+  GateData_t masked = gates[0];
+  masked.Mul(icarus::trigger::discriminate(gates[1], 2));
+
+  DenseGate_t denseSum = A;
+  denseSum.Sum(B);
+  DenseGate_t denseMax = A;
+  denseMax.Max(B);
+  DenseGate_t denseMasked = A;
+  denseMasked.Mask(B.above(2));
+
+  for (int tick = Start; tick < End; ++tick) {
+    BOOST_TEST_MESSAGE("Tick " << tick);
+    BOOST_CHECK_EQUAL(denseSum.openingCount(tick), sum.openingCount(tick));
+    BOOST_CHECK_EQUAL(denseMax.openingCount(tick), max.openingCount(tick));
+    BOOST_CHECK_EQUAL
+      (denseMasked.openingCount(tick), masked.openingCount(tick));
+  } // for
+
+  BOOST_CHECK_EQUAL(denseSum.findMaxOpen(), sum.findMaxOpen(Start, End));
+
+} // DenseTriggerGate_operations_test()
+
+
+void DenseTriggerGate_majority_test() {
+
+  constexpr int Start = 0;
+  constexpr int End = 450;
+
+  std::mt19937 gen { 5678 };
+  std::vector<GateData_t> const gates = makeRandomGates(gen, 11);
+
+  std::vector<DenseGate_t::Bits_t> bits;
+  for (GateData_t const& gate: gates)
+    bits.push_back(DenseGate_t{ gate, Start, End }.above(1));
+
+  for (unsigned int minCount = 0; minCount <= gates.size() + 1; ++minCount) {
+    auto const majority
+      = DenseGate_t::Bits_t::atLeast(bits.begin(), bits.end(), minCount);
+
+    for (int tick = Start; tick < End; ++tick) {
+      unsigned int nOpen = 0;
+      for (GateData_t const& gate: gates) if (gate.openingCount(tick)) ++nOpen;
+      BOOST_TEST_MESSAGE("Tick " << tick << " at least " << minCount);
+      BOOST_CHECK_EQUAL(majority.isOpen(tick), nOpen >= minCount);
+    } // for ticks
+  } // for minCount
+
+} // DenseTriggerGate_majority_test()
+
+
+void DenseTriggerGate_openRange_test() {
+
+  GateData_t beamGate;
+  BOOST_CHECK(DenseGate_t::openRange(beamGate).first
+    == DenseGate_t::openRange(beamGate).second);
+
+  beamGate.openFor(100, 50);
+  auto const [ start, end ] = DenseGate_t::openRange(beamGate);
+  BOOST_CHECK_EQUAL(start, 100);
+  BOOST_CHECK_EQUAL(end, 150);
+
+} // DenseTriggerGate_openRange_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(DenseTriggerGate_testcase) {
+
+  DenseTriggerGate_sampling_test();
+  DenseTriggerGate_operations_test();
+  DenseTriggerGate_majority_test();
+  DenseTriggerGate_openRange_test();
+
+} // BOOST_AUTO_TEST_CASE(DenseTriggerGate_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
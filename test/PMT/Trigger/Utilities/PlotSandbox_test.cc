@@ -0,0 +1,168 @@
+/**
+ * @file   test/PMT/Trigger/Utilities/PlotSandbox_test.cc
+ * @brief  Unit test for the keyed access of `PlotSandbox`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/PMT/Trigger/Utilities/PlotSandbox.h`
+ *
+ * Objects and contained sandboxes accessed via registered keys must be the
+ * same as the ones found by name, box by box; unregistered keys fall back to
+ * the name, and missing objects are reported as with names.
+ */
+
+// ICARUS libraries
+#include "icaruscode/PMT/Trigger/Utilities/PlotSandbox.h"
+
+// framework libraries
+#include "art_root_io/TFileDirectory.h"
+#include "cetlib_except/exception.h"
+
+// ROOT libraries
+#include "TMemFile.h"
+#include "TH1F.h"
+#include "TH2F.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PlotSandbox_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+using PlotSandbox = icarus::trigger::PlotSandbox;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// The top directory of a ROOT file, as `TFileService` would create it.
+  struct TopDirectory: art::TFileDirectory {
+    TopDirectory(TFile& file): art::TFileDirectory("", "", &file, "") {}
+  }; // TopDirectory
+
+  /// Fills the `box` with a histogram, and its subboxes too.
+  void makePlots(PlotSandbox& box) {
+    box.make<TH1F>("HValue", "value", 10, 0.0, 1.0);
+    for (PlotSandbox& subbox: box.subSandboxes()) makePlots(subbox);
+  } // makePlots()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- PlotSandbox tests
+// -----------------------------------------------------------------------------
+void PlotSandbox_objectKey_test() {
+
+  TMemFile file { "PlotSandbox_test.root", "RECREATE" };
+  TopDirectory const topDir { file };
+
+  PlotSandbox box { topDir, "Top", "top box" };
+  PlotSandbox& triggering = box.addSubSandbox("triggering", "triggering");
+  PlotSandbox& nontriggering
+    = box.addSubSandbox("nontriggering", "non-triggering");
+  makePlots(box);
+
+  PlotSandbox::ObjectKey<TH1> const ValueKey { "HValue" };
+  PlotSandbox::ObjectKey<TH1> const MissingKey { "HMissing" };
+  PlotSandbox::ObjectKey<TH2> const WrongTypeKey { "HValue" };
+
+  // each key has its own index
+  BOOST_CHECK_NE(ValueKey.index(), MissingKey.index());
+  BOOST_CHECK_NE(ValueKey.index(), WrongTypeKey.index());
+  BOOST_CHECK_EQUAL(ValueKey.name(), "HValue");
+
+  // before registration, the lookup goes by name
+  TH1* const topValue = box.use<TH1>("HValue");
+  BOOST_TEST_REQUIRE(topValue);
+  BOOST_CHECK_EQUAL(box.use(ValueKey), topValue);
+  BOOST_CHECK_EQUAL(&box.demand(ValueKey), topValue);
+
+  // registration in all the boxes: each box has its own object
+  box.registerObjects(ValueKey, MissingKey, WrongTypeKey);
+  BOOST_CHECK_EQUAL(box.use(ValueKey), topValue);
+  BOOST_CHECK_EQUAL(&box.demand(ValueKey), topValue);
+  for (PlotSandbox const* subbox: { &triggering, &nontriggering }) {
+    BOOST_TEST_MESSAGE("Box '" << subbox->ID() << "'");
+    TH1* const value = subbox->use<TH1>("HValue");
+    BOOST_TEST_REQUIRE(value);
+    BOOST_CHECK_NE(value, topValue);
+    BOOST_CHECK_EQUAL(subbox->use(ValueKey), value);
+    BOOST_CHECK_EQUAL(&subbox->demand(ValueKey), value);
+  } // for
+
+  // a registered key returns the same object as the name
+  PlotSandbox::ObjectKey<TH1> const SingleKey { "HValue" };
+  TH1* const triggeringValue = triggering.use<TH1>("HValue");
+  BOOST_CHECK_EQUAL(triggering.registerObject(SingleKey), triggeringValue);
+  BOOST_CHECK_EQUAL(triggering.use(SingleKey), triggeringValue);
+  // ... and where it is not registered, it is still found by name
+  BOOST_CHECK_EQUAL
+    (nontriggering.use(SingleKey), nontriggering.use<TH1>("HValue"));
+
+  // missing objects and objects of the wrong type are not registered
+  BOOST_CHECK(!box.registerObject(MissingKey));
+  BOOST_CHECK(!box.use(MissingKey));
+  BOOST_CHECK_THROW(box.demand(MissingKey), cet::exception);
+  BOOST_CHECK(!box.registerObject(WrongTypeKey));
+  BOOST_CHECK(!box.use(WrongTypeKey));
+  BOOST_CHECK_THROW(box.demand(WrongTypeKey), cet::exception);
+
+} // PlotSandbox_objectKey_test()
+
+
+void PlotSandbox_sandboxKey_test() {
+
+  TMemFile file { "PlotSandbox_test.root", "RECREATE" };
+  TopDirectory const topDir { file };
+
+  PlotSandbox box { topDir, "Top", "top box" };
+  PlotSandbox& settings = box.addSubSandbox("Settings", "settings");
+  PlotSandbox& triggering = settings.addSubSandbox("triggering", "triggering");
+  PlotSandbox& nontriggering
+    = settings.addSubSandbox("nontriggering", "non-triggering");
+
+  PlotSandbox::SandboxKey const TriggeringKey { "triggering" };
+  PlotSandbox::SandboxKey const NonTriggeringKey { "nontriggering" };
+  PlotSandbox::SandboxKey const MissingKey { "missing" };
+
+  // before registration, the lookup goes by name
+  BOOST_CHECK_EQUAL(&settings.demandSandbox(TriggeringKey), &triggering);
+
+  // registration descends into the contained boxes
+  box.registerSandboxes(TriggeringKey, NonTriggeringKey, MissingKey);
+  PlotSandbox const& constSettings = settings;
+  BOOST_CHECK_EQUAL(&settings.demandSandbox(TriggeringKey), &triggering);
+  BOOST_CHECK_EQUAL(&constSettings.demandSandbox(TriggeringKey), &triggering);
+  BOOST_CHECK_EQUAL
+    (&constSettings.demandSandbox(NonTriggeringKey), &nontriggering);
+
+  // boxes without such a subbox are not registered
+  BOOST_CHECK(!box.registerSandbox(TriggeringKey));
+  BOOST_CHECK_THROW(box.demandSandbox(TriggeringKey), cet::exception);
+  BOOST_CHECK_THROW(settings.demandSandbox(MissingKey), cet::exception);
+
+  // a deleted subbox is not returned any more
+  BOOST_CHECK(settings.deleteSubSandbox("nontriggering"));
+  BOOST_CHECK_THROW(settings.demandSandbox(NonTriggeringKey), cet::exception);
+  BOOST_CHECK_EQUAL(&settings.demandSandbox(TriggeringKey), &triggering);
+
+} // PlotSandbox_sandboxKey_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PlotSandbox_testcase) {
+
+  PlotSandbox_objectKey_test();
+  PlotSandbox_sandboxKey_test();
+
+} // BOOST_AUTO_TEST_CASE(PlotSandbox_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
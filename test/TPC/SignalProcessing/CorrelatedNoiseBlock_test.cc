@@ -0,0 +1,255 @@
+/**
+ * @file   test/TPC/SignalProcessing/CorrelatedNoiseBlock_test.cc
+ * @brief  Unit test for `CorrelatedNoiseBlock.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/CorrelatedNoiseBlock.h`
+ *
+ * The per tick corrections from the packed block are compared, on random wire
+ * groups with partial and empty sample ranges, with the per tick average that
+ * `RawDigitCorrelatedCorrectionAlg` computed before packing the waveforms, and
+ * with a median from a full sort. The same block is reused across groups of
+ * different sizes, as the algorithm does.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/SignalProcessing/RawDigitFilter/Algorithms/CorrelatedNoiseBlock.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( CorrelatedNoiseBlock_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <algorithm> // std::sort(), std::min()
+#include <cmath> // std::isnan()
+#include <map>
+#include <numeric> // std::accumulate()
+#include <random>
+#include <utility> // std::pair
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+using CorrelatedNoiseBlock = caldata::CorrelatedNoiseBlock;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// A wire group as the algorithm receives it.
+  struct WireGroup_t {
+    std::size_t numTicks = 0;
+    std::map<std::size_t, std::vector<short>> waveforms; ///< By wire number.
+    std::map<std::size_t, std::pair<std::size_t, std::size_t>> ranges;
+    std::map<std::size_t, float> truncMeans;
+  }; // WireGroup_t
+
+
+  /**
+   * @brief Returns a random group of `numWires` wires.
+   *
+   * Wires have a pedestal and a common noise; some wires have only part of
+   * their samples in range, some none ("start" after "stop"), and some ranges
+   * go past the end of the waveform.
+   */
+  WireGroup_t makeRandomGroup
+    (std::mt19937& gen, std::size_t numWires, std::size_t numTicks)
+  {
+    std::uniform_int_distribution<std::size_t> firstWireDist { 0U, 1000U };
+    std::uniform_int_distribution<std::size_t> tickDist { 0U, numTicks + 5U };
+    std::uniform_real_distribution<float> pedestalDist { 1900.f, 2100.f };
+    std::normal_distribution<float> noiseDist { 0.f, 4.f };
+    std::uniform_real_distribution<float> flatDist { 0.f, 1.f };
+
+    std::vector<float> commonNoise(numTicks);
+    for (float& noise: commonNoise) noise = 2.f * noiseDist(gen);
+
+    WireGroup_t group;
+    group.numTicks = numTicks;
+    std::size_t const firstWire = firstWireDist(gen);
+    for (std::size_t wire = firstWire; wire < firstWire + numWires; ++wire) {
+      float const pedestal = pedestalDist(gen);
+      std::vector<short>& waveform = group.waveforms[wire];
+      for (std::size_t tick = 0; tick < numTicks; ++tick) {
+        waveform.push_back
+          (static_cast<short>(pedestal + commonNoise[tick] + noiseDist(gen)));
+      }
+      group.truncMeans[wire] = pedestal + noiseDist(gen) / 10.f;
+
+      float const rangeType = flatDist(gen);
+      if (rangeType < 0.6f) group.ranges[wire] = { 0U, numTicks };
+      else {
+        std::size_t const first = tickDist(gen), second = tickDist(gen);
+        group.ranges[wire] = (rangeType < 0.9f)
+          ? std::pair{ std::min(first, second), std::max(first, second) }
+          : std::pair{ std::max(first, second) + 1U, std::min(first, second) };
+      }
+    } // for wires
+
+    return group;
+  } // makeRandomGroup()
+
+
+  /// Packs the `group` into the `block`, as the algorithm does.
+  void packGroup(CorrelatedNoiseBlock& block, WireGroup_t const& group) {
+    block.reset(group.waveforms.size(), group.numTicks);
+    std::size_t rowIdx = 0;
+    for (auto const& [ wire, waveform ]: group.waveforms) {
+      float const truncMean = group.truncMeans.at(wire);
+      float* const adcRow = block.row(rowIdx);
+      auto const& range = group.ranges.at(wire);
+      block.setSampleRange(rowIdx, range.first, range.second);
+      for (std::size_t tick = 0; tick < group.numTicks; ++tick)
+        adcRow[tick] = float(waveform[tick]) - truncMean;
+      ++rowIdx;
+    } // for
+  } // packGroup()
+
+
+  /// Returns the pedestal corrected values of the wires in range at `tick`.
+  std::vector<float> valuesAt(WireGroup_t const& group, std::size_t tick) {
+    std::vector<float> adcValuesVec;
+    for (auto const& [ wire, range ]: group.ranges) {
+      if (tick < range.first || tick >= range.second) continue;
+      adcValuesVec.push_back
+        (float(group.waveforms.at(wire)[tick]) - group.truncMeans.at(wire));
+    }
+    return adcValuesVec;
+  } // valuesAt()
+
+
+  /// Reference: the per tick average the algorithm computed before packing.
+  std::vector<float> referenceAverage(WireGroup_t const& group) {
+    std::vector<float> corValVec(group.numTicks);
+    for (std::size_t tick = 0; tick < group.numTicks; ++tick) {
+      std::vector<float> const adcValuesVec = valuesAt(group, tick);
+      corValVec[tick]
+        = std::accumulate(adcValuesVec.begin(), adcValuesVec.end(), 0.)
+        / float(adcValuesVec.size());
+    }
+    return corValVec;
+  } // referenceAverage()
+
+
+  /// Reference: the per tick median from a full sort (0 with no wires).
+  std::vector<float> referenceMedian(WireGroup_t const& group) {
+    std::vector<float> corValVec(group.numTicks, 0.f);
+    for (std::size_t tick = 0; tick < group.numTicks; ++tick) {
+      std::vector<float> adcValuesVec = valuesAt(group, tick);
+      if (adcValuesVec.empty()) continue;
+      std::sort(adcValuesVec.begin(), adcValuesVec.end());
+      std::size_t const n = adcValuesVec.size();
+      corValVec[tick] = (n % 2 == 1)
+        ? adcValuesVec[n / 2]
+        : (adcValuesVec[n / 2] + adcValuesVec[n / 2 - 1]) / 2;
+    }
+    return corValVec;
+  } // referenceMedian()
+
+
+  /// Checks that the correction vectors are the same, bit by bit.
+  std::size_t checkSame
+    (std::vector<float> const& corValVec, std::vector<float> const& expected)
+  {
+    BOOST_TEST_REQUIRE(corValVec.size() == expected.size());
+    std::size_t nEmpty = 0U;
+    for (std::size_t tick = 0; tick < expected.size(); ++tick) {
+      if (std::isnan(expected[tick])) { // no wire in range
+        BOOST_CHECK(std::isnan(corValVec[tick]));
+        ++nEmpty;
+      }
+      else BOOST_CHECK_EQUAL(corValVec[tick], expected[tick]);
+    } // for
+    return nEmpty;
+  } // checkSame()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- CorrelatedNoiseBlock tests
+// -----------------------------------------------------------------------------
+void CorrelatedNoiseBlock_average_test() {
+
+  std::mt19937 gen { 2016 };
+  std::uniform_int_distribution<std::size_t> numWiresDist { 3U, 96U };
+  std::uniform_int_distribution<std::size_t> numTicksDist { 1U, 400U };
+
+  CorrelatedNoiseBlock block; // reused as in the algorithm
+  std::size_t nEmpty = 0U;
+  for (int iTrial = 0; iTrial < 50; ++iTrial) {
+    WireGroup_t const group
+      = makeRandomGroup(gen, numWiresDist(gen), numTicksDist(gen));
+    BOOST_TEST_MESSAGE("Trial #" << iTrial << ": " << group.waveforms.size()
+      << " wires, " << group.numTicks << " ticks");
+
+    packGroup(block, group);
+    BOOST_CHECK_EQUAL(block.numWires(), group.waveforms.size());
+    BOOST_CHECK_EQUAL(block.numTicks(), group.numTicks);
+
+    std::vector<float> corValVec(group.numTicks);
+    block.averageCorrection(corValVec);
+    nEmpty += checkSame(corValVec, referenceAverage(group));
+  } // for trials
+
+  BOOST_TEST_MESSAGE(nEmpty << " ticks without wires in range");
+
+} // CorrelatedNoiseBlock_average_test()
+
+
+void CorrelatedNoiseBlock_median_test() {
+
+  std::mt19937 gen { 2017 };
+  std::uniform_int_distribution<std::size_t> numWiresDist { 3U, 96U };
+  std::uniform_int_distribution<std::size_t> numTicksDist { 1U, 400U };
+
+  CorrelatedNoiseBlock block; // reused as in the algorithm
+  for (int iTrial = 0; iTrial < 50; ++iTrial) {
+    WireGroup_t const group
+      = makeRandomGroup(gen, numWiresDist(gen), numTicksDist(gen));
+    BOOST_TEST_MESSAGE("Trial #" << iTrial << ": " << group.waveforms.size()
+      << " wires, " << group.numTicks << " ticks");
+
+    packGroup(block, group);
+
+    std::vector<float> corValVec(group.numTicks);
+    block.medianCorrection(corValVec);
+    checkSame(corValVec, referenceMedian(group));
+  } // for trials
+
+  // exact values: odd and even number of wires, and no wire in range
+  WireGroup_t group;
+  group.numTicks = 3;
+  std::vector<short> const values { 7, 1, 4, 10 };
+  for (std::size_t wire = 0; wire < values.size(); ++wire) {
+    group.waveforms[wire].assign(group.numTicks, values[wire]);
+    group.truncMeans[wire] = 0.f;
+    group.ranges[wire] = { 0U, (wire == 3)? 1U: 2U }; // tick #2 not in range
+  }
+  packGroup(block, group);
+
+  std::vector<float> corValVec;
+  block.medianCorrection(corValVec);
+  BOOST_TEST_REQUIRE(corValVec.size() == 3U);
+  BOOST_CHECK_EQUAL(corValVec[0], 5.5f); // { 1, 4, 7, 10 }
+  BOOST_CHECK_EQUAL(corValVec[1], 4.0f); // { 1, 4, 7 }
+  BOOST_CHECK_EQUAL(corValVec[2], 0.0f); // none
+
+} // CorrelatedNoiseBlock_median_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CorrelatedNoiseBlock_testcase) {
+
+  CorrelatedNoiseBlock_average_test();
+  CorrelatedNoiseBlock_median_test();
+
+} // BOOST_AUTO_TEST_CASE(CorrelatedNoiseBlock_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
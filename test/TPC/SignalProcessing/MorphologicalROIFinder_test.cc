@@ -0,0 +1,217 @@
+/**
+ * @file   test/TPC/SignalProcessing/MorphologicalROIFinder_test.cc
+ * @brief  Unit test for `MorphologicalROIFinder.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/TPC/SignalProcessing/RecoWire/ROITools/MorphologicalROIFinder.h`
+ *
+ * On a synthetic image with noise and tracks, the coarse to fine search with
+ * a margin at least as large as the structuring element must not miss any ROI
+ * of the full resolution search containing a track, and must select exactly
+ * the ticks where the full resolution dilation passes the median and threshold
+ * of the coarse (max-pooled) image. Since those are not the full resolution
+ * ones, ROIs from noise fluctuations close to the threshold may be dropped:
+ * they are only counted.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/SignalProcessing/RecoWire/ROITools/MorphologicalROIFinder.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( MorphologicalROIFinder_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <algorithm> // std::max_element(), std::min()
+#include <random>
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+using MorphologicalROIFinder = icarus_tool::MorphologicalROIFinder;
+using ArrayFloat = MorphologicalROIFinder::ArrayFloat;
+using ArrayBool = MorphologicalROIFinder::ArrayBool;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  std::vector<std::size_t> const StructuringElement { 8U, 16U };
+  constexpr float Threshold = 2.75f;
+
+  constexpr std::size_t NumChannels = 64U;
+  constexpr std::size_t NumTicks = 1000U; // not a multiple of the pooling
+
+
+  /// An image with the ticks where a track was added.
+  struct SyntheticImage_t {
+    ArrayFloat image;
+    ArrayBool signal;
+  }; // SyntheticImage_t
+
+
+  /// Adds a straight track of `amplitude` from (`chan0`, `tick0`) to (`chan1`, `tick1`).
+  void addTrack(SyntheticImage_t& image, std::size_t chan0, std::size_t tick0,
+    std::size_t chan1, std::size_t tick1, float amplitude)
+  {
+    for (std::size_t chan = chan0; chan <= chan1; ++chan) {
+      double const f = (chan1 == chan0)? 0.0: double(chan - chan0) / (chan1 - chan0);
+      std::size_t const tick = tick0 + static_cast<std::size_t>(f * (double(tick1) - tick0));
+      for (std::size_t t = tick; t < std::min(tick + 6U, NumTicks); ++t) {
+        image.image[chan][t] += amplitude;
+        image.signal[chan][t] = true;
+      }
+    }
+  } // addTrack()
+
+
+  /// Returns an image with gaussian noise and a few tracks, some at the edges.
+  SyntheticImage_t makeImage() {
+    std::mt19937 gen { 2020 };
+    std::normal_distribution<float> noiseDist { 0.f, 1.f };
+
+    SyntheticImage_t image;
+    image.image.assign(NumChannels, std::vector<float>(NumTicks));
+    image.signal.assign(NumChannels, std::vector<bool>(NumTicks, false));
+    for (auto& waveform: image.image) for (float& sample: waveform) sample = noiseDist(gen);
+
+    addTrack(image, 5U, 100U, 40U, 400U, 20.f);   // inclined track
+    addTrack(image, 20U, 700U, 22U, 700U, 8.f);   // small isolated deposit
+    addTrack(image, 0U, 0U, 10U, 30U, 15.f);      // at the first channel and tick
+    addTrack(image, 55U, 990U, 63U, 994U, 15.f);  // at the last channel and tick
+    addTrack(image, 30U, 600U, 63U, 610U, 4.f);   // faint, close to the threshold
+    return image;
+  } // makeImage()
+
+
+  /// Reference: full dilation compared to the median and threshold of the coarse image.
+  ArrayBool referenceROIs
+    (MorphologicalROIFinder const& finder, ArrayFloat const& image, std::size_t pooling)
+  {
+    std::size_t const numBins = (NumTicks + pooling - 1) / pooling;
+
+    ArrayFloat coarseImage(NumChannels, std::vector<float>(numBins));
+    for (std::size_t chan = 0; chan < NumChannels; ++chan) {
+      for (std::size_t bin = 0; bin < numBins; ++bin) {
+        coarseImage[chan][bin] = *std::max_element(image[chan].begin() + bin * pooling,
+          image[chan].begin() + std::min((bin + 1) * pooling, NumTicks));
+      }
+    }
+    ArrayFloat coarseMorphed(NumChannels, std::vector<float>(numBins));
+    icarus_signal_processing::Dilation2D(StructuringElement[0],
+      std::max(std::size_t(1), (StructuringElement[1] + pooling - 1) / pooling))
+      (coarseImage.begin(), NumChannels, coarseMorphed.begin());
+
+    ArrayFloat morphed(NumChannels, std::vector<float>(NumTicks));
+    icarus_signal_processing::Dilation2D(StructuringElement[0], StructuringElement[1])
+      (image.begin(), NumChannels, morphed.begin());
+
+    ArrayBool rois(NumChannels, std::vector<bool>(NumTicks, false));
+    for (std::size_t chan = 0; chan < NumChannels; ++chan) {
+      float median = 0.f, threshold = 0.f;
+      finder.getBaselineAndThreshold(coarseMorphed[chan], median, threshold);
+      for (std::size_t tick = 0; tick < NumTicks; ++tick)
+        rois[chan][tick] = (morphed[chan][tick] - median > threshold);
+    }
+    return rois;
+  } // referenceROIs()
+
+
+  /// Number of ROIs in the full resolution selection missed by another one.
+  struct MissedROIs_t {
+    std::size_t withSignal = 0U; ///< Missed ROIs containing track ticks.
+    std::size_t noiseOnly = 0U;  ///< Missed ROIs from noise only.
+  }; // MissedROIs_t
+
+
+  /// Counts the ROIs in `fullROIs` with no tick selected in `rois`.
+  MissedROIs_t countMissedROIs
+    (ArrayBool const& fullROIs, ArrayBool const& rois, ArrayBool const& signal)
+  {
+    MissedROIs_t nMissed;
+    for (std::size_t chan = 0; chan < fullROIs.size(); ++chan) {
+      std::size_t tick = 0;
+      while (tick < NumTicks) {
+        if (!fullROIs[chan][tick]) { ++tick; continue; }
+        bool found = false, hasSignal = false;
+        for (; (tick < NumTicks) && fullROIs[chan][tick]; ++tick) {
+          if (rois[chan][tick]) found = true;
+          if (signal[chan][tick]) hasSignal = true;
+        }
+        if (found) continue;
+        if (hasSignal) {
+          BOOST_TEST_MESSAGE("ROI with signal missed on channel " << chan
+            << " before tick " << tick);
+          ++nMissed.withSignal;
+        }
+        else ++nMissed.noiseOnly;
+      } // while
+    } // for channels
+    return nMissed;
+  } // countMissedROIs()
+
+
+  /// Returns the number of selected ticks.
+  std::size_t countTicks(ArrayBool const& rois) {
+    std::size_t n = 0U;
+    for (auto const& selVals: rois) for (bool sel: selVals) if (sel) ++n;
+    return n;
+  } // countTicks()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- MorphologicalROIFinder tests
+// -----------------------------------------------------------------------------
+void MorphologicalROIFinder_coarseToFine_test(std::size_t pooling) {
+
+  MorphologicalROIFinder const finder { StructuringElement, Threshold };
+  SyntheticImage_t const synthetic = makeImage();
+  ArrayFloat const& image = synthetic.image;
+
+  ArrayBool fullROIs(NumChannels);
+  finder.findROIsFullResolution(image, fullROIs);
+  BOOST_TEST_MESSAGE("Pooling " << pooling << ": " << countTicks(fullROIs)
+    << " ticks selected at full resolution");
+  BOOST_TEST_REQUIRE(countTicks(fullROIs) > 0U);
+
+  // margin (in coarse bins) as large as the structuring element
+  std::size_t const margin = StructuringElement[1];
+  ArrayBool rois(NumChannels);
+  finder.findROIsCoarseToFine(image, pooling, margin, rois);
+
+  BOOST_TEST_REQUIRE(rois.size() == NumChannels);
+  for (auto const& selVals: rois) BOOST_TEST_REQUIRE(selVals.size() == NumTicks);
+
+  MissedROIs_t const nMissed = countMissedROIs(fullROIs, rois, synthetic.signal);
+  BOOST_TEST_MESSAGE("  " << countTicks(rois) << " ticks selected coarse to fine, "
+    << nMissed.noiseOnly << " noise ROIs missed");
+  BOOST_CHECK_EQUAL(nMissed.withSignal, 0U);
+
+  ArrayBool const expected = referenceROIs(finder, image, pooling);
+  std::size_t nDiff = 0U;
+  for (std::size_t chan = 0; chan < NumChannels; ++chan)
+    for (std::size_t tick = 0; tick < NumTicks; ++tick)
+      if (rois[chan][tick] != expected[chan][tick]) ++nDiff;
+  BOOST_CHECK_EQUAL(nDiff, 0U);
+
+} // MorphologicalROIFinder_coarseToFine_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MorphologicalROIFinder_testcase) {
+
+  MorphologicalROIFinder_coarseToFine_test(2U);
+  MorphologicalROIFinder_coarseToFine_test(4U);
+  MorphologicalROIFinder_coarseToFine_test(7U);
+
+} // BOOST_AUTO_TEST_CASE(MorphologicalROIFinder_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
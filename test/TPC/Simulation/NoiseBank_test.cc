@@ -0,0 +1,301 @@
+/**
+ * @file   test/TPC/Simulation/NoiseBank_test.cc
+ * @brief  Unit test for `NoiseBank.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/TPC/Simulation/DetSim/tools/NoiseBank.h`
+ *
+ * The bank is filled with waveforms of a known amplitude spectrum and random
+ * phases; every drawn waveform must preserve that spectrum exactly, up to the
+ * requested scale, since circular shifts and sign flips only change phases.
+ * Banks saved to file are reused only for the same key and sizes, and shared
+ * banks are generated once per job.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Simulation/DetSim/tools/NoiseBank.h"
+
+// CLHEP libraries
+#include "CLHEP/Random/JamesRandom.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( NoiseBank_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio> // std::remove(), std::rename()
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  constexpr std::size_t NTicks = 64;
+
+  /// Amplitude of the cosine at frequency bin `k` in the test waveforms.
+  double amplitude(std::size_t k) { return 1.0 / (1.0 + k); }
+
+  /// Fills `wave` with cosines of fixed amplitudes and random phases.
+  struct TestNoiseGenerator {
+    std::mt19937 gen { 12345 };
+
+    void operator() (icarusutil::TimeVec& wave) {
+      std::uniform_real_distribution<double> phaseDist { 0.0, 2.0 * M_PI };
+      std::fill(wave.begin(), wave.end(), 0.0);
+      for (std::size_t k = 1; k < wave.size() / 2; ++k) {
+        double const phase = phaseDist(gen);
+        for (std::size_t t = 0; t < wave.size(); ++t) {
+          wave[t] += amplitude(k)
+            * std::cos(2.0 * M_PI * k * t / wave.size() + phase);
+        }
+      } // for k
+    } // operator()
+  }; // TestNoiseGenerator
+
+
+  /// Magnitudes of the discrete Fourier transform of `wave` (naive).
+  std::vector<double> spectrum(icarusutil::TimeVec const& wave) {
+    std::size_t const N = wave.size();
+    std::vector<double> mag(N / 2, 0.0);
+    for (std::size_t k = 0; k < N / 2; ++k) {
+      std::complex<double> sum { 0.0, 0.0 };
+      for (std::size_t t = 0; t < N; ++t)
+        sum += wave[t] * std::polar(1.0, -2.0 * M_PI * k * t / N);
+      mag[k] = std::abs(sum);
+    }
+    return mag;
+  } // spectrum()
+
+
+  /// Returns the shift `s` such that `wave[t] == sign * scale * entry[t + s]`,
+  /// or `NTicks` if there is none.
+  std::size_t findShift(
+    icarus_tool::NoiseBank const& bank, icarusutil::TimeVec const& wave,
+    double scale, double& sign
+  ) {
+    for (std::size_t idx = 0; idx < bank.size(); ++idx) {
+      auto const* entry = bank.waveform(idx);
+      for (std::size_t shift = 0; shift < NTicks; ++shift) {
+        for (double s: { +1.0, -1.0 }) {
+          bool match = true;
+          for (std::size_t t = 0; match && (t < NTicks); ++t) {
+            match = std::abs(wave[t] - s * scale * entry[(t + shift) % NTicks])
+              < 1e-5 * scale;
+          }
+          if (match) { sign = s; return shift; }
+        } // for sign
+      } // for shift
+    } // for entry
+    return NTicks;
+  } // findShift()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- NoiseBank tests
+// -----------------------------------------------------------------------------
+void NoiseBank_spectrum_test() {
+
+  constexpr std::size_t NWaveforms = 16;
+  constexpr double Scale = 2.5;
+
+  icarus_tool::NoiseBank bank;
+  BOOST_CHECK(bank.empty());
+
+  bank.fill(NWaveforms, NTicks, TestNoiseGenerator{});
+  BOOST_CHECK_EQUAL(bank.size(), NWaveforms);
+  BOOST_CHECK_EQUAL(bank.nTicks(), NTicks);
+
+  CLHEP::HepJamesRandom engine { 5000 };
+
+  std::set<std::size_t> shifts;
+  unsigned int nNegative = 0;
+
+  icarusutil::TimeVec noise(NTicks, 0.0);
+  for (unsigned int iDraw = 0; iDraw < 200; ++iDraw) {
+
+    bank.draw(engine, noise, Scale);
+
+    // each drawn waveform carries the input spectrum, scaled
+    std::vector<double> const mag = spectrum(noise);
+    BOOST_CHECK_SMALL(mag[0], 1e-3);
+    for (std::size_t k = 1; k < NTicks / 2; ++k) {
+      BOOST_CHECK_CLOSE
+        (mag[k], Scale * amplitude(k) * NTicks / 2.0, 1e-3 /* percent */);
+    }
+
+    // ... and it is a shifted, possibly flipped bank entry
+    double sign = 0.0;
+    std::size_t const shift = findShift(bank, noise, Scale, sign);
+    BOOST_CHECK_LT(shift, NTicks);
+    shifts.insert(shift);
+    if (sign < 0.0) ++nNegative;
+
+  } // for draws
+
+  // the shifts and the signs are actually being randomized
+  BOOST_CHECK_GT(shifts.size(), 10U);
+  BOOST_CHECK_GT(nNegative, 50U);
+  BOOST_CHECK_LT(nNegative, 150U);
+
+} // NoiseBank_spectrum_test()
+
+
+void NoiseBank_reseed_test() {
+
+  icarus_tool::NoiseBank bank;
+  bank.fill(8, NTicks, TestNoiseGenerator{});
+
+  CLHEP::HepJamesRandom engine;
+  icarusutil::TimeVec first(NTicks), second(NTicks);
+
+  // reseeding reproduces the draw, as for the coherent noise of a board
+  engine.setSeed(1042, 0);
+  bank.draw(engine, first, 1.0);
+  engine.setSeed(1042, 0);
+  bank.draw(engine, second, 1.0);
+
+  BOOST_CHECK_EQUAL_COLLECTIONS
+    (first.begin(), first.end(), second.begin(), second.end());
+
+} // NoiseBank_reseed_test()
+
+
+void NoiseBank_file_test() {
+
+  using icarus_tool::NoiseBank;
+
+  std::string const baseName { "NoiseBank_test" };
+  std::uint64_t const configKey = NoiseBank::KeyHasher().add(12345L).value();
+  std::string const fileName
+    = NoiseBank::bankFileName(baseName, configKey, 4, NTicks);
+  std::remove(fileName.c_str());
+
+  // the first request generates and saves the bank...
+  NoiseBank bank;
+  bank.fillOrLoad(baseName, configKey, 4, NTicks, TestNoiseGenerator{});
+
+  // ... the next one maps it, and must not call the generator
+  NoiseBank mapped;
+  mapped.fillOrLoad(baseName, configKey, 4, NTicks,
+    [](icarusutil::TimeVec&){ BOOST_ERROR("Bank regenerated"); });
+
+  BOOST_CHECK_EQUAL(mapped.size(), bank.size());
+  BOOST_CHECK_EQUAL(mapped.nTicks(), bank.nTicks());
+  BOOST_CHECK_EQUAL(mapped.key(), bank.key());
+  for (std::size_t idx = 0; idx < bank.size(); ++idx) {
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+      bank.waveform(idx), bank.waveform(idx) + NTicks,
+      mapped.waveform(idx), mapped.waveform(idx) + NTicks
+      );
+  }
+
+  // a different configuration does not reuse the bank
+  std::uint64_t const otherKey = NoiseBank::KeyHasher().add(54321L).value();
+  BOOST_CHECK_NE(otherKey, configKey);
+  std::string const otherFileName
+    = NoiseBank::bankFileName(baseName, otherKey, 4, NTicks);
+  BOOST_CHECK_NE(otherFileName, fileName);
+  std::remove(otherFileName.c_str());
+
+  unsigned int nGenerated = 0U;
+  TestNoiseGenerator generator;
+  NoiseBank other;
+  other.fillOrLoad(baseName, otherKey, 4, NTicks,
+    [&](icarusutil::TimeVec& wave){ ++nGenerated; generator(wave); });
+  BOOST_CHECK_EQUAL(nGenerated, 4U);
+  std::remove(otherFileName.c_str());
+
+  // a different size is in a different file too...
+  BOOST_CHECK_NE(NoiseBank::bankFileName(baseName, configKey, 8, NTicks), fileName);
+  BOOST_CHECK_NE(NoiseBank::bankFileName(baseName, configKey, 4, 2 * NTicks), fileName);
+
+  // ... and a file whose content does not match its name is rejected
+  std::string const wrongFileName
+    = NoiseBank::bankFileName(baseName, configKey, 8, NTicks);
+  BOOST_REQUIRE_EQUAL(std::rename(fileName.c_str(), wrongFileName.c_str()), 0);
+  NoiseBank wrong;
+  BOOST_CHECK_THROW(
+    wrong.fillOrLoad(baseName, configKey, 8, NTicks, TestNoiseGenerator{}),
+    cet::exception
+    );
+  std::remove(wrongFileName.c_str());
+
+  // no temporary file is left behind
+  BOOST_CHECK_NE(::access((fileName + ".tmp" + std::to_string(::getpid())).c_str(), F_OK), 0);
+
+} // NoiseBank_file_test()
+
+
+void NoiseBank_shared_test() {
+
+  using icarus_tool::NoiseBank;
+
+  unsigned int nGenerated = 0U;
+  TestNoiseGenerator generator;
+  auto countingGenerator
+    = [&](icarusutil::TimeVec& wave){ ++nGenerated; generator(wave); };
+
+  // the same bank is handed out to all the requests...
+  auto bank = NoiseBank::shared("", 101, 4, NTicks, countingGenerator);
+  auto again = NoiseBank::shared("", 101, 4, NTicks, countingGenerator);
+  BOOST_CHECK_EQUAL(bank.get(), again.get());
+  BOOST_CHECK_EQUAL(nGenerated, 4U);
+
+  // ... but different keys or sizes are different banks
+  auto other = NoiseBank::shared("", 102, 4, NTicks, countingGenerator);
+  auto longer = NoiseBank::shared("", 101, 4, 2 * NTicks, countingGenerator);
+  BOOST_CHECK_NE(other.get(), bank.get());
+  BOOST_CHECK_NE(longer.get(), bank.get());
+  BOOST_CHECK_EQUAL(nGenerated, 12U);
+
+  // a bank no longer held by anyone is released
+  bank.reset();
+  again.reset();
+  auto regenerated = NoiseBank::shared("", 101, 4, NTicks, countingGenerator);
+  BOOST_CHECK_EQUAL(nGenerated, 16U);
+
+  // concurrent requests still generate the bank only once
+  unsigned int nConcurrentGenerated = 0U; // protected by the bank registry
+  std::vector<std::shared_ptr<const NoiseBank>> banks(8);
+  std::vector<std::thread> threads;
+  for (std::size_t iThread = 0; iThread < banks.size(); ++iThread) {
+    threads.emplace_back([&banks,&nConcurrentGenerated,iThread](){
+      banks[iThread] = NoiseBank::shared("", 103, 4, NTicks,
+        [&nConcurrentGenerated](icarusutil::TimeVec& wave)
+          { ++nConcurrentGenerated; TestNoiseGenerator{}(wave); }
+        );
+      });
+  } // for
+  for (std::thread& thread: threads) thread.join();
+
+  BOOST_CHECK_EQUAL(nConcurrentGenerated, 4U);
+  for (auto const& threadBank: banks)
+    BOOST_CHECK_EQUAL(threadBank.get(), banks.front().get());
+
+} // NoiseBank_shared_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(NoiseBank_testcase) {
+
+  NoiseBank_spectrum_test();
+  NoiseBank_reseed_test();
+  NoiseBank_file_test();
+  NoiseBank_shared_test();
+
+} // BOOST_AUTO_TEST_CASE(NoiseBank_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
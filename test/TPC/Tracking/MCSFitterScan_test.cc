@@ -0,0 +1,168 @@
+/**
+ * @file   test/TPC/Tracking/MCSFitterScan_test.cc
+ * @brief  Unit test of the momentum scan options of `TrajectoryMCSFitterICARUS`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/TPC/Tracking/MCS/TrajectoryMCSFitterICARUS.h`
+ *
+ * A sample of muon tracks with multiple scattering and energy loss is
+ * generated, and each track is fitted with the full likelihood scan, with the
+ * coarse-to-fine scan and with the range tables.
+ * The coarse-to-fine scan can not find a better likelihood than the full scan,
+ * and it may settle in a different minimum on tracks with a multimodal
+ * likelihood; when it finds the same minimum, the result must be identical,
+ * and that must happen for most of the tracks.
+ * The range tables must give momenta close to the ones from stepping.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Tracking/MCS/TrajectoryMCSFitterICARUS.h"
+
+// LArSoft libraries
+#include "lardataobj/RecoBase/Track.h"
+#include "lardataobj/RecoBase/TrackTrajectory.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( MCSFitterScan_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <algorithm> // std::max()
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Muon trajectory with points every `step` cm, scattered as per Highland.
+  recob::TrackTrajectory makeMuonTrajectory
+    (std::mt19937& gen, double p, double length, double step = 0.3)
+  {
+    constexpr double mass = 0.105658;  // GeV
+    constexpr double dEdx = 0.0021;    // GeV/cm
+    constexpr double X0   = 14.0;      // cm
+
+    std::normal_distribution<double> gaus;
+
+    recob::TrackTrajectory::Positions_t positions;
+    recob::TrackTrajectory::Momenta_t momenta;
+
+    recob::tracking::Point_t pos { 0.0, 0.0, 0.0 };
+    recob::tracking::Vector_t dir { 0.0, 0.0, 1.0 };
+    double E = std::sqrt(p*p + mass*mass);
+
+    for (double travelled = 0.0; travelled < length; travelled += step) {
+      double const pNow = std::sqrt(E*E - mass*mass);
+      positions.push_back(pos);
+      momenta.push_back(dir * pNow);
+
+      double const beta = pNow / E;
+      double const theta0 = 0.0136 / (pNow*beta) * std::sqrt(step/X0)
+        * (1.0 + 0.038 * std::log(step/X0));
+      // kick perpendicular to the direction
+      recob::tracking::Vector_t const u
+        = dir.Cross(std::abs(dir.X()) < 0.9
+          ? recob::tracking::Vector_t{ 1.0, 0.0, 0.0 }
+          : recob::tracking::Vector_t{ 0.0, 1.0, 0.0 }
+          ).Unit();
+      recob::tracking::Vector_t const v = dir.Cross(u);
+      dir = (dir + theta0 * (gaus(gen) * u + gaus(gen) * v)).Unit();
+      pos += step * dir;
+
+      E -= dEdx * step;
+      if (E <= mass + 0.01) break;
+    } // for
+
+    recob::TrackTrajectory::Flags_t flags(positions.size());
+    return { std::move(positions), std::move(momenta), std::move(flags), true };
+  } // makeMuonTrajectory()
+
+
+  trkf::TrajectoryMCSFitterICARUS makeFitter
+    (bool rangeTable, int coarseScanStride)
+  {
+    // same settings as mcsfitproducer_icarus.fcl
+    return { 13, 6, 14.0, 2, 10, 0, 0.01, 7.50, 0.01, 3.0,
+      rangeTable, coarseScanStride };
+  }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- MCS fitter scan tests
+// -----------------------------------------------------------------------------
+void MCSFitterScan_scan_test() {
+
+  constexpr unsigned int NTracks = 100;
+
+  std::mt19937 gen { 2021 };
+  std::uniform_real_distribution<double> pDist { 0.3, 3.0 };
+  std::uniform_real_distribution<double> lengthDist { 50.0, 400.0 };
+
+  std::vector<recob::TrackTrajectory> sample;
+  for (unsigned int iTrack = 0; iTrack < NTracks; ++iTrack)
+    sample.push_back(makeMuonTrajectory(gen, pDist(gen), lengthDist(gen)));
+
+  auto const fullScan = makeFitter(false, 1);
+  auto const coarseScan = makeFitter(false, 10);
+  auto const rangeTable = makeFitter(true, 1); // full scan, to compare only the tables
+
+  unsigned int nSameMinimum = 0U;
+  double maxTableDiff = 0.0;
+  for (unsigned int iTrack = 0; iTrack < NTracks; ++iTrack) {
+    BOOST_TEST_MESSAGE("Track #" << iTrack);
+
+    auto const& traj = sample[iTrack];
+    recob::MCSFitResult const full = fullScan.fitMcs(traj);
+    recob::MCSFitResult const coarse = coarseScan.fitMcs(traj);
+    recob::MCSFitResult const table = rangeTable.fitMcs(traj);
+
+    // the full scan finds the lowest point of the scan grid
+    BOOST_CHECK_GE(coarse.fwdLogLikelihood(), full.fwdLogLikelihood());
+    BOOST_CHECK_GE(coarse.bwdLogLikelihood(), full.bwdLogLikelihood());
+
+    // the same minimum gives the same result
+    bool const sameFwd = (coarse.fwdLogLikelihood() == full.fwdLogLikelihood());
+    bool const sameBwd = (coarse.bwdLogLikelihood() == full.bwdLogLikelihood());
+    if (sameFwd) {
+      BOOST_CHECK_EQUAL(coarse.fwdMomentum(), full.fwdMomentum());
+      BOOST_CHECK_EQUAL(coarse.fwdMomUncertainty(), full.fwdMomUncertainty());
+    }
+    if (sameBwd) {
+      BOOST_CHECK_EQUAL(coarse.bwdMomentum(), full.bwdMomentum());
+      BOOST_CHECK_EQUAL(coarse.bwdMomUncertainty(), full.bwdMomUncertainty());
+    }
+    if (sameFwd && sameBwd) ++nSameMinimum;
+
+    if (full.fwdMomentum() > 0.0) {
+      maxTableDiff = std::max(maxTableDiff,
+        std::abs(table.fwdMomentum() - full.fwdMomentum()) / full.fwdMomentum()
+        );
+    }
+  } // for
+
+  BOOST_TEST_MESSAGE("Coarse scan found the same minimum on " << nSameMinimum
+    << "/" << NTracks << " tracks; largest relative momentum difference with"
+    " range tables: " << maxTableDiff);
+  BOOST_CHECK_GE(nSameMinimum, NTracks * 3 / 4);
+  BOOST_CHECK_LT(maxTableDiff, 0.1);
+
+} // MCSFitterScan_scan_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MCSFitterScan_testcase) {
+
+  MCSFitterScan_scan_test();
+
+} // BOOST_AUTO_TEST_CASE(MCSFitterScan_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
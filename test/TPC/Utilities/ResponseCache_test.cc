@@ -0,0 +1,197 @@
+/**
+ * @file   test/TPC/Utilities/ResponseCache_test.cc
+ * @brief  Unit test for `ResponseCache.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/TPC/Utilities/tools/ResponseCache.h`
+ *
+ * An entry written to the cache is read back exactly with the same key, and
+ * is rejected when any part of the key, or the file, does not match.
+ */
+
+// ICARUS libraries
+#include "icaruscode/TPC/Utilities/tools/ResponseCache.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ResponseCache_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <cmath>
+#include <cstdio> // std::remove()
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h> // ::getpid(), ::truncate()
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  constexpr std::size_t Plane = 2;
+  constexpr std::size_t NTimeSamples = 4096;
+  constexpr double SamplingRate = 400.;
+  constexpr double Weight = 0.9;
+
+  /// Returns a cache entry with recognizable content.
+  icarus_tool::ResponseCacheEntry makeEntry() {
+
+    icarus_tool::ResponseCacheEntry entry;
+
+    entry.t0Offset = -12.5;
+    for (std::size_t i = 0; i < 300; ++i)
+      entry.response.push_back(std::sin(0.1 * i) / (1.0 + i));
+    for (std::size_t i = 0; i < NTimeSamples / 2 + 1; ++i) {
+      entry.convKernel.emplace_back(std::cos(0.01 * i), -1.0 / (3.0 + i));
+      entry.deconvKernel.emplace_back(1.0 / (1.0 + i), std::sin(0.02 * i));
+    }
+
+    return entry;
+  } // makeEntry()
+
+
+  /// Returns the configuration ID of a field response with the `content`.
+  std::string configIDfor(std::vector<double> const& content)
+    { return icarus_tool::responseCacheConfigID("0123456789abcdef0123456789abcdef", content); }
+
+
+  /// Returns the name of a scratch cache file unique to this process.
+  std::string scratchPath(std::string const& name)
+    { return "ResponseCache_test_" + std::to_string(::getpid()) + "_" + name + ".bin"; }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- ResponseCache tests
+// -----------------------------------------------------------------------------
+void ResponseCache_configID_test() {
+
+  std::vector<double> const field { 0.0, 1.5, -2.25, 3.0 };
+  std::vector<double> changed = field;
+  changed[2] = -2.25000001;
+
+  std::string const configID = configIDfor(field);
+
+  // the field response content is part of the key
+  BOOST_CHECK_EQUAL(configID, configIDfor(field));
+  BOOST_CHECK_NE(configID, configIDfor(changed));
+  BOOST_CHECK_NE(configID, configIDfor({}));
+  BOOST_CHECK_NE(configID,
+    icarus_tool::responseCacheConfigID("fedcba9876543210fedcba9876543210", field));
+
+  // and it fits in the cache file header
+  BOOST_CHECK_LT(configID.size(), sizeof(icarus_tool::ResponseCacheHeader::configID));
+
+  // different keys go to different files
+  BOOST_CHECK_NE(
+    icarus_tool::responseCachePath(".", configID, Plane, NTimeSamples, SamplingRate, Weight),
+    icarus_tool::responseCachePath(".", configIDfor(changed), Plane, NTimeSamples, SamplingRate, Weight)
+    );
+  BOOST_CHECK_NE(
+    icarus_tool::responseCachePath(".", configID, Plane, NTimeSamples, SamplingRate, Weight),
+    icarus_tool::responseCachePath(".", configID, Plane, NTimeSamples, SamplingRate, Weight * (1.0 + 1e-15))
+    );
+
+} // ResponseCache_configID_test()
+
+
+void ResponseCache_roundTrip_test() {
+
+  std::string const configID = configIDfor({ 0.5, -1.0, 2.0 });
+  std::string const path = scratchPath("roundTrip");
+  icarus_tool::ResponseCacheEntry const written = makeEntry();
+
+  BOOST_TEST_REQUIRE(icarus_tool::writeResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, written));
+
+  // no temporary file is left behind
+  BOOST_CHECK(!std::ifstream(path + ".tmp" + std::to_string(::getpid())));
+
+  icarus_tool::ResponseCacheEntry read;
+  BOOST_TEST_REQUIRE(icarus_tool::readResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, read));
+
+  // the content is copied bit by bit
+  BOOST_CHECK_EQUAL(read.t0Offset, written.t0Offset);
+  BOOST_CHECK(read.response == written.response);
+  BOOST_CHECK(read.convKernel == written.convKernel);
+  BOOST_CHECK(read.deconvKernel == written.deconvKernel);
+
+  // rewriting an entry replaces it
+  icarus_tool::ResponseCacheEntry rewritten = makeEntry();
+  rewritten.t0Offset = 3.0;
+  rewritten.response.resize(10);
+  BOOST_TEST_REQUIRE(icarus_tool::writeResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, rewritten));
+  BOOST_TEST_REQUIRE(icarus_tool::readResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, read));
+  BOOST_CHECK_EQUAL(read.t0Offset, rewritten.t0Offset);
+  BOOST_CHECK(read.response == rewritten.response);
+
+  std::remove(path.c_str());
+
+} // ResponseCache_roundTrip_test()
+
+
+void ResponseCache_mismatch_test() {
+
+  std::string const configID = configIDfor({ 0.5, -1.0, 2.0 });
+  std::string const path = scratchPath("mismatch");
+  icarus_tool::ResponseCacheEntry const written = makeEntry();
+
+  BOOST_TEST_REQUIRE(icarus_tool::writeResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, written));
+
+  // each part of the key must match, or the entry is rejected
+  icarus_tool::ResponseCacheEntry read;
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configIDfor({ 0.5, -1.0, 2.5 }), Plane, NTimeSamples, SamplingRate, Weight, read));
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configID, Plane + 1, NTimeSamples, SamplingRate, Weight, read));
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configID, Plane, 2 * NTimeSamples, SamplingRate, Weight, read));
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configID, Plane, NTimeSamples, 2. * SamplingRate, Weight, read));
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, 0.5 * Weight, read));
+
+  // a rejected entry leaves the output untouched
+  BOOST_CHECK(read.response.empty());
+  BOOST_CHECK(read.convKernel.empty());
+  BOOST_CHECK(read.deconvKernel.empty());
+
+  // a truncated file does not match its header
+  BOOST_TEST_REQUIRE(::truncate(path.c_str(), sizeof(icarus_tool::ResponseCacheHeader) + 8) == 0);
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, read));
+
+  // a missing file is not an error
+  std::remove(path.c_str());
+  BOOST_CHECK(!icarus_tool::readResponseCache
+    (path, configID, Plane, NTimeSamples, SamplingRate, Weight, read));
+
+  // a configuration ID which does not fit the header is not written
+  BOOST_CHECK(!icarus_tool::writeResponseCache
+    (path, std::string(100, 'x'), Plane, NTimeSamples, SamplingRate, Weight, written));
+  BOOST_CHECK(!std::ifstream(path));
+
+} // ResponseCache_mismatch_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ResponseCache_testcase) {
+
+  ResponseCache_configID_test();
+  ResponseCache_roundTrip_test();
+  ResponseCache_mismatch_test();
+
+} // BOOST_AUTO_TEST_CASE(ResponseCache_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,169 @@
+/**
+ * @file   test/Utilities/ADCCountHistogram_test.cc
+ * @brief  Unit test for `ADCCountHistogram.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Utilities/ADCCountHistogram.h`
+ *
+ * The statistics from the histogram are compared with the ones from sorting
+ * the samples, on random waveforms with a baseline, noise and some pulses.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Utilities/ADCCountHistogram.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ADCCountHistogram_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <algorithm> // std::sort()
+#include <cmath> // std::abs(), std::lround()
+#include <map>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+// --- ADCCountHistogram tests
+// -----------------------------------------------------------------------------
+void ADCCountHistogram_empty_test() {
+
+  std::vector<short> const waveform;
+  icarus::ns::util::ADCCountHistogram<short> const counts
+    { waveform.begin(), waveform.end() };
+
+  BOOST_CHECK(counts.empty());
+  BOOST_CHECK_EQUAL(counts.nEntries(), 0U);
+  BOOST_CHECK_EQUAL(counts.count(0), 0U);
+  BOOST_CHECK_EQUAL(counts.sumsAround(0, 3).n, 0U);
+  BOOST_CHECK_EQUAL(counts.deviations(0.0).n, 0U);
+  BOOST_CHECK_EQUAL(counts.closestTo(0.0, 10U).n, 0U);
+
+} // ADCCountHistogram_empty_test()
+
+
+void ADCCountHistogram_simple_test() {
+
+  std::vector<short> const waveform { 5, 3, 4, 4, 9, 3, 4, 2 };
+  icarus::ns::util::ADCCountHistogram<short> const counts
+    { waveform.begin(), waveform.end() };
+
+  BOOST_CHECK_EQUAL(counts.nEntries(), waveform.size());
+  BOOST_CHECK_EQUAL(counts.min(), 2);
+  BOOST_CHECK_EQUAL(counts.max(), 9);
+  BOOST_CHECK_EQUAL(counts.count(4), 3U);
+  BOOST_CHECK_EQUAL(counts.count(7), 0U);
+  BOOST_CHECK_EQUAL(counts.count(10), 0U);
+  BOOST_CHECK_EQUAL(counts.mode(), 4);
+  BOOST_CHECK_EQUAL(counts.modeCount(), 3U);
+  BOOST_CHECK_EQUAL(counts.median(), 4); // sorted: 2 3 3 4 [4] 4 5 9
+  BOOST_CHECK_EQUAL(counts.nthValue(0U), 2);
+  BOOST_CHECK_EQUAL(counts.nthValue(7U), 9);
+
+  auto const window = counts.sumsAround(4, 1); // 3 3 4 4 4 5
+  BOOST_CHECK_EQUAL(window.n, 6U);
+  BOOST_CHECK_CLOSE(window.mean(), 23.0 / 6.0, 1e-8);
+
+  auto const closest = counts.closestTo(4.0, 5U); // 4 4 4 and two of 3 or 5
+  BOOST_CHECK_EQUAL(closest.n, 5U);
+  BOOST_CHECK_CLOSE(closest.sumSq, 2.0, 1e-8);
+
+} // ADCCountHistogram_simple_test()
+
+
+void ADCCountHistogram_random_test() {
+
+  std::mt19937 gen { 2026 };
+  std::uniform_int_distribution<int> lengthDist { 1, 4096 };
+  std::uniform_real_distribution<double> uniform { 0.0, 1.0 };
+
+  icarus::ns::util::ADCCountHistogram<short> counts; // reused
+  for (int iWaveform = 0; iWaveform < 200; ++iWaveform) {
+
+    std::normal_distribution<double> noise
+      { 2000.0 + 50.0 * uniform(gen), 0.5 + 8.0 * uniform(gen) };
+    std::vector<short> waveform(lengthDist(gen));
+    for (auto& sample: waveform) {
+      sample = static_cast<short>(std::lround(noise(gen)));
+      if (uniform(gen) < 0.02) sample -= static_cast<short>(500 * uniform(gen));
+    }
+
+    counts.fill(waveform.begin(), waveform.end());
+    BOOST_TEST_MESSAGE("Waveform #" << iWaveform << " (" << waveform.size()
+      << " samples)");
+
+    // reference: mode as the first value reaching the largest count
+    std::map<short, unsigned int> frequencies;
+    short mode = 0;
+    unsigned int modeCount = 0U;
+    for (short const sample: waveform) {
+      if (++frequencies[sample] > modeCount) {
+        mode = sample;
+        modeCount = frequencies[sample];
+      }
+    } // for
+    BOOST_CHECK_EQUAL(counts.mode(), mode);
+    BOOST_CHECK_EQUAL(counts.modeCount(), modeCount);
+
+    std::vector<short> sorted { waveform };
+    std::sort(sorted.begin(), sorted.end());
+    BOOST_CHECK_EQUAL(counts.median(), sorted[sorted.size() / 2]);
+
+    double windowSum = 0.0;
+    std::size_t windowCount = 0U;
+    for (short const sample: waveform) {
+      if (std::abs(sample - mode) > 3) continue;
+      windowSum += sample;
+      ++windowCount;
+    }
+    auto const window = counts.sumsAround(mode, 3);
+    BOOST_CHECK_EQUAL(window.n, windowCount);
+    BOOST_CHECK_CLOSE(window.mean(), windowSum / windowCount, 1e-8);
+
+    // truncation by distance from a non-integral reference
+    double const reference = mode + uniform(gen) - 0.5;
+    std::size_t const nKeep = waveform.size() * 85 / 100;
+    std::vector<double> dev;
+    for (short const sample: waveform) dev.push_back(sample - reference);
+    std::sort(dev.begin(), dev.end(),
+      [](double a, double b){ return std::abs(a) < std::abs(b); });
+    double sumSq = 0.0;
+    for (std::size_t i = 0; i < nKeep; ++i) sumSq += dev[i] * dev[i];
+    auto const closest = counts.closestTo(reference, nKeep);
+    BOOST_CHECK_EQUAL(closest.n, nKeep);
+    if (nKeep > 0U) BOOST_CHECK_CLOSE(closest.sumSq, sumSq, 1e-6);
+
+    // truncation by maximum deviation
+    double const maxDev = 2.5 * counts.deviations(reference).rms();
+    double truncSumSq = 0.0;
+    std::size_t truncCount = 0U;
+    for (double const d: dev) {
+      if (std::abs(d) > maxDev) continue;
+      truncSumSq += d * d;
+      ++truncCount;
+    }
+    auto const truncated = counts.deviations(reference, maxDev);
+    BOOST_CHECK_EQUAL(truncated.n, truncCount);
+    if (truncCount > 0U) BOOST_CHECK_CLOSE(truncated.sumSq, truncSumSq, 1e-6);
+
+  } // for waveforms
+
+} // ADCCountHistogram_random_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ADCCountHistogram_testcase) {
+
+  ADCCountHistogram_empty_test();
+  ADCCountHistogram_simple_test();
+  ADCCountHistogram_random_test();
+
+} // BOOST_AUTO_TEST_CASE(ADCCountHistogram_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+/**
+ * @file   test/Utilities/DataProductPointerMap_test.cc
+ * @brief  Unit test for `util::DataProductPointerIndex`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Utilities/DataProductPointerMap.h`
+ *
+ * Elements of several data products are looked up in the index, which must
+ * return the _art_ pointer with the ID of their product and their position in
+ * it, and reject elements of no registered product.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Utilities/DataProductPointerMap.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( DataProductPointerMap_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <stdexcept> // std::out_of_range
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+// -----------------------------------------------------------------------------
+using Index_t = util::DataProductPointerIndex<int>;
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Checks that each element of `data` is found in `index` in product `id`.
+  void checkProduct
+    (Index_t const& index, std::vector<int> const& data, art::ProductID id)
+  {
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      BOOST_TEST_MESSAGE("Product " << id << ", element #" << i);
+      BOOST_CHECK(index.contains(&data[i]));
+
+      art::Ptr<int> const ptr = index.at(&data[i]);
+      BOOST_CHECK_EQUAL(ptr.id(), id);
+      BOOST_CHECK_EQUAL(ptr.key(), i);
+
+      art::Ptr<int> const uncheckedPtr = index[&data[i]];
+      BOOST_CHECK_EQUAL(uncheckedPtr.id(), id);
+      BOOST_CHECK_EQUAL(uncheckedPtr.key(), i);
+    } // for
+  } // checkProduct()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- DataProductPointerIndex tests
+// -----------------------------------------------------------------------------
+void DataProductPointerIndex_empty_test() {
+
+  int const notRegistered = 0;
+
+  Index_t index;
+  BOOST_CHECK(index.empty());
+  BOOST_CHECK_EQUAL(index.size(), 0U);
+  BOOST_CHECK(!index.contains(&notRegistered));
+  BOOST_CHECK_THROW(index.at(&notRegistered), std::out_of_range);
+
+  // an empty data product is not registered
+  std::vector<int> const empty;
+  index.add(empty, art::ProductID{ 3U }, nullptr);
+  BOOST_CHECK(index.empty());
+  BOOST_CHECK(!index.contains(&notRegistered));
+  BOOST_CHECK_THROW(index.at(&notRegistered), std::out_of_range);
+
+} // DataProductPointerIndex_empty_test()
+
+
+void DataProductPointerIndex_singleProduct_test() {
+
+  std::vector<int> const data { 4, 5, 6, 7 };
+  std::vector<int> const other { 8, 9 };
+
+  Index_t index;
+  index.add(data, art::ProductID{ 1U }, nullptr);
+
+  BOOST_CHECK(!index.empty());
+  BOOST_CHECK_EQUAL(index.size(), data.size());
+  checkProduct(index, data, art::ProductID{ 1U });
+
+  // with a single product, a foreign pointer is still rejected
+  BOOST_CHECK(!index.contains(&other.front()));
+  BOOST_CHECK_THROW(index.at(&other.front()), std::out_of_range);
+  BOOST_CHECK(!index.contains(data.data() + data.size()));
+  BOOST_CHECK_THROW(index.at(data.data() + data.size()), std::out_of_range);
+
+  index.clear();
+  BOOST_CHECK(index.empty());
+  BOOST_CHECK(!index.contains(&data.front()));
+
+} // DataProductPointerIndex_singleProduct_test()
+
+
+void DataProductPointerIndex_severalProducts_test() {
+
+  std::vector<int> const first { 1, 2, 3 };
+  std::vector<int> const second { 10 };
+  std::vector<int> const third { 20, 21, 22, 23, 24 };
+  std::vector<int> const notRegistered { 30, 31 };
+
+  // the order of registration does not matter
+  Index_t index;
+  index.add(third, art::ProductID{ 13U }, nullptr);
+  index.add(first, art::ProductID{ 11U }, nullptr);
+  index.add(second, art::ProductID{ 12U }, nullptr);
+
+  BOOST_CHECK_EQUAL(index.size(), first.size() + second.size() + third.size());
+  checkProduct(index, first, art::ProductID{ 11U });
+  checkProduct(index, second, art::ProductID{ 12U });
+  checkProduct(index, third, art::ProductID{ 13U });
+
+  for (int const& value: notRegistered) {
+    BOOST_CHECK(!index.contains(&value));
+    BOOST_CHECK_THROW(index.at(&value), std::out_of_range);
+  }
+
+} // DataProductPointerIndex_severalProducts_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(DataProductPointerIndex_testcase) {
+
+  DataProductPointerIndex_empty_test();
+  DataProductPointerIndex_singleProduct_test();
+  DataProductPointerIndex_severalProducts_test();
+
+} // BOOST_AUTO_TEST_CASE(DataProductPointerIndex_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+/**
+ * @file   test/Utilities/EventRegistry_test.cc
+ * @brief  Unit test and contention benchmark for `sbn::EventRegistry`.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Utilities/EventRegistry.h`
+ *
+ * Events are registered concurrently from an increasing number of threads,
+ * each recording disjoint events and some events shared with all the others.
+ * The content of the registry is verified at the end, and the registration
+ * time is compared with the one of a registry guarded by a single lock.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Utilities/EventRegistry.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( EventRegistry_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <algorithm> // std::min(), std::max()
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Event registration with a single lock around all events (reference).
+  struct SingleLockRegistry {
+    std::unordered_map<art::EventID, std::vector<std::size_t>> events;
+    std::mutex lock;
+
+    std::vector<std::size_t> recordEvent
+      (art::EventID const& event, std::size_t fileID)
+    {
+      std::lock_guard const lg { lock };
+      auto& record = events[event];
+      record.push_back(fileID);
+      return record;
+    }
+  }; // SingleLockRegistry
+
+
+  constexpr unsigned int NEventsPerThread = 20000;
+  constexpr unsigned int NSharedEvents = 100;
+
+  /// Registers the events of thread `iThread` into `registry`.
+  template <typename Registry>
+  void registerEvents
+    (Registry& registry, unsigned int iThread, std::size_t fileID)
+  {
+    constexpr unsigned int SharedEvery = NEventsPerThread / NSharedEvents;
+    for (unsigned int iEvent = 0; iEvent < NEventsPerThread; ++iEvent) {
+      art::EventID const event
+        { 1000U + iThread, 1U + iEvent / 100U, 1U + iEvent };
+      registry.recordEvent(event, fileID);
+      if (iEvent % SharedEvery == 0) {
+        art::EventID const sharedEvent { 1U, 1U, 1U + iEvent / SharedEvery };
+        registry.recordEvent(sharedEvent, fileID);
+      }
+    } // for
+  } // registerEvents()
+
+
+  /// Runs the registration from `nThreads` threads, returns the time [s].
+  template <typename Registry>
+  double timeRegistration(
+    Registry& registry, unsigned int nThreads,
+    std::vector<std::size_t> const& fileIDs
+  ) {
+    auto const start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int iThread = 0; iThread < nThreads; ++iThread) {
+      threads.emplace_back(
+        [&registry, iThread, fileID=fileIDs[iThread]]
+        { registerEvents(registry, iThread, fileID); }
+        );
+    }
+    for (std::thread& thread: threads) thread.join();
+    std::chrono::duration<double> const elapsed
+      = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  } // timeRegistration()
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- EventRegistry tests
+// -----------------------------------------------------------------------------
+void EventRegistry_sources_test() {
+
+  sbn::EventRegistry registry;
+
+  auto const fileA = registry.recordSource("A.root");
+  auto const fileB = registry.recordSource("B.root");
+  BOOST_CHECK_NE(fileA, fileB);
+  BOOST_CHECK_EQUAL(registry.recordSource("A.root"), fileA);
+  BOOST_CHECK(registry.hasSource(fileB));
+  BOOST_CHECK(registry.hasSource("B.root"));
+  BOOST_CHECK(!registry.hasSource("C.root"));
+  BOOST_CHECK_EQUAL(registry.sourceNameOr(fileB, "none"), "B.root");
+
+  art::EventID const event { 1U, 2U, 3U };
+  BOOST_CHECK(!registry.eventRecord(event));
+  BOOST_CHECK_EQUAL(registry.recordEvent(event, fileA).sourceFiles.size(), 1U);
+  auto const record = registry.recordEvent(event, fileB);
+  BOOST_CHECK_EQUAL(record.sourceFiles.size(), 2U);
+  BOOST_CHECK_EQUAL(record.sourceFiles.front(), fileA);
+  BOOST_CHECK_EQUAL(record.sourceFiles.back(), fileB);
+  BOOST_CHECK_EQUAL(registry.records().size(), 1U);
+
+} // EventRegistry_sources_test()
+
+
+void EventRegistry_contention_test() {
+
+  // up to 16 threads, but not more than the hardware supports
+  // (`hardware_concurrency()` may also be unknown, i.e. `0`)
+  unsigned int const maxThreads
+    = std::min(16U, std::max(1U, std::thread::hardware_concurrency()));
+
+  for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+
+    sbn::EventRegistry registry;
+    std::vector<std::size_t> fileIDs;
+    for (unsigned int iThread = 0; iThread < nThreads; ++iThread) {
+      fileIDs.push_back
+        (registry.recordSource("file" + std::to_string(iThread) + ".root"));
+    }
+
+    SingleLockRegistry reference;
+
+    double const shardedTime = timeRegistration(registry, nThreads, fileIDs);
+    double const singleLockTime
+      = timeRegistration(reference, nThreads, fileIDs);
+
+    // each thread has its own events, plus the ones shared by all threads
+    auto const records = registry.records();
+    BOOST_CHECK_EQUAL
+      (records.size(), nThreads * NEventsPerThread + NSharedEvents);
+    BOOST_CHECK_EQUAL(records.size(), reference.events.size());
+    unsigned int nWrongRecords = 0;
+    for (auto const& [ eventID, record ]: records) {
+      std::size_t const expected = (eventID.run() == 1U)? nThreads: 1U;
+      if (record.sourceFiles.size() != expected) ++nWrongRecords;
+    }
+    BOOST_CHECK_EQUAL(nWrongRecords, 0U);
+
+    BOOST_TEST_MESSAGE(nThreads << " threads registering "
+      << (NEventsPerThread + NSharedEvents) << " events each: "
+      << shardedTime << " s (single lock: " << singleLockTime << " s)");
+
+  } // for threads
+
+} // EventRegistry_contention_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(EventRegistry_testcase) {
+
+  EventRegistry_sources_test();
+  EventRegistry_contention_test();
+
+} // BOOST_AUTO_TEST_CASE(EventRegistry_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+/**
+ * @file   test/Utilities/RunningADCMedian_test.cc
+ * @brief  Unit test for `RunningADCMedian.h` header.
+ * @date   October 19, 2026
+ * @see    `icaruscode/Utilities/RunningADCMedian.h`
+ *
+ * The running median is compared with the median from sorting the values, as
+ * values are added and removed, and on sliding windows.
+ */
+
+// ICARUS libraries
+#include "icaruscode/Utilities/RunningADCMedian.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( RunningADCMedian_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK_EQUAL()
+
+// C/C++ standard library
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  /// Median from sorting: the value at position `N / 2`.
+  template <typename Coll>
+  typename Coll::value_type sortedMedian(Coll const& values) {
+    std::vector<typename Coll::value_type> data(values.begin(), values.end());
+    std::sort(data.begin(), data.end());
+    return data[data.size() / 2];
+  }
+
+} // local namespace
+
+
+// -----------------------------------------------------------------------------
+// --- RunningADCMedian tests
+// -----------------------------------------------------------------------------
+void RunningADCMedian_addRemove_test() {
+
+  icarus::ns::util::RunningADCMedian<short> median;
+  BOOST_CHECK(median.empty());
+
+  std::mt19937 gen { 4321 };
+  std::normal_distribution<double> noise { 0.0, 4.0 };
+  std::uniform_int_distribution<short> pulse { -2000, 0 };
+
+  // a queue of values going through the median, with occasional outliers
+  // in both directions to force the range of the counts to grow
+  std::deque<short> values;
+  for (int i = 0; i < 5000; ++i) {
+    short const value = (i % 97 == 0)
+      ? pulse(gen): static_cast<short>(14000 + std::lround(noise(gen)));
+    values.push_back(value);
+    median.add(value);
+    if (values.size() > 250U) {
+      median.remove(values.front());
+      values.pop_front();
+    }
+    BOOST_CHECK_EQUAL(median.size(), values.size());
+    BOOST_CHECK_EQUAL(median.median(), sortedMedian(values));
+  } // for
+
+  while (!values.empty()) {
+    BOOST_CHECK_EQUAL(median.median(), sortedMedian(values));
+    median.remove(values.back());
+    values.pop_back();
+  }
+  BOOST_CHECK(median.empty());
+
+  // reuse after clearing
+  median.add(3);
+  median.add(1);
+  median.clear();
+  BOOST_CHECK(median.empty());
+  median.add(7);
+  BOOST_CHECK_EQUAL(median.median(), 7);
+
+} // RunningADCMedian_addRemove_test()
+
+
+void RunningADCMedian_sliding_test() {
+
+  std::mt19937 gen { 1234 };
+  std::uniform_int_distribution<short> adc { 1000, 1050 };
+
+  std::vector<short> waveform(777);
+  for (short& sample: waveform) sample = adc(gen);
+
+  for (std::size_t const halfWindow: { 0U, 1U, 20U, 1000U }) {
+
+    auto const medians = icarus::ns::util::RunningADCMedian<short>::slidingMedian
+      (waveform.begin(), waveform.end(), halfWindow);
+    BOOST_CHECK_EQUAL(medians.size(), waveform.size());
+
+    for (std::size_t i = 0U; i < waveform.size(); ++i) {
+      auto const first = waveform.begin() + (i > halfWindow? i - halfWindow: 0U);
+      auto const last
+        = waveform.begin() + std::min(i + halfWindow + 1U, waveform.size());
+      BOOST_CHECK_EQUAL
+        (medians[i], sortedMedian(std::vector<short>(first, last)));
+    } // for samples
+
+  } // for windows
+
+} // RunningADCMedian_sliding_test()
+
+
+// -----------------------------------------------------------------------------
+// BEGIN Test cases  -----------------------------------------------------------
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(RunningADCMedian_testcase) {
+
+  RunningADCMedian_addRemove_test();
+  RunningADCMedian_sliding_test();
+
+} // BOOST_AUTO_TEST_CASE(RunningADCMedian_testcase)
+
+
+// -----------------------------------------------------------------------------
+// END Test cases  -------------------------------------------------------------
+// -----------------------------------------------------------------------------